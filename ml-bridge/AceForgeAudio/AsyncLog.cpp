@@ -0,0 +1,221 @@
+#include "AsyncLog.hpp"
+#include <chrono>
+#include <cstring>
+#include <ctime>
+
+namespace aceforge {
+
+namespace {
+
+constexpr size_t kBatchRecords = 256; // lines per write/flush
+
+/** path with ".<n>" before the extension: log/AceForgeBridge.log -> log/AceForgeBridge.2.log */
+std::string backupPath(const std::string& path, int n) {
+    const size_t slash = path.find_last_of("/\\");
+    const size_t dot = path.find_last_of('.');
+    const bool hasExtension = dot != std::string::npos && (slash == std::string::npos || dot > slash);
+    const std::string suffix = "." + std::to_string(n);
+    return hasExtension ? path.substr(0, dot) + suffix + path.substr(dot) : path + suffix;
+}
+
+void appendLine(std::string& out, int64_t timeMicros, LogLevel level, const char* text, size_t length) {
+    const std::time_t seconds = (std::time_t)(timeMicros / 1000000);
+    std::tm local{};
+#ifdef _WIN32
+    localtime_s(&local, &seconds);
+#else
+    localtime_r(&seconds, &local);
+#endif
+    char stamp[48];
+    const size_t stampLength = std::strftime(stamp, sizeof(stamp), "%Y-%m-%d %H:%M:%S", &local);
+    char millis[8];
+    std::snprintf(millis, sizeof(millis), ".%03d ", (int)((timeMicros / 1000) % 1000));
+    out.append(stamp, stampLength);
+    out.append(millis);
+    out.append(logLevelName(level));
+    out.append(": ");
+    out.append(text, length);
+    out.push_back('\n');
+}
+
+} // namespace
+
+const char* logLevelName(LogLevel level) {
+    switch (level) {
+        case LogLevel::Trace: return "TRACE";
+        case LogLevel::Info: return "INFO";
+        case LogLevel::Warning: return "WARN";
+        case LogLevel::Error: return "ERROR";
+    }
+    return "";
+}
+
+AsyncLog::~AsyncLog() {
+    close();
+}
+
+bool AsyncLog::open(const std::string& path, const Options& options) {
+    close();
+    std::FILE* file = std::fopen(path.c_str(), "ab");
+    if (file == nullptr) return false;
+    std::fseek(file, 0, SEEK_END);
+    const long size = std::ftell(file);
+
+    if (ring_ == nullptr) {
+        ring_ = std::make_unique<std::array<Record, kRecords>>();
+        for (size_t i = 0; i < kRecords; ++i) (*ring_)[i].sequence.store(i, std::memory_order_relaxed);
+        enqueuePos_.store(0, std::memory_order_relaxed);
+        dequeuePos_ = 0;
+        writtenPos_.store(0, std::memory_order_relaxed);
+    }
+    path_ = path;
+    options_ = options;
+    file_ = file;
+    fileBytes_ = size > 0 ? (size_t)size : 0;
+    droppedReported_ = dropped_.load(std::memory_order_relaxed);
+    stopping_ = false;
+    running_.store(true, std::memory_order_release);
+    thread_ = std::thread([this] { run(); });
+    return true;
+}
+
+void AsyncLog::close() {
+    if (!thread_.joinable()) return;
+    running_.store(false, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> l(wakeLock_);
+        stopping_ = true;
+    }
+    wake_.notify_one();
+    thread_.join(); // drains the ring before it exits
+    std::fclose(file_);
+    file_ = nullptr;
+    flushed_.notify_all();
+}
+
+bool AsyncLog::write(LogLevel level, const char* text) {
+    return write(level, text, text != nullptr ? std::strlen(text) : 0);
+}
+
+bool AsyncLog::write(LogLevel level, const char* text, size_t length) {
+    if (!isEnabled(level) || !running_.load(std::memory_order_acquire)) return false;
+    const int64_t timeMicros = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+
+    // Claim a slot: its sequence equals the position while it is free for this lap
+    size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+    Record* record = nullptr;
+    for (;;) {
+        record = &(*ring_)[pos & (kRecords - 1)];
+        const size_t sequence = record->sequence.load(std::memory_order_acquire);
+        const intptr_t diff = (intptr_t)sequence - (intptr_t)pos;
+        if (diff == 0) {
+            if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+        } else if (diff < 0) {
+            dropped_.fetch_add(1, std::memory_order_relaxed); // the writer is a full lap behind
+            return false;
+        } else {
+            pos = enqueuePos_.load(std::memory_order_relaxed);
+        }
+    }
+
+    length = length < kMaxText ? length : kMaxText;
+    if (length > 0) std::memcpy(record->text, text, length);
+    record->length = (uint16_t)length;
+    record->level = level;
+    record->timeMicros = timeMicros;
+    record->sequence.store(pos + 1, std::memory_order_release);
+
+    // Warnings and errors go out now; a burst wakes the writer every quarter ring so it does not fill up
+    if (level >= LogLevel::Warning || (pos & (kRecords / 4 - 1)) == 0) {
+        // Without taking the lock: a missed wakeup only delays the line to the next flush interval
+        wakePending_.store(true, std::memory_order_release);
+        wake_.notify_one();
+    }
+    return true;
+}
+
+void AsyncLog::flush() {
+    if (!running_.load(std::memory_order_acquire)) return;
+    const size_t target = enqueuePos_.load(std::memory_order_acquire);
+    wakePending_.store(true, std::memory_order_release);
+    wake_.notify_one();
+    std::unique_lock<std::mutex> l(wakeLock_);
+    flushed_.wait(l, [&] {
+        return writtenPos_.load(std::memory_order_acquire) >= target || !running_.load(std::memory_order_acquire);
+    });
+}
+
+void AsyncLog::run() {
+    std::string batch;
+    batch.reserve(kBatchRecords * 96);
+    for (;;) {
+        bool stop = false;
+        {
+            std::unique_lock<std::mutex> l(wakeLock_);
+            wake_.wait_for(l, std::chrono::milliseconds(options_.flushIntervalMs),
+                           [&] { return stopping_ || wakePending_.load(std::memory_order_acquire); });
+            wakePending_.store(false, std::memory_order_relaxed);
+            stop = stopping_;
+        }
+        while (drain(batch) > 0 || !batch.empty()) {
+            append(batch);
+            batch.clear();
+        }
+        {
+            std::lock_guard<std::mutex> l(wakeLock_);
+            writtenPos_.store(dequeuePos_, std::memory_order_release);
+        }
+        flushed_.notify_all();
+        if (stop) return;
+    }
+}
+
+size_t AsyncLog::drain(std::string& batch) {
+    const uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+    if (dropped != droppedReported_) {
+        const std::string note = std::to_string(dropped - droppedReported_) + " log lines dropped (ring full)";
+        const int64_t now = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        appendLine(batch, now, LogLevel::Warning, note.data(), note.size());
+        droppedReported_ = dropped;
+    }
+
+    size_t count = 0;
+    for (; count < kBatchRecords; ++count) {
+        Record& record = (*ring_)[dequeuePos_ & (kRecords - 1)];
+        if (record.sequence.load(std::memory_order_acquire) != dequeuePos_ + 1) break; // empty, or still being written
+        const size_t lineStart = batch.size();
+        appendLine(batch, record.timeMicros, record.level, record.text, record.length);
+        if (record.level >= options_.echoLevel) std::fwrite(batch.data() + lineStart, 1, batch.size() - lineStart, stderr);
+        record.sequence.store(dequeuePos_ + kRecords, std::memory_order_release); // free for the next lap
+        ++dequeuePos_;
+    }
+    return count;
+}
+
+void AsyncLog::append(const std::string& batch) {
+    if (file_ == nullptr) return;
+    std::fwrite(batch.data(), 1, batch.size(), file_);
+    std::fflush(file_);
+    fileBytes_ += batch.size();
+    if (fileBytes_ >= options_.maxFileBytes) rotate();
+}
+
+void AsyncLog::rotate() {
+    std::fclose(file_);
+    for (int n = options_.maxBackups - 1; n >= 1; --n) {
+        std::remove(backupPath(path_, n + 1).c_str()); // rename over an existing file fails on Windows
+        std::rename(backupPath(path_, n).c_str(), backupPath(path_, n + 1).c_str());
+    }
+    if (options_.maxBackups > 0) {
+        std::remove(backupPath(path_, 1).c_str());
+        std::rename(path_.c_str(), backupPath(path_, 1).c_str());
+    } else {
+        std::remove(path_.c_str());
+    }
+    file_ = std::fopen(path_.c_str(), "ab");
+    fileBytes_ = 0;
+}
+
+} // namespace aceforge
@@ -0,0 +1,112 @@
+/**
+ * Asynchronous append-only log file.
+ *
+ * Callers format nothing and touch no file: write() copies the text and a timestamp into a fixed-size record in
+ * a lock-free ring (bounded multi-producer queue, one sequence number per slot) and returns. A background thread
+ * drains the ring in batches, formats the lines and appends them with one write and one flush per batch. The file
+ * is rotated by size (name.log -> name.1.log -> ... name.<maxBackups>.log).
+ *
+ * write() never blocks and never allocates, so any thread may log, including ones next to the audio thread (not
+ * the audio callback itself: a full ring drops the line, and the drop is counted and reported in the file).
+ * Lines longer than kMaxText bytes are cut. Warnings and errors wake the writer at once; other lines reach the
+ * file within flushIntervalMs.
+ */
+#ifndef ACEFORGE_ASYNC_LOG_HPP
+#define ACEFORGE_ASYNC_LOG_HPP
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace aceforge {
+
+enum class LogLevel : uint8_t { Trace, Info, Warning, Error };
+
+/** "TRACE", "INFO", "WARN" or "ERROR". */
+const char* logLevelName(LogLevel level);
+
+class AsyncLog {
+public:
+    static constexpr size_t kMaxText = 490;  // bytes of message text per line
+    static constexpr size_t kRecords = 1024; // ring capacity (power of two)
+
+    struct Options {
+        size_t maxFileBytes = 4 * 1024 * 1024; // rotate once the file grows past this
+        int maxBackups = 3;                    // rotated files kept next to the log
+        int flushIntervalMs = 50;              // how long a trace line may wait in the ring
+        LogLevel echoLevel = LogLevel::Error;  // lines at or above this are also written to stderr
+    };
+
+    AsyncLog() = default;
+    ~AsyncLog();
+    AsyncLog(const AsyncLog&) = delete;
+    AsyncLog& operator=(const AsyncLog&) = delete;
+
+    /** Opens (appends to) path and starts the writer thread. False if the file cannot be opened. */
+    bool open(const std::string& path, const Options& options);
+    bool open(const std::string& path) { return open(path, Options()); }
+    /** Writes everything queued so far, closes the file and joins the writer thread. */
+    void close();
+    bool isOpen() const { return running_.load(std::memory_order_acquire); }
+
+    /** Lines below level are dropped at the call site (one atomic load). */
+    void setLevel(LogLevel level) { level_.store(level, std::memory_order_relaxed); }
+    LogLevel getLevel() const { return level_.load(std::memory_order_relaxed); }
+    bool isEnabled(LogLevel level) const { return level >= getLevel(); }
+
+    /** Queues one line. Lock-free and allocation-free; false if the level is off, the log is closed or the ring is full. */
+    bool write(LogLevel level, const char* text, size_t length);
+    bool write(LogLevel level, const char* text);
+
+    /** Blocks until every line queued before the call is in the file (for shutdown paths and tests). */
+    void flush();
+
+    /** Lines lost to a full ring since open(). */
+    uint64_t droppedCount() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    struct alignas(64) Record {
+        std::atomic<size_t> sequence{ 0 };
+        int64_t timeMicros = 0; // since the Unix epoch
+        uint16_t length = 0;
+        LogLevel level = LogLevel::Trace;
+        char text[kMaxText];
+    };
+
+    void run();
+    size_t drain(std::string& batch);
+    void append(const std::string& batch);
+    void rotate();
+
+    std::unique_ptr<std::array<Record, kRecords>> ring_;
+    std::atomic<size_t> enqueuePos_{ 0 };
+    size_t dequeuePos_ = 0; // writer thread only
+    std::atomic<LogLevel> level_{ LogLevel::Trace };
+    std::atomic<uint64_t> dropped_{ 0 };
+    uint64_t droppedReported_ = 0; // writer thread only
+    std::atomic<bool> running_{ false };
+    std::atomic<bool> wakePending_{ false };
+
+    std::string path_;
+    Options options_;
+    std::FILE* file_ = nullptr; // writer thread only while running
+    size_t fileBytes_ = 0;
+
+    std::mutex wakeLock_;
+    std::condition_variable wake_;
+    std::condition_variable flushed_;
+    std::atomic<size_t> writtenPos_{ 0 }; // records below this are in the file
+    bool stopping_ = false;               // guarded by wakeLock_
+    std::thread thread_;
+};
+
+} // namespace aceforge
+
+#endif
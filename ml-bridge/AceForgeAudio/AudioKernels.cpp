@@ -0,0 +1,163 @@
+#include "AudioKernels.hpp"
+#include "Simd.hpp"
+#include <cstring>
+
+namespace aceforge {
+namespace kernels {
+
+// Plain copies and clears go through the C library, which already uses the widest vector moves available
+void copy(float* dst, const float* src, int numSamples) {
+    if (numSamples > 0) std::memcpy(dst, src, (size_t)numSamples * sizeof(float));
+}
+
+void clear(float* dst, int numSamples) {
+    if (numSamples > 0) std::memset(dst, 0, (size_t)numSamples * sizeof(float));
+}
+
+void copyWithGain(float* dst, const float* src, int numSamples, float gain) {
+    int i = 0;
+#if defined(ACEFORGE_SIMD_SSE2)
+    const __m128 g = _mm_set1_ps(gain);
+    for (; i + 8 <= numSamples; i += 8) {
+        _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_loadu_ps(src + i), g));
+        _mm_storeu_ps(dst + i + 4, _mm_mul_ps(_mm_loadu_ps(src + i + 4), g));
+    }
+#elif defined(ACEFORGE_SIMD_NEON)
+    const float32x4_t g = vdupq_n_f32(gain);
+    for (; i + 8 <= numSamples; i += 8) {
+        vst1q_f32(dst + i, vmulq_f32(vld1q_f32(src + i), g));
+        vst1q_f32(dst + i + 4, vmulq_f32(vld1q_f32(src + i + 4), g));
+    }
+#endif
+    for (; i < numSamples; ++i) dst[i] = src[i] * gain;
+}
+
+void copyWithRamp(float* dst, const float* src, int numSamples, float startGain, float gainStep) {
+    int i = 0;
+#if defined(ACEFORGE_SIMD_SSE2)
+    // Gains are recomputed from the start value each iteration rather than accumulated, so long ramps don't drift
+    const __m128 lane = _mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f);
+    const __m128 step = _mm_set1_ps(gainStep);
+    const __m128 start = _mm_set1_ps(startGain);
+    for (; i + 4 <= numSamples; i += 4) {
+        const __m128 idx = _mm_add_ps(_mm_set1_ps((float)i), lane);
+        const __m128 g = _mm_add_ps(start, _mm_mul_ps(idx, step));
+        _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_loadu_ps(src + i), g));
+    }
+#elif defined(ACEFORGE_SIMD_NEON)
+    const float laneInit[4] = { 0.0f, 1.0f, 2.0f, 3.0f };
+    const float32x4_t lane = vld1q_f32(laneInit);
+    const float32x4_t start = vdupq_n_f32(startGain);
+    for (; i + 4 <= numSamples; i += 4) {
+        const float32x4_t idx = vaddq_f32(vdupq_n_f32((float)i), lane);
+        const float32x4_t g = vmlaq_n_f32(start, idx, gainStep);
+        vst1q_f32(dst + i, vmulq_f32(vld1q_f32(src + i), g));
+    }
+#endif
+    for (; i < numSamples; ++i) dst[i] = src[i] * (startGain + (float)i * gainStep);
+}
+
+void addWindowed(float* dst, const float* src, const float* window, int numSamples) {
+    int i = 0;
+#if defined(ACEFORGE_SIMD_SSE2)
+    for (; i + 8 <= numSamples; i += 8) {
+        const __m128 a = _mm_mul_ps(_mm_loadu_ps(src + i), _mm_loadu_ps(window + i));
+        const __m128 b = _mm_mul_ps(_mm_loadu_ps(src + i + 4), _mm_loadu_ps(window + i + 4));
+        _mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), a));
+        _mm_storeu_ps(dst + i + 4, _mm_add_ps(_mm_loadu_ps(dst + i + 4), b));
+    }
+#elif defined(ACEFORGE_SIMD_NEON)
+    for (; i + 8 <= numSamples; i += 8) {
+        vst1q_f32(dst + i, vmlaq_f32(vld1q_f32(dst + i), vld1q_f32(src + i), vld1q_f32(window + i)));
+        vst1q_f32(dst + i + 4, vmlaq_f32(vld1q_f32(dst + i + 4), vld1q_f32(src + i + 4), vld1q_f32(window + i + 4)));
+    }
+#endif
+    for (; i < numSamples; ++i) dst[i] += src[i] * window[i];
+}
+
+void deinterleave(const float* interleaved, int numChannels, int numFrames, float* const* dst, int numDst) {
+    if (numChannels <= 0 || numFrames <= 0 || numDst <= 0) return;
+    if (numChannels == 1) {
+        for (int c = 0; c < numDst; ++c) copy(dst[c], interleaved, numFrames);
+        return;
+    }
+    if (numChannels == 2 && numDst >= 2) {
+        float* l = dst[0];
+        float* r = dst[1];
+        int i = 0;
+#if defined(ACEFORGE_SIMD_SSE2)
+        for (; i + 4 <= numFrames; i += 4) {
+            const __m128 a = _mm_loadu_ps(interleaved + i * 2);      // l0 r0 l1 r1
+            const __m128 b = _mm_loadu_ps(interleaved + i * 2 + 4);  // l2 r2 l3 r3
+            _mm_storeu_ps(l + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+            _mm_storeu_ps(r + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+        }
+#elif defined(ACEFORGE_SIMD_NEON)
+        for (; i + 4 <= numFrames; i += 4) {
+            const float32x4x2_t v = vld2q_f32(interleaved + i * 2);
+            vst1q_f32(l + i, v.val[0]);
+            vst1q_f32(r + i, v.val[1]);
+        }
+#endif
+        for (; i < numFrames; ++i) {
+            l[i] = interleaved[i * 2];
+            r[i] = interleaved[i * 2 + 1];
+        }
+        for (int c = 2; c < numDst; ++c) copy(dst[c], r, numFrames);
+        return;
+    }
+    for (int c = 0; c < numDst; ++c) {
+        const int sc = c < numChannels ? c : numChannels - 1;
+        float* out = dst[c];
+        const float* in = interleaved + sc;
+        for (int i = 0; i < numFrames; ++i) out[i] = in[(size_t)i * (size_t)numChannels];
+    }
+}
+
+void minMax(const float* src, int numSamples, float& lo, float& hi) {
+    int i = 0;
+#if defined(ACEFORGE_SIMD_SSE2)
+    // Two accumulator pairs hide the min/max latency; minps/maxps return the second operand for a NaN, the
+    // accumulator here, so NaNs are skipped like in the scalar tail
+    if (numSamples >= 8) {
+        __m128 lo0 = _mm_set1_ps(lo), lo1 = lo0, hi0 = _mm_set1_ps(hi), hi1 = hi0;
+        for (; i + 8 <= numSamples; i += 8) {
+            const __m128 a = _mm_loadu_ps(src + i);
+            const __m128 b = _mm_loadu_ps(src + i + 4);
+            lo0 = _mm_min_ps(a, lo0);
+            lo1 = _mm_min_ps(b, lo1);
+            hi0 = _mm_max_ps(a, hi0);
+            hi1 = _mm_max_ps(b, hi1);
+        }
+        lo0 = _mm_min_ps(lo0, lo1);
+        hi0 = _mm_max_ps(hi0, hi1);
+        lo0 = _mm_min_ps(lo0, _mm_shuffle_ps(lo0, lo0, _MM_SHUFFLE(1, 0, 3, 2)));
+        hi0 = _mm_max_ps(hi0, _mm_shuffle_ps(hi0, hi0, _MM_SHUFFLE(1, 0, 3, 2)));
+        lo = _mm_cvtss_f32(_mm_min_ss(lo0, _mm_shuffle_ps(lo0, lo0, _MM_SHUFFLE(2, 3, 0, 1))));
+        hi = _mm_cvtss_f32(_mm_max_ss(hi0, _mm_shuffle_ps(hi0, hi0, _MM_SHUFFLE(2, 3, 0, 1))));
+    }
+#elif defined(ACEFORGE_SIMD_NEON) && (defined(__aarch64__) || defined(_M_ARM64))
+    // vminnmq/vmaxnmq (IEEE minNum/maxNum, ARMv8) return the number when one operand is a NaN
+    if (numSamples >= 8) {
+        float32x4_t lo0 = vdupq_n_f32(lo), lo1 = lo0, hi0 = vdupq_n_f32(hi), hi1 = hi0;
+        for (; i + 8 <= numSamples; i += 8) {
+            const float32x4_t a = vld1q_f32(src + i);
+            const float32x4_t b = vld1q_f32(src + i + 4);
+            lo0 = vminnmq_f32(lo0, a);
+            lo1 = vminnmq_f32(lo1, b);
+            hi0 = vmaxnmq_f32(hi0, a);
+            hi1 = vmaxnmq_f32(hi1, b);
+        }
+        lo = vminnmvq_f32(vminnmq_f32(lo0, lo1));
+        hi = vmaxnmvq_f32(vmaxnmq_f32(hi0, hi1));
+    }
+#endif
+    for (; i < numSamples; ++i) {
+        const float v = src[i];
+        if (v < lo) lo = v;
+        if (v > hi) hi = v;
+    }
+}
+
+} // namespace kernels
+} // namespace aceforge
@@ -0,0 +1,37 @@
+/**
+ * Vectorized block kernels for planar float audio (SSE2 on x86-64, NEON on ARM64, scalar elsewhere).
+ *
+ * All functions are realtime-safe: no allocation, no locks, no branches per sample. Pointers need no
+ * particular alignment; dst and src must not overlap.
+ */
+#ifndef ACEFORGE_AUDIO_KERNELS_HPP
+#define ACEFORGE_AUDIO_KERNELS_HPP
+
+namespace aceforge {
+namespace kernels {
+
+void copy(float* dst, const float* src, int numSamples);
+void clear(float* dst, int numSamples);
+
+/** dst[i] = src[i] * gain */
+void copyWithGain(float* dst, const float* src, int numSamples, float gain);
+
+/** dst[i] = src[i] * (startGain + i * gainStep): a linear gain or fade ramp in the same pass as the copy. */
+void copyWithRamp(float* dst, const float* src, int numSamples, float startGain, float gainStep);
+
+/** dst[i] += src[i] * window[i]: one windowed grain overlap-added into the output (TimeStretch). */
+void addWindowed(float* dst, const float* src, const float* window, int numSamples);
+
+/**
+ * Splits interleaved frames into numDst planar channels. Destination channels beyond numChannels repeat the
+ * last source channel (mono -> stereo duplicates), extra source channels are dropped.
+ */
+void deinterleave(const float* interleaved, int numChannels, int numFrames, float* const* dst, int numDst);
+
+/** Widens [lo, hi] to cover src[0..numSamples): a min/max reduction (PeakPyramid). NaNs are skipped. */
+void minMax(const float* src, int numSamples, float& lo, float& hi);
+
+} // namespace kernels
+} // namespace aceforge
+
+#endif
@@ -0,0 +1,83 @@
+#include "ClipHandoff.hpp"
+#include <algorithm>
+
+namespace aceforge {
+
+std::shared_ptr<PlaybackClip> ClipHandoff::createClip(int numChannels, int numFrames) {
+    {
+        std::lock_guard<std::mutex> l(lock_);
+        for (auto it = free_.begin(); it != free_.end(); ++it) {
+            if ((*it)->audio.numChannels() == numChannels && (*it)->audio.numFrames() >= numFrames) {
+                std::shared_ptr<PlaybackClip> clip = std::move(*it);
+                free_.erase(it);
+                clip->readyFrames.store(0, std::memory_order_relaxed);
+                clip->complete.store(false, std::memory_order_relaxed);
+                clip->sampleRate = 0.0;
+                clip->sourceId = 0;
+                clip->stretch = 1.0;
+                clip->isRerender = false;
+                clip->startOnBar = false;
+                clip->isRing = false;
+                clip->firstFrame = 0;
+                clip->consumedFrames.store(0, std::memory_order_relaxed);
+                return clip;
+            }
+        }
+    }
+    // Allocate outside the lock: a long clip takes a while to zero
+    auto clip = std::make_shared<PlaybackClip>();
+    clip->audio.allocate(numChannels, numFrames);
+    return clip;
+}
+
+void ClipHandoff::publish(std::shared_ptr<PlaybackClip> clip) {
+    std::lock_guard<std::mutex> l(lock_);
+    PlaybackClip* raw = clip.get();
+    if (raw != nullptr) live_.push_back(std::move(clip));
+    // The audio thread never saw a clip we take back out of the slot, so it can go right away
+    if (PlaybackClip* displaced = pending_.exchange(raw, std::memory_order_acq_rel))
+        dropLocked(displaced);
+}
+
+void ClipHandoff::reclaim() {
+    std::lock_guard<std::mutex> l(lock_);
+    size_t head = retireHead_.load(std::memory_order_relaxed);
+    const size_t tail = retireTail_.load(std::memory_order_acquire);
+    for (; head != tail; ++head)
+        dropLocked(retired_[head % kRetireSlots]);
+    retireHead_.store(head, std::memory_order_release);
+}
+
+void ClipHandoff::dropLocked(const PlaybackClip* clip) {
+    auto it = std::find_if(live_.begin(), live_.end(), [clip](const auto& p) { return p.get() == clip; });
+    if (it == live_.end()) return;
+    // Pool only clips nobody else holds; a producer still writing keeps its reference and frees it when done
+    if (it->use_count() == 1 && free_.size() < kMaxPooled) free_.push_back(std::move(*it));
+    live_.erase(it);
+}
+
+const PlaybackClip* ClipHandoff::acquire() {
+    // With no room to track another clip, leave it in the slot until reclaim() has caught up
+    if (numHeld_ == kMaxHeld || pending_.load(std::memory_order_relaxed) == nullptr) return nullptr;
+    const PlaybackClip* clip = pending_.exchange(nullptr, std::memory_order_acq_rel);
+    if (clip != nullptr) held_[numHeld_++] = clip;
+    return clip;
+}
+
+void ClipHandoff::releaseUnused(const PlaybackClip* inUse, const PlaybackClip* alsoInUse,
+                                const PlaybackClip* waiting) {
+    for (size_t i = 0; i < numHeld_;) {
+        const PlaybackClip* clip = held_[i];
+        if (clip == inUse || clip == alsoInUse || clip == waiting) {
+            ++i;
+            continue;
+        }
+        const size_t tail = retireTail_.load(std::memory_order_relaxed);
+        if (tail - retireHead_.load(std::memory_order_acquire) == kRetireSlots) return;  // ring full: retry next block
+        retired_[tail % kRetireSlots] = clip;
+        retireTail_.store(tail + 1, std::memory_order_release);
+        held_[i] = held_[--numHeld_];
+    }
+}
+
+} // namespace aceforge
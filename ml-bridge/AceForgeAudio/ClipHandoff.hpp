@@ -0,0 +1,73 @@
+/**
+ * Wait-free handoff of playback clips from a producer thread to the audio thread.
+ *
+ * The producer creates a clip (createClip, reusing reclaimed memory when it fits), writes frames into it and
+ * publishes it with a single pointer exchange; it may keep appending frames after publishing, but never
+ * changes frames below readyFrames (a ring clip reuses only slots the engine has consumed). The audio thread picks the clip up with one exchange (acquire) and reports
+ * which clips it still reads after each block (releaseUnused). Clips it let go of travel back through a
+ * fixed-size ring and are freed or pooled by reclaim() on a non-realtime thread, so the audio thread never
+ * copies, allocates or frees clip memory (RCU-style deferred reclamation).
+ *
+ * Producer-side calls (createClip, publish, reclaim) may come from any non-realtime thread.
+ * acquire and releaseUnused must only be called from the audio thread.
+ */
+#ifndef ACEFORGE_CLIP_HANDOFF_HPP
+#define ACEFORGE_CLIP_HANDOFF_HPP
+
+#include "PlaybackEngine.hpp"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace aceforge {
+
+class ClipHandoff {
+public:
+    ClipHandoff() = default;
+    ClipHandoff(const ClipHandoff&) = delete;
+    ClipHandoff& operator=(const ClipHandoff&) = delete;
+
+    /** A clip with room for numFrames per channel and readyFrames = 0; pooled memory is reused when it fits. */
+    std::shared_ptr<PlaybackClip> createClip(int numChannels, int numFrames);
+
+    /** Makes clip the next one the audio thread picks up. A clip published earlier but never picked up is dropped. */
+    void publish(std::shared_ptr<PlaybackClip> clip);
+
+    /** Frees (or pools) clips the audio thread has let go of. Call periodically from a non-realtime thread. */
+    void reclaim();
+
+    /** Audio thread: the newly published clip, or nullptr. Wait-free. */
+    const PlaybackClip* acquire();
+
+    /** Audio thread: hands back every acquired clip other than the (up to three) still in use. Wait-free. */
+    void releaseUnused(const PlaybackClip* inUse, const PlaybackClip* alsoInUse, const PlaybackClip* waiting = nullptr);
+
+private:
+    static constexpr size_t kMaxHeld = 8;
+    static constexpr size_t kRetireSlots = 16;
+    static constexpr size_t kMaxPooled = 2;
+
+    void dropLocked(const PlaybackClip* clip);
+
+    std::atomic<PlaybackClip*> pending_{ nullptr };
+
+    // Audio thread only: clips acquired and not yet handed back
+    std::array<const PlaybackClip*, kMaxHeld> held_{};
+    size_t numHeld_ = 0;
+
+    // Single-producer (audio thread) single-consumer (reclaim) ring of clips to free
+    std::array<const PlaybackClip*, kRetireSlots> retired_{};
+    std::atomic<size_t> retireHead_{ 0 };  // next slot reclaim() reads
+    std::atomic<size_t> retireTail_{ 0 };  // next slot the audio thread writes
+
+    std::mutex lock_;                                  // guards live_, free_ and the consumer side of the ring
+    std::vector<std::shared_ptr<PlaybackClip>> live_;  // every clip published and not yet reclaimed
+    std::vector<std::shared_ptr<PlaybackClip>> free_;  // reclaimed clips kept for reuse
+};
+
+} // namespace aceforge
+
+#endif
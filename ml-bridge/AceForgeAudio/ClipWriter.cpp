@@ -0,0 +1,94 @@
+#include "ClipWriter.hpp"
+#include "AudioKernels.hpp"
+#include <algorithm>
+
+namespace aceforge {
+
+bool ClipWriter::begin(ClipHandoff& handoff, int64_t sourceFrames, double sourceRate, double hostRate, int64_t sourceId,
+                       int maxFrames, int prebufferFrames, PublishFn publish) {
+    active_ = false;
+    resampler_.setRates(sourceRate, hostRate);
+    // Unknown length (streamed WAV header): reserve the whole clip buffer and stop writing once it is full
+    const int64_t outFrames = sourceFrames > 0 ? resampler_.outputLength(sourceFrames) : (int64_t)maxFrames;
+    if (outFrames <= 0 || outFrames > maxFrames) return false;
+
+    clip_ = handoff.createClip(kChannels, (int)outFrames);
+    clip_->sampleRate = hostRate;
+    clip_->sourceId = sourceId;
+    publish_ = std::move(publish);
+    for (auto& channel : source_) {
+        channel.clear();
+        if (sourceFrames > 0) channel.reserve((size_t)sourceFrames);
+    }
+    sourceId_ = sourceId;
+    maxFrames_ = maxFrames;
+    prebufferFrames_ = prebufferFrames;
+    outFrames_ = (int)outFrames;
+    outWritten_ = 0;
+    unbounded_ = sourceFrames <= 0;
+    published_ = false;
+    truncated_ = false;
+    active_ = true;
+    return true;
+}
+
+void ClipWriter::append(const float* interleaved, int numFrames, int sourceChannels) {
+    if (!active_ || truncated_ || numFrames <= 0 || interleaved == nullptr || sourceChannels <= 0) return;
+    const size_t base = source_[0].size();
+    float* dst[kChannels];
+    for (int c = 0; c < kChannels; ++c) {
+        source_[c].resize(base + (size_t)numFrames);
+        dst[c] = source_[c].data() + base;
+    }
+    kernels::deinterleave(interleaved, sourceChannels, numFrames, dst, kChannels);
+    render(false);
+}
+
+void ClipWriter::appendPlanar(const float* const* channels, int numChannels, int numFrames) {
+    if (!active_ || truncated_ || numFrames <= 0 || channels == nullptr || numChannels <= 0) return;
+    for (int c = 0; c < kChannels; ++c) {
+        const float* src = channels[std::min(c, numChannels - 1)];
+        source_[c].insert(source_[c].end(), src, src + numFrames);
+    }
+    render(false);
+}
+
+void ClipWriter::finish() {
+    if (!active_) return;
+    if (!truncated_) {
+        if (unbounded_)
+            outFrames_ = (int)std::min<int64_t>(maxFrames_, resampler_.outputLength((int64_t)source_[0].size()));
+        render(true);
+    }
+    active_ = false;
+    clip_.reset();
+    publish_ = nullptr;
+}
+
+void ClipWriter::render(bool endOfStream) {
+    const int64_t numFrames = (int64_t)source_[0].size();
+    if (numFrames <= 0) return;
+    // Until the stream ends, only render output frames whose whole filter window has already arrived
+    int limit = outFrames_;
+    if (!endOfStream) limit = (int)std::min<int64_t>(limit, resampler_.outputFramesReady(numFrames));
+    if (limit > outWritten_) {
+        PlanarBuffer& out = clip_->audio;
+        for (int c = 0; c < kChannels; ++c)
+            resampler_.render(source_[c].data(), numFrames, out.channel(c) + outWritten_, outWritten_, limit);
+        outWritten_ = limit;
+    }
+    clip_->readyFrames.store(outWritten_, std::memory_order_release);
+    // The end of the source, or a full buffer that will not grow: playing past it is the clip ending, not an underrun
+    if (endOfStream || outWritten_ >= outFrames_) clip_->complete.store(true, std::memory_order_release);
+    if (!published_ && (outWritten_ >= prebufferFrames_ || endOfStream)) {
+        published_ = true;
+        if (publish_) publish_(clip_);
+    }
+    if (unbounded_ && !endOfStream && outWritten_ >= outFrames_) {
+        // The clip buffer is full; the source is no longer needed
+        truncated_ = true;
+        for (auto& channel : source_) channel = {};
+    }
+}
+
+} // namespace aceforge
@@ -0,0 +1,73 @@
+/**
+ * Builds one stereo playback clip at the host rate from source frames as they arrive (a streamed download, or a
+ * whole decoded file in one piece).
+ *
+ * Source frames are deinterleaved into planar source-rate buffers; after each append only the output frames
+ * whose whole resampler window has arrived are rendered into the clip. Once prebufferFrames are ready the clip
+ * goes to the audio thread through the owner's publish callback, and from then on readyFrames simply grows.
+ * With an unknown source length the whole maxFrames buffer is reserved and writing stops when it is full
+ * (truncated()); the owner plays the rest some other way.
+ *
+ * Owned and used by one producer thread; the audio thread only sees the published clip.
+ */
+#ifndef ACEFORGE_CLIP_WRITER_HPP
+#define ACEFORGE_CLIP_WRITER_HPP
+
+#include "ClipHandoff.hpp"
+#include "Resampler.hpp"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace aceforge {
+
+class ClipWriter {
+public:
+    static constexpr int kChannels = 2;
+    /** Called on the producer thread, once per clip; typically ClipHandoff::publish unless something newer plays. */
+    using PublishFn = std::function<void(const std::shared_ptr<PlaybackClip>& clip)>;
+
+    /**
+     * Starts a clip for sourceId: sourceFrames at sourceRate (<= 0 when unknown), rendered at hostRate into a fresh
+     * clip from handoff. Returns false, with nothing started, when the known length does not fit in maxFrames.
+     */
+    bool begin(ClipHandoff& handoff, int64_t sourceFrames, double sourceRate, double hostRate, int64_t sourceId,
+               int maxFrames, int prebufferFrames, PublishFn publish);
+    /** Adds interleaved source frames (mono is duplicated, channels past two dropped) and renders what they complete. */
+    void append(const float* interleaved, int numFrames, int sourceChannels);
+    /** Adds planar source frames. */
+    void appendPlanar(const float* const* channels, int numChannels, int numFrames);
+    /** End of the source: renders the remaining output, publishes if that has not happened yet, and releases the clip. */
+    void finish();
+
+    bool active() const { return active_; }
+    bool truncated() const { return truncated_; }
+    bool published() const { return published_; }
+    int framesWritten() const { return outWritten_; }
+    int64_t sourceId() const { return sourceId_; }
+    const Resampler& resampler() const { return resampler_; }
+    /** Source-rate audio after finish() (empty when truncated), e.g. to re-render later at another host rate. */
+    std::vector<float> takeSource(int channel) { return std::move(source_[channel]); }
+
+private:
+    void render(bool endOfStream);
+
+    std::vector<float> source_[kChannels];  // planar stereo at the source rate; the filter reads across appends
+    Resampler resampler_;
+    std::shared_ptr<PlaybackClip> clip_;
+    PublishFn publish_;
+    int64_t sourceId_ = 0;
+    int maxFrames_ = 0;
+    int prebufferFrames_ = 0;
+    int outFrames_ = 0;   // frames the clip will have at host rate (whole clip buffer when the length is unknown)
+    int outWritten_ = 0;
+    bool unbounded_ = false;
+    bool published_ = false;
+    bool active_ = false;
+    bool truncated_ = false;
+};
+
+} // namespace aceforge
+
+#endif
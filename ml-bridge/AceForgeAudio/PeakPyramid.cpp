@@ -0,0 +1,175 @@
+#include "PeakPyramid.hpp"
+#include "AudioKernels.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace aceforge {
+
+namespace {
+
+constexpr uint8_t kMagic[4] = { 'A', 'F', 'P', 'K' };
+constexpr size_t kHeaderSize = 32;  // magic, version, base frames, levels, frames (u64), rate (f64)
+constexpr int kMaxBaseFrames = 1 << 20;
+constexpr int kMaxLevels = 64;
+constexpr uint64_t kMaxFrames = (uint64_t)1 << 40;
+
+int8_t quantize(float v) {
+    return (int8_t)std::lround(std::min(1.0f, std::max(-1.0f, v)) * 127.0f);
+}
+
+PeakPyramid::Peak merge(PeakPyramid::Peak a, PeakPyramid::Peak b) {
+    return { std::min(a.min, b.min), std::max(a.max, b.max) };
+}
+
+void put32(std::vector<uint8_t>& out, uint32_t v) {
+    const uint8_t b[4] = { (uint8_t)v, (uint8_t)(v >> 8), (uint8_t)(v >> 16), (uint8_t)(v >> 24) };
+    out.insert(out.end(), b, b + 4);
+}
+
+void put64(std::vector<uint8_t>& out, uint64_t v) {
+    put32(out, (uint32_t)v);
+    put32(out, (uint32_t)(v >> 32));
+}
+
+uint32_t get32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+uint64_t get64(const uint8_t* p) {
+    return (uint64_t)get32(p) | ((uint64_t)get32(p + 4) << 32);
+}
+
+} // namespace
+
+PeakPyramid::Builder::Builder(int baseFrames) : baseFrames_(std::max(1, baseFrames)) {}
+
+void PeakPyramid::Builder::add(const float* const* channels, int numChannels, int numFrames) {
+    int pos = 0;
+    while (pos < numFrames) {
+        if (filled_ == 0) {
+            lo_ = std::numeric_limits<float>::max();
+            hi_ = std::numeric_limits<float>::lowest();
+        }
+        const int n = std::min(numFrames - pos, baseFrames_ - filled_);
+        for (int c = 0; c < numChannels; ++c) kernels::minMax(channels[c] + pos, n, lo_, hi_);
+        filled_ += n;
+        pos += n;
+        numFrames_ += n;
+        if (filled_ == baseFrames_) closeBucket();
+    }
+}
+
+void PeakPyramid::Builder::closeBucket() {
+    // No channels (or only NaNs) leave the bucket empty: draw it as silence
+    if (lo_ > hi_) base_.push_back(Peak());
+    else base_.push_back({ quantize(lo_), quantize(hi_) });
+    filled_ = 0;
+}
+
+PeakPyramid PeakPyramid::Builder::finish(double sampleRate) {
+    if (filled_ > 0) closeBucket();
+    PeakPyramid pyramid;
+    pyramid.baseFrames_ = baseFrames_;
+    pyramid.numFrames_ = numFrames_;
+    pyramid.sampleRate_ = sampleRate;
+    if (!base_.empty()) {
+        pyramid.levels_.push_back(std::move(base_));
+        while (pyramid.levels_.back().size() > 1) {
+            const std::vector<Peak>& below = pyramid.levels_.back();
+            std::vector<Peak> up((below.size() + 1) / 2);
+            for (size_t i = 0; i < up.size(); ++i)
+                up[i] = 2 * i + 1 < below.size() ? merge(below[2 * i], below[2 * i + 1]) : below[2 * i];
+            pyramid.levels_.push_back(std::move(up));
+        }
+    }
+    base_.clear();
+    numFrames_ = 0;
+    filled_ = 0;
+    return pyramid;
+}
+
+void PeakPyramid::render(int numColumns, float* mins, float* maxs) const {
+    if (numColumns <= 0) return;
+    if (levels_.empty()) {
+        std::fill(mins, mins + numColumns, 0.0f);
+        std::fill(maxs, maxs + numColumns, 0.0f);
+        return;
+    }
+    // Coarsest level with at least a bucket per column: each column then reduces one or two buckets
+    size_t index = 0;
+    while (index + 1 < levels_.size() && levels_[index + 1].size() >= (size_t)numColumns) ++index;
+    const std::vector<Peak>& peaks = levels_[index];
+    const int64_t n = (int64_t)peaks.size();
+    for (int c = 0; c < numColumns; ++c) {
+        const int64_t first = (int64_t)c * n / numColumns;
+        const int64_t end = std::max(first + 1, (int64_t)(c + 1) * n / numColumns);
+        Peak peak = peaks[(size_t)first];
+        for (int64_t b = first + 1; b < end; ++b) peak = merge(peak, peaks[(size_t)b]);
+        mins[c] = (float)peak.min / 127.0f;
+        maxs[c] = (float)peak.max / 127.0f;
+    }
+}
+
+std::vector<uint8_t> PeakPyramid::serialize() const {
+    size_t bytes = kHeaderSize;
+    for (const auto& peaks : levels_) bytes += 4 + peaks.size() * 2;
+    std::vector<uint8_t> out;
+    out.reserve(bytes);
+    out.insert(out.end(), kMagic, kMagic + 4);
+    put32(out, kFileVersion);
+    put32(out, (uint32_t)baseFrames_);
+    put32(out, (uint32_t)levels_.size());
+    put64(out, (uint64_t)numFrames_);
+    uint64_t rateBits = 0;
+    std::memcpy(&rateBits, &sampleRate_, sizeof(rateBits));
+    put64(out, rateBits);
+    for (const auto& peaks : levels_) {
+        put32(out, (uint32_t)peaks.size());
+        for (const Peak& p : peaks) {
+            out.push_back((uint8_t)p.min);
+            out.push_back((uint8_t)p.max);
+        }
+    }
+    return out;
+}
+
+bool PeakPyramid::parse(const uint8_t* data, size_t size, PeakPyramid& out) {
+    if (size < kHeaderSize || std::memcmp(data, kMagic, 4) != 0 || get32(data + 4) != kFileVersion) return false;
+    const uint32_t baseFrames = get32(data + 8);
+    const uint32_t numLevels = get32(data + 12);
+    const uint64_t numFrames = get64(data + 16);
+    const uint64_t rateBits = get64(data + 24);
+    double sampleRate = 0.0;
+    std::memcpy(&sampleRate, &rateBits, sizeof(sampleRate));
+    if (baseFrames < 1 || baseFrames > (uint32_t)kMaxBaseFrames || numLevels > (uint32_t)kMaxLevels
+        || numFrames > kMaxFrames || !(sampleRate >= 0.0 && sampleRate <= 1.0e7))
+        return false;
+
+    // The shape follows from the header: ceil(frames / base) buckets, halved (rounding up) down to one
+    uint64_t expected = (numFrames + baseFrames - 1) / baseFrames;
+    PeakPyramid pyramid;
+    pyramid.baseFrames_ = (int)baseFrames;
+    pyramid.numFrames_ = (int64_t)numFrames;
+    pyramid.sampleRate_ = sampleRate;
+    size_t pos = kHeaderSize;
+    for (uint32_t l = 0; l < numLevels; ++l) {
+        if (expected == 0 || size - pos < 4 || get32(data + pos) != expected) return false;
+        pos += 4;
+        if ((size - pos) / 2 < expected) return false;
+        std::vector<Peak> peaks((size_t)expected);
+        for (Peak& p : peaks) {
+            p.min = (int8_t)data[pos++];
+            p.max = (int8_t)data[pos++];
+            if (p.min < -127 || p.min > p.max) return false;
+        }
+        pyramid.levels_.push_back(std::move(peaks));
+        expected = expected == 1 ? 0 : (expected + 1) / 2;
+    }
+    if (expected != 0 || pos != size) return false;
+    out = std::move(pyramid);
+    return true;
+}
+
+} // namespace aceforge
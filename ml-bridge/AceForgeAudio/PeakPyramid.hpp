@@ -0,0 +1,79 @@
+/**
+ * Multi-resolution min/max summary of a clip's waveform, for drawing thumbnails without reading its audio.
+ *
+ * Level 0 holds the min and max over all channels of every baseFrames() frames; each level above halves the
+ * resolution (bucket i spans buckets 2i and 2i + 1 of the level below) down to a single bucket. Values are
+ * quantised to 8 bits, so a 30 s stereo clip at 48 kHz takes about 22 kB with every level. render() reads the
+ * coarsest level that still has a bucket per column, so drawing a row costs O(columns) whatever the clip length.
+ *
+ * Builder reduces the audio chunk by chunk with kernels::minMax, so a file can be summarised while it is read.
+ * serialize() and parse() are the on-disk form (the .peaks file the plugin keeps next to a library file): a
+ * little-endian header and the levels. parse() checks every count against the header and the input size.
+ */
+#ifndef ACEFORGE_PEAK_PYRAMID_HPP
+#define ACEFORGE_PEAK_PYRAMID_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace aceforge {
+
+class PeakPyramid {
+public:
+    static constexpr int kBaseFrames = 256;
+    static constexpr uint32_t kFileVersion = 1;
+
+    /** -127..127 for -1..1 (clipped beyond). */
+    struct Peak {
+        int8_t min = 0;
+        int8_t max = 0;
+    };
+
+    class Builder {
+    public:
+        explicit Builder(int baseFrames = kBaseFrames);
+
+        /** The next numFrames frames of numChannels planar channels. Chunks need not line up with buckets. */
+        void add(const float* const* channels, int numChannels, int numFrames);
+        /** Closes the last (partial) bucket and builds the upper levels; the builder starts over afterwards. */
+        PeakPyramid finish(double sampleRate);
+
+    private:
+        void closeBucket();
+
+        int baseFrames_;
+        int filled_ = 0;  // frames in the open bucket
+        float lo_ = 0.0f;
+        float hi_ = 0.0f;
+        int64_t numFrames_ = 0;
+        std::vector<Peak> base_;
+    };
+
+    bool empty() const { return levels_.empty(); }
+    int baseFrames() const { return baseFrames_; }
+    int64_t numFrames() const { return numFrames_; }
+    double sampleRate() const { return sampleRate_; }
+    int numLevels() const { return (int)levels_.size(); }
+    const std::vector<Peak>& level(int index) const { return levels_[(size_t)index]; }
+
+    /**
+     * Min and max (-1..1) of each of numColumns equal slices of the clip into mins[] and maxs[]. Columns finer than
+     * level 0 repeat its buckets; an empty pyramid gives zeros.
+     */
+    void render(int numColumns, float* mins, float* maxs) const;
+
+    std::vector<uint8_t> serialize() const;
+    /** False (out untouched) unless data is exactly one well-formed pyramid. */
+    static bool parse(const uint8_t* data, size_t size, PeakPyramid& out);
+
+private:
+    int baseFrames_ = kBaseFrames;
+    int64_t numFrames_ = 0;
+    double sampleRate_ = 0.0;
+    std::vector<std::vector<Peak>> levels_;  // [0] finest
+};
+
+} // namespace aceforge
+
+#endif
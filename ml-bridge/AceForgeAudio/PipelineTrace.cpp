@@ -0,0 +1,168 @@
+#include "PipelineTrace.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+namespace aceforge {
+
+namespace {
+
+void appendJsonString(std::string& out, const std::string& s) {
+    out += '"';
+    for (char c : s) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if ((unsigned char)c < 0x20) {
+            char esc[8];
+            std::snprintf(esc, sizeof(esc), "\\u%04x", (unsigned)(unsigned char)c);
+            out += esc;
+        } else {
+            out += c;
+        }
+    }
+    out += '"';
+}
+
+void appendDuration(std::string& out, double ms) {
+    char buf[32];
+    if (ms >= 1000.0) std::snprintf(buf, sizeof(buf), "%.1f s", ms / 1000.0);
+    else if (ms >= 10.0) std::snprintf(buf, sizeof(buf), "%.0f ms", ms);
+    else std::snprintf(buf, sizeof(buf), "%.1f ms", ms);
+    out += buf;
+}
+
+} // namespace
+
+const char* stageName(Stage stage) {
+    switch (stage) {
+    case Stage::Cache: return "cache";
+    case Stage::Health: return "health";
+    case Stage::Submit: return "submit";
+    case Stage::Queue: return "queue";
+    case Stage::Inference: return "inference";
+    case Stage::Fetch: return "fetch";
+    case Stage::Decode: return "decode";
+    case Stage::Push: return "push";
+    case Stage::Handoff: return "handoff";
+    }
+    return "";
+}
+
+int64_t traceNowUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+double JobTimeline::ms(Stage stage) const {
+    const Span& s = span(stage);
+    return s.beginUs >= 0 && s.endUs >= 0 ? (double)(s.endUs - s.beginUs) / 1000.0 : 0.0;
+}
+
+std::string JobTimeline::summary() const {
+    std::string out;
+    for (int i = 0; i < kNumStages; ++i) {
+        const Stage stage = (Stage)i;
+        if (!started(stage)) continue;
+        if (!out.empty()) out += " | ";
+        out += stageName(stage);
+        out += ' ';
+        if (finished(stage)) appendDuration(out, ms(stage));
+        else out += "...";
+    }
+    return out;
+}
+
+void PipelineTrace::setLabel(int jobId, const std::string& label) {
+    std::lock_guard<std::mutex> l(lock_);
+    timelineLocked(jobId).label = label;
+}
+
+void PipelineTrace::begin(int jobId, Stage stage, int64_t atUs) {
+    std::lock_guard<std::mutex> l(lock_);
+    JobTimeline::Span& s = timelineLocked(jobId).spans[(int)stage];
+    s.beginUs = atUs;
+    s.endUs = -1;
+}
+
+void PipelineTrace::end(int jobId, Stage stage, int64_t atUs) {
+    std::lock_guard<std::mutex> l(lock_);
+    JobTimeline::Span& s = timelineLocked(jobId).spans[(int)stage];
+    if (s.beginUs >= 0 && s.endUs < 0) s.endUs = std::max(atUs, s.beginUs);
+}
+
+void PipelineTrace::record(int jobId, Stage stage, int64_t beginUs, int64_t endUs) {
+    std::lock_guard<std::mutex> l(lock_);
+    JobTimeline::Span& s = timelineLocked(jobId).spans[(int)stage];
+    s.beginUs = beginUs;
+    s.endUs = std::max(endUs, beginUs);
+}
+
+bool PipelineTrace::get(int jobId, JobTimeline& out) const {
+    std::lock_guard<std::mutex> l(lock_);
+    for (const JobTimeline& t : jobs_) {
+        if (t.jobId == jobId) {
+            out = t;
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<JobTimeline> PipelineTrace::jobs() const {
+    std::lock_guard<std::mutex> l(lock_);
+    return std::vector<JobTimeline>(jobs_.begin(), jobs_.end());
+}
+
+void PipelineTrace::clear() {
+    std::lock_guard<std::mutex> l(lock_);
+    jobs_.clear();
+}
+
+JobTimeline& PipelineTrace::timelineLocked(int jobId) {
+    // Stamps almost always go to one of the newest jobs: search from the back
+    for (auto it = jobs_.rbegin(); it != jobs_.rend(); ++it)
+        if (it->jobId == jobId) return *it;
+    if (jobs_.size() >= kMaxJobs) jobs_.pop_front();
+    jobs_.emplace_back();
+    jobs_.back().jobId = jobId;
+    return jobs_.back();
+}
+
+std::string PipelineTrace::chromeTraceJson() const {
+    const std::vector<JobTimeline> timelines = jobs();
+    std::string out = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    out += "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"AceForge Bridge\"}}";
+    char buf[160];
+    for (const JobTimeline& t : timelines) {
+        std::snprintf(buf, sizeof(buf), ",{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":",
+                      t.jobId);
+        out += buf;
+        appendJsonString(out, "job " + std::to_string(t.jobId) + (t.label.empty() ? "" : ": " + t.label));
+        std::snprintf(buf, sizeof(buf), "}},{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,"
+                                         "\"args\":{\"sort_index\":%d}}", t.jobId, t.jobId);
+        out += buf;
+        for (int i = 0; i < kNumStages; ++i) {
+            const JobTimeline::Span& s = t.spans[i];
+            if (s.beginUs < 0 || s.endUs < 0) continue;
+            std::snprintf(buf, sizeof(buf),
+                          ",{\"name\":\"%s\",\"cat\":\"generation\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%lld,"
+                          "\"dur\":%lld,\"args\":{\"ms\":%.3f}}",
+                          stageName((Stage)i), t.jobId, (long long)(s.beginUs - originUs_),
+                          (long long)(s.endUs - s.beginUs), t.ms((Stage)i));
+            out += buf;
+        }
+    }
+    out += "]}\n";
+    return out;
+}
+
+bool PipelineTrace::writeChromeTrace(const std::string& path) const {
+    const std::string json = chromeTraceJson();
+    FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) return false;
+    const bool ok = std::fwrite(json.data(), 1, json.size(), f) == json.size();
+    return std::fclose(f) == 0 && ok;
+}
+
+} // namespace aceforge
@@ -0,0 +1,94 @@
+/**
+ * Per-job stage timing for the generation pipeline, exportable as Chrome trace-event JSON.
+ *
+ * Each job gets a JobTimeline: one begin/end pair per Stage, stamped with traceNowUs() (steady clock, so the audio
+ * thread's PlaybackCore::lastAcquiredUs() is on the same timebase). Stages are recorded from whichever thread runs
+ * them (generation worker, decode worker, message thread) and may be left open when a job fails or is cancelled.
+ * summary() gives a one-line breakdown for the UI; chromeTraceJson() lays the jobs out one per row (tid = job id)
+ * for chrome://tracing or Perfetto, so a session's jobs can be compared stage by stage.
+ *
+ * All methods are thread-safe (one mutex; a few stamps per job, never on the audio thread).
+ */
+#ifndef ACEFORGE_PIPELINE_TRACE_HPP
+#define ACEFORGE_PIPELINE_TRACE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace aceforge {
+
+/** Pipeline stages of one generation, in pipeline order. */
+enum class Stage : uint8_t {
+    Cache,      // generation cache lookup
+    Health,     // healthCheck
+    Submit,     // startGeneration (POST /api/generate)
+    Queue,      // accepted until the server reports "running"
+    Inference,  // "running" until the job finished
+    Fetch,      // audio download (streamed decode runs inside it)
+    Decode,     // WAV decode (+ resample); for a streamed download, the decoder's share of Fetch
+    Push,       // pushSamplesToPlayback after a full decode
+    Handoff,    // clip published until the audio thread picked it up
+};
+constexpr int kNumStages = 9;
+
+/** "cache", "health", "submit", "queue", "inference", "fetch", "decode", "push" or "handoff". */
+const char* stageName(Stage stage);
+
+/** Monotonic microseconds, the timebase of every timestamp here. */
+int64_t traceNowUs();
+
+struct JobTimeline {
+    struct Span {
+        int64_t beginUs = -1;
+        int64_t endUs = -1;  // -1 while the stage is still open
+    };
+
+    int jobId = 0;
+    std::string label;
+    Span spans[kNumStages];
+
+    const Span& span(Stage stage) const { return spans[(int)stage]; }
+    bool started(Stage stage) const { return span(stage).beginUs >= 0; }
+    bool finished(Stage stage) const { return span(stage).endUs >= 0; }
+    /** Duration in ms of a finished stage, else 0. */
+    double ms(Stage stage) const;
+    /** Finished stages in pipeline order, e.g. "health 2 ms | submit 4 ms | queue 1.2 s | ..."; an open one ends with "...". */
+    std::string summary() const;
+};
+
+class PipelineTrace {
+public:
+    static constexpr size_t kMaxJobs = 256;  // oldest timelines are dropped beyond this
+
+    void setLabel(int jobId, const std::string& label);
+    /** Opens stage (again, when it was already recorded: the latest run wins). */
+    void begin(int jobId, Stage stage, int64_t atUs = traceNowUs());
+    /** Closes stage; ignored when it was never opened or is already closed. */
+    void end(int jobId, Stage stage, int64_t atUs = traceNowUs());
+    /** Records a finished stage in one call (durations measured elsewhere). */
+    void record(int jobId, Stage stage, int64_t beginUs, int64_t endUs);
+
+    bool get(int jobId, JobTimeline& out) const;
+    std::vector<JobTimeline> jobs() const;  // oldest first
+    void clear();
+
+    /** {"traceEvents": [...]}: one complete ("X") event per finished stage, one row per job named by its label. */
+    std::string chromeTraceJson() const;
+    /** Writes chromeTraceJson() to path; false when the file cannot be written. */
+    bool writeChromeTrace(const std::string& path) const;
+
+private:
+    JobTimeline& timelineLocked(int jobId);
+
+    mutable std::mutex lock_;
+    std::deque<JobTimeline> jobs_;
+    const int64_t originUs_ = traceNowUs();  // trace timestamps are relative to this
+};
+
+} // namespace aceforge
+
+#endif
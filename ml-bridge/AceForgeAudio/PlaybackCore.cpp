@@ -0,0 +1,101 @@
+#include "PlaybackCore.hpp"
+#include "AudioKernels.hpp"
+#include "PipelineTrace.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace aceforge {
+
+void PlaybackCore::prepare(double sampleRate) {
+    sampleRate_ = sampleRate;
+    nsPerFrame_ = sampleRate > 0.0 ? 1.0e9 / sampleRate : 0.0;
+    engine_.prepare(sampleRate);
+}
+
+int64_t framesToNextBar(const HostTransport& transport, double sampleRate) {
+    if (!(transport.bpm > 0.0) || !(sampleRate > 0.0) || transport.numerator <= 0 || transport.denominator <= 0)
+        return -1;
+    const double barLength = 4.0 * transport.numerator / transport.denominator;  // in quarter notes
+    double intoBar = transport.ppqPosition - transport.barStartPpq;
+    // Some hosts report no (or a stale) bar start: count bars from the start of the timeline then
+    if (!(intoBar >= 0.0 && intoBar < barLength)) {
+        intoBar = std::fmod(transport.ppqPosition, barLength);
+        if (intoBar < 0.0) intoBar += barLength;
+    }
+    if (intoBar < 1.0e-6) return 0;
+    return std::llround((barLength - intoBar) * 60.0 / transport.bpm * sampleRate);
+}
+
+void PlaybackCore::process(float* const* out, int numChannels, int numFrames, const HostTransport* transport) {
+    const int64_t start = RealtimeStats::nowNs();
+    const int64_t budget = (int64_t)(numFrames * nsPerFrame_);
+    if (numChannels < 2 || numChannels > kMaxChannels) {
+        for (int c = 0; c < numChannels; ++c) kernels::clear(out[c], numFrames);
+        stats_.recordBlock(RealtimeStats::nowNs() - start, budget, numFrames);
+        return;
+    }
+    const bool running = transport != nullptr && transport->playing;
+    if (transport != nullptr && transport->bpm > 0.0) hostBpm_.store(transport->bpm, std::memory_order_relaxed);
+
+    // Switch to the clip the writer just published (one pointer exchange); the engine fades out whatever is
+    // still playing first
+    const PlaybackClip* clip = handoff_.acquire();
+    if (clip != nullptr) {
+        // A clock read (vDSO / mach_absolute_time) and two stores, only on the block that picks up a clip
+        acquiredUs_.store(traceNowUs(), std::memory_order_relaxed);
+        acquiredSource_.store(clip->sourceId, std::memory_order_release);
+        stats_.recordHandoff(clip->isRerender);
+        if (clip->isRerender) {
+            // Same audio at a new host rate or tempo, same point in the source; one still waiting just swaps
+            if (waiting_ != nullptr && waiting_->sourceId == clip->sourceId) waiting_ = clip;
+            else engine_.replace(clip);
+        } else if (clip->startOnBar && running && framesToNextBar(*transport, sampleRate_) > 0) {
+            waiting_ = clip;
+        } else {
+            waiting_ = nullptr;
+            engine_.play(clip);
+        }
+    }
+
+    // A waiting clip starts in the block holding its bar line, less the playing clip's fade-out so that its first
+    // frame lands on the bar (a bar closer than a full fade gets a shorter one); when the transport stops it starts
+    // right away
+    int split = -1;
+    int fadeOut = -1;
+    if (waiting_ != nullptr) {
+        const int64_t toBar = running ? framesToNextBar(*transport, sampleRate_) : -1;
+        fadeOut = toBar < 0 || !engine_.audible() ? 0 : (int)std::min<int64_t>(engine_.fadeFrames(), toBar);
+        const int64_t at = toBar < 0 ? 0 : toBar - fadeOut;
+        if (at < numFrames) split = (int)at;
+    }
+
+    // Bulk copy of the frames published so far (a streamed clip keeps growing while it plays); silence after that
+    bool starved = false;
+    if (split < 0) {
+        engine_.render(out, numChannels, numFrames);
+        starved = engine_.starved();
+    } else {
+        if (split > 0) {
+            engine_.render(out, numChannels, split);
+            starved = engine_.starved();
+        }
+        engine_.play(waiting_, fadeOut);
+        waiting_ = nullptr;
+        float* rest[kMaxChannels];
+        for (int c = 0; c < numChannels; ++c) rest[c] = out[c] + split;
+        engine_.render(rest, numChannels, numFrames - split);
+        starved = starved || engine_.starved();
+    }
+    waitingForBar_.store(waiting_ != nullptr, std::memory_order_relaxed);
+    position_.store(engine_.position(), std::memory_order_relaxed);
+    if (starved) stats_.recordUnderrun();
+
+    // Clips the engine has finished with go back to handoff_.reclaim() (never freed here)
+    handoff_.releaseUnused(engine_.clip(), engine_.pendingClip(), waiting_);
+
+    const int64_t elapsed = RealtimeStats::nowNs() - start;
+    stats_.recordBlock(elapsed, budget, numFrames);
+    if (clip != nullptr) stats_.recordHandoffBlock(elapsed);
+}
+
+} // namespace aceforge
@@ -0,0 +1,93 @@
+/**
+ * The plugin's realtime path without the plugin: a ClipHandoff feeding a PlaybackEngine.
+ *
+ * process() is what AceForgeBridgeAudioProcessor::processBlock does for one host block: pick up a newly
+ * published clip (a re-render at a new host rate or tempo replaces the playing clip in place, anything else
+ * starts from its first frame), render it into the output channels and hand clips the engine has finished with
+ * back to the handoff. Producers (ClipWriter, disk streaming, re-renders) create and publish clips through
+ * handoff() and call handoff().reclaim() from a non-realtime thread.
+ *
+ * With the host's transport (HostTransport, read from the play head), a clip marked startOnBar waits for the
+ * next bar line while the transport runs: the previous clip keeps playing, its fade-out starts early enough that
+ * the new clip's first frame lands on the bar (and is shortened when the bar is nearer than a whole fade), and a
+ * block that contains the bar line is rendered in two parts.
+ * The tempo the host last reported is kept for the non-realtime side (hostBpm()), which conforms clips to it.
+ *
+ * process() must only be called from the audio thread; position(), stats() and the lastAcquired*() stamps (when
+ * the audio thread first picked up a clip, for PipelineTrace's handoff stage) may be read from any thread.
+ * Every block is timed against its budget into stats() (two clock reads per block), with underruns and handoffs.
+ */
+#ifndef ACEFORGE_PLAYBACK_CORE_HPP
+#define ACEFORGE_PLAYBACK_CORE_HPP
+
+#include "ClipHandoff.hpp"
+#include "PlaybackEngine.hpp"
+#include "RealtimeStats.hpp"
+#include <atomic>
+#include <cstdint>
+
+namespace aceforge {
+
+/** The host's transport at the first frame of a block (AudioPlayHead::PositionInfo, without JUCE). */
+struct HostTransport {
+    bool playing = false;
+    double bpm = 0.0;          // 0 when the host does not say
+    double ppqPosition = 0.0;  // quarter notes since the start of the timeline
+    double barStartPpq = 0.0;  // ppqPosition of the bar containing it
+    int numerator = 4;         // time signature
+    int denominator = 4;
+};
+
+/** Frames from the transport position until the next bar line at sampleRate (0 on a bar line, -1 without a tempo). */
+int64_t framesToNextBar(const HostTransport& transport, double sampleRate);
+
+class PlaybackCore {
+public:
+    PlaybackCore() = default;
+    PlaybackCore(const PlaybackCore&) = delete;
+    PlaybackCore& operator=(const PlaybackCore&) = delete;
+
+    /** Host rate for fades; call before the first process() at that rate (not concurrently with it). */
+    void prepare(double sampleRate);
+
+    /**
+     * Fills out[0..numChannels) with numFrames of playback. Fewer than two output channels (or more than
+     * kMaxChannels) get silence, like the plugin's stereo-only bus layout. transport (may be null) times clips that
+     * start on a bar. Wait-free: no locks, no allocation.
+     */
+    void process(float* const* out, int numChannels, int numFrames, const HostTransport* transport = nullptr);
+
+    ClipHandoff& handoff() { return handoff_; }
+    /** Engine read position after the last block (relaxed; for handovers to disk streaming and re-renders). */
+    int64_t position() const { return position_.load(std::memory_order_relaxed); }
+    /** sourceId of the clip process() last picked up (0 before the first), and when, in traceNowUs() time. */
+    int64_t lastAcquiredSource() const { return acquiredSource_.load(std::memory_order_acquire); }
+    int64_t lastAcquiredUs() const { return acquiredUs_.load(std::memory_order_relaxed); }
+    double sampleRate() const { return sampleRate_; }
+    /** Tempo from the last block's transport (0 before the host reported one). */
+    double hostBpm() const { return hostBpm_.load(std::memory_order_relaxed); }
+    /** A clip is waiting for the next bar line. */
+    bool waitingForBar() const { return waitingForBar_.load(std::memory_order_relaxed); }
+    /** Block timing, underrun and handoff counters; snapshot from any thread. */
+    RealtimeStats& stats() { return stats_; }
+    const RealtimeStats& stats() const { return stats_; }
+
+private:
+    static constexpr int kMaxChannels = 8;
+
+    ClipHandoff handoff_;
+    PlaybackEngine engine_;
+    std::atomic<int64_t> position_{ 0 };
+    std::atomic<int64_t> acquiredSource_{ 0 };
+    std::atomic<int64_t> acquiredUs_{ 0 };
+    RealtimeStats stats_;
+    std::atomic<double> hostBpm_{ 0.0 };
+    std::atomic<bool> waitingForBar_{ false };
+    const PlaybackClip* waiting_ = nullptr;  // audio thread: acquired, held back until the next bar line
+    double sampleRate_ = 0.0;
+    double nsPerFrame_ = 0.0;  // block budget per frame at sampleRate_
+};
+
+} // namespace aceforge
+
+#endif
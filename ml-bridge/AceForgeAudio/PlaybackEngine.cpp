@@ -0,0 +1,150 @@
+#include "PlaybackEngine.hpp"
+#include "AudioKernels.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace aceforge {
+
+void PlanarBuffer::allocate(int numChannels, int numFrames) {
+    channels_ = std::max(0, numChannels);
+    frames_ = std::max(0, numFrames);
+    // Round each channel up to 16 floats so every channel starts on the same 64-byte phase as the first
+    stride_ = ((size_t)frames_ + 15u) & ~(size_t)15u;
+    data_.assign(stride_ * (size_t)channels_, 0.0f);
+}
+
+void PlaybackEngine::prepare(double sampleRate, double fadeMs) {
+    fadeFrames_ = sampleRate > 0.0 ? std::max(0, (int)std::lround(sampleRate * fadeMs / 1000.0)) : 0;
+}
+
+void PlaybackEngine::play(const PlaybackClip* clip, int fadeOutFrames) {
+    if (!audible()) {
+        pending_ = clip;
+        switchToPending();
+        return;
+    }
+    pending_ = clip;
+    const int fade = fadeOutFrames < 0 ? fadeFrames_ : std::min(fadeOutFrames, fadeFrames_);
+    // A fade-out already under way is cut short too when it would run past the requested length
+    if (!switching_ || rampFramesLeft_ > fade) {
+        switching_ = true;
+        ending_ = false;
+        startRamp(0.0f, fade);
+    }
+}
+
+void PlaybackEngine::replace(const PlaybackClip* clip) {
+    if (clip == nullptr || clip->sourceId == 0) return;
+    if (pending_ != nullptr && pending_->sourceId == clip->sourceId) {
+        pending_ = clip;  // not started yet: it will start from the top either way
+        return;
+    }
+    if (clip_ == nullptr || switching_ || clip_->sourceId != clip->sourceId) return;
+    pending_ = clip;
+    switching_ = true;
+    ending_ = false;
+    startRamp(0.0f, fadeFrames_);
+}
+
+void PlaybackEngine::stop() {
+    if (clip_ == nullptr) return;
+    play(nullptr);
+}
+
+void PlaybackEngine::setGain(float gain) {
+    userGain_ = gain;
+    if (clip_ != nullptr && !switching_ && !ending_) startRamp(gain, fadeFrames_);
+}
+
+void PlaybackEngine::startRamp(float target, int frames) {
+    targetGain_ = target;
+    if (frames <= 0 || target == gain_) {
+        gain_ = target;
+        gainStep_ = 0.0f;
+        rampFramesLeft_ = 0;
+        return;
+    }
+    rampFramesLeft_ = frames;
+    gainStep_ = (target - gain_) / (float)frames;
+}
+
+void PlaybackEngine::switchToPending() {
+    // A re-render of the same source continues where the old clip was, in the new clip's frames (rate and tempo)
+    int64_t start = 0;
+    if (pending_ != nullptr && clip_ != nullptr && pending_->sourceId != 0 && pending_->sourceId == clip_->sourceId
+        && clip_->sampleRate > 0.0 && pending_->sampleRate > 0.0)
+        start = std::llround((double)position_ * (pending_->sampleRate * pending_->stretch)
+                             / (clip_->sampleRate * clip_->stretch));
+    // Nothing was written before the frame the producer started at
+    if (pending_ != nullptr) start = std::max(start, pending_->firstFrame);
+    clip_ = pending_;
+    pending_ = nullptr;
+    switching_ = false;
+    ending_ = false;
+    position_ = start;
+    gain_ = 0.0f;
+    if (clip_ != nullptr) startRamp(userGain_, fadeFrames_);
+    else rampFramesLeft_ = 0;
+}
+
+int PlaybackEngine::render(float* const* out, int numOutChannels, int numFrames) {
+    int written = 0;
+    starved_ = false;
+    while (written < numFrames && clip_ != nullptr) {
+        if (switching_ && rampFramesLeft_ == 0) {
+            switchToPending();
+            continue;
+        }
+        const int capacity = clip_->audio.numFrames();
+        int64_t ready = clip_->readyFrames.load(std::memory_order_acquire);
+        if (!clip_->isRing) ready = std::min<int64_t>(ready, capacity);
+        // The last fadeFrames of a complete clip fade out (or the rest of its fade-in turns around), ending on silence
+        const bool toEnd = !switching_ && !ending_ && clip_->complete.load(std::memory_order_acquire);
+        if (toEnd && ready - position_ <= fadeFrames_ && ready > position_) {
+            ending_ = true;
+            startRamp(0.0f, (int)(ready - position_));
+        }
+        int n = (int)std::min<int64_t>(numFrames - written, ready - position_);
+        if (toEnd && !ending_) n = (int)std::min<int64_t>(n, ready - fadeFrames_ - position_);  // up to the end fade
+        if (n <= 0) {
+            // Nothing left to fade out: switch right away. Otherwise wait for more frames (or the next play())
+            if (switching_) {
+                switchToPending();
+                continue;
+            }
+            starved_ = !clip_->complete.load(std::memory_order_acquire);
+            break;
+        }
+        if (rampFramesLeft_ > 0) n = std::min(n, rampFramesLeft_);
+        const int64_t clipFrame = clip_->isRing ? position_ % capacity : position_;
+        if (clip_->isRing) n = std::min(n, (int)(capacity - clipFrame));  // up to the wrap
+        renderSegment(out, numOutChannels, written, clipFrame, n);
+        position_ += n;
+        written += n;
+        if (rampFramesLeft_ > 0) {
+            rampFramesLeft_ -= n;
+            gain_ = rampFramesLeft_ == 0 ? targetGain_ : gain_ + gainStep_ * (float)n;
+        }
+    }
+    // Hand the space behind the read position back to a ring clip's producer
+    if (clip_ != nullptr && clip_->isRing) clip_->consumedFrames.store(position_, std::memory_order_release);
+    for (int c = 0; c < numOutChannels; ++c)
+        kernels::clear(out[c] + written, numFrames - written);
+    return written;
+}
+
+void PlaybackEngine::renderSegment(float* const* out, int numOutChannels, int offset, int64_t clipFrame,
+                                   int numFrames) {
+    const PlanarBuffer& audio = clip_->audio;
+    const int lastChannel = audio.numChannels() - 1;
+    for (int c = 0; c < numOutChannels; ++c) {
+        const float* src = audio.channel(std::min(c, lastChannel)) + clipFrame;
+        float* dst = out[c] + offset;
+        if (rampFramesLeft_ > 0) kernels::copyWithRamp(dst, src, numFrames, gain_, gainStep_);
+        else if (gain_ == 1.0f) kernels::copy(dst, src, numFrames);
+        else if (gain_ == 0.0f) kernels::clear(dst, numFrames);
+        else kernels::copyWithGain(dst, src, numFrames, gain_);
+    }
+}
+
+} // namespace aceforge
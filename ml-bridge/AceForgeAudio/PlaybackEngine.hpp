@@ -0,0 +1,138 @@
+/**
+ * Planar clip playback for the audio thread.
+ *
+ * A PlaybackClip holds one contiguous float array per channel plus the number of frames that are ready to
+ * play (it grows while a clip streams in). PlaybackEngine renders a clip into the host's output channels
+ * with bulk copies and clears (AudioKernels): at unity gain a block is one memcpy per channel, gain changes
+ * and clip starts/stops are short linear ramps applied in the same pass, and whatever the clip cannot fill
+ * is cleared in one call. Switching clips fades the old one out before the new one fades in, and a complete clip
+ * fades out over its last frames, so it never ends mid-waveform.
+ *
+ * A ring clip (disk streaming) is a fixed-size window onto an arbitrarily long stream: frame f lives at
+ * f % numFrames(), the producer writes ahead of the engine and the engine reports how far it has read, so the
+ * producer never overwrites frames that have not been played.
+ *
+ * PlaybackEngine is audio-thread only (no locks, no allocation after prepare()).
+ */
+#ifndef ACEFORGE_PLAYBACK_ENGINE_HPP
+#define ACEFORGE_PLAYBACK_ENGINE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace aceforge {
+
+/** Planar float audio in a single allocation: channel c starts at c * stride. Contents start zeroed. */
+class PlanarBuffer {
+public:
+    void allocate(int numChannels, int numFrames);
+
+    int numChannels() const { return channels_; }
+    int numFrames() const { return frames_; }
+    float* channel(int c) { return data_.data() + (size_t)c * stride_; }
+    const float* channel(int c) const { return data_.data() + (size_t)c * stride_; }
+
+private:
+    std::vector<float> data_;
+    size_t stride_ = 0;
+    int channels_ = 0;
+    int frames_ = 0;
+};
+
+struct PlaybackClip {
+    PlanarBuffer audio;
+    /** Frames of audio ready to play. Producer stores with release after writing them; the engine loads with acquire. */
+    std::atomic<int64_t> readyFrames{ 0 };
+    /**
+     * Set (release) once readyFrames will not grow any more. Running out of frames before that is an underrun
+     * (the producer fell behind); after it, the clip has simply ended.
+     */
+    std::atomic<bool> complete{ false };
+    /** Rate the audio was rendered at, and the source it was rendered from (0 = unknown). */
+    double sampleRate = 0.0;
+    int64_t sourceId = 0;
+    /** Clip length / source length after tempo conforming (TimeStretch); 1 when played at the source tempo. */
+    double stretch = 1.0;
+    /**
+     * A re-render of the same source at another rate or tempo: replaces the playing clip instead of starting over,
+     * at the same point in the source.
+     */
+    bool isRerender = false;
+    /** Hold the clip until the host's next bar line (PlaybackCore); ignored while the transport is stopped. */
+    bool startOnBar = false;
+
+    /**
+     * Frames before firstFrame were never written: a ring clip's stream, or a re-render, starts there. Ring clips:
+     * frame positions are absolute and frame f is stored at f % audio.numFrames(); readyFrames is the end of what
+     * has been written and consumedFrames (stored by the engine with release) is how far it has been read, so the
+     * producer may write up to consumedFrames + audio.numFrames().
+     */
+    bool isRing = false;
+    int64_t firstFrame = 0;
+    mutable std::atomic<int64_t> consumedFrames{ 0 };
+};
+
+class PlaybackEngine {
+public:
+    /** Sets the fade length used for clip starts/stops and gain changes (default 5 ms). */
+    void prepare(double sampleRate, double fadeMs = 5.0);
+
+    /**
+     * Starts clip from its first frame. A clip that is still audible fades out first, over fadeOutFrames when that
+     * is shorter than fadeFrames() (e.g. to have the new clip start on a bar line) and over fadeFrames() otherwise.
+     */
+    void play(const PlaybackClip* clip, int fadeOutFrames = -1);
+    /**
+     * Swaps in clip for the playing (or about to play) clip with the same sourceId, continuing at the same point
+     * in the source (position scaled by the ratio of sampleRate * stretch). Ignored when that source is no longer
+     * playing.
+     */
+    void replace(const PlaybackClip* clip);
+    /** Fades out and stops. */
+    void stop();
+    /** Output gain (linear); changes ramp over the fade length. */
+    void setGain(float gain);
+
+    /**
+     * Renders numFrames into out[0..numOutChannels). Output channels beyond the clip's channel count repeat its
+     * last channel. Frames the clip cannot supply (not streamed in yet, or past its end) are silence.
+     * Returns the number of clip frames rendered.
+     */
+    int render(float* const* out, int numOutChannels, int numFrames);
+    /** The last render() ran out of frames of a clip that is not complete yet (silence mid-clip). */
+    bool starved() const { return starved_; }
+
+    const PlaybackClip* clip() const { return clip_; }
+    /** A clip is playing and not yet faded to silence, so play() would fade it out before switching. */
+    bool audible() const { return clip_ != nullptr && (gain_ > 0.0f || rampFramesLeft_ > 0); }
+    /** Clip waiting for the current one to fade out, if any. */
+    const PlaybackClip* pendingClip() const { return pending_; }
+    /** Read position in the current clip, in frames. */
+    int64_t position() const { return position_; }
+    /** Length of clip start/stop fades, in frames. */
+    int fadeFrames() const { return fadeFrames_; }
+
+private:
+    void startRamp(float target, int frames);
+    void switchToPending();
+    void renderSegment(float* const* out, int numOutChannels, int offset, int64_t clipFrame, int numFrames);
+
+    const PlaybackClip* clip_ = nullptr;
+    const PlaybackClip* pending_ = nullptr;  // clip to start once the current one has faded out
+    bool switching_ = false;                 // current ramp fades out for a stop or clip switch
+    bool ending_ = false;                    // current ramp fades out the last frames of a complete clip
+    int64_t position_ = 0;
+    int fadeFrames_ = 220;
+    float userGain_ = 1.0f;
+    float gain_ = 0.0f;                      // gain at the next frame
+    float targetGain_ = 0.0f;
+    float gainStep_ = 0.0f;
+    int rampFramesLeft_ = 0;
+    bool starved_ = false;
+};
+
+} // namespace aceforge
+
+#endif
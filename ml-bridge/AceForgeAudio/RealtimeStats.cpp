@@ -0,0 +1,95 @@
+#include "RealtimeStats.hpp"
+#include <chrono>
+
+namespace aceforge {
+
+namespace {
+
+// Block time as a share of the budget, in permille: typical blocks sit in the first few buckets, so they are finer
+constexpr int kBucketLimits[RealtimeStats::kNumBuckets - 1] = { 10, 20, 50, 100, 200, 500, 750, 1000, 2000 };
+
+} // namespace
+
+int RealtimeStats::bucketLimitPermille(int bucket) {
+    return bucket >= 0 && bucket < kNumBuckets - 1 ? kBucketLimits[bucket] : -1;
+}
+
+int64_t RealtimeStats::nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+void RealtimeStats::recordBlock(int64_t elapsedNs, int64_t budgetNs, int numFrames) {
+    bump(blocks_);
+    bump(frames_, numFrames);
+    bump(busyNs_, elapsedNs);
+    lastBlockNs_.store(elapsedNs, std::memory_order_relaxed);
+    raise(peakBlockNs_, elapsedNs);
+    if (budgetNs <= 0) return;
+    bump(budgetNs_, budgetNs);
+    const int64_t permille = elapsedNs * 1000 / budgetNs;
+    raise(peakLoadPermille_, permille);
+    if (elapsedNs > budgetNs) bump(overruns_);
+    int bucket = 0;
+    while (bucket < kNumBuckets - 1 && permille > kBucketLimits[bucket]) ++bucket;
+    bump(histogram_[bucket]);
+}
+
+void RealtimeStats::recordHandoff(bool rerender) {
+    bump(handoffs_);
+    if (rerender) bump(rerenders_);
+}
+
+void RealtimeStats::recordHandoffBlock(int64_t elapsedNs) {
+    raise(peakHandoffBlockNs_, elapsedNs);
+}
+
+void RealtimeStats::recordUnderrun() {
+    bump(underruns_);
+}
+
+RealtimeStats::Snapshot RealtimeStats::snapshot() const {
+    Snapshot s;
+    s.blocks = blocks_.load(std::memory_order_relaxed);
+    s.frames = frames_.load(std::memory_order_relaxed);
+    s.busyNs = busyNs_.load(std::memory_order_relaxed);
+    s.budgetNs = budgetNs_.load(std::memory_order_relaxed);
+    s.lastBlockNs = lastBlockNs_.load(std::memory_order_relaxed);
+    s.peakBlockNs = peakBlockNs_.load(std::memory_order_relaxed);
+    s.peakLoadPermille = (int)peakLoadPermille_.load(std::memory_order_relaxed);
+    s.overruns = overruns_.load(std::memory_order_relaxed);
+    s.underruns = underruns_.load(std::memory_order_relaxed);
+    s.handoffs = handoffs_.load(std::memory_order_relaxed);
+    s.rerenders = rerenders_.load(std::memory_order_relaxed);
+    s.peakHandoffBlockNs = peakHandoffBlockNs_.load(std::memory_order_relaxed);
+    for (int i = 0; i < kNumBuckets; ++i) s.histogram[i] = histogram_[i].load(std::memory_order_relaxed);
+    return s;
+}
+
+RealtimeStats::Snapshot RealtimeStats::takePeak() {
+    Snapshot s = snapshot();
+    s.peakBlockNs = peakBlockNs_.exchange(0, std::memory_order_relaxed);
+    s.peakLoadPermille = (int)peakLoadPermille_.exchange(0, std::memory_order_relaxed);
+    s.peakHandoffBlockNs = peakHandoffBlockNs_.exchange(0, std::memory_order_relaxed);
+    return s;
+}
+
+double RealtimeStats::Snapshot::meanLoadPercent() const {
+    return budgetNs > 0 ? 100.0 * (double)busyNs / (double)budgetNs : 0.0;
+}
+
+RealtimeStats::Snapshot RealtimeStats::Snapshot::since(const Snapshot& earlier) const {
+    Snapshot d = *this;
+    d.blocks -= earlier.blocks;
+    d.frames -= earlier.frames;
+    d.busyNs -= earlier.busyNs;
+    d.budgetNs -= earlier.budgetNs;
+    d.overruns -= earlier.overruns;
+    d.underruns -= earlier.underruns;
+    d.handoffs -= earlier.handoffs;
+    d.rerenders -= earlier.rerenders;
+    for (int i = 0; i < kNumBuckets; ++i) d.histogram[i] -= earlier.histogram[i];
+    return d;
+}
+
+} // namespace aceforge
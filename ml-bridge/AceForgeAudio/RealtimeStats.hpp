@@ -0,0 +1,103 @@
+/**
+ * Audio-thread performance counters: what each process() block cost against its deadline, and how often playback
+ * misbehaved.
+ *
+ * The audio thread is the only writer. It times each block (steady clock, wall time, so preemption shows up as
+ * it would in the host) and records it against the block's budget (numFrames / sampleRate). Every counter is a
+ * lock-free atomic that only the audio thread stores to, so recording is a handful of relaxed loads and stores:
+ * no locks, no read-modify-write instructions, no allocation. Any other thread may take a snapshot() at any time
+ * for the editor or the log. A snapshot is not one consistent instant (counters are read one by one), which is
+ * fine for counts that only grow.
+ *
+ * - Load histogram: block time as a share of the budget, in kNumBuckets log-spaced buckets (bucketLimitPermille).
+ * - Overruns: blocks that took longer than their budget (the host would have glitched had it been that slow).
+ * - Underruns: blocks in which a clip still being written (streamed download, disk ring) ran out of frames, so
+ *   the engine played silence mid-clip.
+ * - Handoffs: clips picked up from ClipHandoff, and the slowest block that picked one up (a clip switch is the
+ *   one time the audio thread does more than copy frames).
+ */
+#ifndef ACEFORGE_REALTIME_STATS_HPP
+#define ACEFORGE_REALTIME_STATS_HPP
+
+#include <atomic>
+#include <cstdint>
+
+namespace aceforge {
+
+class RealtimeStats {
+public:
+    /** Histogram buckets: bucket i holds blocks up to bucketLimitPermille(i) of their budget; the last is open. */
+    static constexpr int kNumBuckets = 10;
+    static int bucketLimitPermille(int bucket);
+
+    struct Snapshot {
+        int64_t blocks = 0;
+        int64_t frames = 0;
+        int64_t busyNs = 0;            // sum of block times
+        int64_t budgetNs = 0;          // sum of block budgets
+        int64_t lastBlockNs = 0;
+        int64_t peakBlockNs = 0;       // slowest block since the last takePeak() (or ever)
+        int peakLoadPermille = 0;      // highest block load since the last takePeak()
+        int64_t overruns = 0;
+        int64_t underruns = 0;
+        int64_t handoffs = 0;          // clips picked up (new clips and re-renders)
+        int64_t rerenders = 0;         // of those, re-renders at a new host rate
+        int64_t peakHandoffBlockNs = 0;
+        int64_t histogram[kNumBuckets] = {};
+
+        /** Mean block time over mean budget, in percent (0 before the first block). */
+        double meanLoadPercent() const;
+        /** Counters accumulated since earlier (a snapshot of the same stats); peaks are kept as they are. */
+        Snapshot since(const Snapshot& earlier) const;
+    };
+
+    RealtimeStats() = default;
+    RealtimeStats(const RealtimeStats&) = delete;
+    RealtimeStats& operator=(const RealtimeStats&) = delete;
+
+    /** Monotonic nanoseconds for timing blocks. */
+    static int64_t nowNs();
+
+    // Audio thread only
+    /** One block of numFrames that took elapsedNs; budgetNs = numFrames / sampleRate (<= 0: counted, not rated). */
+    void recordBlock(int64_t elapsedNs, int64_t budgetNs, int numFrames);
+    void recordHandoff(bool rerender);
+    /** Call after recordBlock for a block that picked up a clip. */
+    void recordHandoffBlock(int64_t elapsedNs);
+    void recordUnderrun();
+
+    // Any thread
+    Snapshot snapshot() const;
+    /** Snapshot, then starts new peak windows (the audio thread may race one block into the old window). */
+    Snapshot takePeak();
+
+private:
+    static void bump(std::atomic<int64_t>& counter, int64_t by = 1) {
+        counter.store(counter.load(std::memory_order_relaxed) + by, std::memory_order_relaxed);
+    }
+    static void raise(std::atomic<int64_t>& peak, int64_t value) {
+        if (value > peak.load(std::memory_order_relaxed)) peak.store(value, std::memory_order_relaxed);
+    }
+
+    // Plain load + store per update: one writer, so no locked read-modify-write on the audio thread
+    std::atomic<int64_t> blocks_{ 0 };
+    std::atomic<int64_t> frames_{ 0 };
+    std::atomic<int64_t> busyNs_{ 0 };
+    std::atomic<int64_t> budgetNs_{ 0 };
+    std::atomic<int64_t> lastBlockNs_{ 0 };
+    std::atomic<int64_t> overruns_{ 0 };
+    std::atomic<int64_t> underruns_{ 0 };
+    std::atomic<int64_t> handoffs_{ 0 };
+    std::atomic<int64_t> rerenders_{ 0 };
+    std::atomic<int64_t> histogram_[kNumBuckets] = {};
+    // Peaks are also reset by takePeak() on a reader thread
+    std::atomic<int64_t> peakBlockNs_{ 0 };
+    std::atomic<int64_t> peakLoadPermille_{ 0 };
+    std::atomic<int64_t> peakHandoffBlockNs_{ 0 };
+
+    static_assert(std::atomic<int64_t>::is_always_lock_free, "audio-thread counters must be lock-free");
+};
+
+} // namespace aceforge
+
+#endif
@@ -0,0 +1,229 @@
+#include "Resampler.hpp"
+#include "Simd.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+
+namespace aceforge {
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+constexpr double kKaiserBeta = 8.0;  // ~80 dB stopband
+
+// Zeroth-order modified Bessel function of the first kind (power series)
+double besselI0(double x) {
+    double sum = 1.0, term = 1.0;
+    const double q = x * x * 0.25;
+    for (int k = 1; k < 64 && term > sum * 1e-12; ++k) {
+        term *= q / ((double)k * (double)k);
+        sum += term;
+    }
+    return sum;
+}
+
+bool isWholeNumber(double v) { return v == std::floor(v) && v < 1e9; }
+
+// Taps that overlap the start or end of the source; samples outside count as silence
+float dotClipped(const float* source, int64_t sourceFrames, int64_t start, const float* h, int taps) {
+    const int k0 = start < 0 ? (int)std::min<int64_t>(-start, taps) : 0;
+    const int k1 = (int)std::max<int64_t>(k0, std::min<int64_t>(taps, sourceFrames - start));
+    float sum = 0.0f;
+    for (int k = k0; k < k1; ++k) sum += source[start + k] * h[k];
+    return sum;
+}
+
+} // namespace
+
+void Resampler::setRates(double sourceRate, double targetRate) {
+    sourceRate_ = sourceRate;
+    targetRate_ = targetRate;
+    table_.clear();
+    up_ = down_ = 1;
+    step_ = 1.0;
+    taps_ = 0;
+    if (sourceRate <= 0.0 || targetRate <= 0.0 || sourceRate == targetRate) {
+        mode_ = Mode::Identity;
+        return;
+    }
+
+    mode_ = Mode::Interpolated;
+    step_ = sourceRate / targetRate;
+    if (isWholeNumber(sourceRate) && isWholeNumber(targetRate)) {
+        const int64_t s = (int64_t)sourceRate, t = (int64_t)targetRate;
+        const int64_t g = std::gcd(s, t);
+        if (t / g <= kMaxRationalPhases) {
+            mode_ = Mode::Rational;
+            up_ = t / g;
+            down_ = s / g;
+        }
+    }
+
+    // Longer filters when decimating keep the transition band narrow relative to the lower Nyquist frequency
+    const double ratio = targetRate / sourceRate;
+    taps_ = ratio >= 0.8 ? 64 : (ratio >= 0.4 ? 128 : 256);
+    const double stopEdge = 0.5 * std::min(1.0, ratio);  // cycles per input sample
+    const double attenuation = kKaiserBeta / 0.1102 + 8.7;
+    const double transition = (attenuation - 8.0) / (2.285 * 2.0 * kPi * (double)taps_);
+    const double cutoff = std::max(0.1 * stopEdge, stopEdge - 0.5 * transition);
+
+    const int phases = mode_ == Mode::Rational ? (int)up_ : kInterpolatedPhases + 1;
+    const double phaseScale = mode_ == Mode::Rational ? (double)up_ : (double)kInterpolatedPhases;
+    const double half = (double)taps_ * 0.5;
+    const double i0Beta = besselI0(kKaiserBeta);
+    table_.resize((size_t)phases * (size_t)taps_);
+    std::vector<double> h((size_t)taps_);
+    for (int p = 0; p < phases; ++p) {
+        const double frac = (double)p / phaseScale;
+        float* row = table_.data() + (size_t)p * (size_t)taps_;
+        double sum = 0.0;
+        for (int k = 0; k < taps_; ++k) {
+            const double d = (double)(k - taps_ / 2 + 1) - frac;  // distance from the output position, in input frames
+            const double x = d / half;
+            const double window = std::fabs(x) <= 1.0 ? besselI0(kKaiserBeta * std::sqrt(1.0 - x * x)) / i0Beta : 0.0;
+            const double arg = 2.0 * cutoff * d;
+            const double sinc = arg == 0.0 ? 1.0 : std::sin(kPi * arg) / (kPi * arg);
+            h[(size_t)k] = 2.0 * cutoff * sinc * window;
+            sum += h[(size_t)k];
+        }
+        for (int k = 0; k < taps_; ++k) row[k] = (float)(h[(size_t)k] / sum);
+    }
+}
+
+int64_t Resampler::outputLength(int64_t sourceFrames) const {
+    if (sourceFrames <= 0) return 0;
+    switch (mode_) {
+    case Mode::Identity: return sourceFrames;
+    case Mode::Rational: return (sourceFrames * up_ + down_ - 1) / down_;
+    case Mode::Interpolated: return (int64_t)std::ceil((double)sourceFrames / step_);
+    }
+    return 0;
+}
+
+int64_t Resampler::outputFramesReady(int64_t sourceFramesAvailable) const {
+    if (mode_ == Mode::Identity) return std::max<int64_t>(0, sourceFramesAvailable);
+    // Output frame i needs input frames up to base(i) + taps/2
+    const int64_t lastBase = sourceFramesAvailable - 1 - taps_ / 2;
+    if (lastBase < 0) return 0;
+    if (mode_ == Mode::Rational) return ((lastBase + 1) * up_ - 1) / down_ + 1;
+    int64_t ready = (int64_t)std::ceil((double)(lastBase + 1) / step_);
+    while (ready > 0 && (int64_t)std::floor((double)(ready - 1) * step_) > lastBase) --ready;
+    return ready;
+}
+
+int64_t Resampler::baseFrame(int64_t outFrame) const {
+    switch (mode_) {
+    case Mode::Identity: return outFrame;
+    case Mode::Rational: return outFrame * down_ / up_;
+    case Mode::Interpolated: return (int64_t)std::floor((double)outFrame * step_);
+    }
+    return outFrame;
+}
+
+void Resampler::sourceWindow(int64_t firstFrame, int64_t endFrame, int64_t& begin, int64_t& end) const {
+    if (endFrame <= firstFrame) {
+        begin = end = baseFrame(firstFrame);
+        return;
+    }
+    if (mode_ == Mode::Identity) {
+        begin = firstFrame;
+        end = endFrame;
+        return;
+    }
+    begin = baseFrame(firstFrame) - taps_ / 2 + 1;
+    end = baseFrame(endFrame - 1) + taps_ / 2 + 1;
+}
+
+template <int Taps, int Up, int Down>
+void Resampler::renderRational(const float* window, int64_t windowStart, int64_t windowFrames, float* out,
+                               int64_t firstFrame, int64_t endFrame) const {
+    // Constant template arguments let the compiler unroll the dot product and fold the phase arithmetic
+    const int taps = Taps != 0 ? Taps : taps_;
+    const int64_t up = Up != 0 ? Up : up_;
+    const int64_t down = Down != 0 ? Down : down_;
+    const int64_t baseStep = down / up, phaseStep = down % up;
+    const int64_t position = firstFrame * down;
+    int64_t base = position / up;
+    int64_t phase = position % up;
+    const float* table = table_.data();
+    for (int64_t i = firstFrame; i < endFrame; ++i) {
+        const int64_t start = base - taps / 2 + 1 - windowStart;
+        const float* h = table + phase * taps;
+        *out++ = start >= 0 && start + taps <= windowFrames ? simd::dot(window + start, h, taps)
+                                                            : dotClipped(window, windowFrames, start, h, taps);
+        base += baseStep;
+        phase += phaseStep;
+        if (phase >= up) {
+            phase -= up;
+            ++base;
+        }
+    }
+}
+
+template <int Taps>
+void Resampler::renderInterpolated(const float* window, int64_t windowStart, int64_t windowFrames, float* out,
+                                   int64_t firstFrame, int64_t endFrame) const {
+    const int taps = Taps != 0 ? Taps : taps_;
+    const float* table = table_.data();
+    for (int64_t i = firstFrame; i < endFrame; ++i) {
+        const double t = (double)i * step_;
+        const double base = std::floor(t);
+        const double scaled = (t - base) * kInterpolatedPhases;
+        const int p = std::min((int)scaled, kInterpolatedPhases - 1);
+        const float w = (float)(scaled - (double)p);
+        const int64_t start = (int64_t)base - taps / 2 + 1 - windowStart;
+        const float* h0 = table + (size_t)p * (size_t)taps;
+        const float* h1 = h0 + taps;
+        float y0, y1;
+        if (start >= 0 && start + taps <= windowFrames) {
+            y0 = simd::dot(window + start, h0, taps);
+            y1 = simd::dot(window + start, h1, taps);
+        } else {
+            y0 = dotClipped(window, windowFrames, start, h0, taps);
+            y1 = dotClipped(window, windowFrames, start, h1, taps);
+        }
+        *out++ = y0 + w * (y1 - y0);
+    }
+}
+
+void Resampler::render(const float* window, int64_t windowStart, int64_t windowFrames, float* out, int64_t firstFrame,
+                       int64_t endFrame) const {
+    if (endFrame <= firstFrame) return;
+    switch (mode_) {
+    case Mode::Identity: {
+        // Copy the part of [firstFrame, endFrame) that the window covers; silence around it
+        const int64_t copyBegin = std::min(endFrame, std::max(firstFrame, windowStart));
+        const int64_t copyEnd = std::max(copyBegin, std::min(endFrame, windowStart + windowFrames));
+        std::fill(out, out + (copyBegin - firstFrame), 0.0f);
+        if (copyEnd > copyBegin)
+            std::memcpy(out + (copyBegin - firstFrame), window + (copyBegin - windowStart),
+                        (size_t)(copyEnd - copyBegin) * sizeof(float));
+        std::fill(out + (copyEnd - firstFrame), out + (endFrame - firstFrame), 0.0f);
+        return;
+    }
+    case Mode::Rational:
+        if (taps_ == 64 && up_ == 160 && down_ == 147)
+            renderRational<64, 160, 147>(window, windowStart, windowFrames, out, firstFrame, endFrame);  // 44.1k -> 48k
+        else if (taps_ == 64 && up_ == 147 && down_ == 160)
+            renderRational<64, 147, 160>(window, windowStart, windowFrames, out, firstFrame, endFrame);  // 48k -> 44.1k
+        else if (taps_ == 64 && up_ == 2 && down_ == 1)
+            renderRational<64, 2, 1>(window, windowStart, windowFrames, out, firstFrame, endFrame);
+        else if (taps_ == 128 && up_ == 1 && down_ == 2)
+            renderRational<128, 1, 2>(window, windowStart, windowFrames, out, firstFrame, endFrame);
+        else if (taps_ == 64)
+            renderRational<64, 0, 0>(window, windowStart, windowFrames, out, firstFrame, endFrame);
+        else if (taps_ == 128)
+            renderRational<128, 0, 0>(window, windowStart, windowFrames, out, firstFrame, endFrame);
+        else
+            renderRational<0, 0, 0>(window, windowStart, windowFrames, out, firstFrame, endFrame);
+        return;
+    case Mode::Interpolated:
+        if (taps_ == 64) renderInterpolated<64>(window, windowStart, windowFrames, out, firstFrame, endFrame);
+        else if (taps_ == 128) renderInterpolated<128>(window, windowStart, windowFrames, out, firstFrame, endFrame);
+        else renderInterpolated<0>(window, windowStart, windowFrames, out, firstFrame, endFrame);
+        return;
+    }
+}
+
+} // namespace aceforge
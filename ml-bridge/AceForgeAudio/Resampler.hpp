@@ -0,0 +1,90 @@
+/**
+ * Windowed-sinc sample-rate converter for planar float audio.
+ *
+ * Rates with a small rational ratio up/down (44.1k <-> 48k is 160/147, 2x is 2/1) use an exact polyphase
+ * table: output frame i lies at input position i * down / up, and its taps are the table row for that phase.
+ * Other ratios interpolate between 256 precomputed phases. Filters are Kaiser-windowed sincs (64 taps, 128+
+ * when decimating) with the cutoff just below the lower of the two Nyquist frequencies; every row is
+ * normalized to unity DC gain. The inner loops are vectorized dot products, and 44.1k <-> 48k and 2x are
+ * compiled as dedicated specializations with constant tap counts and phase steps.
+ *
+ * Rendering is random access: any range of output frames can be computed from the source at any time, which
+ * suits both streaming (render what the arrived input allows, see outputFramesReady) and re-rendering a whole
+ * clip at a new rate. Samples before the start or past the end of the source count as silence. The source can
+ * also be a window onto a longer stream (disk playback): sourceWindow() says which source frames a range of
+ * output needs, and only those have to be in memory.
+ */
+#ifndef ACEFORGE_RESAMPLER_HPP
+#define ACEFORGE_RESAMPLER_HPP
+
+#include <cstdint>
+#include <vector>
+
+namespace aceforge {
+
+class Resampler {
+public:
+    Resampler() = default;
+    Resampler(double sourceRate, double targetRate) { setRates(sourceRate, targetRate); }
+
+    /** Designs the filter for sourceRate -> targetRate (non-positive rates mean no conversion). */
+    void setRates(double sourceRate, double targetRate);
+
+    double sourceRate() const { return sourceRate_; }
+    double targetRate() const { return targetRate_; }
+    bool isIdentity() const { return mode_ == Mode::Identity; }
+    int numTaps() const { return taps_; }
+
+    /** Output frames for a source of sourceFrames frames. */
+    int64_t outputLength(int64_t sourceFrames) const;
+
+    /**
+     * Output frames whose taps all lie within the first sourceFramesAvailable source frames, i.e. frames that
+     * will not change when more input arrives.
+     */
+    int64_t outputFramesReady(int64_t sourceFramesAvailable) const;
+
+    /** Renders output frames [firstFrame, endFrame) of one channel into out[0 .. endFrame - firstFrame). */
+    void render(const float* source, int64_t sourceFrames, float* out, int64_t firstFrame, int64_t endFrame) const {
+        render(source, 0, sourceFrames, out, firstFrame, endFrame);
+    }
+
+    /**
+     * Same, reading from a window: window[0 .. windowFrames) holds source frames [windowStart, windowStart +
+     * windowFrames) and everything outside it counts as silence.
+     */
+    void render(const float* window, int64_t windowStart, int64_t windowFrames, float* out, int64_t firstFrame,
+                int64_t endFrame) const;
+
+    /**
+     * Source frames [begin, end) read by output frames [firstFrame, endFrame). Not clipped to the source: the range
+     * can start before 0 or extend past the last frame.
+     */
+    void sourceWindow(int64_t firstFrame, int64_t endFrame, int64_t& begin, int64_t& end) const;
+
+private:
+    enum class Mode { Identity, Rational, Interpolated };
+    static constexpr int kInterpolatedPhases = 256;
+    static constexpr int kMaxRationalPhases = 1024;
+
+    int64_t baseFrame(int64_t outFrame) const;  // source frame at or before output frame outFrame
+    template <int Taps, int Up, int Down>
+    void renderRational(const float* window, int64_t windowStart, int64_t windowFrames, float* out, int64_t firstFrame,
+                        int64_t endFrame) const;
+    template <int Taps>
+    void renderInterpolated(const float* window, int64_t windowStart, int64_t windowFrames, float* out,
+                            int64_t firstFrame, int64_t endFrame) const;
+
+    Mode mode_ = Mode::Identity;
+    double sourceRate_ = 0.0;
+    double targetRate_ = 0.0;
+    int64_t up_ = 1;    // rational mode: output/input = up_/down_ (reduced)
+    int64_t down_ = 1;
+    double step_ = 1.0; // interpolated mode: input frames per output frame
+    int taps_ = 0;
+    std::vector<float> table_; // phase-major: row p holds taps_ coefficients
+};
+
+} // namespace aceforge
+
+#endif
@@ -0,0 +1,52 @@
+/**
+ * Instruction-set selection shared by the AceForgeAudio kernels (internal header).
+ *
+ * ACEFORGE_SIMD_SSE2 on x86-64 (always available there), ACEFORGE_SIMD_NEON on ARM64, neither otherwise;
+ * every kernel keeps a scalar path for the remainder and for other targets.
+ */
+#ifndef ACEFORGE_SIMD_HPP
+#define ACEFORGE_SIMD_HPP
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ACEFORGE_SIMD_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define ACEFORGE_SIMD_NEON 1
+#endif
+
+namespace aceforge {
+namespace simd {
+
+/** Sum of a[i] * b[i]. Inline so that callers passing a constant n get a fully unrolled loop. */
+inline float dot(const float* a, const float* b, int n) {
+    int i = 0;
+    float sum = 0.0f;
+#if defined(ACEFORGE_SIMD_SSE2)
+    __m128 acc0 = _mm_setzero_ps(), acc1 = _mm_setzero_ps();
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+    }
+    acc0 = _mm_add_ps(acc0, acc1);
+    acc0 = _mm_add_ps(acc0, _mm_shuffle_ps(acc0, acc0, _MM_SHUFFLE(1, 0, 3, 2)));
+    acc0 = _mm_add_ss(acc0, _mm_shuffle_ps(acc0, acc0, _MM_SHUFFLE(2, 3, 0, 1)));
+    sum = _mm_cvtss_f32(acc0);
+#elif defined(ACEFORGE_SIMD_NEON)
+    float32x4_t acc0 = vdupq_n_f32(0.0f), acc1 = vdupq_n_f32(0.0f);
+    for (; i + 8 <= n; i += 8) {
+        acc0 = vmlaq_f32(acc0, vld1q_f32(a + i), vld1q_f32(b + i));
+        acc1 = vmlaq_f32(acc1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+    }
+    acc0 = vaddq_f32(acc0, acc1);
+    float32x2_t half = vadd_f32(vget_low_f32(acc0), vget_high_f32(acc0));
+    sum = vget_lane_f32(vpadd_f32(half, half), 0);
+#endif
+    for (; i < n; ++i) sum += a[i] * b[i];
+    return sum;
+}
+
+} // namespace simd
+} // namespace aceforge
+
+#endif
@@ -0,0 +1,156 @@
+#include "TimeStretch.hpp"
+#include "AudioKernels.hpp"
+#include "Simd.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace aceforge {
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+constexpr double kGrainSeconds = 0.0427;  // 2048 frames at 48 kHz
+
+int64_t alignDown(int64_t frame, int64_t step) {
+    const int64_t r = frame % step;
+    return r < 0 ? frame - r - step : frame - r;
+}
+
+} // namespace
+
+void TimeStretch::prepare(double sampleRate, double stretch) {
+    if (!(stretch > 0.0)) stretch = 1.0;
+    stretch_ = std::min(kMaxStretch, std::max(kMinStretch, stretch));
+    identity_ = std::fabs(stretch_ - 1.0) < kIdentityTolerance;
+    if (!(sampleRate > 0.0)) sampleRate = 48000.0;
+    // Hop a multiple of 8: the grain is a whole number of SIMD widths and the tolerance of decimation steps
+    hop_ = std::max(64, (int)std::lround(sampleRate * kGrainSeconds / 16.0) * 8);
+    grain_ = 2 * hop_;
+    tolerance_ = hop_ / 2;
+    analysisHop_ = (double)hop_ / stretch_;
+    // Periodic Hann: grains half a grain apart sum to exactly one
+    window_.resize((size_t)grain_);
+    for (int i = 0; i < grain_; ++i) window_[(size_t)i] = (float)(0.5 - 0.5 * std::cos(2.0 * kPi * i / grain_));
+    span_.assign((size_t)grain_, 0.0f);
+    cachedGrain_[0] = cachedGrain_[1] = INT64_MIN;
+}
+
+int64_t TimeStretch::outputLength(int64_t sourceFrames) const {
+    return identity_ ? sourceFrames : std::llround((double)sourceFrames * stretch_);
+}
+
+void TimeStretch::setSource(const float* const* channels, int numChannels, int64_t numFrames) {
+    channels_.assign(channels, channels + std::max(0, numChannels));
+    sourceFrames_ = std::max<int64_t>(0, numFrames);
+    cachedGrain_[0] = cachedGrain_[1] = INT64_MIN;
+    mono_.clear();
+    coarse_.clear();
+    if (identity_ || channels_.empty()) return;
+
+    // Searches read up to a tolerance (plus a decimation step) before a grain's nominal position and a grain past
+    // it; the first grain sits one analysis hop before the source, the last up to one past it
+    pad_ = alignDown((int64_t)std::ceil(2.0 * analysisHop_) + tolerance_ + 2 * grain_ + 16, kDecimation) + kDecimation;
+    const size_t total = (size_t)(2 * pad_ + alignDown(sourceFrames_, kDecimation) + kDecimation);
+    mono_.assign(total, 0.0f);
+    const float scale = 1.0f / (float)channels_.size();
+    float* dst = mono_.data() + pad_;
+    for (const float* src : channels_)
+        for (int64_t i = 0; i < sourceFrames_; ++i) dst[i] += src[i] * scale;
+    coarse_.resize(total / kDecimation);
+    for (size_t j = 0; j < coarse_.size(); ++j) {
+        const float* m = mono_.data() + j * kDecimation;
+        coarse_[j] = 0.25f * (m[0] + m[1] + m[2] + m[3]);
+    }
+}
+
+int64_t TimeStretch::search(int64_t nominal, int64_t reference) const {
+    const float* refFine = mono(reference);
+    if (simd::dot(refFine, refFine, hop_) < 1.0e-9f) return nominal;  // silence: nothing to line up with
+
+    // Coarse pass: every kDecimation-th offset across the whole tolerance, on the decimated signal
+    const int coarseLength = hop_ / kDecimation;
+    const float* refCoarse = coarse(alignDown(reference, kDecimation));
+    int64_t best = nominal;
+    float bestScore = -1.0e30f;
+    for (int64_t q = alignDown(nominal - tolerance_, kDecimation); q <= nominal + tolerance_; q += kDecimation) {
+        const float* c = coarse(q);
+        const float score = simd::dot(c, refCoarse, coarseLength) / std::sqrt(simd::dot(c, c, coarseLength) + 1.0e-9f);
+        if (score > bestScore) {
+            bestScore = score;
+            best = q;
+        }
+    }
+
+    // Fine pass: full rate within one decimation step of the coarse winner
+    const int64_t centre = best;
+    bestScore = -1.0e30f;
+    const int64_t lo = std::max(nominal - tolerance_, centre - (kDecimation - 1));
+    const int64_t hi = std::min(nominal + tolerance_, centre + (kDecimation - 1));
+    for (int64_t q = lo; q <= hi; ++q) {
+        const float* c = mono(q);
+        const float score = simd::dot(c, refFine, hop_) / std::sqrt(simd::dot(c, c, hop_) + 1.0e-9f);
+        if (score > bestScore) {
+            bestScore = score;
+            best = q;
+        }
+    }
+    return best;
+}
+
+int64_t TimeStretch::grainStart(int64_t grain) {
+    for (int i = 0; i < 2; ++i)
+        if (cachedGrain_[i] == grain) return cachedStart_[i];
+    const int64_t nominal = std::llround((double)grain * analysisHop_);
+    // Continue the chain when the previous grain is known; otherwise this grain starts a new one where it belongs.
+    // Its first half should match how the previous grain's source would have gone on: one hop after its start.
+    const int64_t start = cachedGrain_[1] == grain - 1 ? search(nominal, cachedStart_[1] + hop_) : nominal;
+    cachedGrain_[0] = cachedGrain_[1];
+    cachedStart_[0] = cachedStart_[1];
+    cachedGrain_[1] = grain;
+    cachedStart_[1] = start;
+    return start;
+}
+
+const float* TimeStretch::sourceSpan(int channel, int64_t start, int n) {
+    const float* src = channels_[(size_t)channel];
+    if (start >= 0 && start + n <= sourceFrames_) return src + start;
+    kernels::clear(span_.data(), n);
+    const int64_t from = std::max<int64_t>(0, start);
+    const int64_t to = std::min(sourceFrames_, start + n);
+    if (to > from) kernels::copy(span_.data() + (from - start), src + from, (int)(to - from));
+    return span_.data();
+}
+
+void TimeStretch::render(float* const* out, int numChannels, int64_t firstFrame, int64_t endFrame) {
+    if (endFrame <= firstFrame) return;
+    for (int c = 0; c < numChannels; ++c) kernels::clear(out[c], (int)(endFrame - firstFrame));
+    if (channels_.empty()) return;
+    const int lastChannel = (int)channels_.size() - 1;
+    const int64_t end = std::min(endFrame, outputLength(sourceFrames_));
+    if (end <= firstFrame) return;
+
+    if (identity_) {
+        for (int c = 0; c < numChannels; ++c)
+            kernels::copy(out[c], channels_[(size_t)std::min(c, lastChannel)] + firstFrame, (int)(end - firstFrame));
+        return;
+    }
+
+    // Grain k covers output [k * hop, k * hop + grain): every frame is covered by two grains
+    const int64_t firstGrain = firstFrame / hop_ - 1;
+    const int64_t lastGrain = (end - 1) / hop_;
+    for (int64_t k = firstGrain; k <= lastGrain; ++k) {
+        const int64_t start = grainStart(k);
+        const int64_t grainOut = k * hop_;
+        const int64_t from = std::max(firstFrame, grainOut);
+        const int64_t to = std::min(end, grainOut + grain_);
+        if (to <= from) continue;
+        const int offset = (int)(from - grainOut);
+        const int n = (int)(to - from);
+        for (int c = 0; c < numChannels; ++c) {
+            const float* src = sourceSpan(std::min(c, lastChannel), start + offset, n);
+            kernels::addWindowed(out[c] + (from - firstFrame), src, window_.data() + offset, n);
+        }
+    }
+}
+
+} // namespace aceforge
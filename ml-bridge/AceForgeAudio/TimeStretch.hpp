@@ -0,0 +1,89 @@
+/**
+ * Tempo change without pitch change for planar float audio (WSOLA: waveform-similarity overlap-add).
+ *
+ * The output is built from Hann-windowed grains of ~43 ms laid down every half grain (the synthesis hop), so
+ * adjacent grains sum to unity gain. Grain k nominally reads the source at k * hop / stretch; WSOLA moves it by
+ * up to a quarter grain so that its first half best matches how the previous grain's source would have
+ * continued, which keeps periodic material phase-coherent across grain boundaries. The match is a normalized
+ * cross-correlation on a mono mix: first on a 4x decimated copy over the whole tolerance, then at full rate
+ * around the best coarse offset. Correlations are vectorized dot products (Simd.hpp) and the overlap-add is
+ * kernels::addWindowed.
+ *
+ * Meant for offline rendering on a worker: render() can produce any range of output frames, and consecutive
+ * ranges continue exactly where the previous one stopped, so a clip can be rendered in chunks (and published
+ * after the first one). A range that does not follow the previous one starts a fresh grain chain there, which
+ * is how a re-render starts at the playhead.
+ *
+ * Not thread-safe; one instance per rendering thread.
+ */
+#ifndef ACEFORGE_TIME_STRETCH_HPP
+#define ACEFORGE_TIME_STRETCH_HPP
+
+#include <cstdint>
+#include <vector>
+
+namespace aceforge {
+
+class TimeStretch {
+public:
+    /** Stretches closer to 1 than this are a plain copy. */
+    static constexpr double kIdentityTolerance = 1.0e-4;
+    static constexpr double kMinStretch = 0.25;
+    static constexpr double kMaxStretch = 4.0;
+
+    /**
+     * stretch = output length / source length (source tempo / target tempo), clamped to [kMinStretch,
+     * kMaxStretch]. Call before setSource().
+     */
+    void prepare(double sampleRate, double stretch);
+
+    double stretch() const { return stretch_; }
+    bool isIdentity() const { return identity_; }
+    int grainFrames() const { return grain_; }
+    int64_t outputLength(int64_t sourceFrames) const;
+
+    /**
+     * The audio to stretch: numChannels planar channels of numFrames. The pointers are kept (the caller owns the
+     * audio and keeps it alive while rendering); the mono search signal is built here.
+     */
+    void setSource(const float* const* channels, int numChannels, int64_t numFrames);
+
+    /**
+     * Renders output frames [firstFrame, endFrame) into out[c][0 .. endFrame - firstFrame) for numChannels output
+     * channels (beyond the source's channels the last one repeats). Frames past the end of the output are silence.
+     */
+    void render(float* const* out, int numChannels, int64_t firstFrame, int64_t endFrame);
+
+private:
+    static constexpr int kDecimation = 4;  // coarse search resolution
+
+    int64_t grainStart(int64_t grain);
+    int64_t search(int64_t nominal, int64_t reference) const;
+    const float* mono(int64_t frame) const { return mono_.data() + (pad_ + frame); }
+    const float* coarse(int64_t frame) const { return coarse_.data() + (pad_ + frame) / kDecimation; }
+    /** Source frames [start, start + n) of channel, zero outside the source; may point into the source itself. */
+    const float* sourceSpan(int channel, int64_t start, int n);
+
+    double stretch_ = 1.0;
+    bool identity_ = true;
+    int grain_ = 2048;
+    int hop_ = 1024;        // synthesis hop: half a grain
+    int tolerance_ = 512;   // how far a grain may move from its nominal source position
+    double analysisHop_ = 1024.0;
+    std::vector<float> window_;
+
+    std::vector<const float*> channels_;
+    int64_t sourceFrames_ = 0;
+    int64_t pad_ = 0;       // silence on either side of the search signals, so every search reads in range
+    std::vector<float> mono_;
+    std::vector<float> coarse_;
+    std::vector<float> span_;
+
+    // The last two grains placed: a chunk continues the chain from them
+    int64_t cachedGrain_[2] = { INT64_MIN, INT64_MIN };
+    int64_t cachedStart_[2] = { 0, 0 };
+};
+
+} // namespace aceforge
+
+#endif
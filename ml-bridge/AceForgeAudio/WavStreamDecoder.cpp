@@ -0,0 +1,209 @@
+#include "WavStreamDecoder.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace aceforge {
+
+namespace {
+
+constexpr int kFormatPcm = 1;
+constexpr int kFormatFloat = 3;
+constexpr int kFormatExtensible = 0xFFFE;
+constexpr size_t kMaxFmtChunk = 4096;
+constexpr int kFramesPerBatch = 4096;
+
+inline uint16_t readU16(const uint8_t* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+inline uint32_t readU32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+} // namespace
+
+WavStreamDecoder::WavStreamDecoder(FormatCallback onFormat, FramesCallback onFrames)
+    : onFormat_(std::move(onFormat)), onFrames_(std::move(onFrames)) {
+    header_.reserve(64);
+}
+
+bool WavStreamDecoder::fail(const std::string& message) {
+    error_ = message;
+    state_ = State::Failed;
+    return false;
+}
+
+bool WavStreamDecoder::push(const uint8_t* data, size_t size) {
+    while (size > 0) {
+        switch (state_) {
+        case State::RiffHeader:
+        case State::ChunkHeader:
+        case State::FmtChunk: {
+            const size_t take = std::min(need_ - header_.size(), size);
+            header_.insert(header_.end(), data, data + take);
+            data += take;
+            size -= take;
+            if (header_.size() < need_) return true;
+
+            if (state_ == State::RiffHeader) {
+                if (std::memcmp(header_.data(), "RIFF", 4) != 0 || std::memcmp(header_.data() + 8, "WAVE", 4) != 0)
+                    return fail("Not a RIFF/WAVE stream");
+                state_ = State::ChunkHeader;
+            } else if (state_ == State::ChunkHeader) {
+                const uint32_t chunkSize = readU32(header_.data() + 4);
+                if (std::memcmp(header_.data(), "fmt ", 4) == 0) {
+                    if (chunkSize < 16 || chunkSize > kMaxFmtChunk) return fail("Invalid fmt chunk");
+                    chunkPadded_ = (chunkSize & 1u) != 0;
+                    state_ = State::FmtChunk;
+                    need_ = chunkSize;
+                    header_.clear();
+                    continue;
+                }
+                if (std::memcmp(header_.data(), "data", 4) == 0) {
+                    if (!formatKnown_) return fail("data chunk before fmt chunk");
+                    dataUnbounded_ = chunkSize == 0 || chunkSize == 0xFFFFFFFFu;
+                    chunkRemaining_ = chunkSize;
+                    format_.totalFrames = dataUnbounded_ ? 0 : chunkSize / (uint32_t)bytesPerFrame_;
+                    state_ = State::DataChunk;
+                    if (onFormat_ && !onFormat_(format_)) return fail("Aborted");
+                    continue;
+                }
+                chunkRemaining_ = (uint64_t)chunkSize + (chunkSize & 1u);
+                state_ = State::SkipChunk;
+                continue;
+            } else {
+                if (!parseFmt()) return false;
+                if (chunkPadded_) {
+                    chunkRemaining_ = 1;
+                    state_ = State::SkipChunk;
+                    continue;
+                }
+                state_ = State::ChunkHeader;
+            }
+            need_ = 8;
+            header_.clear();
+            break;
+        }
+        case State::SkipChunk: {
+            const size_t take = (size_t)std::min<uint64_t>(chunkRemaining_, size);
+            data += take;
+            size -= take;
+            chunkRemaining_ -= take;
+            if (chunkRemaining_ == 0) {
+                state_ = State::ChunkHeader;
+                need_ = 8;
+                header_.clear();
+            }
+            break;
+        }
+        case State::DataChunk: {
+            const size_t take = dataUnbounded_ ? size : (size_t)std::min<uint64_t>(chunkRemaining_, size);
+            if (!decodeData(data, take)) return false;
+            data += take;
+            size -= take;
+            if (!dataUnbounded_) {
+                chunkRemaining_ -= take;
+                if (chunkRemaining_ == 0) state_ = State::Done;
+            }
+            break;
+        }
+        case State::Done:
+            return true;
+        case State::Failed:
+            return false;
+        }
+    }
+    return state_ != State::Failed;
+}
+
+bool WavStreamDecoder::parseFmt() {
+    const uint8_t* p = header_.data();
+    formatTag_ = readU16(p);
+    const int channels = readU16(p + 2);
+    const uint32_t rate = readU32(p + 4);
+    const int blockAlign = readU16(p + 12);
+    const int bits = readU16(p + 14);
+    if (formatTag_ == kFormatExtensible) {
+        if (header_.size() < 40) return fail("Truncated WAVE_FORMAT_EXTENSIBLE header");
+        formatTag_ = readU16(p + 24);  // first two bytes of the SubFormat GUID
+    }
+    const bool pcmOk = formatTag_ == kFormatPcm && (bits == 8 || bits == 16 || bits == 24 || bits == 32);
+    const bool floatOk = formatTag_ == kFormatFloat && (bits == 32 || bits == 64);
+    if (!pcmOk && !floatOk)
+        return fail("Unsupported WAV encoding (format " + std::to_string(formatTag_) + ", " + std::to_string(bits) + " bit)");
+    if (channels <= 0 || channels > 64 || rate == 0) return fail("Invalid WAV channel count or sample rate");
+    bytesPerFrame_ = channels * (bits / 8);
+    if (blockAlign != 0 && blockAlign != bytesPerFrame_) return fail("Unsupported WAV block alignment");
+
+    format_.sampleRate = (double)rate;
+    format_.numChannels = channels;
+    format_.bitsPerSample = bits;
+    format_.isFloat = floatOk;
+    formatKnown_ = true;
+    scratch_.resize((size_t)kFramesPerBatch * (size_t)channels);
+    carry_.reserve((size_t)bytesPerFrame_);
+    return true;
+}
+
+bool WavStreamDecoder::decodeData(const uint8_t* data, size_t size) {
+    const size_t frameBytes = (size_t)bytesPerFrame_;
+    // Complete a frame split across pushes
+    if (!carry_.empty()) {
+        const size_t take = std::min(frameBytes - carry_.size(), size);
+        carry_.insert(carry_.end(), data, data + take);
+        data += take;
+        size -= take;
+        if (carry_.size() < frameBytes) return true;
+        convert(carry_.data(), 1, scratch_.data());
+        carry_.clear();
+        ++framesDecoded_;
+        if (onFrames_ && !onFrames_(scratch_.data(), 1)) return fail("Aborted");
+    }
+    size_t frames = size / frameBytes;
+    while (frames > 0) {
+        const int batch = (int)std::min<size_t>(frames, (size_t)kFramesPerBatch);
+        convert(data, batch, scratch_.data());
+        framesDecoded_ += (uint64_t)batch;
+        if (onFrames_ && !onFrames_(scratch_.data(), batch)) return fail("Aborted");
+        data += (size_t)batch * frameBytes;
+        size -= (size_t)batch * frameBytes;
+        frames -= (size_t)batch;
+    }
+    if (size > 0) carry_.assign(data, data + size);
+    return true;
+}
+
+void WavStreamDecoder::convert(const uint8_t* src, int numFrames, float* dst) const {
+    const size_t n = (size_t)numFrames * (size_t)format_.numChannels;
+    if (format_.isFloat) {
+        if (format_.bitsPerSample == 32) {
+            std::memcpy(dst, src, n * sizeof(float));
+        } else {
+            for (size_t i = 0; i < n; ++i) {
+                double d;
+                std::memcpy(&d, src + i * 8, sizeof(double));
+                dst[i] = (float)d;
+            }
+        }
+        return;
+    }
+    switch (format_.bitsPerSample) {
+    case 8:
+        for (size_t i = 0; i < n; ++i) dst[i] = ((int)src[i] - 128) * (1.0f / 128.0f);
+        break;
+    case 16:
+        for (size_t i = 0; i < n; ++i) dst[i] = (int16_t)readU16(src + i * 2) * (1.0f / 32768.0f);
+        break;
+    case 24:
+        for (size_t i = 0; i < n; ++i) {
+            const uint8_t* s = src + i * 3;
+            const int32_t v = (int32_t)(((uint32_t)s[0] << 8) | ((uint32_t)s[1] << 16) | ((uint32_t)s[2] << 24)) >> 8;
+            dst[i] = v * (1.0f / 8388608.0f);
+        }
+        break;
+    case 32:
+        for (size_t i = 0; i < n; ++i) dst[i] = (float)((int32_t)readU32(src + i * 4) * (1.0 / 2147483648.0));
+        break;
+    default:
+        break;
+    }
+}
+
+} // namespace aceforge
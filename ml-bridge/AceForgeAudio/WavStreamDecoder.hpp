@@ -0,0 +1,77 @@
+/**
+ * Incremental WAV decoder: feed bytes as they arrive from the network and receive
+ * interleaved float frames as soon as enough bytes for them are available.
+ *
+ * Supports RIFF/WAVE with PCM 8/16/24/32-bit, IEEE float 32/64-bit and WAVE_FORMAT_EXTENSIBLE.
+ * Chunks before "data" (LIST, fact, ...) are skipped; anything after the data chunk is ignored.
+ * Not thread-safe; use one decoder per stream.
+ */
+#ifndef ACEFORGE_WAV_STREAM_DECODER_HPP
+#define ACEFORGE_WAV_STREAM_DECODER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace aceforge {
+
+class WavStreamDecoder {
+public:
+    struct Format {
+        double sampleRate = 0;
+        int numChannels = 0;
+        int bitsPerSample = 0;
+        bool isFloat = false;
+        /** Frames in the data chunk, or 0 when the header does not say (streamed/unknown length). */
+        uint64_t totalFrames = 0;
+    };
+
+    /** Called once, when the fmt chunk and the data chunk header have been parsed. Return false to abort. */
+    using FormatCallback = std::function<bool(const Format&)>;
+    /** Called for each run of decoded frames (interleaved, format().numChannels per frame). Return false to abort. */
+    using FramesCallback = std::function<bool(const float* interleaved, int numFrames)>;
+
+    WavStreamDecoder(FormatCallback onFormat, FramesCallback onFrames);
+
+    /** Feeds the next bytes of the file. Returns false on a parse error or when a callback aborted. */
+    bool push(const uint8_t* data, size_t size);
+
+    /** True once the whole data chunk has been decoded (always false for unknown-length data). */
+    bool isFinished() const { return state_ == State::Done; }
+    bool hasFormat() const { return formatKnown_; }
+    const Format& format() const { return format_; }
+    /** Frames delivered so far. */
+    uint64_t framesDecoded() const { return framesDecoded_; }
+    const std::string& error() const { return error_; }
+
+private:
+    enum class State { RiffHeader, ChunkHeader, FmtChunk, SkipChunk, DataChunk, Done, Failed };
+
+    bool parseFmt();
+    bool decodeData(const uint8_t* data, size_t size);
+    void convert(const uint8_t* src, int numFrames, float* dst) const;
+    bool fail(const std::string& message);
+
+    FormatCallback onFormat_;
+    FramesCallback onFrames_;
+    State state_ = State::RiffHeader;
+    std::vector<uint8_t> header_;   // accumulates fixed-size headers and the fmt chunk
+    size_t need_ = 12;              // bytes header_ must reach before the current state can proceed
+    uint64_t chunkRemaining_ = 0;   // bytes left in the current chunk (skip or data)
+    bool chunkPadded_ = false;      // odd-sized chunks are followed by one pad byte
+    bool dataUnbounded_ = false;    // data size 0 / 0xFFFFFFFF: decode until the stream ends
+    bool formatKnown_ = false;
+    Format format_;
+    int formatTag_ = 0;
+    int bytesPerFrame_ = 0;
+    std::vector<uint8_t> carry_;    // partial frame left over between pushes
+    std::vector<float> scratch_;
+    uint64_t framesDecoded_ = 0;
+    std::string error_;
+};
+
+} // namespace aceforge
+
+#endif
@@ -0,0 +1,302 @@
+/**
+ * Platform-neutral part of AceForgeClient: request bodies, response parsing (AceForgeJson) and job waiting.
+ * Transport (get/post/fetchAudio) lives in AceForgeClientMac.mm (NSURLSession)
+ * and AceForgeClientPosix.cpp (plain sockets with keep-alive).
+ */
+#include "AceForgeClient.hpp"
+#include "AceForgeJson.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <locale>
+#include <sstream>
+#include <thread>
+
+namespace aceforge {
+
+std::string AceForgeClient::getBaseUrl() const { return base_; }
+
+void CancellationToken::cancel() {
+    std::lock_guard<std::mutex> l(lock_);
+    cancelled_.store(true);
+    for (AceForgeClient* client : clients_) client->interruptTransport();
+}
+
+void CancellationToken::attach(AceForgeClient* client) const {
+    std::lock_guard<std::mutex> l(lock_);
+    clients_.push_back(client);
+}
+
+void CancellationToken::detach(AceForgeClient* client) const {
+    std::lock_guard<std::mutex> l(lock_);
+    clients_.erase(std::find(clients_.begin(), clients_.end(), client));
+}
+
+// The transport checks stopReason() after registering a request, so a cancel() that lands between attach()
+// and the request start is not lost.
+AceForgeClient::TokenScope::TokenScope(AceForgeClient& client, const CancellationToken* token)
+    : client_(client), token_(token) {
+    if (!token_) return;
+    client_.token_ = token_;
+    token_->attach(&client_);
+}
+
+AceForgeClient::TokenScope::~TokenScope() {
+    if (!token_) return;
+    token_->detach(&client_);
+    client_.token_ = nullptr;
+}
+
+void AceForgeClient::abort() {
+    aborted_.store(true);
+    interruptTransport();
+}
+
+const char* AceForgeClient::stopReason() const {
+    if (aborted_.load()) return "Aborted";
+    if (token_ && token_->isCancelled()) return "Cancelled";
+    return nullptr;
+}
+
+bool AceForgeClient::healthCheck() {
+    std::string body = get("/api/generate/health");
+    if (body.empty()) return false;
+    bool healthy = false;
+    return parseHealth(body, healthy) && healthy;
+}
+
+static std::string escapeJsonString(const std::string& s) {
+    std::string out;
+    out.reserve(s.size() + 8);
+    for (char c : s) {
+        if (c == '"') out += "\\\"";
+        else if (c == '\\') out += "\\\\";
+        else if (c == '\n') out += "\\n";
+        else if (c == '\r') out += "\\r";
+        else if ((unsigned char)c >= 32) out += c;
+    }
+    return out;
+}
+
+std::string canonicalGenerateParams(const GenerateParams& params) {
+    std::ostringstream out;
+    out.imbue(std::locale::classic());
+    out.precision(6);
+    // Bump the version when the server's interpretation of a field changes, so old entries stop matching
+    out << "v1\n"
+        << "songDescription=\"" << escapeJsonString(params.songDescription) << "\"\n"
+        << "lyrics=\"" << escapeJsonString(params.lyrics) << "\"\n"
+        << "instrumental=" << (params.instrumental ? 1 : 0) << "\n"
+        << "duration=" << params.durationSeconds << "\n"
+        << "inferenceSteps=" << params.inferenceSteps << "\n"
+        << "guidanceScale=" << params.guidanceScale << "\n"
+        << "seed=" << (params.randomSeed ? std::string("random") : std::to_string(params.seed)) << "\n"
+        << "taskType=" << params.taskType << "\n";
+    if (!params.referenceAudioUrl.empty())
+        out << "referenceAudioUrl=\"" << escapeJsonString(params.referenceAudioUrl) << "\"\n"
+            << "refAudioStrength=" << params.refAudioStrength << "\n";
+    if (!params.sourceAudioUrl.empty())
+        out << "sourceAudioUrl=\"" << escapeJsonString(params.sourceAudioUrl) << "\"\n"
+            << "audioCoverStrength=" << params.audioCoverStrength << "\n";
+    // Only when set, so entries cached before tempo requests existed keep their keys
+    if (params.bpm > 0) out << "bpm=" << params.bpm << "\n";
+    return out.str();
+}
+
+std::string generationCacheKey(const GenerateParams& params) {
+    const std::string text = canonicalGenerateParams(params);
+    uint64_t h = 14695981039346656037ull;
+    for (unsigned char c : text) {
+        h ^= c;
+        h *= 1099511628211ull;
+    }
+    char hex[17];
+    std::snprintf(hex, sizeof(hex), "%016llx", (unsigned long long)h);
+    return hex;
+}
+
+std::string AceForgeClient::startGeneration(const GenerateParams& params) {
+    std::string sd = escapeJsonString(params.songDescription);
+    std::string ly = escapeJsonString(params.lyrics);
+    std::string ti = escapeJsonString(params.title);
+    std::ostringstream json;
+    json << "{"
+         << "\"customMode\":false,"
+         << "\"songDescription\":\"" << sd << "\","
+         << "\"lyrics\":\"" << ly << "\","
+         << "\"instrumental\":" << (params.instrumental ? "true" : "false") << ","
+         << "\"duration\":" << params.durationSeconds << ","
+         << "\"inferenceSteps\":" << params.inferenceSteps << ","
+         << "\"guidanceScale\":" << params.guidanceScale << ","
+         << "\"randomSeed\":" << (params.randomSeed ? "true" : "false") << ","
+         << "\"seed\":" << params.seed << ","
+         << "\"taskType\":\"" << params.taskType << "\","
+         << "\"title\":\"" << ti << "\"";
+    if (!params.referenceAudioUrl.empty()) {
+        json << ",\"referenceAudioUrl\":\"" << escapeJsonString(params.referenceAudioUrl) << "\"";
+        json << ",\"ref_audio_strength\":" << params.refAudioStrength;
+    }
+    if (!params.sourceAudioUrl.empty()) {
+        json << ",\"sourceAudioUrl\":\"" << escapeJsonString(params.sourceAudioUrl) << "\"";
+        json << ",\"audioCoverStrength\":" << params.audioCoverStrength;
+    }
+    if (params.bpm > 0) json << ",\"bpm\":" << params.bpm;
+    json << "}";
+    std::string body = post("/api/generate", json.str());
+    if (body.empty()) return {};
+    JobStatus started;
+    if (!parseStartResponse(body, started) || started.jobId.empty()) { lastError_ = "No jobId in response"; return {}; }
+    return started.jobId;
+}
+
+JobStatus AceForgeClient::getStatus(const std::string& jobId) {
+    JobStatus out;
+    out.jobId = jobId;
+    std::string body = get("/api/generate/status/" + jobId);
+    if (body.empty()) return out;
+    if (!parseJobStatus(body, out) || out.status.empty()) {
+        // Not a status (an HTML error page, another API): no answer, so a wait gives up instead of spinning
+        lastError_ = "Malformed status response";
+        out = JobStatus();
+        out.jobId = jobId;
+    }
+    return out;
+}
+
+ProgressInfo AceForgeClient::getProgress() {
+    ProgressInfo out;
+    std::string body = get("/progress");
+    if (body.empty()) return out;
+    if (!parseProgressInfo(body, out)) lastError_ = "Malformed progress response";
+    return out;
+}
+
+bool AceForgeClient::cancelJob(const std::string& jobId) {
+    post("/api/generate/cancel/" + jobId, "{}");
+    return lastError_.empty();
+}
+
+JobStatus AceForgeClient::waitForJob(const std::string& jobId, const JobUpdateCallback& onUpdate,
+                                     const CancellationToken* token) {
+    TokenScope scope(*this, token);
+    JobStatus last;
+    last.jobId = jobId;
+    bool stopped = false;
+    if (!eventsUnsupported_) {
+        if (!subscribeJobEvents(jobId, onUpdate, last, stopped) && !stopped && !stopReason())
+            last = pollJob(jobId, onUpdate, last);
+    } else {
+        last = pollJob(jobId, onUpdate, last);
+    }
+    if (const char* reason = stopReason()) lastError_ = reason;
+    return last;
+}
+
+bool AceForgeClient::followJobEvents(const std::string& jobId, const JobUpdateCallback& onUpdate, JobStatus& last,
+                                     const CancellationToken* token) {
+    TokenScope scope(*this, token);
+    bool stopped = false;
+    const bool finished = !eventsUnsupported_ && subscribeJobEvents(jobId, onUpdate, last, stopped);
+    if (const char* reason = stopReason()) lastError_ = reason;
+    return finished || stopped;
+}
+
+bool AceForgeClient::subscribeJobEvents(const std::string& jobId, const JobUpdateCallback& onUpdate,
+                                        JobStatus& last, bool& stopped) {
+    std::string pending;  // received text not yet split into lines
+    std::string data;     // data: lines of the event being assembled
+    ProgressInfo progress;
+    bool finished = false;
+    auto dispatch = [&]() {
+        if (data.empty()) return true;
+        // Each event is a full snapshot; only the status is carried over for progress-only events
+        JobStatus next;
+        next.jobId = jobId;
+        next.status = last.status;
+        parseJobEvent(data, next, progress);
+        last = next;
+        data.clear();
+        if (!onUpdate(last, progress)) { stopped = true; return false; }
+        if (last.isFinished()) { finished = true; return false; }
+        return true;
+    };
+    bool ok = getStream("/api/generate/events/" + jobId, [&](const uint8_t* bytes, size_t n) {
+        pending.append((const char*)bytes, n);
+        size_t start = 0, nl;
+        while ((nl = pending.find('\n', start)) != std::string::npos) {
+            size_t end = nl > start && pending[nl - 1] == '\r' ? nl - 1 : nl;
+            if (end == start) {
+                if (!dispatch()) return false;
+            } else if (pending.compare(start, 5, "data:") == 0) {
+                size_t v = start + 5;
+                if (v < end && pending[v] == ' ') ++v;
+                if (!data.empty()) data += '\n';
+                data.append(pending, v, end - v);
+            }
+            // Comments (":") and event:/id:/retry: fields carry nothing we need
+            start = nl + 1;
+        }
+        pending.erase(0, start);
+        return true;
+    });
+    if (finished || stopped) {
+        lastError_.clear();
+        return finished;
+    }
+    if (!ok && lastError_ == "HTTP 404") eventsUnsupported_ = true;
+    if (stopReason()) stopped = true;
+    return false;
+}
+
+// Poll fast when the job is about to finish (so the audio fetch starts without dead time) and slowly while it
+// waits deep in the queue. Without an ETA, back off while nothing changes.
+int nextPollDelayMs(const JobStatus& st, bool changed, int& backoffMs) {
+    constexpr int kMinMs = 100, kMaxMs = 2000;
+    backoffMs = changed ? kMinMs : std::min(backoffMs * 3 / 2, 1000);
+    if (st.etaSeconds > 0)
+        return std::max(kMinMs, std::min(kMaxMs, (int)(st.etaSeconds * 250.0)));
+    if (st.status == "queued" && st.queuePosition > 1)
+        return std::max(500, std::min(3000, st.queuePosition * 500));
+    return backoffMs;
+}
+
+bool statusPollGivesUp(const std::string& error, int failures) {
+    return error == "HTTP 404" || failures >= kMaxStatusFailures;
+}
+
+JobStatus statusLost(JobStatus last, const std::string& error) {
+    last.status = "failed";
+    last.error = "Lost contact with the job (" + (error.empty() ? std::string("no answer") : error) + ")";
+    return last;
+}
+
+JobStatus AceForgeClient::pollJob(const std::string& jobId, const JobUpdateCallback& onUpdate, JobStatus last) {
+    ProgressInfo progress;
+    int backoffMs = 100;
+    int failures = 0;
+    for (;;) {
+        if (stopReason()) return last;
+        JobStatus st = getStatus(jobId);
+        if (st.status.empty()) {
+            // Transport error: keep the last known state and retry, but not forever (server gone, job unknown)
+            if (stopReason()) return last;
+            if (statusPollGivesUp(lastError_, ++failures)) return statusLost(last, lastError_);
+            st.status = last.status;
+        } else {
+            failures = 0;
+        }
+        const int previousStep = progress.current;
+        if (st.status == "running") parseProgressInfo(get("/progress"), progress);
+        if (!onUpdate(st, progress) || st.isFinished()) return st;
+        const bool changed = st.status != last.status || st.queuePosition != last.queuePosition
+                             || progress.current != previousStep;
+        last = st;
+        // Sleep in short slices so abort() or a cancelled token does not wait out a long poll interval
+        constexpr int kSliceMs = 50;
+        for (int ms = nextPollDelayMs(st, changed, backoffMs); ms > 0 && !stopReason(); ms -= kSliceMs)
+            std::this_thread::sleep_for(std::chrono::milliseconds(std::min(ms, kSliceMs)));
+    }
+}
+
+} // namespace aceforge
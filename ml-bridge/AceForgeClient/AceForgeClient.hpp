@@ -3,14 +3,18 @@
  * Talks to AceForge API (e.g. http://127.0.0.1:5056) for generation and audio.
  *
  * Use from a background thread; do not call from the audio/render thread.
- * After fetchAudio(), decode WAV and feed a lock-free queue for playback.
+ * After fetchAudio(), decode WAV and feed a lock-free queue for playback; or use
+ * fetchAudioStream() to decode while the file is still downloading.
  */
 #ifndef ACEFORGE_CLIENT_HPP
 #define ACEFORGE_CLIENT_HPP
 
 #include <string>
 #include <vector>
+#include <atomic>
 #include <functional>
+#include <memory>
+#include <mutex>
 #include <cstdint>
 
 namespace aceforge {
@@ -30,16 +34,34 @@ struct GenerateParams {
     std::string sourceAudioUrl;
     float audioCoverStrength = 0.5f;
     float refAudioStrength = 0.5f;
+    int bpm = 0;  // requested tempo; 0 leaves it to the model (sent as null)
 };
 
+/**
+ * Canonical text of every field that shapes the generated audio (all but title): fixed field order,
+ * locale-independent numbers, unused reference/source fields left out. Equal requests give identical text.
+ */
+std::string canonicalGenerateParams(const GenerateParams& params);
+
+/** Content address of a request: FNV-1a 64 of canonicalGenerateParams(), as 16 hex digits. */
+std::string generationCacheKey(const GenerateParams& params);
+
+/** Only fixed-seed requests reproduce their audio, so only those are worth caching. */
+inline bool isDeterministic(const GenerateParams& params) { return !params.randomSeed; }
+
 struct JobStatus {
     std::string jobId;
-    std::string status;  // "queued" | "running" | "succeeded" | "failed"
+    std::string status;  // "queued" | "running" | "succeeded" | "failed" | "cancelled"
     int queuePosition = 0;
     double etaSeconds = 0;
     std::string error;
     std::string audioUrl;   // from result.audioUrls[0] when succeeded
-    double durationSeconds = 0;
+    std::vector<std::string> audioUrls;  // result.audioUrls
+    double durationSeconds = 0;          // result.duration
+    double bpm = 0;                      // result.bpm (0 when null)
+    std::string keyScale;                // result.keyScale
+
+    bool isFinished() const { return status == "succeeded" || status == "failed" || status == "cancelled"; }
 };
 
 struct ProgressInfo {
@@ -51,8 +73,60 @@ struct ProgressInfo {
     int total = 0;
 };
 
+/**
+ * Delay before the next status poll of a job that reported st: short when its ETA is near, long deep in the queue,
+ * otherwise a backoff (carried in backoffMs, start at 100) that grows while nothing changed since the last poll.
+ */
+int nextPollDelayMs(const JobStatus& st, bool changed, int& backoffMs);
+
+/** Status polls in a row that may go unanswered before a wait gives the job up. */
+constexpr int kMaxStatusFailures = 10;
+
+/**
+ * Whether a wait gives a job up after its failures-th unanswered status poll in a row, which failed with error
+ * (lastError()): at once on "HTTP 404" (the server does not know the job, e.g. it restarted), otherwise after
+ * kMaxStatusFailures. The wait then ends with statusLost().
+ */
+bool statusPollGivesUp(const std::string& error, int failures);
+
+/** last turned into a finished "failed" status whose error says the job was lost and why. */
+JobStatus statusLost(JobStatus last, const std::string& error);
+
+class AceForgeClient;
+
+/**
+ * Stops one job's blocking calls from any thread without poisoning the client that runs them.
+ * cancel() interrupts the request in flight on every client currently waiting with this token
+ * (waitForJob, fetchAudioStream) and makes those calls return with lastError() "Cancelled".
+ * Calls made without the token keep working, so the worker can still tell the server (cancelJob).
+ * Cancellation is sticky; use one token per job.
+ */
+class CancellationToken {
+public:
+    CancellationToken() = default;
+    CancellationToken(const CancellationToken&) = delete;
+    CancellationToken& operator=(const CancellationToken&) = delete;
+
+    void cancel();
+    bool isCancelled() const { return cancelled_.load(); }
+
+private:
+    friend class AceForgeClient;
+    void attach(AceForgeClient* client) const;
+    void detach(AceForgeClient* client) const;
+
+    std::atomic<bool> cancelled_{ false };
+    mutable std::mutex lock_;
+    mutable std::vector<AceForgeClient*> clients_;  // clients blocked in a call with this token
+};
+
 class AceForgeClient {
 public:
+    /** Receives response body bytes as they arrive; return false to abort the transfer. */
+    using ChunkCallback = std::function<bool(const uint8_t* data, size_t size)>;
+    /** Job updates from waitForJob(); return false to stop waiting. */
+    using JobUpdateCallback = std::function<bool(const JobStatus& status, const ProgressInfo& progress)>;
+
     explicit AceForgeClient(std::string baseUrl = "http://127.0.0.1:5056");
     ~AceForgeClient();
 
@@ -65,24 +139,100 @@ public:
     /** POST /api/generate; returns jobId or empty on error */
     std::string startGeneration(const GenerateParams& params);
 
-    /** GET /api/generate/status/<jobId> */
+    /**
+     * GET /api/generate/status/<jobId>. status is empty when the server did not answer or sent a body that is no
+     * job status (lastError() says which); waits count both as unanswered polls.
+     */
     JobStatus getStatus(const std::string& jobId);
 
     /** GET /progress (optional) */
     ProgressInfo getProgress();
 
+    /**
+     * POST /api/generate/cancel/<jobId>: removes a queued job from the server queue or stops a running one.
+     * Returns false (lastError() set) on error, e.g. "HTTP 404" from servers without the endpoint.
+     */
+    bool cancelJob(const std::string& jobId);
+
+    /**
+     * Blocks until jobId finishes (or onUpdate returns false, or token is cancelled) and returns the last status.
+     * Subscribes to GET /api/generate/events/<jobId> (server-sent events) when the server offers it;
+     * otherwise polls status at an interval derived from etaSeconds/queuePosition, plus /progress while running.
+     * Only stops waiting locally on cancel; the caller decides whether to cancelJob() on the server.
+     */
+    JobStatus waitForJob(const std::string& jobId, const JobUpdateCallback& onUpdate,
+                         const CancellationToken* token = nullptr);
+
+    /**
+     * The event half of waitForJob(), for callers that poll elsewhere (AceForgeSession): follows jobId over its
+     * event stream, starting from last, and returns true when that ended the wait (job finished, onUpdate returned
+     * false, token cancelled). Returns false with last holding the latest event when the stream was unavailable or
+     * broke off; eventsUnsupported() then tells whether the server has no events endpoint.
+     */
+    bool followJobEvents(const std::string& jobId, const JobUpdateCallback& onUpdate, JobStatus& last,
+                         const CancellationToken* token = nullptr);
+    bool eventsUnsupported() const { return eventsUnsupported_; }
+
     /** GET <base>/audio/<path> or /audio/refs/<path>; returns raw bytes (WAV) */
     std::vector<uint8_t> fetchAudio(const std::string& path);
 
+    /**
+     * Same request as fetchAudio(), but hands each received block to onChunk instead of
+     * buffering the whole file. Returns false on HTTP/transport error, when onChunk aborted
+     * or when token was cancelled.
+     */
+    bool fetchAudioStream(const std::string& path, const ChunkCallback& onChunk,
+                          const CancellationToken* token = nullptr);
+
     /** Last HTTP or parse error message */
     std::string lastError() const { return lastError_; }
 
+    /**
+     * Callable from any thread: interrupts the request in flight on this client (including an event stream or an
+     * audio download), makes waitForJob() return, and fails every later call at once with lastError() "Aborted"
+     * until resetAbort(). Used to stop a worker that is blocked in the client.
+     */
+    void abort();
+    void resetAbort() { aborted_.store(false); }
+    bool isAborted() const { return aborted_.load(); }
+
 private:
+    friend class CancellationToken;
+
+    // Platform transport state (NSURLSession on macOS, keep-alive socket pool elsewhere)
+    struct Transport;
+
+    /** Binds a token to the calling thread's call for its lifetime (see CancellationToken). */
+    class TokenScope {
+    public:
+        TokenScope(AceForgeClient& client, const CancellationToken* token);
+        ~TokenScope();
+        TokenScope(const TokenScope&) = delete;
+        TokenScope& operator=(const TokenScope&) = delete;
+
+    private:
+        AceForgeClient& client_;
+        const CancellationToken* token_;
+    };
+
     std::string base_;
     std::string lastError_;
-
+    std::unique_ptr<Transport> transport_;
+    bool eventsUnsupported_ = false;  // set after the events endpoint returned 404 for this base URL
+    std::atomic<bool> aborted_{ false };
+    const CancellationToken* token_ = nullptr;  // only touched by the thread making the call
+
+    /** "Aborted" or "Cancelled" once the current call should give up, else nullptr. */
+    const char* stopReason() const;
+    /** Interrupts whatever request is in flight without changing state (abort() and CancellationToken). */
+    void interruptTransport();
     std::string get(const std::string& path);
     std::string post(const std::string& path, const std::string& jsonBody);
+    /** GET with the body delivered incrementally (audio downloads, event streams). */
+    bool getStream(const std::string& path, const ChunkCallback& onChunk);
+
+    bool subscribeJobEvents(const std::string& jobId, const JobUpdateCallback& onUpdate, JobStatus& last, bool& stopped);
+    JobStatus pollJob(const std::string& jobId, const JobUpdateCallback& onUpdate, JobStatus last);
 };
 
 } // namespace aceforge
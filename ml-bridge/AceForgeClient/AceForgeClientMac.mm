@@ -1,5 +1,6 @@
 /**
- * AceForgeClient implementation for macOS using NSURLSession (synchronous).
+ * AceForgeClient transport for macOS using NSURLSession (synchronous).
+ * Request bodies and response parsing are shared with other platforms in AceForgeClient.cpp.
  * Compile as Objective-C++: clang++ -x objective-c++ -framework Foundation -framework Security ...
  */
 #ifdef __APPLE__
@@ -7,7 +8,7 @@
 #include "AceForgeClient.hpp"
 #include <Foundation/Foundation.h>
 #include <algorithm>
-#include <sstream>
+#include <mutex>
 
 static std::string nsstringToStd(NSString* s) {
     if (!s) return {};
@@ -19,6 +20,50 @@ static NSString* stdToNSString(const std::string& s) {
     return [NSString stringWithUTF8String:s.c_str()];
 }
 
+// Data delegate for fetchAudioStream(): forwards each received NSData block to the C++ callback
+// on the session's delegate queue and signals `done` when the task completes.
+@interface AceForgeStreamDelegate : NSObject <NSURLSessionDataDelegate> {
+@public
+    const aceforge::AceForgeClient::ChunkCallback* onChunk;
+    dispatch_semaphore_t done;
+    NSInteger statusCode;
+    bool aborted;
+    std::string error;
+}
+@end
+
+@implementation AceForgeStreamDelegate
+- (void)URLSession:(NSURLSession*)session
+          dataTask:(NSURLSessionDataTask*)dataTask
+didReceiveResponse:(NSURLResponse*)response
+ completionHandler:(void (^)(NSURLSessionResponseDisposition))completionHandler {
+    statusCode = [response isKindOfClass:[NSHTTPURLResponse class]] ? [(NSHTTPURLResponse*)response statusCode] : 200;
+    completionHandler(statusCode >= 400 ? NSURLSessionResponseCancel : NSURLSessionResponseAllow);
+}
+
+- (void)URLSession:(NSURLSession*)session dataTask:(NSURLSessionDataTask*)dataTask didReceiveData:(NSData*)data {
+    if (aborted) return;
+    __block bool keepGoing = true;
+    const aceforge::AceForgeClient::ChunkCallback* cb = onChunk;
+    [data enumerateByteRangesUsingBlock:^(const void* bytes, NSRange range, BOOL* stop) {
+        if (!(*cb)((const uint8_t*)bytes, (size_t)range.length)) {
+            keepGoing = false;
+            *stop = YES;
+        }
+    }];
+    if (!keepGoing) {
+        aborted = true;
+        [dataTask cancel];
+    }
+}
+
+- (void)URLSession:(NSURLSession*)session task:(NSURLSessionTask*)task didCompleteWithError:(NSError*)err {
+    if (err && !aborted && statusCode < 400)
+        error = nsstringToStd([err localizedDescription]);
+    dispatch_semaphore_signal(done);
+}
+@end
+
 namespace aceforge {
 
 static std::string trimPath(const std::string& path) {
@@ -27,27 +72,62 @@ static std::string trimPath(const std::string& path) {
     return path.substr(start);
 }
 
-AceForgeClient::AceForgeClient(std::string baseUrl) : base_(std::move(baseUrl)) {
+// NSURLSession keeps its own connection cache; the transport only tracks running tasks so abort() can cancel them.
+struct AceForgeClient::Transport {
+    std::mutex lock;
+    std::vector<void*> tasks;  // unretained: each request keeps its task alive until it has called remove()
+
+    /** Registers a task before it is resumed; cancels it right away if the client was stopped meanwhile. */
+    void add(NSURLSessionTask* task, const AceForgeClient& client) {
+        {
+            std::lock_guard<std::mutex> l(lock);
+            tasks.push_back((__bridge void*)task);
+        }
+        if (client.stopReason()) [task cancel];
+    }
+
+    void remove(NSURLSessionTask* task) {
+        std::lock_guard<std::mutex> l(lock);
+        tasks.erase(std::remove(tasks.begin(), tasks.end(), (__bridge void*)task), tasks.end());
+    }
+
+    void cancelAll() {
+        std::lock_guard<std::mutex> l(lock);
+        for (void* task : tasks) [(__bridge NSURLSessionTask*)task cancel];
+    }
+
+    void performRequestCopyBody(const AceForgeClient& client, NSURLRequest* request, std::string* outBody,
+                                NSHTTPURLResponse** outResponse, NSError** outError);
+};
+
+AceForgeClient::AceForgeClient(std::string baseUrl)
+    : base_(std::move(baseUrl)), transport_(std::make_unique<Transport>()) {
     while (!base_.empty() && base_.back() == '/') base_.pop_back();
 }
 
 AceForgeClient::~AceForgeClient() = default;
 
-void AceForgeClient::setBaseUrl(const std::string& url) {
-    base_ = url;
-    while (!base_.empty() && base_.back() == '/') base_.pop_back();
+void AceForgeClient::interruptTransport() {
+    transport_->cancelAll();
 }
 
-std::string AceForgeClient::getBaseUrl() const { return base_; }
+void AceForgeClient::setBaseUrl(const std::string& url) {
+    std::string next = url;
+    while (!next.empty() && next.back() == '/') next.pop_back();
+    if (next != base_) eventsUnsupported_ = false;
+    base_ = std::move(next);
+}
 
 // Perform request and copy response body into a __block buffer so we never use NSData* after the block.
-static void performRequestCopyBody(NSURLRequest* request, std::string* outBody, NSHTTPURLResponse** outResponse, NSError** outError) {
+void AceForgeClient::Transport::performRequestCopyBody(const AceForgeClient& client, NSURLRequest* request,
+                                                       std::string* outBody, NSHTTPURLResponse** outResponse,
+                                                       NSError** outError) {
     dispatch_semaphore_t sem = dispatch_semaphore_create(0);
     __block std::string body;
     __block NSHTTPURLResponse* resultResp = nil;
     __block NSError* resultErr = nil;
     NSURLSession* session = [NSURLSession sharedSession];
-    [[session dataTaskWithRequest:request completionHandler:^(NSData* data, NSURLResponse* response, NSError* error) {
+    NSURLSessionDataTask* task = [session dataTaskWithRequest:request completionHandler:^(NSData* data, NSURLResponse* response, NSError* error) {
         resultResp = (NSHTTPURLResponse*)response;
         resultErr = error;
         if (data && [data length] > 0) {
@@ -56,8 +136,11 @@ static void performRequestCopyBody(NSURLRequest* request, std::string* outBody,
                 body.assign((const char*)[dataCopy bytes], (size_t)[dataCopy length]);
         }
         dispatch_semaphore_signal(sem);
-    }] resume];
+    }];
+    add(task, client);
+    [task resume];
     dispatch_semaphore_wait(sem, DISPATCH_TIME_FOREVER);
+    remove(task);
     if (outResponse) *outResponse = resultResp;
     if (outError) *outError = resultErr;
     if (outBody) *outBody = std::move(body);
@@ -65,6 +148,7 @@ static void performRequestCopyBody(NSURLRequest* request, std::string* outBody,
 
 std::string AceForgeClient::get(const std::string& path) {
     lastError_.clear();
+    if (const char* reason = stopReason()) { lastError_ = reason; return {}; }
     std::string urlStr = base_ + (path.empty() || path[0] != '/' ? "/" : "") + path;
     NSURL* url = [NSURL URLWithString:stdToNSString(urlStr)];
     if (!url) { lastError_ = "Invalid URL"; return {}; }
@@ -72,7 +156,11 @@ std::string AceForgeClient::get(const std::string& path) {
     NSError* err = nil;
     NSHTTPURLResponse* resp = nil;
     std::string body;
-    performRequestCopyBody(req, &body, &resp, &err);
+    transport_->performRequestCopyBody(*this, req, &body, &resp, &err);
+    if (const char* reason = stopReason()) {
+        lastError_ = reason;
+        return {};
+    }
     if (err) {
         lastError_ = nsstringToStd([err localizedDescription]);
         return {};
@@ -86,6 +174,7 @@ std::string AceForgeClient::get(const std::string& path) {
 
 std::string AceForgeClient::post(const std::string& path, const std::string& jsonBody) {
     lastError_.clear();
+    if (const char* reason = stopReason()) { lastError_ = reason; return {}; }
     std::string urlStr = base_ + (path.empty() || path[0] != '/' ? "/" : "") + path;
     NSURL* url = [NSURL URLWithString:stdToNSString(urlStr)];
     if (!url) { lastError_ = "Invalid URL"; return {}; }
@@ -96,7 +185,11 @@ std::string AceForgeClient::post(const std::string& path, const std::string& jso
     NSError* err = nil;
     NSHTTPURLResponse* resp = nil;
     std::string body;
-    performRequestCopyBody(req, &body, &resp, &err);
+    transport_->performRequestCopyBody(*this, req, &body, &resp, &err);
+    if (const char* reason = stopReason()) {
+        lastError_ = reason;
+        return {};
+    }
     if (err) {
         lastError_ = nsstringToStd([err localizedDescription]);
         return {};
@@ -108,112 +201,9 @@ std::string AceForgeClient::post(const std::string& path, const std::string& jso
     return body;
 }
 
-bool AceForgeClient::healthCheck() {
-    std::string body = get("/api/generate/health");
-    if (body.empty()) return false;
-    return body.find("\"healthy\":true") != std::string::npos;
-}
-
-static std::string escapeJsonString(const std::string& s) {
-    std::string out;
-    out.reserve(s.size() + 8);
-    for (char c : s) {
-        if (c == '"') out += "\\\"";
-        else if (c == '\\') out += "\\\\";
-        else if (c == '\n') out += "\\n";
-        else if (c == '\r') out += "\\r";
-        else if ((unsigned char)c >= 32) out += c;
-    }
-    return out;
-}
-
-std::string AceForgeClient::startGeneration(const GenerateParams& params) {
-    std::string sd = escapeJsonString(params.songDescription);
-    std::string ly = escapeJsonString(params.lyrics);
-    std::string ti = escapeJsonString(params.title);
-    std::ostringstream json;
-    json << "{"
-         << "\"customMode\":false,"
-         << "\"songDescription\":\"" << sd << "\","
-         << "\"lyrics\":\"" << ly << "\","
-         << "\"instrumental\":" << (params.instrumental ? "true" : "false") << ","
-         << "\"duration\":" << params.durationSeconds << ","
-         << "\"inferenceSteps\":" << params.inferenceSteps << ","
-         << "\"guidanceScale\":" << params.guidanceScale << ","
-         << "\"randomSeed\":" << (params.randomSeed ? "true" : "false") << ","
-         << "\"seed\":" << params.seed << ","
-         << "\"taskType\":\"" << params.taskType << "\","
-         << "\"title\":\"" << ti << "\"";
-    if (!params.referenceAudioUrl.empty()) {
-        json << ",\"referenceAudioUrl\":\"" << escapeJsonString(params.referenceAudioUrl) << "\"";
-        json << ",\"ref_audio_strength\":" << params.refAudioStrength;
-    }
-    if (!params.sourceAudioUrl.empty()) {
-        json << ",\"sourceAudioUrl\":\"" << escapeJsonString(params.sourceAudioUrl) << "\"";
-        json << ",\"audioCoverStrength\":" << params.audioCoverStrength;
-    }
-    json << "}";
-    std::string body = post("/api/generate", json.str());
-    if (body.empty()) return {};
-    // Parse jobId: "jobId":"<uuid>"
-    size_t pos = body.find("\"jobId\"");
-    if (pos == std::string::npos) { lastError_ = "No jobId in response"; return {}; }
-    pos = body.find(':', pos);
-    if (pos == std::string::npos) return {};
-    pos = body.find('"', pos);
-    if (pos == std::string::npos) return {};
-    size_t end = body.find('"', pos + 1);
-    if (end == std::string::npos) return {};
-    return body.substr(pos + 1, end - (pos + 1));
-}
-
-JobStatus AceForgeClient::getStatus(const std::string& jobId) {
-    JobStatus out;
-    out.jobId = jobId;
-    std::string body = get("/api/generate/status/" + jobId);
-    if (body.empty()) return out;
-    out.status = "unknown";
-    if (body.find("\"status\"") != std::string::npos) {
-        size_t p = body.find("\"status\"");
-        p = body.find('"', body.find(':', p) + 1);
-        size_t e = body.find('"', p + 1);
-        if (p != std::string::npos && e != std::string::npos)
-            out.status = body.substr(p + 1, e - (p + 1));
-    }
-    if (body.find("\"error\"") != std::string::npos) {
-        size_t p = body.find("\"error\"");
-        p = body.find('"', body.find(':', p) + 1);
-        size_t e = body.find('"', p + 1);
-        if (p != std::string::npos && e != std::string::npos)
-            out.error = body.substr(p + 1, e - (p + 1));
-    }
-    if (out.status == "succeeded" && body.find("\"audioUrls\"") != std::string::npos) {
-        size_t p = body.find("[", body.find("\"audioUrls\""));
-        size_t q = body.find('"', p);
-        size_t r = body.find('"', q + 1);
-        if (q != std::string::npos && r != std::string::npos)
-            out.audioUrl = body.substr(q + 1, r - (q + 1));
-    }
-    return out;
-}
-
-ProgressInfo AceForgeClient::getProgress() {
-    ProgressInfo out;
-    std::string body = get("/progress");
-    if (body.empty()) return out;
-    // fraction
-    size_t p = body.find("\"fraction\"");
-    if (p != std::string::npos) {
-        p = body.find(':', p);
-        if (p != std::string::npos) out.fraction = (float)atof(body.c_str() + p + 1);
-    }
-    p = body.find("\"done\"");
-    if (p != std::string::npos) out.done = body.find("true", p) < body.find("false", p) || body.find("false", p) == std::string::npos;
-    return out;
-}
-
 std::vector<uint8_t> AceForgeClient::fetchAudio(const std::string& path) {
     lastError_.clear();
+    if (const char* reason = stopReason()) { lastError_ = reason; return {}; }
     std::string p = trimPath(path);
     std::string urlStr = base_ + "/" + p;
     NSURL* url = [NSURL URLWithString:stdToNSString(urlStr)];
@@ -224,7 +214,7 @@ std::vector<uint8_t> AceForgeClient::fetchAudio(const std::string& path) {
     __block std::vector<uint8_t> out;
     dispatch_semaphore_t sem = dispatch_semaphore_create(0);
     NSURLSession* session = [NSURLSession sharedSession];
-    [[session dataTaskWithRequest:req completionHandler:^(NSData* data, NSURLResponse* response, NSError* error) {
+    NSURLSessionDataTask* task = [session dataTaskWithRequest:req completionHandler:^(NSData* data, NSURLResponse* response, NSError* error) {
         resp = (NSHTTPURLResponse*)response;
         err = error;
         if (data && [data length] > 0) {
@@ -236,8 +226,15 @@ std::vector<uint8_t> AceForgeClient::fetchAudio(const std::string& path) {
             }
         }
         dispatch_semaphore_signal(sem);
-    }] resume];
+    }];
+    transport_->add(task, *this);
+    [task resume];
     dispatch_semaphore_wait(sem, DISPATCH_TIME_FOREVER);
+    transport_->remove(task);
+    if (const char* reason = stopReason()) {
+        lastError_ = reason;
+        return {};
+    }
     if (err) {
         lastError_ = nsstringToStd([err localizedDescription]);
         return {};
@@ -249,6 +246,54 @@ std::vector<uint8_t> AceForgeClient::fetchAudio(const std::string& path) {
     return out;
 }
 
+bool AceForgeClient::fetchAudioStream(const std::string& path, const ChunkCallback& onChunk,
+                                      const CancellationToken* token) {
+    TokenScope scope(*this, token);
+    return getStream("/" + trimPath(path), onChunk);
+}
+
+bool AceForgeClient::getStream(const std::string& path, const ChunkCallback& onChunk) {
+    lastError_.clear();
+    if (const char* reason = stopReason()) { lastError_ = reason; return false; }
+    std::string urlStr = base_ + (path.empty() || path[0] != '/' ? "/" : "") + path;
+    NSURL* url = [NSURL URLWithString:stdToNSString(urlStr)];
+    if (!url) { lastError_ = "Invalid path"; return false; }
+    AceForgeStreamDelegate* delegate = [[AceForgeStreamDelegate alloc] init];
+    delegate->onChunk = &onChunk;
+    delegate->done = dispatch_semaphore_create(0);
+    delegate->statusCode = 0;
+    delegate->aborted = false;
+    // A delegate-based session is needed to see data as it arrives; the session retains the delegate until invalidated.
+    // Event streams may stay quiet for a long time while a job is queued, so allow long gaps between packets.
+    NSURLSessionConfiguration* config = [NSURLSessionConfiguration defaultSessionConfiguration];
+    config.timeoutIntervalForRequest = 120;
+    NSURLSession* session = [NSURLSession sessionWithConfiguration:config delegate:delegate delegateQueue:nil];
+    NSURLSessionDataTask* task = [session dataTaskWithRequest:[NSURLRequest requestWithURL:url]];
+    transport_->add(task, *this);
+    [task resume];
+    dispatch_semaphore_wait(delegate->done, DISPATCH_TIME_FOREVER);
+    transport_->remove(task);
+    [session finishTasksAndInvalidate];
+    bool ok = true;
+    if (const char* reason = stopReason()) {
+        lastError_ = reason;
+        ok = false;
+    } else if (delegate->statusCode >= 400) {
+        lastError_ = "HTTP " + std::to_string((int)delegate->statusCode);
+        ok = false;
+    } else if (delegate->aborted) {
+        lastError_ = "Aborted";
+        ok = false;
+    } else if (!delegate->error.empty()) {
+        lastError_ = delegate->error;
+        ok = false;
+    }
+#if !__has_feature(objc_arc)
+    [delegate release];
+#endif
+    return ok;
+}
+
 } // namespace aceforge
 
 #endif // __APPLE__
@@ -0,0 +1,527 @@
+/**
+ * AceForgeClient transport for Linux (and other POSIX hosts) using plain sockets.
+ * Speaks HTTP/1.1 and keeps a small pool of keep-alive connections per client, so
+ * health and status polls reuse an open TCP connection instead of connecting each time.
+ * Only http:// base URLs are supported (AceForge runs locally).
+ */
+#ifndef __APPLE__
+
+#include "AceForgeClient.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+namespace aceforge {
+
+namespace {
+
+constexpr int kConnectTimeoutMs = 5000;
+constexpr int kIoTimeoutMs = 30000;
+constexpr size_t kMaxIdleConnections = 4;
+
+std::string trimPath(const std::string& path) {
+    auto start = path.find_first_not_of('/');
+    if (start == std::string::npos) return path;
+    return path.substr(start);
+}
+
+std::string toLower(std::string s) {
+    for (char& c : s)
+        if (c >= 'A' && c <= 'Z') c = (char)(c - 'A' + 'a');
+    return s;
+}
+
+#ifdef MSG_NOSIGNAL
+constexpr int kSendFlags = MSG_NOSIGNAL;
+#else
+constexpr int kSendFlags = 0;
+#endif
+
+/** Buffered reader/writer over one connected socket. */
+class Connection {
+public:
+    explicit Connection(int fd) : fd_(fd) {}
+    ~Connection() { close(); }
+    Connection(const Connection&) = delete;
+    Connection& operator=(const Connection&) = delete;
+
+    int fd() const { return fd_; }
+    int release() { int fd = fd_; fd_ = -1; return fd; }
+    void close() { if (fd_ >= 0) ::close(fd_); fd_ = -1; }
+
+    /** Bytes received from the socket so far (used to decide whether a reused connection may be retried). */
+    size_t bytesReceived() const { return received_; }
+    /** True when bytes past the current response are already buffered (pipelining; never reuse then). */
+    bool hasBufferedBytes() const { return rpos_ < rbuf_.size(); }
+
+    bool writeAll(const char* data, size_t size) {
+        while (size > 0) {
+            ssize_t n = ::send(fd_, data, size, kSendFlags);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            data += n;
+            size -= (size_t)n;
+        }
+        return true;
+    }
+
+    /** Reads a CRLF- or LF-terminated line (terminator stripped). */
+    bool readLine(std::string& line) {
+        line.clear();
+        for (;;) {
+            const char* begin = rbuf_.data() + rpos_;
+            const char* end = rbuf_.data() + rbuf_.size();
+            const char* nl = std::find(begin, end, '\n');
+            if (nl != end) {
+                line.append(begin, nl);
+                rpos_ += (size_t)(nl - begin) + 1;
+                if (!line.empty() && line.back() == '\r') line.pop_back();
+                return true;
+            }
+            line.append(begin, end);
+            rpos_ = rbuf_.size();
+            if (line.size() > 64 * 1024) return false;
+            if (fill() <= 0) return false;
+        }
+    }
+
+    /**
+     * Reads up to maxBytes body bytes, from the buffer first, then the socket.
+     * Returns bytes read, 0 on orderly close, -1 on error.
+     */
+    ssize_t readSome(char* dst, size_t maxBytes) {
+        if (rpos_ < rbuf_.size()) {
+            size_t n = std::min(maxBytes, rbuf_.size() - rpos_);
+            std::memcpy(dst, rbuf_.data() + rpos_, n);
+            rpos_ += n;
+            return (ssize_t)n;
+        }
+        return readSomeRaw(dst, maxBytes);
+    }
+
+private:
+    ssize_t fill() {
+        if (rpos_ == rbuf_.size()) { rbuf_.clear(); rpos_ = 0; }
+        char tmp[16 * 1024];
+        ssize_t n = readSomeRaw(tmp, sizeof(tmp));
+        if (n > 0) rbuf_.append(tmp, (size_t)n);
+        return n;
+    }
+
+    ssize_t readSomeRaw(char* dst, size_t maxBytes) {
+        for (;;) {
+            ssize_t n = ::recv(fd_, dst, maxBytes, 0);
+            if (n < 0 && errno == EINTR) continue;
+            if (n > 0) received_ += (size_t)n;
+            return n;
+        }
+    }
+
+    int fd_ = -1;
+    std::string rbuf_;
+    size_t rpos_ = 0;
+    size_t received_ = 0;
+};
+
+void setIoTimeouts(int fd, int timeoutMs) {
+    timeval tv{};
+    tv.tv_sec = timeoutMs / 1000;
+    tv.tv_usec = (timeoutMs % 1000) * 1000;
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+}
+
+/** Non-blocking connect with timeout; returns a blocking socket or -1 (errorOut set). */
+int connectTo(const std::string& host, const std::string& port, std::string& errorOut) {
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* res = nullptr;
+    int rc = getaddrinfo(host.c_str(), port.c_str(), &hints, &res);
+    if (rc != 0) {
+        errorOut = std::string("Cannot resolve ") + host + ": " + gai_strerror(rc);
+        return -1;
+    }
+    int fd = -1;
+    std::string lastFailure = "Cannot connect to " + host + ":" + port;
+    for (addrinfo* ai = res; ai != nullptr; ai = ai->ai_next) {
+        fd = ::socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (fd < 0) continue;
+        int flags = fcntl(fd, F_GETFL, 0);
+        fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+        int r = ::connect(fd, ai->ai_addr, ai->ai_addrlen);
+        if (r < 0 && errno == EINPROGRESS) {
+            pollfd pfd{ fd, POLLOUT, 0 };
+            r = -1;
+            if (::poll(&pfd, 1, kConnectTimeoutMs) == 1) {
+                int soErr = 0;
+                socklen_t len = sizeof(soErr);
+                if (getsockopt(fd, SOL_SOCKET, SO_ERROR, &soErr, &len) == 0 && soErr == 0)
+                    r = 0;
+                else
+                    errno = soErr;
+            } else {
+                errno = ETIMEDOUT;
+            }
+        }
+        if (r == 0) {
+            fcntl(fd, F_SETFL, flags);
+            int one = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+#ifdef SO_NOSIGPIPE
+            setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+            setIoTimeouts(fd, kIoTimeoutMs);
+            break;
+        }
+        lastFailure = "Cannot connect to " + host + ":" + port + ": " + std::strerror(errno);
+        ::close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(res);
+    if (fd < 0) errorOut = lastFailure;
+    return fd;
+}
+
+/** An idle pooled socket is stale if the peer closed it (readable with EOF) or sent unsolicited data. */
+bool isIdleSocketUsable(int fd) {
+    pollfd pfd{ fd, POLLIN, 0 };
+    return ::poll(&pfd, 1, 0) == 0;
+}
+
+} // namespace
+
+struct AceForgeClient::Transport {
+    // Parsed from base_ by configure()
+    std::string host;
+    std::string port;
+    std::string hostHeader;
+    std::string pathPrefix;
+    std::string configError;
+
+    std::mutex poolLock;
+    std::vector<int> idle;
+
+    // Sockets with a request in flight; interrupt() shuts them down so a blocked recv() returns at once
+    std::mutex activeLock;
+    std::vector<int> active;
+
+    ~Transport() { closeIdle(); }
+
+    void configure(const std::string& baseUrl) {
+        closeIdle();
+        host.clear(); port.clear(); hostHeader.clear(); pathPrefix.clear(); configError.clear();
+        std::string rest = baseUrl;
+        const std::string scheme = "http://";
+        if (toLower(rest.substr(0, scheme.size())) == scheme) {
+            rest = rest.substr(scheme.size());
+        } else if (rest.find("://") != std::string::npos) {
+            configError = "Only http:// URLs are supported";
+            return;
+        }
+        size_t slash = rest.find('/');
+        std::string authority = rest.substr(0, slash);
+        if (slash != std::string::npos) pathPrefix = rest.substr(slash);
+        while (!pathPrefix.empty() && pathPrefix.back() == '/') pathPrefix.pop_back();
+        hostHeader = authority;
+        port = "80";
+        if (!authority.empty() && authority[0] == '[') {
+            size_t close = authority.find(']');
+            if (close == std::string::npos) { configError = "Invalid URL"; return; }
+            host = authority.substr(1, close - 1);
+            if (close + 1 < authority.size() && authority[close + 1] == ':') port = authority.substr(close + 2);
+        } else {
+            size_t colon = authority.rfind(':');
+            host = authority.substr(0, colon);
+            if (colon != std::string::npos) port = authority.substr(colon + 1);
+        }
+        if (host.empty() || port.empty()) configError = "Invalid URL";
+    }
+
+    void closeIdle() {
+        std::lock_guard<std::mutex> l(poolLock);
+        for (int fd : idle) ::close(fd);
+        idle.clear();
+    }
+
+    /** Pops a live idle socket, or returns -1 when the pool has none. */
+    int takeIdle() {
+        std::lock_guard<std::mutex> l(poolLock);
+        while (!idle.empty()) {
+            int fd = idle.back();
+            idle.pop_back();
+            if (isIdleSocketUsable(fd)) return fd;
+            ::close(fd);
+        }
+        return -1;
+    }
+
+    void giveBack(int fd) {
+        std::lock_guard<std::mutex> l(poolLock);
+        if (idle.size() < kMaxIdleConnections) idle.push_back(fd);
+        else ::close(fd);
+    }
+
+    void interrupt() {
+        std::lock_guard<std::mutex> l(activeLock);
+        for (int fd : active) ::shutdown(fd, SHUT_RDWR);
+    }
+
+    /** Registers fd as in flight for its lifetime; destroy it before the socket is closed. */
+    class ActiveRequest {
+    public:
+        ActiveRequest(Transport& t, int fd) : t_(t), fd_(fd) {
+            std::lock_guard<std::mutex> l(t_.activeLock);
+            t_.active.push_back(fd_);
+        }
+        ~ActiveRequest() {
+            std::lock_guard<std::mutex> l(t_.activeLock);
+            t_.active.erase(std::find(t_.active.begin(), t_.active.end(), fd_));
+        }
+        ActiveRequest(const ActiveRequest&) = delete;
+        ActiveRequest& operator=(const ActiveRequest&) = delete;
+
+    private:
+        Transport& t_;
+        int fd_;
+    };
+
+    using BodySink = std::function<bool(const char* data, size_t size)>;
+
+    /**
+     * Sends one request and streams the response body to sink. Reuses a pooled connection when one is
+     * available and retries once on a fresh connection if the reused one turns out to be closed: when the
+     * request could not be sent, or for a GET when no response byte arrived. A POST that was sent is never
+     * repeated, since the server may have acted on it (a second submit would queue the job twice). Returns false with errorOut set on transport or HTTP errors, or to the
+     * client's stopReason() once it is aborted or its token cancelled (both also call interrupt()).
+     */
+    bool request(const char* method, const std::string& path, const std::string* body,
+                 const BodySink& sink, const AceForgeClient& client, std::string& errorOut) {
+        if (!configError.empty()) { errorOut = configError; return false; }
+        for (int attempt = 0; attempt < 2; ++attempt) {
+            if (const char* reason = client.stopReason()) { errorOut = reason; return false; }
+            int fd = takeIdle();
+            const bool reused = fd >= 0;
+            if (!reused) fd = connectTo(host, port, errorOut);
+            if (fd < 0) return false;
+            Connection conn(fd);
+            ActiveRequest inFlight(*this, fd);
+            // abort() or cancel() may have run between the check above and registering the socket
+            if (const char* reason = client.stopReason()) { errorOut = reason; return false; }
+            bool retryable = false;
+            if (exchange(conn, method, path, body, sink, errorOut, retryable)) return true;
+            if (const char* reason = client.stopReason()) { errorOut = reason; return false; }
+            if (!(reused && retryable)) return false;
+        }
+        return false;
+    }
+
+private:
+    bool exchange(Connection& conn, const char* method, const std::string& path, const std::string* body,
+                  const BodySink& sink, std::string& errorOut, bool& retryable) {
+        std::string req;
+        req.reserve(256 + (body ? body->size() : 0));
+        req += method;
+        req += ' ';
+        req += pathPrefix;
+        req += path;
+        req += " HTTP/1.1\r\nHost: ";
+        req += hostHeader;
+        req += "\r\nUser-Agent: AceForgeBridge\r\nAccept: */*\r\nConnection: keep-alive\r\n";
+        if (body) {
+            req += "Content-Type: application/json\r\nContent-Length: ";
+            req += std::to_string(body->size());
+            req += "\r\n";
+        }
+        req += "\r\n";
+        if (body) req += *body;
+
+        if (!conn.writeAll(req.data(), req.size())) {
+            retryable = true;
+            errorOut = std::string("Send failed: ") + std::strerror(errno);
+            return false;
+        }
+
+        std::string line;
+        if (!conn.readLine(line)) {
+            retryable = conn.bytesReceived() == 0 && std::strcmp(method, "GET") == 0;
+            errorOut = "Connection closed before response";
+            return false;
+        }
+        // Status line: HTTP/1.1 200 OK
+        int statusCode = 0;
+        {
+            size_t sp = line.find(' ');
+            if (line.compare(0, 5, "HTTP/") != 0 || sp == std::string::npos) {
+                errorOut = "Malformed HTTP response";
+                return false;
+            }
+            statusCode = std::atoi(line.c_str() + sp + 1);
+        }
+        bool keepAlive = line.compare(0, 8, "HTTP/1.1") == 0;
+        bool chunked = false;
+        long long contentLength = -1;
+        for (;;) {
+            if (!conn.readLine(line)) { errorOut = "Truncated HTTP headers"; return false; }
+            if (line.empty()) break;
+            size_t colon = line.find(':');
+            if (colon == std::string::npos) continue;
+            std::string name = toLower(line.substr(0, colon));
+            std::string value = line.substr(colon + 1);
+            value.erase(0, value.find_first_not_of(" \t"));
+            if (name == "content-length") contentLength = std::atoll(value.c_str());
+            else if (name == "transfer-encoding") chunked = toLower(value).find("chunked") != std::string::npos;
+            else if (name == "connection") {
+                std::string v = toLower(value);
+                if (v.find("close") != std::string::npos) keepAlive = false;
+                else if (v.find("keep-alive") != std::string::npos) keepAlive = true;
+            }
+        }
+
+        // Error bodies are drained (so the connection stays reusable) but not delivered to the sink
+        const bool ok = statusCode < 400;
+        const BodySink discard = [](const char*, size_t) { return true; };
+        const BodySink& out = ok ? sink : discard;
+        const bool noBody = statusCode == 204 || statusCode == 304 || (statusCode >= 100 && statusCode < 200)
+                            || std::strcmp(method, "HEAD") == 0;
+
+        bool complete = true;
+        if (noBody) {
+            // nothing to read
+        } else if (chunked) {
+            complete = readChunked(conn, out, errorOut);
+        } else if (contentLength >= 0) {
+            complete = readFixed(conn, (size_t)contentLength, out, errorOut);
+        } else {
+            keepAlive = false;
+            complete = readUntilClose(conn, out, errorOut);
+        }
+        if (!complete) return false;
+        if (!ok) {
+            errorOut = "HTTP " + std::to_string(statusCode);
+            // Body was fully drained, the connection is still good
+        }
+        if (keepAlive && !conn.hasBufferedBytes()) giveBack(conn.release());
+        return ok;
+    }
+
+    static bool readFixed(Connection& conn, size_t remaining, const BodySink& sink, std::string& errorOut) {
+        char buf[64 * 1024];
+        while (remaining > 0) {
+            ssize_t n = conn.readSome(buf, std::min(remaining, sizeof(buf)));
+            if (n <= 0) { errorOut = "Connection closed mid-body"; return false; }
+            remaining -= (size_t)n;
+            if (!sink(buf, (size_t)n)) { errorOut = "Aborted"; return false; }
+        }
+        return true;
+    }
+
+    static bool readUntilClose(Connection& conn, const BodySink& sink, std::string& errorOut) {
+        char buf[64 * 1024];
+        for (;;) {
+            ssize_t n = conn.readSome(buf, sizeof(buf));
+            if (n == 0) return true;
+            if (n < 0) { errorOut = std::string("Receive failed: ") + std::strerror(errno); return false; }
+            if (!sink(buf, (size_t)n)) { errorOut = "Aborted"; return false; }
+        }
+    }
+
+    static bool readChunked(Connection& conn, const BodySink& sink, std::string& errorOut) {
+        std::string line;
+        for (;;) {
+            if (!conn.readLine(line)) { errorOut = "Truncated chunked body"; return false; }
+            size_t size = (size_t)std::strtoull(line.c_str(), nullptr, 16);
+            if (size == 0) {
+                // Trailers until blank line
+                do {
+                    if (!conn.readLine(line)) { errorOut = "Truncated chunked body"; return false; }
+                } while (!line.empty());
+                return true;
+            }
+            if (!readFixed(conn, size, sink, errorOut)) return false;
+            if (!conn.readLine(line)) { errorOut = "Truncated chunked body"; return false; }
+        }
+    }
+};
+
+AceForgeClient::AceForgeClient(std::string baseUrl)
+    : base_(std::move(baseUrl)), transport_(std::make_unique<Transport>()) {
+    while (!base_.empty() && base_.back() == '/') base_.pop_back();
+    transport_->configure(base_);
+}
+
+AceForgeClient::~AceForgeClient() = default;
+
+void AceForgeClient::interruptTransport() {
+    transport_->interrupt();
+}
+
+void AceForgeClient::setBaseUrl(const std::string& url) {
+    std::string next = url;
+    while (!next.empty() && next.back() == '/') next.pop_back();
+    if (next == base_) return;  // keep pooled connections
+    base_ = std::move(next);
+    eventsUnsupported_ = false;
+    transport_->configure(base_);
+}
+
+std::string AceForgeClient::get(const std::string& path) {
+    lastError_.clear();
+    std::string body;
+    const std::string p = (path.empty() || path[0] != '/' ? "/" : "") + path;
+    bool ok = transport_->request("GET", p, nullptr,
+                                  [&body](const char* d, size_t n) { body.append(d, n); return true; },
+                                  *this, lastError_);
+    return ok ? body : std::string();
+}
+
+std::string AceForgeClient::post(const std::string& path, const std::string& jsonBody) {
+    lastError_.clear();
+    std::string body;
+    const std::string p = (path.empty() || path[0] != '/' ? "/" : "") + path;
+    bool ok = transport_->request("POST", p, &jsonBody,
+                                  [&body](const char* d, size_t n) { body.append(d, n); return true; },
+                                  *this, lastError_);
+    return ok ? body : std::string();
+}
+
+std::vector<uint8_t> AceForgeClient::fetchAudio(const std::string& path) {
+    std::vector<uint8_t> out;
+    bool ok = fetchAudioStream(path, [&out](const uint8_t* d, size_t n) {
+        out.insert(out.end(), d, d + n);
+        return true;
+    });
+    if (!ok) return {};
+    return out;
+}
+
+bool AceForgeClient::fetchAudioStream(const std::string& path, const ChunkCallback& onChunk,
+                                      const CancellationToken* token) {
+    TokenScope scope(*this, token);
+    return getStream("/" + trimPath(path), onChunk);
+}
+
+bool AceForgeClient::getStream(const std::string& path, const ChunkCallback& onChunk) {
+    lastError_.clear();
+    const std::string p = (path.empty() || path[0] != '/' ? "/" : "") + path;
+    return transport_->request("GET", p, nullptr,
+                               [&onChunk](const char* d, size_t n) { return onChunk((const uint8_t*)d, n); },
+                               *this, lastError_);
+}
+
+} // namespace aceforge
+
+#endif // !__APPLE__
@@ -0,0 +1,360 @@
+#include "AceForgeJson.hpp"
+#include <cmath>
+
+namespace aceforge {
+namespace json {
+
+namespace {
+
+inline bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+inline int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+inline unsigned readHex4(const char* p) {
+    return (unsigned)(hexValue(p[0]) << 12 | hexValue(p[1]) << 8 | hexValue(p[2]) << 4 | hexValue(p[3]));
+}
+
+void appendUtf8(std::string& out, unsigned cp) {
+    if (cp < 0x80) {
+        out += (char)cp;
+    } else if (cp < 0x800) {
+        out += (char)(0xC0 | (cp >> 6));
+        out += (char)(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        out += (char)(0xE0 | (cp >> 12));
+        out += (char)(0x80 | ((cp >> 6) & 0x3F));
+        out += (char)(0x80 | (cp & 0x3F));
+    } else {
+        out += (char)(0xF0 | (cp >> 18));
+        out += (char)(0x80 | ((cp >> 12) & 0x3F));
+        out += (char)(0x80 | ((cp >> 6) & 0x3F));
+        out += (char)(0x80 | (cp & 0x3F));
+    }
+}
+
+double pow10(int e) {
+    static const double table[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+    if (e >= 0 && e <= 22) return table[e];
+    return std::pow(10.0, (double)e);
+}
+
+} // namespace
+
+void assignString(std::string& out, const StringToken& token) {
+    if (!token.hasEscapes) {
+        out.assign(token.raw.data(), token.raw.size());
+        return;
+    }
+    out.clear();
+    const std::string_view s = token.raw;
+    for (size_t i = 0; i < s.size(); ++i) {
+        char c = s[i];
+        if (c != '\\' || i + 1 >= s.size()) {
+            out += c;
+            continue;
+        }
+        c = s[++i];
+        switch (c) {
+        case 'b': out += '\b'; break;
+        case 'f': out += '\f'; break;
+        case 'n': out += '\n'; break;
+        case 'r': out += '\r'; break;
+        case 't': out += '\t'; break;
+        case 'u': {
+            if (i + 4 >= s.size()) return;  // Reader validated escapes; only reachable with hand-built tokens
+            unsigned cp = readHex4(s.data() + i + 1);
+            i += 4;
+            if (cp >= 0xD800 && cp <= 0xDBFF && i + 6 < s.size() && s[i + 1] == '\\' && s[i + 2] == 'u') {
+                const unsigned lo = readHex4(s.data() + i + 3);
+                if (lo >= 0xDC00 && lo <= 0xDFFF) {
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+                    i += 6;
+                }
+            }
+            if (cp >= 0xD800 && cp <= 0xDFFF) cp = 0xFFFD;  // unpaired surrogate
+            appendUtf8(out, cp);
+            break;
+        }
+        default: out += c; break;  // \" \\ \/
+        }
+    }
+}
+
+void Reader::skipWhitespace() {
+    while (pos_ < text_.size()) {
+        const char c = text_[pos_];
+        if (c != ' ' && c != '\t' && c != '\n' && c != '\r') break;
+        ++pos_;
+    }
+}
+
+bool Reader::expect(char c) {
+    if (pos_ < text_.size() && text_[pos_] == c) {
+        ++pos_;
+        return true;
+    }
+    return false;
+}
+
+bool Reader::atEnd() {
+    skipWhitespace();
+    return pos_ == text_.size();
+}
+
+Type Reader::peek() {
+    skipWhitespace();
+    if (failed_ || pos_ >= text_.size()) return Type::Invalid;
+    switch (text_[pos_]) {
+    case '{': return Type::Object;
+    case '[': return Type::Array;
+    case '"': return Type::String;
+    case 't': case 'f': return Type::Bool;
+    case 'n': return Type::Null;
+    default: return (text_[pos_] == '-' || isDigit(text_[pos_])) ? Type::Number : Type::Invalid;
+    }
+}
+
+bool Reader::readString(StringToken& out) {
+    skipWhitespace();
+    if (!expect('"')) return fail();
+    const size_t start = pos_;
+    bool escapes = false;
+    while (pos_ < text_.size()) {
+        const char c = text_[pos_];
+        if (c == '"') {
+            out.raw = text_.substr(start, pos_ - start);
+            out.hasEscapes = escapes;
+            ++pos_;
+            return true;
+        }
+        if ((unsigned char)c < 0x20) return fail();
+        if (c == '\\') {
+            escapes = true;
+            if (pos_ + 1 >= text_.size()) return fail();
+            const char e = text_[pos_ + 1];
+            if (e == 'u') {
+                if (pos_ + 5 >= text_.size()) return fail();
+                for (size_t k = 2; k < 6; ++k)
+                    if (hexValue(text_[pos_ + k]) < 0) return fail();
+                pos_ += 6;
+                continue;
+            }
+            if (e != '"' && e != '\\' && e != '/' && e != 'b' && e != 'f' && e != 'n' && e != 'r' && e != 't')
+                return fail();
+            pos_ += 2;
+            continue;
+        }
+        ++pos_;
+    }
+    return fail();
+}
+
+bool Reader::readNumber(double& out) {
+    skipWhitespace();
+    const size_t n = text_.size();
+    bool negative = false;
+    if (pos_ < n && text_[pos_] == '-') { negative = true; ++pos_; }
+    if (pos_ >= n || !isDigit(text_[pos_])) return fail();
+
+    // Up to 19 significant digits in an integer mantissa, the rest folded into the decimal exponent
+    uint64_t mantissa = 0;
+    int digits = 0;
+    int exp10 = 0;
+    if (text_[pos_] == '0') {
+        ++pos_;
+    } else {
+        while (pos_ < n && isDigit(text_[pos_])) {
+            if (digits < 19) { mantissa = mantissa * 10 + (uint64_t)(text_[pos_] - '0'); ++digits; }
+            else ++exp10;
+            ++pos_;
+        }
+    }
+    if (pos_ < n && text_[pos_] == '.') {
+        ++pos_;
+        if (pos_ >= n || !isDigit(text_[pos_])) return fail();
+        while (pos_ < n && isDigit(text_[pos_])) {
+            if (digits < 19) {
+                mantissa = mantissa * 10 + (uint64_t)(text_[pos_] - '0');
+                if (mantissa != 0) ++digits;
+                --exp10;
+            }
+            ++pos_;
+        }
+    }
+    if (pos_ < n && (text_[pos_] == 'e' || text_[pos_] == 'E')) {
+        ++pos_;
+        bool expNegative = false;
+        if (pos_ < n && (text_[pos_] == '+' || text_[pos_] == '-')) { expNegative = text_[pos_] == '-'; ++pos_; }
+        if (pos_ >= n || !isDigit(text_[pos_])) return fail();
+        int e = 0;
+        while (pos_ < n && isDigit(text_[pos_])) {
+            if (e < 10000) e = e * 10 + (text_[pos_] - '0');
+            ++pos_;
+        }
+        exp10 += expNegative ? -e : e;
+    }
+    double value = (double)mantissa;
+    if (mantissa != 0 && exp10 != 0)
+        value = exp10 > 0 ? value * pow10(exp10) : value / pow10(-exp10);
+    out = negative ? -value : value;
+    return true;
+}
+
+bool Reader::readBool(bool& out) {
+    skipWhitespace();
+    if (text_.compare(pos_, 4, "true") == 0) { pos_ += 4; out = true; return true; }
+    if (text_.compare(pos_, 5, "false") == 0) { pos_ += 5; out = false; return true; }
+    return fail();
+}
+
+bool Reader::readNull() {
+    skipWhitespace();
+    if (text_.compare(pos_, 4, "null") == 0) { pos_ += 4; return true; }
+    return fail();
+}
+
+bool Reader::skipValue() {
+    switch (peek()) {
+    case Type::Object: return readObject([](std::string_view, Reader& r) { return r.skipValue(); });
+    case Type::Array: return readArray([](Reader& r) { return r.skipValue(); });
+    case Type::String: { StringToken t; return readString(t); }
+    case Type::Number: { double d; return readNumber(d); }
+    case Type::Bool: { bool b; return readBool(b); }
+    case Type::Null: return readNull();
+    case Type::Invalid: break;
+    }
+    return fail();
+}
+
+} // namespace json
+
+namespace {
+
+// Field readers: null leaves numbers unchanged and clears strings; values of an unexpected type are skipped,
+// so a server adding or changing a field cannot break parsing of the ones we use.
+bool readNumberField(json::Reader& r, double& out) {
+    if (r.peek() == json::Type::Number) return r.readNumber(out);
+    return r.skipValue();
+}
+
+bool readIntField(json::Reader& r, int& out) {
+    double v = 0;
+    if (r.peek() != json::Type::Number) return r.skipValue();
+    if (!r.readNumber(v)) return false;
+    if (v > 2147483647.0) v = 2147483647.0;
+    if (v < -2147483648.0) v = -2147483648.0;
+    out = (int)v;
+    return true;
+}
+
+bool readStringField(json::Reader& r, std::string& out) {
+    const json::Type t = r.peek();
+    if (t == json::Type::Null) {
+        out.clear();
+        return r.readNull();
+    }
+    if (t != json::Type::String) return r.skipValue();
+    json::StringToken token;
+    if (!r.readString(token)) return false;
+    json::assignString(out, token);
+    return true;
+}
+
+bool readBoolField(json::Reader& r, bool& out) {
+    if (r.peek() == json::Type::Bool) return r.readBool(out);
+    return r.skipValue();
+}
+
+bool readResult(json::Reader& r, JobStatus& out) {
+    if (r.peek() != json::Type::Object) return r.skipValue();
+    return r.readObject([&out](std::string_view key, json::Reader& r) {
+        if (key == "audioUrls") {
+            if (r.peek() != json::Type::Array) return r.skipValue();
+            size_t count = 0;
+            const bool ok = r.readArray([&out, &count](json::Reader& r) {
+                if (r.peek() != json::Type::String) return r.skipValue();
+                json::StringToken token;
+                if (!r.readString(token)) return false;
+                if (count == out.audioUrls.size()) out.audioUrls.emplace_back();
+                json::assignString(out.audioUrls[count++], token);
+                return true;
+            });
+            out.audioUrls.resize(count);
+            out.audioUrl = count > 0 ? out.audioUrls[0] : std::string();
+            return ok;
+        }
+        if (key == "duration") return readNumberField(r, out.durationSeconds);
+        if (key == "bpm") return readNumberField(r, out.bpm);
+        if (key == "keyScale") return readStringField(r, out.keyScale);
+        return r.skipValue();  // includes result.status, which must not override the job status
+    });
+}
+
+// One pass over a top-level object, filling whichever of status/progress is given
+bool parseTopLevel(std::string_view body, JobStatus* status, ProgressInfo* progress) {
+    json::Reader reader(body);
+    const bool ok = reader.readObject([status, progress](std::string_view key, json::Reader& r) {
+        if (status) {
+            if (key == "jobId") return readStringField(r, status->jobId);
+            if (key == "status") return readStringField(r, status->status);
+            if (key == "queuePosition") return readIntField(r, status->queuePosition);
+            if (key == "etaSeconds") return readNumberField(r, status->etaSeconds);
+            if (key == "result") return readResult(r, *status);
+            if (key == "error") {
+                if (!readStringField(r, status->error)) return false;
+                if (progress) progress->error = status->error;
+                return true;
+            }
+        }
+        if (progress) {
+            if (key == "fraction") {
+                double v = progress->fraction;
+                if (!readNumberField(r, v)) return false;
+                progress->fraction = (float)v;
+                return true;
+            }
+            if (key == "done") return readBoolField(r, progress->done);
+            if (key == "error") return readStringField(r, progress->error);
+            if (key == "stage") return readStringField(r, progress->stage);
+            if (key == "current") return readIntField(r, progress->current);
+            if (key == "total") return readIntField(r, progress->total);
+        }
+        return r.skipValue();
+    });
+    return ok && reader.atEnd();
+}
+
+} // namespace
+
+bool parseHealth(std::string_view body, bool& healthy) {
+    json::Reader reader(body);
+    const bool ok = reader.readObject([&healthy](std::string_view key, json::Reader& r) {
+        if (key == "healthy") return readBoolField(r, healthy);
+        return r.skipValue();
+    });
+    return ok && reader.atEnd();
+}
+
+bool parseStartResponse(std::string_view body, JobStatus& out) {
+    return parseTopLevel(body, &out, nullptr);
+}
+
+bool parseJobStatus(std::string_view body, JobStatus& out) {
+    return parseTopLevel(body, &out, nullptr);
+}
+
+bool parseProgressInfo(std::string_view body, ProgressInfo& out) {
+    return parseTopLevel(body, nullptr, &out);
+}
+
+bool parseJobEvent(std::string_view body, JobStatus& status, ProgressInfo& progress) {
+    return parseTopLevel(body, &status, &progress);
+}
+
+} // namespace aceforge
@@ -0,0 +1,138 @@
+/**
+ * Minimal JSON reader for AceForge API responses.
+ *
+ * json::Reader walks a std::string_view in a single pass without allocating: strings are
+ * returned as views into the input (escapes are decoded only when copied into an output
+ * field), numbers are parsed in place, and unknown members are skipped. The parse*
+ * functions map responses onto the AceForgeClient structs; they only overwrite fields
+ * that are present in the body and return false on malformed JSON.
+ */
+#ifndef ACEFORGE_JSON_HPP
+#define ACEFORGE_JSON_HPP
+
+#include "AceForgeClient.hpp"
+#include <string>
+#include <string_view>
+
+namespace aceforge {
+namespace json {
+
+enum class Type { Null, Bool, Number, String, Object, Array, Invalid };
+
+/** A string token: raw bytes between the quotes, still escaped when hasEscapes is set. */
+struct StringToken {
+    std::string_view raw;
+    bool hasEscapes = false;
+};
+
+/** Decodes a string token (\n, \", \uXXXX incl. surrogate pairs -> UTF-8) into out, reusing its capacity. */
+void assignString(std::string& out, const StringToken& token);
+
+class Reader {
+public:
+    static constexpr int kMaxDepth = 64;
+
+    explicit Reader(std::string_view text) : text_(text) {}
+
+    /** Type of the next value (after whitespace), without consuming it. */
+    Type peek();
+
+    bool readString(StringToken& out);
+    bool readNumber(double& out);
+    bool readBool(bool& out);
+    bool readNull();
+    /** Consumes any value, including nested objects and arrays. */
+    bool skipValue();
+
+    /**
+     * Reads an object; onMember(std::string_view key, Reader&) must consume the member's value
+     * (read* or skipValue) and return false to fail the parse. Keys are compared raw (unescaped).
+     */
+    template <typename F>
+    bool readObject(F&& onMember);
+
+    /** Reads an array; onElement(Reader&) must consume one value and return false to fail the parse. */
+    template <typename F>
+    bool readArray(F&& onElement);
+
+    /** True when only whitespace remains. */
+    bool atEnd();
+    bool failed() const { return failed_; }
+
+private:
+    void skipWhitespace();
+    bool expect(char c);
+    bool fail() { failed_ = true; return false; }
+
+    std::string_view text_;
+    size_t pos_ = 0;
+    int depth_ = 0;
+    bool failed_ = false;
+};
+
+template <typename F>
+bool Reader::readObject(F&& onMember) {
+    skipWhitespace();
+    if (!expect('{')) return fail();
+    if (++depth_ > kMaxDepth) return fail();
+    skipWhitespace();
+    if (pos_ < text_.size() && text_[pos_] == '}') {
+        ++pos_;
+        --depth_;
+        return true;
+    }
+    for (;;) {
+        StringToken key;
+        if (!readString(key)) return fail();
+        skipWhitespace();
+        if (!expect(':')) return fail();
+        if (!onMember(key.raw, *this) || failed_) return fail();
+        skipWhitespace();
+        if (pos_ < text_.size() && text_[pos_] == ',') { ++pos_; continue; }
+        if (!expect('}')) return fail();
+        --depth_;
+        return true;
+    }
+}
+
+template <typename F>
+bool Reader::readArray(F&& onElement) {
+    skipWhitespace();
+    if (!expect('[')) return fail();
+    if (++depth_ > kMaxDepth) return fail();
+    skipWhitespace();
+    if (pos_ < text_.size() && text_[pos_] == ']') {
+        ++pos_;
+        --depth_;
+        return true;
+    }
+    for (;;) {
+        if (!onElement(*this) || failed_) return fail();
+        skipWhitespace();
+        if (pos_ < text_.size() && text_[pos_] == ',') { ++pos_; continue; }
+        if (!expect(']')) return fail();
+        --depth_;
+        return true;
+    }
+}
+
+} // namespace json
+
+/** GET /api/generate/health: {"healthy": true} */
+bool parseHealth(std::string_view body, bool& healthy);
+
+/** POST /api/generate: {"jobId": "...", "status": "queued", "queuePosition": 1} */
+bool parseStartResponse(std::string_view body, JobStatus& out);
+
+/** GET /api/generate/status/<id>: top-level status/error/queue fields plus result.{audioUrls,duration,bpm,keyScale}. */
+bool parseJobStatus(std::string_view body, JobStatus& out);
+
+/** GET /progress: {"fraction", "done", "error", "stage", "current", "total"} */
+bool parseProgressInfo(std::string_view body, ProgressInfo& out);
+
+/** Job event (server-sent event data): a status snapshot that may also carry progress fields. */
+bool parseJobEvent(std::string_view body, JobStatus& status, ProgressInfo& progress);
+
+} // namespace aceforge
+
+#endif
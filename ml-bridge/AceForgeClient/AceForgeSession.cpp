@@ -0,0 +1,269 @@
+#include "AceForgeSession.hpp"
+#include <algorithm>
+
+namespace aceforge {
+
+namespace {
+
+constexpr int kWaitSliceMs = 50;  // a waiter re-checks its token this often (tokens do not notify the session)
+
+// Clients strip trailing slashes from their base URL; key everything the same way
+std::string serverKey(std::string url) {
+    while (!url.empty() && url.back() == '/') url.pop_back();
+    return url;
+}
+
+} // namespace
+
+AceForgeSession::Lease::Lease(AceForgeSession* session, std::unique_ptr<AceForgeClient> client)
+    : session_(session), client_(std::move(client)) {}
+
+AceForgeSession::Lease::Lease(Lease&& other) noexcept : session_(other.session_), client_(std::move(other.client_)) {
+    other.session_ = nullptr;
+}
+
+AceForgeSession::Lease& AceForgeSession::Lease::operator=(Lease&& other) noexcept {
+    if (this != &other) {
+        release();
+        session_ = other.session_;
+        client_ = std::move(other.client_);
+        other.session_ = nullptr;
+    }
+    return *this;
+}
+
+AceForgeSession::Lease::~Lease() {
+    release();
+}
+
+void AceForgeSession::Lease::release() {
+    if (session_ != nullptr && client_ != nullptr) session_->returnClient(std::move(client_));
+    client_.reset();
+    session_ = nullptr;
+}
+
+AceForgeSession::~AceForgeSession() {
+    {
+        std::lock_guard<std::mutex> l(lock_);
+        stopping_ = true;
+        for (auto& entry : pollClients_) entry.second->abort();  // cuts short a status request in flight
+    }
+    wake_.notify_all();
+    if (poller_.joinable()) poller_.join();
+}
+
+bool AceForgeSession::isHealthy(const std::string& baseUrl) {
+    const std::string key = serverKey(baseUrl);
+    std::unique_lock<std::mutex> l(lock_);
+    Health& health = health_[key];  // map nodes stay put while other servers are added
+    if (health.checking || Clock::now() < health.expires) {
+        ++stats_.healthCacheHits;
+        healthChecked_.wait(l, [&health] { return !health.checking; });
+        return health.healthy;
+    }
+    health.checking = true;
+    ++stats_.healthChecks;
+    l.unlock();
+
+    bool healthy = false;
+    {
+        Lease client = acquire(key);
+        healthy = client->healthCheck();
+    }
+
+    l.lock();
+    health.checking = false;
+    health.healthy = healthy;
+    health.expires = Clock::now() + std::chrono::milliseconds(healthy ? kHealthyTtlMs : kUnhealthyTtlMs);
+    l.unlock();
+    healthChecked_.notify_all();
+    return healthy;
+}
+
+void AceForgeSession::invalidateHealth(const std::string& baseUrl) {
+    std::lock_guard<std::mutex> l(lock_);
+    const std::string key = serverKey(baseUrl);
+    auto it = health_.find(key);
+    if (it != health_.end()) it->second.expires = Clock::time_point();
+    noEvents_.erase(key);  // may be another server now
+}
+
+AceForgeSession::Lease AceForgeSession::acquire(const std::string& baseUrl) {
+    const std::string key = serverKey(baseUrl);
+    std::unique_ptr<AceForgeClient> client;
+    {
+        std::lock_guard<std::mutex> l(lock_);
+        auto& idle = idle_[key];
+        if (!idle.empty()) {
+            client = std::move(idle.back());
+            idle.pop_back();
+        } else {
+            ++stats_.clientsCreated;
+        }
+    }
+    if (client == nullptr) client = std::make_unique<AceForgeClient>(key);
+    return Lease(this, std::move(client));
+}
+
+void AceForgeSession::returnClient(std::unique_ptr<AceForgeClient> client) {
+    // A borrower that was stopped with abort() hands the client back usable
+    client->resetAbort();
+    std::lock_guard<std::mutex> l(lock_);
+    auto& idle = idle_[client->getBaseUrl()];
+    if ((int)idle.size() < kMaxIdleClients) idle.push_back(std::move(client));
+}
+
+JobStatus AceForgeSession::waitForJob(const std::string& baseUrl, const std::string& jobId,
+                                      const AceForgeClient::JobUpdateCallback& onUpdate,
+                                      const CancellationToken* token) {
+    const std::string key = serverKey(baseUrl);
+    JobStatus last;
+    last.jobId = jobId;
+    bool streamEvents;
+    {
+        std::lock_guard<std::mutex> l(lock_);
+        streamEvents = noEvents_.count(key) == 0;
+        if (streamEvents) ++stats_.eventStreams;
+    }
+    if (streamEvents) {
+        // The server pushes every change: no status requests, and the fetch starts as soon as the job is done.
+        // The stream holds a pooled connection until then.
+        Lease client = acquire(key);
+        if (client->followJobEvents(jobId, onUpdate, last, token)) return last;
+        if (client->eventsUnsupported()) {
+            std::lock_guard<std::mutex> l(lock_);
+            noEvents_.insert(key);
+        }
+        if (token != nullptr && token->isCancelled()) return last;
+        // No events endpoint, or the stream broke off: the poll thread takes over from the last event
+    }
+
+    auto watch = std::make_shared<Watch>();
+    watch->baseUrl = key;
+    watch->jobId = jobId;
+    watch->status = last;
+    watch->due = Clock::now();
+
+    std::unique_lock<std::mutex> l(lock_);
+    watches_.push_back(watch);
+    if (!poller_.joinable() && !stopping_) poller_ = std::thread([this] { pollLoop(); });
+    wake_.notify_one();
+
+    uint64_t seen = 0;
+    for (;;) {
+        watch->updated.wait_for(l, std::chrono::milliseconds(kWaitSliceMs),
+                                [&] { return watch->version != seen || stopping_; });
+        if (stopping_ || (token != nullptr && token->isCancelled())) break;
+        if (watch->version == seen) continue;
+        seen = watch->version;
+        last = watch->status;
+        const ProgressInfo progress = watch->progress;
+        // The callback is the caller's code: run it without the session lock
+        l.unlock();
+        const bool keepWaiting = onUpdate(last, progress) && !last.isFinished();
+        l.lock();
+        if (!keepWaiting) break;
+    }
+    watches_.erase(std::remove(watches_.begin(), watches_.end(), watch), watches_.end());
+    return last;
+}
+
+void AceForgeSession::pollLoop() {
+    std::unique_lock<std::mutex> l(lock_);
+    while (!stopping_) {
+        if (watches_.empty()) {
+            wake_.wait(l);
+            continue;
+        }
+        Clock::time_point next = watches_.front()->due;
+        for (const auto& watch : watches_) next = std::min(next, watch->due);
+        if (Clock::now() < next) {
+            wake_.wait_until(l, next);  // a new watch is due at once and wakes us early
+            continue;
+        }
+
+        // Everything due, grouped by server, so each server is asked in one burst. No job is polled before its
+        // time: pulling jobs forward to share a pass only adds status requests.
+        const Clock::time_point now = Clock::now();
+        std::map<std::string, std::vector<std::shared_ptr<Watch>>> due;
+        for (const auto& watch : watches_)
+            if (watch->due <= now)
+                due[watch->baseUrl].push_back(watch);
+        ++stats_.pollPasses;
+        for (auto& server : due) {
+            std::unique_ptr<AceForgeClient>& client = pollClients_[server.first];
+            if (client == nullptr) {
+                client = std::make_unique<AceForgeClient>(server.first);
+                ++stats_.clientsCreated;
+            }
+            AceForgeClient& c = *client;
+            l.unlock();
+            pollServer(c, server.second);
+            l.lock();
+            if (stopping_) break;
+        }
+    }
+}
+
+void AceForgeSession::pollServer(AceForgeClient& client, const std::vector<std::shared_ptr<Watch>>& due) {
+    // Only this thread writes a watch's status, due time and backoff, so reading them here needs no lock
+    std::vector<JobStatus> answers;
+    std::vector<std::string> errors;  // lastError() of each unanswered poll (transport error, malformed body)
+    answers.reserve(due.size());
+    errors.reserve(due.size());
+    bool anyRunning = false;
+    for (const auto& watch : due) {
+        answers.push_back(client.getStatus(watch->jobId));
+        errors.push_back(answers.back().status.empty() ? client.lastError() : std::string());
+        anyRunning = anyRunning || answers.back().status == "running";
+    }
+    // /progress describes whatever is on the GPU, so one read serves every running job of this server
+    ProgressInfo progress;
+    if (anyRunning) progress = client.getProgress();
+
+    const Clock::time_point now = Clock::now();
+    std::lock_guard<std::mutex> l(lock_);
+    stats_.statusRequests += (int64_t)due.size();
+    if (anyRunning) ++stats_.progressRequests;
+    bool reached = false;
+    for (size_t i = 0; i < due.size(); ++i) {
+        Watch& watch = *due[i];
+        JobStatus& st = answers[i];
+        // getStatus leaves the status empty for a transport error and for a body that is no job status, so a
+        // server that answers garbage counts as not answering, as in AceForgeClient::pollJob
+        const bool answered = !st.status.empty();
+        // A job the server does not know, or one it has not answered for too long, ends the wait as failed;
+        // otherwise an unanswered poll keeps the last known state and retries
+        watch.failures = answered ? 0 : watch.failures + 1;
+        const bool lost = !answered && statusPollGivesUp(errors[i], watch.failures);
+        if (lost) st = statusLost(watch.status, errors[i]);
+        else if (!answered) st = watch.status;
+        reached = reached || answered;
+        const bool running = st.status == "running";
+        const bool changed = st.status != watch.status.status || st.queuePosition != watch.status.queuePosition
+                             || (running && progress.current != watch.progress.current);
+        watch.due = now + std::chrono::milliseconds(nextPollDelayMs(st, changed, watch.backoffMs));
+        if (!answered && !lost) continue;
+        watch.status = st;
+        if (running) watch.progress = progress;
+        ++watch.version;
+        watch.updated.notify_one();
+    }
+    // A server that answers is up: new jobs can skip their health check for a while
+    if (reached) {
+        Health& health = health_[due.front()->baseUrl];
+        if (!health.checking) {
+            health.healthy = true;
+            health.expires = now + std::chrono::milliseconds(kHealthyTtlMs);
+        }
+    }
+}
+
+AceForgeSession::Stats AceForgeSession::stats() const {
+    std::lock_guard<std::mutex> l(lock_);
+    Stats s = stats_;
+    s.watchedJobs = (int)watches_.size();
+    return s;
+}
+
+} // namespace aceforge
@@ -0,0 +1,149 @@
+/**
+ * Process-wide AceForge session shared by every plugin instance in the host (one per process, e.g. through a
+ * juce::SharedResourcePointer). Without it each instance runs its own health check before every job and its own
+ * status wait per job, so a session with many instances multiplies the requests and connections the local server
+ * has to serve. The session multiplexes them:
+ *
+ *  - Health: isHealthy() answers from a cached result (kHealthyTtlMs when healthy, kUnhealthyTtlMs when not). When
+ *    it has expired, one caller checks and the others wait for its answer instead of checking too.
+ *  - Connections: acquire() lends a keep-alive client for one job's submit, event stream, cancel and download from a
+ *    pool per base URL; a returned client keeps its connection for the next lease, whichever instance takes it.
+ *  - Status: waitForJob() follows the job's event stream on a pooled client, as AceForgeClient::waitForJob does,
+ *    so a server with events gets no status requests at all. On a server without the events endpoint (remembered
+ *    per base URL), or when a stream breaks off, the job is registered with one poll thread for all jobs of all
+ *    instances. Each pass polls every job that is due with one client per server, and reads /progress once for all
+ *    running jobs; each job's interval follows its ETA and queue position as in AceForgeClient::waitForJob, and no
+ *    job is polled early. The waiting thread sleeps on its own condition variable and runs its onUpdate itself, so
+ *    results reach the right instance and no instance code runs on the poll thread.
+ *
+ * AceForge has no batch status endpoint, so a pass is still one status request per due job; what is shared is the
+ * connection, the /progress read, the health answer and the thread.
+ */
+#ifndef ACEFORGE_SESSION_HPP
+#define ACEFORGE_SESSION_HPP
+
+#include "AceForgeClient.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace aceforge {
+
+class AceForgeSession {
+public:
+    static constexpr int kHealthyTtlMs = 5000;
+    static constexpr int kUnhealthyTtlMs = 1000;  // retry soon once the user starts AceForge
+    static constexpr int kMaxIdleClients = 4;     // per base URL; more leases at once get clients of their own
+
+    struct Stats {
+        int64_t healthChecks = 0;      // GET /api/generate/health sent
+        int64_t healthCacheHits = 0;   // isHealthy() answered without a request (cached, or another caller's check)
+        int64_t statusRequests = 0;
+        int64_t progressRequests = 0;
+        int64_t eventStreams = 0;      // waits that went to the job's event stream first
+        int64_t pollPasses = 0;
+        int64_t clientsCreated = 0;
+        int watchedJobs = 0;           // jobs waiting right now
+    };
+
+    /** A pooled client on loan; goes back to its pool (abort reset) when destroyed. */
+    class Lease {
+    public:
+        Lease() = default;
+        Lease(Lease&& other) noexcept;
+        Lease& operator=(Lease&& other) noexcept;
+        ~Lease();
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+
+        AceForgeClient* get() const { return client_.get(); }
+        AceForgeClient& operator*() const { return *client_; }
+        AceForgeClient* operator->() const { return client_.get(); }
+        explicit operator bool() const { return client_ != nullptr; }
+
+    private:
+        friend class AceForgeSession;
+        Lease(AceForgeSession* session, std::unique_ptr<AceForgeClient> client);
+        void release();
+
+        AceForgeSession* session_ = nullptr;
+        std::unique_ptr<AceForgeClient> client_;
+    };
+
+    AceForgeSession() = default;
+    /** Stops the poll thread. Every lease must have been returned and every waitForJob() must have returned. */
+    ~AceForgeSession();
+    AceForgeSession(const AceForgeSession&) = delete;
+    AceForgeSession& operator=(const AceForgeSession&) = delete;
+
+    /** Cached GET /api/generate/health of baseUrl; at most one check per server is in flight. */
+    bool isHealthy(const std::string& baseUrl);
+    /**
+     * Forgets the cached health of baseUrl and whether it lacks events, e.g. after the user pointed the plugin at a
+     * server again.
+     */
+    void invalidateHealth(const std::string& baseUrl);
+
+    /** Lends a client for baseUrl from the pool (a new one when none is idle). */
+    Lease acquire(const std::string& baseUrl);
+
+    /**
+     * Same contract as AceForgeClient::waitForJob(): blocks until jobId on baseUrl finishes, onUpdate returns false
+     * or token is cancelled, and returns the last status; a job the poll thread loses contact with ends as
+     * statusLost(). onUpdate runs on the calling thread after each event, or after each poll that reached the
+     * server and once more with the lost status.
+     */
+    JobStatus waitForJob(const std::string& baseUrl, const std::string& jobId,
+                         const AceForgeClient::JobUpdateCallback& onUpdate, const CancellationToken* token = nullptr);
+
+    Stats stats() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Health {
+        bool healthy = false;
+        bool checking = false;
+        Clock::time_point expires;
+    };
+
+    struct Watch {
+        std::string baseUrl;
+        std::string jobId;
+        Clock::time_point due;
+        int backoffMs = 100;
+        int failures = 0;            // unanswered status polls in a row (statusPollGivesUp)
+        JobStatus status;            // last answer that reached the server, or statusLost() once given up
+        ProgressInfo progress;
+        uint64_t version = 0;        // bumped on every answer, for the waiter
+        std::condition_variable updated;
+    };
+
+    void returnClient(std::unique_ptr<AceForgeClient> client);
+    void pollLoop();
+    /** One pass over the watches of one server (poll thread, lock not held). */
+    void pollServer(AceForgeClient& client, const std::vector<std::shared_ptr<Watch>>& due);
+
+    mutable std::mutex lock_;                  // guards everything below
+    std::condition_variable healthChecked_;
+    std::condition_variable wake_;             // new watch or stop, for the poll thread
+    std::map<std::string, Health> health_;
+    std::set<std::string> noEvents_;           // servers whose events endpoint returned 404; polled instead
+    std::map<std::string, std::vector<std::unique_ptr<AceForgeClient>>> idle_;
+    std::vector<std::shared_ptr<Watch>> watches_;
+    std::map<std::string, std::unique_ptr<AceForgeClient>> pollClients_;  // poll thread only, once created
+    std::thread poller_;
+    bool stopping_ = false;
+    Stats stats_;
+};
+
+} // namespace aceforge
+
+#endif
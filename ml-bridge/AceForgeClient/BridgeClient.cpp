@@ -0,0 +1,230 @@
+#include "BridgeClient.hpp"
+#include <algorithm>
+#include <chrono>
+#include <unistd.h>
+
+namespace aceforge {
+namespace bridge {
+
+namespace {
+
+constexpr int kPollMs = 20;  // cancellation latency while waiting for the host
+
+int64_t nowUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+} // namespace
+
+bool BridgeClient::fail(const std::string& error) {
+    lastError_ = error;
+    return false;
+}
+
+bool BridgeClient::connect(const std::string& path, double sampleRate, int blockSize) {
+    close();
+    if (!connection_.connect(path)) return fail(connection_.error());
+    Hello hello;
+    hello.sampleRate = sampleRate;
+    hello.blockSize = (uint32_t)std::max(0, blockSize);
+    hello.flags = options_.sharedRing ? kHelloSharedRing : 0;
+    scratch_.clear();
+    encodeHello(scratch_, hello);
+    if (!connection_.send(scratch_)) return fail(connection_.error());
+
+    const int64_t deadline = nowUs() + (int64_t)options_.helloTimeoutMs * 1000;
+    for (;;) {
+        if (connection_.receive(frame_)) {
+            std::string message;
+            if (decodeError(frame_, message)) {
+                connection_.close();
+                return fail("Host refused the connection: " + message);
+            }
+            if (!decodeHello(frame_, host_)) continue;
+            if (host_.version != kVersion || host_.numChannels == 0 || !(host_.sampleRate > 0.0)) {
+                connection_.close();
+                return fail("Host speaks protocol version " + std::to_string(host_.version) + " or sent no format");
+            }
+            if ((host_.flags & kHelloSharedRing) == 0) return true;
+            break;
+        }
+        if (!connection_.isOpen()) return fail(connection_.error());
+        const int64_t left = deadline - nowUs();
+        if (left <= 0) {
+            connection_.close();
+            return fail("No Hello from the host within " + std::to_string(options_.helloTimeoutMs) + " ms");
+        }
+        connection_.wait((int)std::min<int64_t>(kPollMs, left / 1000 + 1));
+    }
+    return receiveRing() || fail(lastError_);
+}
+
+bool BridgeClient::receiveRing() {
+    const int64_t deadline = nowUs() + (int64_t)options_.helloTimeoutMs * 1000;
+    for (;;) {
+        if (connection_.receive(frame_)) {
+            SharedRingInfo info;
+            if (!decodeSharedRing(frame_, info)) continue;
+            const std::vector<int> fds = connection_.takeReceivedFds();
+            if (fds.size() != 2) {
+                for (int fd : fds) ::close(fd);
+                connection_.close();
+                return fail("SharedRing message without its two descriptors");
+            }
+            if (!ring_.attach(fds[0], fds[1]) || ring_.numChannels() != (int)host_.numChannels
+                || ring_.capacityFrames() != (int)info.capacityFrames || ring_.sampleRate() != host_.sampleRate) {
+                const std::string why = ring_.error().empty() ? "does not match the Hello" : ring_.error();
+                ring_.close();
+                connection_.close();
+                return fail("Shared ring " + why);
+            }
+            return true;
+        }
+        if (!connection_.isOpen()) return fail(connection_.error());
+        const int64_t left = deadline - nowUs();
+        if (left <= 0) {
+            connection_.close();
+            return fail("No SharedRing from the host within " + std::to_string(options_.helloTimeoutMs) + " ms");
+        }
+        connection_.wait((int)std::min<int64_t>(kPollMs, left / 1000 + 1));
+    }
+}
+
+void BridgeClient::close() {
+    connection_.close();
+    ring_.close();
+    pending_.clear();
+    streamsStarted_ = 0;
+    host_ = Hello{};
+}
+
+bool BridgeClient::sendParams(const Params& params) {
+    scratch_.clear();
+    encodeParams(scratch_, params);
+    if (!connection_.send(scratch_)) return fail(connection_.error());
+    ++streamsStarted_;
+    return true;
+}
+
+bool BridgeClient::sendMidi(int64_t frame, const uint8_t* bytes, size_t size) {
+    scratch_.clear();
+    encodeMidi(scratch_, frame, bytes, size);
+    return connection_.send(scratch_) || fail(connection_.error());
+}
+
+bool BridgeClient::stream(int64_t totalFrames, const AudioCallback& onAudio, const CancellationToken* cancel) {
+    if (!connection_.isOpen()) return fail("Not connected");
+    stats_ = Stats{};
+    pending_.clear();
+    if (ring_.isOpen()) return streamShared(totalFrames, onAudio, cancel);
+    const uint32_t chunk = (uint32_t)std::max(1, options_.chunkFrames);
+    const size_t maxInFlight = (size_t)std::max(1, options_.maxInFlight);
+    const int64_t start = nowUs();
+    int64_t requested = 0;
+    int64_t received = 0;
+    int64_t lastProgressUs = start;
+    int64_t roundTripSumUs = 0;
+    bool ended = false;  // the host flagged the end; requests still in flight come back empty
+
+    for (;;) {
+        if (cancel != nullptr && cancel->isCancelled()) return fail("Cancelled");
+
+        // Top up the pipeline: the host works on the next chunk while the previous one is on its way back
+        scratch_.clear();
+        while (!ended && pending_.size() < maxInFlight && (totalFrames <= 0 || requested < totalFrames)) {
+            AudioRequest request;
+            request.frame = requested;
+            request.numFrames = totalFrames > 0 ? (uint32_t)std::min<int64_t>(chunk, totalFrames - requested) : chunk;
+            encodeAudioRequest(scratch_, request);
+            pending_.push_back({ request.frame, request.numFrames, nowUs() });
+            requested += request.numFrames;
+        }
+        if (!scratch_.empty() && !connection_.send(scratch_)) return fail(connection_.error());
+
+        bool progressed = false;
+        while (connection_.receive(frame_)) {
+            std::string message;
+            if (decodeError(frame_, message)) return fail("Host error: " + message);
+            AudioResponse response;
+            if (!decodeAudioResponse(frame_, response)) continue;  // MIDI echoes, late Hellos: not ours
+            if (pending_.empty() || response.frame != pending_.front().frame
+                || response.numFrames > pending_.front().numFrames
+                || (response.numFrames < pending_.front().numFrames && !response.endOfStream()))
+                return fail("Host answered out of order at frame " + std::to_string(response.frame));
+            const int64_t now = nowUs();
+            const int64_t roundTrip = now - pending_.front().sentUs;
+            pending_.pop_front();
+            progressed = true;
+            lastProgressUs = now;
+            ++stats_.responses;
+            roundTripSumUs += roundTrip;
+            stats_.maxRoundTripUs = std::max(stats_.maxRoundTripUs, roundTrip);
+            stats_.meanRoundTripUs = roundTripSumUs / stats_.responses;
+            if (response.endOfStream()) ended = true;
+            if (response.numFrames == 0) continue;
+            if (stats_.firstAudioUs == 0) stats_.firstAudioUs = now - start;
+            stats_.frames += response.numFrames;
+            received += response.numFrames;
+            if (!onAudio(response.samples, (int)response.numFrames, (int)response.numChannels))
+                return fail("Stopped");
+        }
+        if (!connection_.isOpen()) return fail(connection_.error());
+        if (pending_.empty() && (ended || (totalFrames > 0 && received >= totalFrames))) return true;
+        if (progressed) continue;  // answered requests free pipeline slots: top up before waiting
+        if (!connection_.wait(kPollMs) && nowUs() - lastProgressUs > (int64_t)options_.stallTimeoutMs * 1000)
+            return fail("Host sent nothing for " + std::to_string(options_.stallTimeoutMs) + " ms");
+    }
+}
+
+bool BridgeClient::streamShared(int64_t totalFrames, const AudioCallback& onAudio, const CancellationToken* cancel) {
+    if (streamsStarted_ == 0) return fail("No stream started: send Params first");
+    const int channels = ring_.numChannels();
+    const int64_t start = nowUs();
+    int64_t lastProgressUs = start;
+    int64_t delivered = 0;
+
+    for (;;) {
+        if (cancel != nullptr && cancel->isCancelled()) return fail("Cancelled");
+        // Loaded before the frames: everything the host wrote before ending the stream is readable below
+        const bool ended = ring_.endedStream() == streamsStarted_;
+        bool progressed = false;
+        for (;;) {
+            const auto regions = ring_.prepareRead(ring_.capacityFrames());
+            if (regions.total() == 0) break;
+            for (int i = 0; i < 2; ++i) {
+                // Straight from shared memory; a host that writes more than asked for is drained, not delivered
+                const int n = totalFrames > 0
+                                  ? (int)std::min<int64_t>(regions.frames[i], std::max<int64_t>(0, totalFrames - delivered))
+                                  : regions.frames[i];
+                if (n == 0) continue;
+                if (stats_.firstAudioUs == 0) stats_.firstAudioUs = nowUs() - start;
+                delivered += n;
+                stats_.frames += n;
+                if (!onAudio(regions.data[i], n, channels)) {
+                    ring_.commitRead(regions.total());
+                    return fail("Stopped");
+                }
+            }
+            ring_.commitRead(regions.total());
+            ++stats_.responses;
+            progressed = true;
+        }
+        if (ended) return true;
+
+        while (connection_.receive(frame_)) {
+            std::string message;
+            if (decodeError(frame_, message)) return fail("Host error: " + message);
+        }
+        if (!connection_.isOpen()) return fail(connection_.error());
+        if (progressed) {
+            lastProgressUs = nowUs();
+            continue;
+        }
+        if (!ring_.waitReadable(kPollMs) && nowUs() - lastProgressUs > (int64_t)options_.stallTimeoutMs * 1000)
+            return fail("Host wrote nothing for " + std::to_string(options_.stallTimeoutMs) + " ms");
+    }
+}
+
+} // namespace bridge
+} // namespace aceforge
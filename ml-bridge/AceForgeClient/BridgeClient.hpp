@@ -0,0 +1,106 @@
+/**
+ * Plugin side of the bridge protocol (protocol.md): streams audio from a local ML host over a Unix domain socket.
+ *
+ * connect() exchanges Hello messages (the plugin offers its rate and block size, the host answers with the
+ * format it will stream). sendParams() configures the next stream (prompt, duration, seed, ...). stream() then
+ * pulls the audio as pipelined AudioRequests of chunkFrames, keeping up to maxInFlight of them outstanding so
+ * the host always has the next chunk to work on while the previous one travels back; responses are handed to the
+ * callback in stream order as they arrive. Every socket call is non-blocking (BridgeSocket), so the loop also
+ * notices cancellation and a host that stalls.
+ *
+ * When the host offers it, audio comes through a SharedAudioRing instead: the host writes each stream's frames
+ * into shared memory once, as they are generated, and stream() hands the callback pointers into the ring (no
+ * socket copy, no request round trips). The socket then only carries Params, MIDI and errors.
+ *
+ * Use from a background thread, never the audio thread; one stream at a time per client.
+ */
+#ifndef ACEFORGE_BRIDGE_CLIENT_HPP
+#define ACEFORGE_BRIDGE_CLIENT_HPP
+
+#include "AceForgeClient.hpp"
+#include "BridgeSocket.hpp"
+#include "SharedAudioRing.hpp"
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace aceforge {
+namespace bridge {
+
+class BridgeClient {
+public:
+    struct Options {
+        int chunkFrames = 1024;       // frames per AudioRequest
+        int maxInFlight = 4;          // requests outstanding at once
+        int helloTimeoutMs = 2000;
+        int stallTimeoutMs = 10000;   // longest wait for the next response
+        bool sharedRing = true;       // accept a shared-memory ring when the host offers one
+    };
+
+    struct Stats {
+        int64_t responses = 0;        // socket responses, or ring reads
+        int64_t frames = 0;
+        int64_t firstAudioUs = 0;     // stream() start to the first response with frames
+        int64_t meanRoundTripUs = 0;  // request sent to its response received (socket only)
+        int64_t maxRoundTripUs = 0;
+    };
+
+    /** Frames of one response, in stream order; return false to stop the stream. */
+    using AudioCallback = std::function<bool(const float* interleaved, int numFrames, int numChannels)>;
+
+    BridgeClient() = default;
+    explicit BridgeClient(Options options) : options_(options) {}
+
+    /** Connects and exchanges Hello messages. False (lastError()) when no host listens at path or it refuses. */
+    bool connect(const std::string& path, double sampleRate, int blockSize);
+    void close();
+    bool isConnected() const { return connection_.isOpen(); }
+    /** The host's Hello: the rate and channel count of the audio it streams. */
+    const Hello& hostFormat() const { return host_; }
+    /** Audio arrives through shared memory rather than AudioResponses. */
+    bool usesSharedRing() const { return ring_.isOpen(); }
+
+    bool sendParams(const Params& params);
+    bool sendMidi(int64_t frame, const uint8_t* bytes, size_t size);
+
+    /**
+     * Streams frames [0, totalFrames) of the stream the last Params configured (totalFrames <= 0: until the host
+     * ends it). True when the stream was received to its end; false on error, cancellation ("Cancelled") or when
+     * onAudio returned false. Responses to requests still in flight may follow a failed stream: close() and
+     * connect again before the next one. Over a shared ring the host writes a stream only after Params and
+     * decides its length; frames past totalFrames are skipped.
+     */
+    bool stream(int64_t totalFrames, const AudioCallback& onAudio, const CancellationToken* cancel = nullptr);
+
+    const Stats& stats() const { return stats_; }
+    const std::string& lastError() const { return lastError_; }
+
+private:
+    struct Pending {
+        int64_t frame = 0;
+        uint32_t numFrames = 0;
+        int64_t sentUs = 0;
+    };
+
+    bool fail(const std::string& error);
+    bool receiveRing();
+    bool streamShared(int64_t totalFrames, const AudioCallback& onAudio, const CancellationToken* cancel);
+
+    Options options_;
+    BridgeConnection connection_;
+    SharedAudioRing ring_;
+    uint32_t streamsStarted_ = 0;  // Params sent on this connection; the ring numbers its streams the same way
+    Hello host_;
+    Frame frame_;
+    std::vector<uint8_t> scratch_;
+    std::deque<Pending> pending_;
+    Stats stats_;
+    std::string lastError_;
+};
+
+} // namespace bridge
+} // namespace aceforge
+
+#endif
@@ -0,0 +1,251 @@
+#include "BridgeProtocol.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace aceforge {
+namespace bridge {
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "bridge samples are sent in host byte order, which must be little-endian"
+#endif
+
+namespace {
+
+constexpr size_t kHelloSize = 24;          // version, channels, rate (f64), block size, flags
+constexpr size_t kRequestSize = 16;        // frame (i64), frames, reserved
+constexpr size_t kResponseHeaderSize = 16; // frame (i64), frames, channels (u16), flags (u16); samples follow
+constexpr size_t kMidiHeaderSize = 8;      // frame (i64); bytes follow
+constexpr size_t kSharedRingSize = 16;     // channels, capacity frames, rate (f64)
+
+void put32(std::vector<uint8_t>& out, uint32_t v) {
+    const uint8_t b[4] = { (uint8_t)v, (uint8_t)(v >> 8), (uint8_t)(v >> 16), (uint8_t)(v >> 24) };
+    out.insert(out.end(), b, b + 4);
+}
+
+void put16(std::vector<uint8_t>& out, uint16_t v) {
+    const uint8_t b[2] = { (uint8_t)v, (uint8_t)(v >> 8) };
+    out.insert(out.end(), b, b + 2);
+}
+
+void put64(std::vector<uint8_t>& out, uint64_t v) {
+    put32(out, (uint32_t)v);
+    put32(out, (uint32_t)(v >> 32));
+}
+
+void putDouble(std::vector<uint8_t>& out, double v) {
+    uint64_t bits = 0;
+    std::memcpy(&bits, &v, sizeof(bits));
+    put64(out, bits);
+}
+
+void putHeader(std::vector<uint8_t>& out, MessageType type, size_t payloadSize) {
+    put32(out, (uint32_t)type);
+    put32(out, (uint32_t)payloadSize);
+}
+
+uint16_t get16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+uint32_t get32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+uint64_t get64(const uint8_t* p) {
+    return (uint64_t)get32(p) | ((uint64_t)get32(p + 4) << 32);
+}
+
+double getDouble(const uint8_t* p) {
+    const uint64_t bits = get64(p);
+    double v = 0.0;
+    std::memcpy(&v, &bits, sizeof(v));
+    return v;
+}
+
+bool knownType(uint32_t type) {
+    return type >= (uint32_t)MessageType::Hello && type <= (uint32_t)MessageType::SharedRing;
+}
+
+} // namespace
+
+void encodeHello(std::vector<uint8_t>& out, const Hello& hello) {
+    putHeader(out, MessageType::Hello, kHelloSize);
+    put32(out, hello.version);
+    put32(out, hello.numChannels);
+    putDouble(out, hello.sampleRate);
+    put32(out, hello.blockSize);
+    put32(out, hello.flags);
+}
+
+void encodeAudioRequest(std::vector<uint8_t>& out, const AudioRequest& request) {
+    putHeader(out, MessageType::AudioRequest, kRequestSize);
+    put64(out, (uint64_t)request.frame);
+    put32(out, request.numFrames);
+    put32(out, 0);
+}
+
+void encodeAudioResponse(std::vector<uint8_t>& out, int64_t frame, const float* interleaved, uint32_t numFrames,
+                         uint16_t numChannels, uint16_t flags) {
+    const size_t sampleBytes = (size_t)numFrames * numChannels * sizeof(float);
+    putHeader(out, MessageType::AudioResponse, kResponseHeaderSize + sampleBytes);
+    put64(out, (uint64_t)frame);
+    put32(out, numFrames);
+    put16(out, numChannels);
+    put16(out, flags);
+    if (sampleBytes == 0) return;
+    const auto* bytes = reinterpret_cast<const uint8_t*>(interleaved);
+    out.insert(out.end(), bytes, bytes + sampleBytes);
+}
+
+void encodeMidi(std::vector<uint8_t>& out, int64_t frame, const uint8_t* bytes, size_t size) {
+    putHeader(out, MessageType::Midi, kMidiHeaderSize + size);
+    put64(out, (uint64_t)frame);
+    if (size > 0) out.insert(out.end(), bytes, bytes + size);
+}
+
+void encodeParams(std::vector<uint8_t>& out, const Params& params) {
+    // Keys and values longer than a uint16 length can say are cut short
+    auto clamped = [](const std::string& s) { return std::min<size_t>(s.size(), 0xFFFF); };
+    size_t size = 0;
+    for (const auto& kv : params) size += 4 + clamped(kv.first) + clamped(kv.second);
+    putHeader(out, MessageType::Params, size);
+    for (const auto& kv : params) {
+        put16(out, (uint16_t)clamped(kv.first));
+        put16(out, (uint16_t)clamped(kv.second));
+        out.insert(out.end(), kv.first.begin(), kv.first.begin() + (std::ptrdiff_t)clamped(kv.first));
+        out.insert(out.end(), kv.second.begin(), kv.second.begin() + (std::ptrdiff_t)clamped(kv.second));
+    }
+}
+
+void encodeError(std::vector<uint8_t>& out, std::string_view message) {
+    putHeader(out, MessageType::Error, message.size());
+    out.insert(out.end(), message.begin(), message.end());
+}
+
+void encodeSharedRing(std::vector<uint8_t>& out, const SharedRingInfo& info) {
+    putHeader(out, MessageType::SharedRing, kSharedRingSize);
+    put32(out, info.numChannels);
+    put32(out, info.capacityFrames);
+    putDouble(out, info.sampleRate);
+}
+
+bool decodeHello(const Frame& frame, Hello& out) {
+    if (frame.type != MessageType::Hello || frame.payload.size() != kHelloSize) return false;
+    const uint8_t* p = frame.payload.data();
+    out.version = get32(p);
+    out.numChannels = get32(p + 4);
+    out.sampleRate = getDouble(p + 8);
+    out.blockSize = get32(p + 16);
+    out.flags = get32(p + 20);
+    return true;
+}
+
+bool decodeAudioRequest(const Frame& frame, AudioRequest& out) {
+    if (frame.type != MessageType::AudioRequest || frame.payload.size() != kRequestSize) return false;
+    const uint8_t* p = frame.payload.data();
+    out.frame = (int64_t)get64(p);
+    out.numFrames = get32(p + 8);
+    return true;
+}
+
+bool decodeAudioResponse(const Frame& frame, AudioResponse& out) {
+    if (frame.type != MessageType::AudioResponse || frame.payload.size() < kResponseHeaderSize) return false;
+    const uint8_t* p = frame.payload.data();
+    out.frame = (int64_t)get64(p);
+    out.numFrames = get32(p + 8);
+    out.numChannels = get16(p + 12);
+    out.flags = get16(p + 14);
+    if (frame.payload.size() - kResponseHeaderSize != (size_t)out.numFrames * out.numChannels * sizeof(float))
+        return false;
+    if (out.numFrames > 0 && out.numChannels == 0) return false;
+    // The payload buffer comes from operator new, so the samples after the 16-byte header are float-aligned
+    out.samples = reinterpret_cast<const float*>(p + kResponseHeaderSize);
+    return true;
+}
+
+bool decodeMidi(const Frame& frame, MidiEvent& out) {
+    if (frame.type != MessageType::Midi || frame.payload.size() < kMidiHeaderSize) return false;
+    out.frame = (int64_t)get64(frame.payload.data());
+    out.bytes = frame.payload.data() + kMidiHeaderSize;
+    out.size = frame.payload.size() - kMidiHeaderSize;
+    return true;
+}
+
+bool decodeParams(const Frame& frame, Params& out) {
+    if (frame.type != MessageType::Params) return false;
+    out.clear();
+    const uint8_t* p = frame.payload.data();
+    size_t left = frame.payload.size();
+    while (left > 0) {
+        if (left < 4) return false;
+        const size_t keySize = get16(p);
+        const size_t valueSize = get16(p + 2);
+        p += 4;
+        left -= 4;
+        if (left < keySize + valueSize) return false;
+        out.emplace_back(std::string((const char*)p, keySize), std::string((const char*)p + keySize, valueSize));
+        p += keySize + valueSize;
+        left -= keySize + valueSize;
+    }
+    return true;
+}
+
+bool decodeError(const Frame& frame, std::string& out) {
+    if (frame.type != MessageType::Error) return false;
+    out.assign((const char*)frame.payload.data(), frame.payload.size());
+    return true;
+}
+
+bool decodeSharedRing(const Frame& frame, SharedRingInfo& out) {
+    if (frame.type != MessageType::SharedRing || frame.payload.size() != kSharedRingSize) return false;
+    const uint8_t* p = frame.payload.data();
+    out.numChannels = get32(p);
+    out.capacityFrames = get32(p + 4);
+    out.sampleRate = getDouble(p + 8);
+    return true;
+}
+
+std::string findParam(const Params& params, std::string_view key, std::string_view fallback) {
+    for (const auto& kv : params)
+        if (kv.first == key) return kv.second;
+    return std::string(fallback);
+}
+
+void FrameReader::push(const uint8_t* data, size_t size) {
+    if (failed() || size == 0) return;
+    // Drop consumed bytes once they make up most of the buffer, so it stays about one message long
+    if (readPos_ > 0 && readPos_ >= buffer_.size() / 2) {
+        buffer_.erase(buffer_.begin(), buffer_.begin() + (std::ptrdiff_t)readPos_);
+        readPos_ = 0;
+    }
+    buffer_.insert(buffer_.end(), data, data + size);
+}
+
+bool FrameReader::next(Frame& frame) {
+    if (failed() || buffered() < kHeaderSize) return false;
+    const uint8_t* p = buffer_.data() + readPos_;
+    const uint32_t type = get32(p);
+    const uint32_t size = get32(p + 4);
+    if (!knownType(type)) {
+        error_ = "unknown message type " + std::to_string(type);
+        return false;
+    }
+    if (size > kMaxPayload) {
+        error_ = "payload of " + std::to_string(size) + " bytes exceeds the limit";
+        return false;
+    }
+    if (buffered() < kHeaderSize + size) return false;
+    frame.type = (MessageType)type;
+    frame.payload.assign(p + kHeaderSize, p + kHeaderSize + size);
+    readPos_ += kHeaderSize + size;
+    return true;
+}
+
+void FrameReader::reset() {
+    buffer_.clear();
+    readPos_ = 0;
+    error_.clear();
+}
+
+} // namespace bridge
+} // namespace aceforge
@@ -0,0 +1,138 @@
+/**
+ * Binary framing for the plugin <-> local ML host protocol (protocol.md).
+ *
+ * Every message is an 8-byte header (uint32 type, uint32 payload size, little-endian) followed by the payload.
+ * The encode* functions append one whole message to a byte vector (reusing its capacity, so a sender that keeps
+ * the vector allocates nothing in steady state); FrameReader cuts a received byte stream back into messages and
+ * the decode* functions check a payload's size and layout before reading it. Nothing here touches a socket:
+ * BridgeSocket and BridgeClient carry the bytes.
+ *
+ * Samples are float32 in host byte order, which on every supported target (x86-64, ARM64) is little-endian.
+ */
+#ifndef ACEFORGE_BRIDGE_PROTOCOL_HPP
+#define ACEFORGE_BRIDGE_PROTOCOL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace aceforge {
+namespace bridge {
+
+constexpr uint32_t kVersion = 1;
+constexpr size_t kHeaderSize = 8;
+/** Larger payloads are treated as a corrupt stream (a 16 MiB response is ~44 s of 48 kHz stereo). */
+constexpr uint32_t kMaxPayload = 1u << 24;
+/** Where the plugin looks for a local host, and where aceforge_bridge_host listens by default. */
+constexpr const char* kDefaultSocketPath = "/tmp/aceforge-bridge.sock";
+
+enum class MessageType : uint32_t {
+    Hello = 0x01,          // both ways: format offer (plugin), format the stream will use (host)
+    AudioRequest = 0x02,   // plugin -> host: frames [frame, frame + numFrames) of the stream
+    AudioResponse = 0x03,  // host -> plugin: those frames, interleaved float32
+    Midi = 0x04,           // plugin -> host: raw MIDI bytes at a stream frame
+    Params = 0x05,         // plugin -> host: UTF-8 key/value pairs for the next stream
+    Error = 0x06,          // host -> plugin: UTF-8 message
+    SharedRing = 0x07,     // host -> plugin: format of a SharedAudioRing; its two fds travel with the message
+};
+
+/** AudioResponse flag: the stream ends after this response's frames. */
+constexpr uint16_t kEndOfStream = 0x0001;
+/** Hello flag. Plugin: can read audio from a shared-memory ring. Host: a SharedRing message follows. */
+constexpr uint32_t kHelloSharedRing = 0x0001;
+
+struct Hello {
+    uint32_t version = kVersion;
+    uint32_t numChannels = 2;
+    double sampleRate = 0.0;
+    uint32_t blockSize = 0;  // plugin: host block size; host: preferred request size (0: any)
+    uint32_t flags = 0;      // kHelloSharedRing
+};
+
+struct AudioRequest {
+    int64_t frame = 0;
+    uint32_t numFrames = 0;
+};
+
+/** A decoded AudioResponse; samples point into the frame it was decoded from. */
+struct AudioResponse {
+    int64_t frame = 0;
+    uint32_t numFrames = 0;
+    uint16_t numChannels = 0;
+    uint16_t flags = 0;
+    const float* samples = nullptr;  // numFrames * numChannels, interleaved
+    bool endOfStream() const { return (flags & kEndOfStream) != 0; }
+};
+
+struct MidiEvent {
+    int64_t frame = 0;
+    const uint8_t* bytes = nullptr;
+    size_t size = 0;
+};
+
+using Params = std::vector<std::pair<std::string, std::string>>;
+
+/** Shape of the ring a SharedRing message hands over (the ring's own header says the same; both are checked). */
+struct SharedRingInfo {
+    uint32_t numChannels = 0;
+    uint32_t capacityFrames = 0;
+    double sampleRate = 0.0;
+};
+
+/** One received message. The payload buffer is reused across next() calls. */
+struct Frame {
+    MessageType type = MessageType::Hello;
+    std::vector<uint8_t> payload;
+};
+
+// Encoders: append header and payload to out
+void encodeHello(std::vector<uint8_t>& out, const Hello& hello);
+void encodeAudioRequest(std::vector<uint8_t>& out, const AudioRequest& request);
+/** interleaved holds numFrames * numChannels samples (may be null when numFrames is 0). */
+void encodeAudioResponse(std::vector<uint8_t>& out, int64_t frame, const float* interleaved, uint32_t numFrames,
+                         uint16_t numChannels, uint16_t flags);
+void encodeMidi(std::vector<uint8_t>& out, int64_t frame, const uint8_t* bytes, size_t size);
+void encodeParams(std::vector<uint8_t>& out, const Params& params);
+void encodeError(std::vector<uint8_t>& out, std::string_view message);
+void encodeSharedRing(std::vector<uint8_t>& out, const SharedRingInfo& info);
+
+// Decoders: false when the payload does not have the type's layout (the frame must be of that type)
+bool decodeHello(const Frame& frame, Hello& out);
+bool decodeAudioRequest(const Frame& frame, AudioRequest& out);
+bool decodeAudioResponse(const Frame& frame, AudioResponse& out);
+bool decodeMidi(const Frame& frame, MidiEvent& out);
+bool decodeParams(const Frame& frame, Params& out);
+bool decodeError(const Frame& frame, std::string& out);
+bool decodeSharedRing(const Frame& frame, SharedRingInfo& out);
+
+/** Value of key in params, or fallback. */
+std::string findParam(const Params& params, std::string_view key, std::string_view fallback = {});
+
+/**
+ * Reassembles messages from a byte stream that arrives in arbitrary pieces. An unknown type or a payload over
+ * kMaxPayload fails the reader for good (error()): there is no way to find the next header after a bad one.
+ */
+class FrameReader {
+public:
+    void push(const uint8_t* data, size_t size);
+    /** Moves the next complete message into frame; false when more bytes are needed or the reader failed. */
+    bool next(Frame& frame);
+    bool failed() const { return !error_.empty(); }
+    const std::string& error() const { return error_; }
+    /** Bytes received but not yet returned as a message. */
+    size_t buffered() const { return buffer_.size() - readPos_; }
+    void reset();
+
+private:
+    std::vector<uint8_t> buffer_;
+    size_t readPos_ = 0;
+    std::string error_;
+};
+
+} // namespace bridge
+} // namespace aceforge
+
+#endif
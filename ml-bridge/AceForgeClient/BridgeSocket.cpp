@@ -0,0 +1,262 @@
+#include "BridgeSocket.hpp"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace aceforge {
+namespace bridge {
+
+namespace {
+
+constexpr size_t kReadChunk = 64 * 1024;
+// Unix socket buffers default to a few KB on macOS: big enough here for several responses in flight
+constexpr int kSocketBufferBytes = 512 * 1024;
+constexpr int kMaxFdsPerMessage = 4;
+
+#ifdef MSG_NOSIGNAL
+constexpr int kSendFlags = MSG_NOSIGNAL;
+#else
+constexpr int kSendFlags = 0;
+#endif
+#ifdef MSG_CMSG_CLOEXEC
+constexpr int kReceiveFlags = MSG_CMSG_CLOEXEC;
+#else
+constexpr int kReceiveFlags = 0;
+#endif
+
+bool makeAddress(const std::string& path, sockaddr_un& addr, std::string& errorOut) {
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(addr.sun_path)) {
+        errorOut = "Invalid socket path: " + path;
+        return false;
+    }
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+    return true;
+}
+
+void configureSocket(int fd) {
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+    int size = kSocketBufferBytes;
+    setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &size, sizeof(size));
+    setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+#ifdef SO_NOSIGPIPE
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));  // no MSG_NOSIGNAL on macOS
+#endif
+}
+
+} // namespace
+
+BridgeConnection::BridgeConnection(int fd) : fd_(fd) {
+    if (fd_ >= 0) configureSocket(fd_);
+}
+
+BridgeConnection::~BridgeConnection() {
+    close();
+}
+
+bool BridgeConnection::connect(const std::string& path) {
+    close();
+    sockaddr_un addr;
+    if (!makeAddress(path, addr, error_)) return false;
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return fail(std::string("socket: ") + std::strerror(errno));
+    // Local connects complete (or are refused) at once; no timeout needed
+    if (::connect(fd, (const sockaddr*)&addr, sizeof(addr)) != 0) {
+        error_ = "Cannot connect to " + path + ": " + std::strerror(errno);
+        ::close(fd);
+        return false;
+    }
+    fd_ = fd;
+    configureSocket(fd_);
+    return true;
+}
+
+void BridgeConnection::close() {
+    if (fd_ >= 0) ::close(fd_);
+    fd_ = -1;
+    out_.clear();
+    outPos_ = 0;
+    reader_.reset();
+    for (int fd : receivedFds_) ::close(fd);
+    receivedFds_.clear();
+    error_.clear();
+    closedByPeer_ = false;
+}
+
+bool BridgeConnection::fail(const std::string& what) {
+    error_ = what;
+    if (fd_ >= 0) ::close(fd_);
+    fd_ = -1;
+    return false;
+}
+
+bool BridgeConnection::send(const std::vector<uint8_t>& bytes) {
+    if (fd_ < 0) return false;
+    if (outPos_ == out_.size()) {
+        out_.clear();
+        outPos_ = 0;
+    }
+    out_.insert(out_.end(), bytes.begin(), bytes.end());
+    return flush();
+}
+
+bool BridgeConnection::sendWithFds(const std::vector<uint8_t>& bytes, const int* fds, int numFds) {
+    if (fd_ < 0) return false;
+    if (numFds < 1 || numFds > kMaxFdsPerMessage) return fail("Invalid descriptor count");
+    if (!flush()) return false;
+    if (hasPendingOutput()) return fail("Socket busy: cannot attach descriptors");
+    iovec iov{ const_cast<uint8_t*>(bytes.data()), bytes.size() };
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int) * kMaxFdsPerMessage)] = {};
+    msghdr msg{};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = CMSG_SPACE(sizeof(int) * (size_t)numFds);
+    cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(int) * (size_t)numFds);
+    std::memcpy(CMSG_DATA(cmsg), fds, sizeof(int) * (size_t)numFds);
+    ssize_t n;
+    while ((n = ::sendmsg(fd_, &msg, kSendFlags)) < 0 && errno == EINTR) {
+    }
+    if (n <= 0) return fail(std::string("sendmsg: ") + std::strerror(errno));
+    // The descriptors went with the first byte; whatever the socket did not take goes out as plain bytes
+    if ((size_t)n < bytes.size()) {
+        out_.assign(bytes.begin() + n, bytes.end());
+        outPos_ = 0;
+    }
+    return flush();
+}
+
+bool BridgeConnection::flush() {
+    if (fd_ < 0) return false;
+    while (outPos_ < out_.size()) {
+        const ssize_t n = ::send(fd_, out_.data() + outPos_, out_.size() - outPos_, kSendFlags);
+        if (n > 0) {
+            outPos_ += (size_t)n;
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return true;  // the rest goes on the next flush
+        return fail(std::string("send: ") + std::strerror(errno));
+    }
+    out_.clear();
+    outPos_ = 0;
+    return true;
+}
+
+bool BridgeConnection::receive(Frame& frame) {
+    if (reader_.next(frame)) return true;
+    if (fd_ < 0) return false;
+    if (readBuffer_.size() < kReadChunk) readBuffer_.resize(kReadChunk);
+    for (;;) {
+        iovec iov{ readBuffer_.data(), readBuffer_.size() };
+        alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int) * kMaxFdsPerMessage)];
+        msghdr msg{};
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+        const ssize_t n = ::recvmsg(fd_, &msg, kReceiveFlags);
+        if (n >= 0) {
+            for (cmsghdr* c = CMSG_FIRSTHDR(&msg); c != nullptr; c = CMSG_NXTHDR(&msg, c)) {
+                if (c->cmsg_level != SOL_SOCKET || c->cmsg_type != SCM_RIGHTS) continue;
+                const size_t count = (c->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+                for (size_t i = 0; i < count; ++i) {
+                    int fd;
+                    std::memcpy(&fd, CMSG_DATA(c) + i * sizeof(int), sizeof(int));
+                    receivedFds_.push_back(fd);
+                }
+            }
+        }
+        if (n > 0) {
+            reader_.push(readBuffer_.data(), (size_t)n);
+            if (reader_.failed()) return fail("Bridge protocol error: " + reader_.error());
+            if (reader_.next(frame)) return true;
+            if (reader_.failed()) return fail("Bridge protocol error: " + reader_.error());
+            continue;
+        }
+        if (n == 0) {
+            closedByPeer_ = reader_.buffered() == 0;
+            return fail(closedByPeer_ ? "Connection closed by the host" : "Connection closed mid-message");
+        }
+        if (errno == EINTR) continue;
+        if (errno == EAGAIN || errno == EWOULDBLOCK) return false;
+        return fail(std::string("recv: ") + std::strerror(errno));
+    }
+}
+
+bool BridgeConnection::wait(int timeoutMs) {
+    if (fd_ < 0 || !flush()) return false;
+    pollfd p{ fd_, (short)(POLLIN | (hasPendingOutput() ? POLLOUT : 0)), 0 };
+    for (;;) {
+        const int r = ::poll(&p, 1, timeoutMs);
+        if (r < 0 && errno == EINTR) continue;
+        return r > 0;
+    }
+}
+
+std::vector<int> BridgeConnection::takeReceivedFds() {
+    std::vector<int> fds;
+    fds.swap(receivedFds_);
+    return fds;
+}
+
+BridgeListener::~BridgeListener() {
+    close();
+}
+
+bool BridgeListener::listen(const std::string& path) {
+    close();
+    sockaddr_un addr;
+    if (!makeAddress(path, addr, error_)) return false;
+    // A socket file nobody accepts on is left over from a host that did not shut down cleanly
+    struct stat st;
+    if (::stat(path.c_str(), &st) == 0 && S_ISSOCK(st.st_mode)) {
+        BridgeConnection probe;
+        if (probe.connect(path)) {
+            error_ = "Another host is already listening at " + path;
+            return false;
+        }
+        ::unlink(path.c_str());
+    }
+    fd_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd_ < 0) {
+        error_ = std::string("socket: ") + std::strerror(errno);
+        return false;
+    }
+    if (::bind(fd_, (const sockaddr*)&addr, sizeof(addr)) != 0 || ::listen(fd_, 4) != 0) {
+        error_ = "Cannot listen at " + path + ": " + std::strerror(errno);
+        ::close(fd_);
+        fd_ = -1;
+        return false;
+    }
+    path_ = path;
+    return true;
+}
+
+int BridgeListener::accept(int timeoutMs) {
+    if (fd_ < 0) return -1;
+    pollfd p{ fd_, POLLIN, 0 };
+    if (::poll(&p, 1, timeoutMs) <= 0) return -1;
+    return ::accept(fd_, nullptr, nullptr);
+}
+
+void BridgeListener::close() {
+    if (fd_ < 0) return;
+    ::close(fd_);
+    fd_ = -1;
+    ::unlink(path_.c_str());
+    path_.clear();
+}
+
+} // namespace bridge
+} // namespace aceforge
@@ -0,0 +1,110 @@
+/**
+ * Unix domain stream sockets for the bridge protocol (BridgeProtocol.hpp). POSIX only (macOS, Linux).
+ *
+ * BridgeConnection is one end of a connection, non-blocking in both directions: send() writes what the socket
+ * takes and queues the rest, receive() reads what has arrived and returns complete messages, and wait() polls
+ * for either. A peer that stops reading therefore never blocks the sender, and a sender can keep several
+ * requests in flight while responses stream back on the same socket. BridgeListener accepts connections on a
+ * socket path (the host side). File descriptors (a SharedAudioRing) can travel with a message: sendWithFds() on one
+ * end, takeReceivedFds() on the other.
+ *
+ * A connection belongs to one thread at a time.
+ */
+#ifndef ACEFORGE_BRIDGE_SOCKET_HPP
+#define ACEFORGE_BRIDGE_SOCKET_HPP
+
+#include "BridgeProtocol.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace aceforge {
+namespace bridge {
+
+class BridgeConnection {
+public:
+    BridgeConnection() = default;
+    /** Adopts a connected socket (e.g. from BridgeListener::accept) and makes it non-blocking. */
+    explicit BridgeConnection(int fd);
+    ~BridgeConnection();
+    BridgeConnection(const BridgeConnection&) = delete;
+    BridgeConnection& operator=(const BridgeConnection&) = delete;
+
+    /** Connects to the socket at path. False (error() set) when nothing listens there. */
+    bool connect(const std::string& path);
+    void close();
+    bool isOpen() const { return fd_ >= 0; }
+
+    /** Queues bytes (whole messages) and sends as much as the socket takes now. False once the connection failed. */
+    bool send(const std::vector<uint8_t>& bytes);
+    /**
+     * Sends one message with file descriptors attached (SCM_RIGHTS); the receiver gets its own copies. Flushes queued
+     * output first; false (error() set) when that cannot happen without blocking.
+     */
+    bool sendWithFds(const std::vector<uint8_t>& bytes, const int* fds, int numFds);
+    /** Sends queued bytes without blocking. */
+    bool flush();
+    bool hasPendingOutput() const { return outPos_ < out_.size(); }
+
+    /**
+     * Reads whatever has arrived without blocking and moves the next complete message into frame. False when no
+     * message is complete yet; check isOpen() / error() to tell that apart from a closed or corrupt stream.
+     */
+    bool receive(Frame& frame);
+
+    /**
+     * Waits up to timeoutMs (-1: forever) until a message may be read or, while output is queued, the socket
+     * takes more; flushes queued output first. False on timeout or error.
+     */
+    bool wait(int timeoutMs);
+
+    /**
+     * Descriptors that arrived with the messages read so far, in order; the caller owns them. They come with the
+     * first byte of their message, so they are here by the time receive() returns that message.
+     */
+    std::vector<int> takeReceivedFds();
+
+    const std::string& error() const { return error_; }
+    /** The peer closed the connection cleanly (no partial message left behind). */
+    bool closedByPeer() const { return closedByPeer_; }
+
+private:
+    bool fail(const std::string& what);
+
+    int fd_ = -1;
+    std::vector<uint8_t> out_;
+    size_t outPos_ = 0;
+    FrameReader reader_;
+    std::vector<uint8_t> readBuffer_;
+    std::vector<int> receivedFds_;
+    std::string error_;
+    bool closedByPeer_ = false;
+};
+
+class BridgeListener {
+public:
+    BridgeListener() = default;
+    ~BridgeListener();
+    BridgeListener(const BridgeListener&) = delete;
+    BridgeListener& operator=(const BridgeListener&) = delete;
+
+    /** Binds and listens at path, replacing a stale socket file left by a host that died. */
+    bool listen(const std::string& path);
+    /** A connected socket, or -1 when none arrived within timeoutMs. */
+    int accept(int timeoutMs);
+    /** Stops listening and removes the socket file. */
+    void close();
+
+    const std::string& path() const { return path_; }
+    const std::string& error() const { return error_; }
+
+private:
+    int fd_ = -1;
+    std::string path_;
+    std::string error_;
+};
+
+} // namespace bridge
+} // namespace aceforge
+
+#endif
@@ -0,0 +1,251 @@
+#include "SharedAudioRing.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <new>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace aceforge {
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free,
+              "ring positions are shared between processes and must be lock-free");
+
+// In the shared mapping, followed by the samples at kDataOffset. Each position has its own cache line so the
+// writer's and the reader's stores do not contend.
+struct SharedAudioRing::Header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t numChannels;
+    uint32_t capacityFrames;
+    double sampleRate;
+    alignas(64) std::atomic<uint64_t> writeFrame;  // writer only
+    alignas(64) std::atomic<uint64_t> readFrame;   // reader only
+    alignas(64) std::atomic<uint32_t> endedStream; // writer only
+};
+
+namespace {
+
+constexpr uint32_t kMagic = 0x52464641;  // "AFFR"
+constexpr uint32_t kRingVersion = 1;
+constexpr int kMaxChannels = 64;
+constexpr int kMaxCapacityFrames = 1 << 24;
+
+constexpr size_t kDataOffset = 256;  // samples start on their own cache line after the header
+
+void setFlags(int fd) {
+    fcntl(fd, F_SETFD, fcntl(fd, F_GETFD, 0) | FD_CLOEXEC);
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+}
+
+int createSharedMemory() {
+#ifdef __linux__
+    return ::memfd_create("aceforge-ring", MFD_CLOEXEC);
+#else
+    // No memfd on macOS: a fresh shm name, unlinked at once so only the descriptors keep it alive
+    static std::atomic<uint32_t> counter{ 0 };
+    const std::string name = "/aceforge." + std::to_string((long)getpid()) + "." + std::to_string(counter++);
+    const int fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd >= 0) ::shm_unlink(name.c_str());
+    return fd;
+#endif
+}
+
+void closeFd(int& fd) {
+    if (fd >= 0) ::close(fd);
+    fd = -1;
+}
+
+} // namespace
+
+SharedAudioRing::~SharedAudioRing() {
+    close();
+}
+
+bool SharedAudioRing::fail(const std::string& what) {
+    error_ = what;
+    close();
+    return false;
+}
+
+bool SharedAudioRing::map(int fd, size_t bytes) {
+    static_assert(sizeof(Header) <= kDataOffset, "ring header overlaps the samples");
+    void* p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED) return fail(std::string("mmap: ") + std::strerror(errno));
+    header_ = (Header*)p;
+    samples_ = (float*)((uint8_t*)p + kDataOffset);
+    mappedBytes_ = bytes;
+    return true;
+}
+
+bool SharedAudioRing::create(int numChannels, int capacityFrames, double sampleRate) {
+    close();
+    error_.clear();
+    if (numChannels < 1 || numChannels > kMaxChannels || capacityFrames < 1 || capacityFrames > kMaxCapacityFrames
+        || !(sampleRate > 0.0))
+        return fail("Invalid ring format");
+    uint64_t capacity = 1;
+    while (capacity < (uint64_t)capacityFrames) capacity <<= 1;
+    const size_t bytes = kDataOffset + (size_t)capacity * (size_t)numChannels * sizeof(float);
+
+    memoryFd_ = createSharedMemory();
+    if (memoryFd_ < 0) return fail(std::string("shared memory: ") + std::strerror(errno));
+    if (::ftruncate(memoryFd_, (off_t)bytes) != 0) return fail(std::string("ftruncate: ") + std::strerror(errno));
+    int pipeFds[2];
+    if (::pipe(pipeFds) != 0) return fail(std::string("pipe: ") + std::strerror(errno));
+    doorbellReadFd_ = pipeFds[0];
+    doorbellWriteFd_ = pipeFds[1];
+    setFlags(doorbellReadFd_);
+    setFlags(doorbellWriteFd_);
+    if (!map(memoryFd_, bytes)) return false;
+
+    Header* h = new (header_) Header();
+    h->magic = kMagic;
+    h->version = kRingVersion;
+    h->numChannels = (uint32_t)numChannels;
+    h->capacityFrames = (uint32_t)capacity;
+    h->sampleRate = sampleRate;
+    h->writeFrame.store(0, std::memory_order_relaxed);
+    h->readFrame.store(0, std::memory_order_relaxed);
+    h->endedStream.store(0, std::memory_order_release);
+    numChannels_ = numChannels;
+    capacity_ = capacity;
+    return true;
+}
+
+bool SharedAudioRing::attach(int memoryFd, int doorbellFd) {
+    close();
+    error_.clear();
+    doorbellReadFd_ = doorbellFd;
+    struct stat st;
+    if (memoryFd < 0 || doorbellFd < 0 || ::fstat(memoryFd, &st) != 0 || (size_t)st.st_size < kDataOffset) {
+        if (memoryFd >= 0) ::close(memoryFd);
+        return fail("Not a shared ring");
+    }
+    setFlags(doorbellReadFd_);
+    const bool mapped = map(memoryFd, (size_t)st.st_size);
+    ::close(memoryFd);  // the mapping keeps the memory alive
+    if (!mapped) return false;
+    // The writer is another process: check the layout before trusting any of it
+    const Header* h = header_;
+    const uint64_t capacity = h->capacityFrames;
+    if (h->magic != kMagic || h->version != kRingVersion || h->numChannels < 1 || h->numChannels > (uint32_t)kMaxChannels
+        || capacity == 0 || capacity > (uint64_t)kMaxCapacityFrames || (capacity & (capacity - 1)) != 0
+        || kDataOffset + capacity * h->numChannels * sizeof(float) > mappedBytes_)
+        return fail("Shared ring has an unknown layout");
+    numChannels_ = (int)h->numChannels;
+    capacity_ = capacity;
+    return true;
+}
+
+void SharedAudioRing::close() {
+    if (header_ != nullptr) ::munmap(header_, mappedBytes_);
+    header_ = nullptr;
+    samples_ = nullptr;
+    mappedBytes_ = 0;
+    numChannels_ = 0;
+    capacity_ = 0;
+    closeFd(memoryFd_);
+    closeFd(doorbellReadFd_);
+    closeFd(doorbellWriteFd_);
+}
+
+void SharedAudioRing::closeSharedFds() {
+    closeFd(memoryFd_);
+    closeFd(doorbellReadFd_);
+}
+
+double SharedAudioRing::sampleRate() const {
+    return header_ != nullptr ? header_->sampleRate : 0.0;
+}
+
+int SharedAudioRing::writableFrames() const {
+    if (header_ == nullptr) return 0;
+    const uint64_t used = header_->writeFrame.load(std::memory_order_relaxed)
+                          - header_->readFrame.load(std::memory_order_acquire);
+    return used >= capacity_ ? 0 : (int)(capacity_ - used);
+}
+
+SharedAudioRing::Regions<float> SharedAudioRing::prepareWrite(int maxFrames) {
+    Regions<float> r;
+    const int n = std::min(writableFrames(), std::max(0, maxFrames));
+    if (n == 0) return r;
+    const uint64_t index = header_->writeFrame.load(std::memory_order_relaxed) & (capacity_ - 1);
+    const int first = (int)std::min<uint64_t>((uint64_t)n, capacity_ - index);
+    r.data[0] = samples_ + index * (uint64_t)numChannels_;
+    r.frames[0] = first;
+    if (n > first) {
+        r.data[1] = samples_;
+        r.frames[1] = n - first;
+    }
+    return r;
+}
+
+void SharedAudioRing::commitWrite(int frames) {
+    if (header_ == nullptr || frames <= 0) return;
+    header_->writeFrame.store(header_->writeFrame.load(std::memory_order_relaxed) + (uint64_t)frames,
+                              std::memory_order_release);
+    const uint8_t ring = 1;
+    // A full pipe means the reader has wake-ups pending already
+    while (::write(doorbellWriteFd_, &ring, 1) < 0 && errno == EINTR) {
+    }
+}
+
+void SharedAudioRing::endStream(uint32_t stream) {
+    if (header_ == nullptr) return;
+    header_->endedStream.store(stream, std::memory_order_release);
+    const uint8_t ring = 1;
+    while (::write(doorbellWriteFd_, &ring, 1) < 0 && errno == EINTR) {
+    }
+}
+
+int SharedAudioRing::readableFrames() const {
+    if (header_ == nullptr) return 0;
+    const uint64_t available = header_->writeFrame.load(std::memory_order_acquire)
+                               - header_->readFrame.load(std::memory_order_relaxed);
+    return (int)std::min(available, capacity_);  // a writer that lies about its position cannot push reads out of the ring
+}
+
+SharedAudioRing::Regions<const float> SharedAudioRing::prepareRead(int maxFrames) const {
+    Regions<const float> r;
+    const int n = std::min(readableFrames(), std::max(0, maxFrames));
+    if (n == 0) return r;
+    const uint64_t index = header_->readFrame.load(std::memory_order_relaxed) & (capacity_ - 1);
+    const int first = (int)std::min<uint64_t>((uint64_t)n, capacity_ - index);
+    r.data[0] = samples_ + index * (uint64_t)numChannels_;
+    r.frames[0] = first;
+    if (n > first) {
+        r.data[1] = samples_;
+        r.frames[1] = n - first;
+    }
+    return r;
+}
+
+void SharedAudioRing::commitRead(int frames) {
+    if (header_ == nullptr || frames <= 0) return;
+    header_->readFrame.store(header_->readFrame.load(std::memory_order_relaxed) + (uint64_t)frames,
+                             std::memory_order_release);
+}
+
+uint32_t SharedAudioRing::endedStream() const {
+    return header_ != nullptr ? header_->endedStream.load(std::memory_order_acquire) : 0;
+}
+
+bool SharedAudioRing::waitReadable(int timeoutMs) {
+    if (doorbellReadFd_ < 0) return false;
+    pollfd p{ doorbellReadFd_, POLLIN, 0 };
+    int r;
+    while ((r = ::poll(&p, 1, timeoutMs)) < 0 && errno == EINTR) {
+    }
+    if (r <= 0 || (p.revents & POLLIN) == 0) return false;  // timeout, or the writer is gone (POLLHUP)
+    uint8_t drain[64];
+    ssize_t n;
+    while ((n = ::read(doorbellReadFd_, drain, sizeof(drain))) > 0 || (n < 0 && errno == EINTR)) {
+    }
+    return true;
+}
+
+} // namespace aceforge
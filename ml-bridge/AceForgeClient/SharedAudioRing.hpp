@@ -0,0 +1,97 @@
+/**
+ * Single-producer single-consumer ring of interleaved float frames in shared memory, for handing audio from a local
+ * generation host to a plugin instance without copying it through a socket. POSIX only (macOS, Linux).
+ *
+ * The writer (host) create()s the ring: an anonymous shared-memory file (memfd_create on Linux, an shm_open name
+ * unlinked at once on macOS) mapped into both processes, and a pipe as doorbell. It passes memoryFd() and
+ * doorbellFd() to the reader over the bridge socket (SCM_RIGHTS, BridgeConnection::sendWithFds), and the reader
+ * attach()es to them. Frames are then written straight into the mapping (prepareWrite / commitWrite) and read
+ * straight out of it (prepareRead / commitRead): each side sees at most two contiguous regions because the ring
+ * wraps. Positions are 64-bit frame counters that only grow, one per side, each written by its owner alone with
+ * release stores and read by the other with acquire loads, so no locks and no read-modify-write are needed.
+ * commitWrite() writes one byte to the doorbell, which the reader polls (waitReadable) instead of spinning.
+ *
+ * A ring carries successive streams; the writer marks the end of stream n with endStream(n) after its last frame.
+ */
+#ifndef ACEFORGE_SHARED_AUDIO_RING_HPP
+#define ACEFORGE_SHARED_AUDIO_RING_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace aceforge {
+
+class SharedAudioRing {
+public:
+    /** Up to two contiguous runs of interleaved frames; frames[1] is non-zero only where the ring wraps. */
+    template <typename Sample>
+    struct Regions {
+        Sample* data[2] = { nullptr, nullptr };
+        int frames[2] = { 0, 0 };
+        int total() const { return frames[0] + frames[1]; }
+    };
+
+    SharedAudioRing() = default;
+    ~SharedAudioRing();
+    SharedAudioRing(const SharedAudioRing&) = delete;
+    SharedAudioRing& operator=(const SharedAudioRing&) = delete;
+
+    /** Writer: maps a new ring of at least capacityFrames (rounded up to a power of two). False (error()) on failure. */
+    bool create(int numChannels, int capacityFrames, double sampleRate);
+    /** Reader: maps the ring behind memoryFd and keeps doorbellFd; takes ownership of both, even on failure. */
+    bool attach(int memoryFd, int doorbellFd);
+    void close();
+    bool isOpen() const { return header_ != nullptr; }
+
+    /** Writer: the descriptors to pass to the reader. Close them with closeSharedFds() once they were sent. */
+    int memoryFd() const { return memoryFd_; }
+    int doorbellFd() const { return doorbellReadFd_; }
+    void closeSharedFds();
+
+    int numChannels() const { return numChannels_; }
+    int capacityFrames() const { return (int)capacity_; }
+    double sampleRate() const;
+    const std::string& error() const { return error_; }
+
+    // Writer
+    int writableFrames() const;
+    /** Free space, up to maxFrames, as regions to render into. */
+    Regions<float> prepareWrite(int maxFrames);
+    /** Publishes frames written into the regions of prepareWrite and rings the doorbell. */
+    void commitWrite(int frames);
+    /** Stream `stream` has no frames after the ones committed so far. */
+    void endStream(uint32_t stream);
+
+    // Reader
+    int readableFrames() const;
+    /** Published frames, up to maxFrames; they stay valid until commitRead. */
+    Regions<const float> prepareRead(int maxFrames) const;
+    /** Frees frames returned by prepareRead for the writer. */
+    void commitRead(int frames);
+    /** Last stream the writer ended (0: none). Load it before readableFrames() to know those frames are all there. */
+    uint32_t endedStream() const;
+    /** Waits up to timeoutMs for the doorbell (-1: forever) and drains it. True when rung. */
+    bool waitReadable(int timeoutMs);
+
+private:
+    struct Header;
+
+    bool map(int fd, size_t bytes);
+    bool fail(const std::string& what);
+
+    Header* header_ = nullptr;
+    float* samples_ = nullptr;
+    size_t mappedBytes_ = 0;
+    int numChannels_ = 0;
+    uint64_t capacity_ = 0;
+    int memoryFd_ = -1;
+    int doorbellReadFd_ = -1;
+    int doorbellWriteFd_ = -1;
+    std::string error_;
+};
+
+} // namespace aceforge
+
+#endif
@@ -0,0 +1,104 @@
+/**
+ * Microbenchmark for AsyncLog (AceForgeAudio): caller-side cost of one log line through the ring, with one and
+ * several producer threads, against the old open-append-flush-close per line. Prints ns per line on the calling
+ * thread, the worst single call and lines dropped to a full ring.
+ *
+ *   aceforge_log_bench [lines per thread] [directory for the log files]
+ */
+#include "AceForgeAudio/AsyncLog.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const char kLine[] = "finishFetchedAudio: decoded rate=48000 ch=2 samples=1440000 in 12.34 ms";
+
+struct Result {
+    double nsPerLine = 0.0;
+    double worstNs = 0.0;
+};
+
+Result runAsync(const std::string& path, int threads, int lines, uint64_t& dropped) {
+    std::remove(path.c_str());
+    aceforge::AsyncLog log;
+    aceforge::AsyncLog::Options options;
+    options.maxFileBytes = (size_t)1 << 30;
+    options.echoLevel = aceforge::LogLevel::Error;
+    if (!log.open(path, options)) {
+        std::fprintf(stderr, "cannot open %s\n", path.c_str());
+        std::exit(1);
+    }
+    std::vector<double> totals((size_t)threads), worst((size_t)threads);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            double total = 0.0, maxNs = 0.0;
+            for (int i = 0; i < lines; ++i) {
+                const auto t0 = Clock::now();
+                log.write(aceforge::LogLevel::Trace, kLine, sizeof(kLine) - 1);
+                const double ns = std::chrono::duration<double, std::nano>(Clock::now() - t0).count();
+                total += ns;
+                maxNs = std::max(maxNs, ns);
+                // Paced like real tracing: bursts of a few lines, not a tight loop that only measures a full ring
+                if (i % 8 == 7) std::this_thread::sleep_for(std::chrono::microseconds(50));
+            }
+            totals[(size_t)t] = total;
+            worst[(size_t)t] = maxNs;
+        });
+    }
+    for (auto& w : workers) w.join();
+    log.close();
+    dropped = log.droppedCount();
+    Result r;
+    for (int t = 0; t < threads; ++t) {
+        r.nsPerLine += totals[(size_t)t] / (double)lines / (double)threads;
+        r.worstNs = std::max(r.worstNs, worst[(size_t)t]);
+    }
+    return r;
+}
+
+Result runOpenAppendClose(const std::string& path, int lines) {
+    std::remove(path.c_str());
+    Result r;
+    double total = 0.0;
+    for (int i = 0; i < lines; ++i) {
+        const auto t0 = Clock::now();
+        if (std::FILE* f = std::fopen(path.c_str(), "a")) {
+            std::fprintf(f, "2025-01-01 00:00:00 TRACE: %s\n", kLine);
+            std::fflush(f);
+            std::fclose(f);
+        }
+        const double ns = std::chrono::duration<double, std::nano>(Clock::now() - t0).count();
+        total += ns;
+        r.worstNs = std::max(r.worstNs, ns);
+    }
+    r.nsPerLine = total / (double)lines;
+    return r;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int lines = argc > 1 ? std::atoi(argv[1]) : 20000;
+    const std::string dir = argc > 2 ? argv[2] : ".";
+    const std::string path = dir + "/aceforge_log_bench.log";
+
+    std::printf("%-26s %14s %14s %10s\n", "case", "ns/line", "worst ns", "dropped");
+    const Result sync = runOpenAppendClose(path, lines);
+    std::printf("%-26s %14.1f %14.0f %10s\n", "open+append+close", sync.nsPerLine, sync.worstNs, "-");
+    for (int threads : { 1, 4 }) {
+        uint64_t dropped = 0;
+        const Result r = runAsync(path, threads, lines, dropped);
+        const std::string name = "AsyncLog x" + std::to_string(threads) + " thread" + (threads > 1 ? "s" : "");
+        std::printf("%-26s %14.1f %14.0f %10llu\n", name.c_str(), r.nsPerLine, r.worstNs, (unsigned long long)dropped);
+    }
+    std::remove(path.c_str());
+    return 0;
+}
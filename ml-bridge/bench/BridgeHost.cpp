@@ -0,0 +1,339 @@
+#include "BridgeHost.hpp"
+#include "AceForgeAudio/WavStreamDecoder.hpp"
+#include "AceForgeClient/SharedAudioRing.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <iterator>
+#include <random>
+
+namespace aceforge {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int kPollMs = 20;        // how often idle loops notice stop()
+constexpr int kRingPollMs = 1;     // while a ring stream waits for the reader to free space
+constexpr int kRingCommitFrames = 1024;  // published at a time, so the reader starts before a long write is done
+constexpr double kPi = 3.14159265358979323846;
+
+uint32_t hashText(const std::string& text, uint32_t h) {
+    for (unsigned char c : text) h = (h ^ c) * 16777619u;  // FNV-1a
+    return h;
+}
+
+} // namespace
+
+struct BridgeHost::Stream {
+    int64_t lengthFrames = 0;
+    double rootHz = 110.0;
+    double bpm = 0.0;
+    Clock::time_point start;
+};
+
+BridgeHost::BridgeHost() : BridgeHost(Options()) {}
+
+BridgeHost::BridgeHost(Options options) : options_(std::move(options)) {}
+
+BridgeHost::~BridgeHost() {
+    stop();
+}
+
+bool BridgeHost::start() {
+    if (running_.load()) return true;
+    if (!options_.wavFile.empty() && !loadWav()) return false;
+    if (options_.numChannels < 1 || options_.numChannels > 0xFFFF || !(options_.sampleRate > 0.0)) {
+        error_ = "Invalid stream format";
+        return false;
+    }
+    if (!listener_.listen(options_.socketPath)) {
+        error_ = listener_.error();
+        return false;
+    }
+    running_ = true;
+    acceptThread_ = std::thread([this] { acceptLoop(); });
+    return true;
+}
+
+void BridgeHost::stop() {
+    if (!running_.exchange(false)) return;
+    acceptThread_.join();
+    reapConnections(true);  // connection loops poll running_ every kPollMs
+    listener_.close();
+}
+
+BridgeHost::Stats BridgeHost::stats() const {
+    Stats s;
+    s.connections = connectionCount_.load();
+    s.sharedRings = sharedRings_.load();
+    s.streams = streams_.load();
+    s.requests = requests_.load();
+    s.frames = frames_.load();
+    s.midiMessages = midiMessages_.load();
+    s.protocolErrors = protocolErrors_.load();
+    return s;
+}
+
+bool BridgeHost::loadWav() {
+    std::ifstream in(options_.wavFile, std::ios::binary);
+    if (!in) {
+        error_ = "Cannot open " + options_.wavFile;
+        return false;
+    }
+    wav_.clear();
+    WavStreamDecoder decoder(
+        [this](const WavStreamDecoder::Format& f) {
+            options_.sampleRate = f.sampleRate;
+            options_.numChannels = f.numChannels;
+            return true;
+        },
+        [this](const float* interleaved, int numFrames) {
+            wav_.insert(wav_.end(), interleaved, interleaved + (size_t)numFrames * options_.numChannels);
+            return true;
+        });
+    std::vector<uint8_t> chunk(64 * 1024);
+    while (in) {
+        in.read((char*)chunk.data(), (std::streamsize)chunk.size());
+        const size_t got = (size_t)in.gcount();
+        if (got > 0 && !decoder.push(chunk.data(), got)) {
+            error_ = options_.wavFile + ": " + decoder.error();
+            return false;
+        }
+    }
+    wavFrames_ = (int64_t)decoder.framesDecoded();
+    if (wavFrames_ == 0) {
+        error_ = options_.wavFile + ": no audio";
+        return false;
+    }
+    return true;
+}
+
+void BridgeHost::acceptLoop() {
+    while (running_.load()) {
+        const int fd = listener_.accept(kPollMs);
+        if (fd >= 0) {
+            auto connection = std::make_unique<Connection>();
+            connection->fd = fd;
+            connection->index = connectionCount_++;
+            Connection* c = connection.get();
+            std::lock_guard<std::mutex> l(connectionLock_);
+            connections_.push_back(std::move(connection));
+            c->thread = std::thread([this, c] { serve(c); });
+        }
+        reapConnections(false);
+    }
+}
+
+void BridgeHost::reapConnections(bool all) {
+    std::vector<std::unique_ptr<Connection>> finished;
+    {
+        std::lock_guard<std::mutex> l(connectionLock_);
+        auto keep = std::partition(connections_.begin(), connections_.end(),
+                                   [all](const std::unique_ptr<Connection>& c) { return !all && !c->done.load(); });
+        std::move(keep, connections_.end(), std::back_inserter(finished));
+        connections_.erase(keep, connections_.end());
+    }
+    for (auto& c : finished) c->thread.join();  // the connection closed its socket
+}
+
+void BridgeHost::serve(Connection* connection) {
+    struct Queued {
+        bridge::AudioRequest request;
+        Clock::duration jitter;
+    };
+
+    bridge::BridgeConnection conn(connection->fd);
+    bridge::Frame frame;
+    std::vector<uint8_t> out;
+    std::vector<float> samples;
+    std::deque<Queued> queue;
+    std::mt19937 rng(options_.seed + (uint32_t)connection->index);
+    std::uniform_int_distribution<int> jitterMs(0, std::max(0, options_.jitterMs));
+    Stream stream;
+    bool started = false;
+    bool greeted = false;
+    SharedAudioRing ring;
+    uint32_t ringStream = 0;   // streams started on this connection; the ring marks their ends with this number
+    int64_t ringWritten = 0;   // frames of the current stream in the ring
+
+    const auto startStream = [&](const bridge::Params& params) {
+        const std::string prompt = bridge::findParam(params, "prompt");
+        const uint32_t seed = (uint32_t)std::strtoul(bridge::findParam(params, "seed", "0").c_str(), nullptr, 10);
+        const double seconds = std::atof(bridge::findParam(params, "duration", "0").c_str());
+        stream.lengthFrames = seconds > 0.0 ? (int64_t)std::llround(seconds * options_.sampleRate)
+                                            : (int64_t)std::llround(options_.defaultSeconds * options_.sampleRate);
+        if (wavFrames_ > 0) stream.lengthFrames = std::min(stream.lengthFrames, wavFrames_);
+        // A root note from A2 up two octaves, different for every prompt and seed
+        stream.rootHz = 110.0 * std::pow(2.0, (double)(hashText(prompt, 2166136261u ^ seed) % 24) / 12.0);
+        stream.bpm = std::max(0.0, std::atof(bridge::findParam(params, "bpm", "0").c_str()));
+        stream.start = Clock::now();
+        started = true;
+        queue.clear();
+        ++ringStream;
+        ringWritten = 0;
+    };
+
+    const auto sendError = [&](const std::string& message) {
+        ++protocolErrors_;
+        out.clear();
+        bridge::encodeError(out, message);
+        conn.send(out);
+    };
+
+    while (running_.load() && conn.isOpen()) {
+        while (conn.receive(frame)) {
+            switch (frame.type) {
+            case bridge::MessageType::Hello: {
+                bridge::Hello hello;
+                if (!bridge::decodeHello(frame, hello)) {
+                    sendError("Malformed Hello");
+                    break;
+                }
+                if (hello.version != bridge::kVersion) {
+                    sendError("Unsupported protocol version " + std::to_string(hello.version) + ", this host speaks "
+                              + std::to_string(bridge::kVersion));
+                    break;
+                }
+                bridge::Hello reply;
+                reply.numChannels = (uint32_t)options_.numChannels;
+                reply.sampleRate = options_.sampleRate;
+                const bool offerRing = options_.sharedRing && (hello.flags & bridge::kHelloSharedRing) != 0 && !ring.isOpen()
+                                       && ring.create(options_.numChannels, options_.ringFrames, options_.sampleRate);
+                if (offerRing) reply.flags = bridge::kHelloSharedRing;
+                out.clear();
+                bridge::encodeHello(out, reply);
+                conn.send(out);
+                if (offerRing) {
+                    bridge::SharedRingInfo info;
+                    info.numChannels = (uint32_t)ring.numChannels();
+                    info.capacityFrames = (uint32_t)ring.capacityFrames();
+                    info.sampleRate = ring.sampleRate();
+                    out.clear();
+                    bridge::encodeSharedRing(out, info);
+                    const int fds[2] = { ring.memoryFd(), ring.doorbellFd() };
+                    if (conn.sendWithFds(out, fds, 2)) ++sharedRings_;
+                    ring.closeSharedFds();  // the plugin has its own copies now
+                }
+                greeted = true;
+                break;
+            }
+            case bridge::MessageType::Params: {
+                bridge::Params params;
+                if (!bridge::decodeParams(frame, params)) {
+                    sendError("Malformed Params");
+                    break;
+                }
+                ++streams_;
+                startStream(params);
+                break;
+            }
+            case bridge::MessageType::AudioRequest: {
+                bridge::AudioRequest request;
+                if (!greeted || !bridge::decodeAudioRequest(frame, request) || request.frame < 0) {
+                    sendError(greeted ? "Malformed AudioRequest" : "AudioRequest before Hello");
+                    break;
+                }
+                if (!started) startStream({});
+                ++requests_;
+                queue.push_back({ request, std::chrono::milliseconds(jitterMs(rng)) });
+                break;
+            }
+            case bridge::MessageType::Midi: {
+                bridge::MidiEvent event;
+                if (bridge::decodeMidi(frame, event)) ++midiMessages_;
+                break;
+            }
+            default:
+                sendError("Unexpected message type " + std::to_string((uint32_t)frame.type));
+                break;
+            }
+        }
+        if (!conn.isOpen()) break;
+
+        int waitMs = kPollMs;
+        // Shared ring: write whatever has been "generated" and fits, then end the stream after its last frame
+        if (ring.isOpen() && started && ringStream > ring.endedStream()) {
+            int64_t generated = stream.lengthFrames;
+            const auto sinceStart = Clock::now() - stream.start - std::chrono::milliseconds(options_.firstAudioMs);
+            if (sinceStart < Clock::duration::zero())
+                generated = 0;
+            else if (options_.realtimeFactor > 0.0)
+                generated = std::min(generated, (int64_t)(std::chrono::duration<double>(sinceStart).count()
+                                                          * options_.sampleRate * options_.realtimeFactor));
+            for (;;) {
+                const auto regions = ring.prepareWrite((int)std::min<int64_t>(kRingCommitFrames, generated - ringWritten));
+                if (regions.total() == 0) break;
+                for (int i = 0; i < 2; ++i) {
+                    if (regions.frames[i] == 0) continue;
+                    render(stream, ringWritten, regions.frames[i], regions.data[i]);
+                    ringWritten += regions.frames[i];
+                }
+                ring.commitWrite(regions.total());
+                frames_ += regions.total();
+            }
+            if (ringWritten >= stream.lengthFrames)
+                ring.endStream(ringStream);
+            else
+                waitMs = kRingPollMs;
+        }
+
+        // Answer in request order, each once its last frame has been "generated"
+        while (!queue.empty()) {
+            const bridge::AudioRequest& request = queue.front().request;
+            const int64_t end = std::min(request.frame + (int64_t)request.numFrames, stream.lengthFrames);
+            const int64_t count = std::max<int64_t>(0, end - request.frame);
+            Clock::time_point ready = stream.start + std::chrono::milliseconds(options_.firstAudioMs);
+            if (options_.realtimeFactor > 0.0)
+                ready += std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(
+                    (double)std::max(end, request.frame) / (options_.sampleRate * options_.realtimeFactor)));
+            ready += queue.front().jitter;
+            const Clock::time_point now = Clock::now();
+            if (now < ready) {
+                const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(ready - now).count() + 1;
+                waitMs = (int)std::min<int64_t>(kPollMs, left);
+                break;
+            }
+            samples.resize((size_t)count * options_.numChannels);
+            if (count > 0) render(stream, request.frame, (int)count, samples.data());
+            out.clear();
+            bridge::encodeAudioResponse(out, request.frame, samples.data(), (uint32_t)count,
+                                        (uint16_t)options_.numChannels,
+                                        end >= stream.lengthFrames ? bridge::kEndOfStream : 0);
+            if (!conn.send(out)) break;
+            frames_ += count;
+            queue.pop_front();
+        }
+        conn.wait(waitMs);
+    }
+    connection->done = true;
+}
+
+void BridgeHost::render(const Stream& stream, int64_t firstFrame, int numFrames, float* interleaved) const {
+    const int channels = options_.numChannels;
+    if (wavFrames_ > 0) {
+        std::copy(wav_.begin() + (size_t)firstFrame * channels,
+                  wav_.begin() + (size_t)(firstFrame + numFrames) * channels, interleaved);
+        return;
+    }
+    const double rate = options_.sampleRate;
+    const double beatFrames = stream.bpm > 0.0 ? rate * 60.0 / stream.bpm : 0.0;
+    const double clickFrames = rate * 0.01;
+    for (int i = 0; i < numFrames; ++i) {
+        const int64_t n = firstFrame + i;
+        const double t = (double)n / rate;
+        // Root, fifth and octave, at a level that leaves headroom for the click
+        double v = 0.15 * std::sin(2.0 * kPi * stream.rootHz * t) + 0.1 * std::sin(2.0 * kPi * stream.rootHz * 1.5 * t)
+                   + 0.05 * std::sin(2.0 * kPi * stream.rootHz * 2.0 * t);
+        if (beatFrames > 0.0) {
+            const double intoBeat = std::fmod((double)n, beatFrames);
+            if (intoBeat < clickFrames) v += 0.4 * (1.0 - intoBeat / clickFrames) * std::sin(2.0 * kPi * 1000.0 * t);
+        }
+        for (int c = 0; c < channels; ++c) interleaved[(size_t)i * channels + c] = (float)v;
+    }
+}
+
+} // namespace aceforge
@@ -0,0 +1,109 @@
+/**
+ * Reference local ML host for the bridge protocol (protocol.md), for developing and benchmarking the plugin side
+ * (aceforge::bridge::BridgeClient) without a model.
+ *
+ * Listens on a Unix domain socket and serves each connection on its own thread: answers Hello with its format,
+ * starts a new stream on every Params message (prompt, duration, seed, bpm) and answers AudioRequests in order.
+ * A stream is "generated" at a configurable speed: frame f exists firstAudioMs plus f / (rate * realtimeFactor)
+ * after the stream started, so a request for frames that do not exist yet is answered once they do, plus an
+ * optional random jitter. The audio is a chord picked from the prompt and seed, with a click on every beat when
+ * Params carry a bpm, or the frames of a WAV file. POSIX only.
+ *
+ * A plugin that offers it in its Hello gets a SharedAudioRing instead: each stream is rendered straight into shared
+ * memory as it is generated (bounded by the ring's free space), and AudioRequests are not used. Jitter applies to
+ * socket responses only.
+ */
+#ifndef ACEFORGE_BRIDGE_HOST_HPP
+#define ACEFORGE_BRIDGE_HOST_HPP
+
+#include "AceForgeClient/BridgeSocket.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace aceforge {
+
+class BridgeHost {
+public:
+    struct Options {
+        std::string socketPath = bridge::kDefaultSocketPath;
+        double sampleRate = 48000.0;   // rate the host streams at (a model's native rate)
+        int numChannels = 2;
+        double realtimeFactor = 0.0;   // generation speed as a multiple of realtime; <= 0: every frame exists at once
+        int firstAudioMs = 0;          // model start-up before the first frame of a stream exists
+        int jitterMs = 0;              // extra delay per response, uniform in [0, jitterMs]
+        double defaultSeconds = 10.0;  // stream length when Params carry no duration
+        std::string wavFile;           // stream this file (at its own rate and channel count) instead of tones
+        uint32_t seed = 1;             // jitter is reproducible for a given seed
+        bool sharedRing = true;        // offer a shared-memory ring to plugins that can read one
+        int ringFrames = 1 << 16;      // ring capacity
+    };
+
+    struct Stats {
+        int64_t connections = 0;
+        int64_t sharedRings = 0;       // connections streaming through shared memory
+        int64_t streams = 0;           // Params messages
+        int64_t requests = 0;
+        int64_t frames = 0;            // frames sent
+        int64_t midiMessages = 0;
+        int64_t protocolErrors = 0;
+    };
+
+    BridgeHost();
+    explicit BridgeHost(Options options);
+    ~BridgeHost();
+    BridgeHost(const BridgeHost&) = delete;
+    BridgeHost& operator=(const BridgeHost&) = delete;
+
+    /** Loads the WAV (if any) and listens at socketPath. False (error() set) on failure. */
+    bool start();
+    /** Closes every connection, joins all threads and removes the socket file. */
+    void stop();
+
+    const std::string& error() const { return error_; }
+    const Options& options() const { return options_; }
+    Stats stats() const;
+
+private:
+    struct Connection {
+        int fd = -1;
+        int64_t index = 0;
+        std::thread thread;
+        std::atomic<bool> done{ false };
+    };
+
+    struct Stream;
+
+    void acceptLoop();
+    void serve(Connection* connection);
+    void render(const Stream& stream, int64_t firstFrame, int numFrames, float* interleaved) const;
+    bool loadWav();
+    void reapConnections(bool all);
+
+    Options options_;
+    std::string error_;
+    bridge::BridgeListener listener_;
+    std::atomic<bool> running_{ false };
+    std::thread acceptThread_;
+    std::mutex connectionLock_;
+    std::vector<std::unique_ptr<Connection>> connections_;
+
+    std::vector<float> wav_;  // interleaved, options_.numChannels per frame
+    int64_t wavFrames_ = 0;
+
+    std::atomic<int64_t> connectionCount_{ 0 };
+    std::atomic<int64_t> sharedRings_{ 0 };
+    std::atomic<int64_t> streams_{ 0 };
+    std::atomic<int64_t> requests_{ 0 };
+    std::atomic<int64_t> frames_{ 0 };
+    std::atomic<int64_t> midiMessages_{ 0 };
+    std::atomic<int64_t> protocolErrors_{ 0 };
+};
+
+} // namespace aceforge
+
+#endif
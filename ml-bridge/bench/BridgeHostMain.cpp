@@ -0,0 +1,84 @@
+/**
+ * Standalone reference bridge host (BridgeHost) for running the plugin against without a model. Listens on the
+ * plugin's default socket path (protocol.md) until Ctrl-C, then prints its counters.
+ *
+ *   aceforge_bridge_host [--socket PATH] [--rate HZ] [--channels N] [--realtime X] [--first-audio-ms N]
+ *                        [--jitter-ms N] [--seconds S] [--wav FILE] [--seed N] [--ring-frames N] [--no-ring]
+ */
+#include "BridgeHost.hpp"
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <pthread.h>
+#include <signal.h>
+
+namespace {
+
+void usage() {
+    std::fprintf(stderr,
+                 "usage: aceforge_bridge_host [--socket PATH] [--rate HZ] [--channels N] [--realtime X]\n"
+                 "                            [--first-audio-ms N] [--jitter-ms N] [--seconds S] [--wav FILE]\n"
+                 "                            [--seed N] [--ring-frames N] [--no-ring]\n");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    aceforge::BridgeHost::Options options;
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        if (std::strcmp(arg, "--no-ring") == 0) {
+            options.sharedRing = false;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            usage();
+            return 2;
+        }
+        const char* value = argv[++i];
+        if (std::strcmp(arg, "--socket") == 0) options.socketPath = value;
+        else if (std::strcmp(arg, "--rate") == 0) options.sampleRate = std::atof(value);
+        else if (std::strcmp(arg, "--channels") == 0) options.numChannels = std::atoi(value);
+        else if (std::strcmp(arg, "--realtime") == 0) options.realtimeFactor = std::atof(value);
+        else if (std::strcmp(arg, "--first-audio-ms") == 0) options.firstAudioMs = std::atoi(value);
+        else if (std::strcmp(arg, "--jitter-ms") == 0) options.jitterMs = std::atoi(value);
+        else if (std::strcmp(arg, "--seconds") == 0) options.defaultSeconds = std::atof(value);
+        else if (std::strcmp(arg, "--wav") == 0) options.wavFile = value;
+        else if (std::strcmp(arg, "--seed") == 0) options.seed = (uint32_t)std::strtoul(value, nullptr, 10);
+        else if (std::strcmp(arg, "--ring-frames") == 0) options.ringFrames = std::atoi(value);
+        else {
+            usage();
+            return 2;
+        }
+    }
+
+    // Wait for Ctrl-C / SIGTERM on this thread; block them before the host threads start so they inherit the mask
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+    std::signal(SIGPIPE, SIG_IGN);
+
+    aceforge::BridgeHost host(options);
+    if (!host.start()) {
+        std::fprintf(stderr, "aceforge_bridge_host: %s\n", host.error().c_str());
+        return 1;
+    }
+    const auto& o = host.options();
+    std::printf("Bridge host on %s (%.0f Hz, %d ch, %s, first audio %d ms, jitter %d ms, shared ring %s)\n",
+                o.socketPath.c_str(), o.sampleRate, o.numChannels, o.wavFile.empty() ? "tones" : o.wavFile.c_str(),
+                o.firstAudioMs, o.jitterMs, o.sharedRing ? "offered" : "off");
+    if (o.realtimeFactor > 0.0) std::printf("Generating at %.2fx realtime\n", o.realtimeFactor);
+    std::fflush(stdout);
+
+    int received = 0;
+    sigwait(&signals, &received);
+    host.stop();
+    const auto s = host.stats();
+    std::printf("connections %lld (%lld over a shared ring), streams %lld, requests %lld, %.1f s audio sent, midi %lld, protocol errors %lld\n",
+                (long long)s.connections, (long long)s.sharedRings, (long long)s.streams, (long long)s.requests,
+                (double)s.frames / o.sampleRate, (long long)s.midiMessages, (long long)s.protocolErrors);
+    return 0;
+}
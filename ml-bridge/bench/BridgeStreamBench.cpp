@@ -0,0 +1,159 @@
+/**
+ * Streaming latency and throughput of the bridge protocol (BridgeClient) against an in-process BridgeHost over a
+ * real Unix domain socket, 48 kHz stereo float.
+ *
+ * Pipeline: the host answers instantly (realtime factor 0), so the table shows what the framing, the socket and
+ * the request round trips alone cost. Each row streams the same clip with a different request size and number of
+ * requests in flight: first audio is stream() start to the first response, "x realtime" the clip length over the
+ * wall time, RTT request sent to response received. The last row streams the same clip through the shared-memory
+ * ring (SharedAudioRing) instead, where the host renders into shared memory and the client reads it in place.
+ *
+ * Jitter: the host generates at a fixed multiple of realtime and delays each response by up to jitter ms. A
+ * consumer that starts playing once prebuffer frames have arrived needs frame f at start + f / rate; every response
+ * that arrives after its first frame was due is an underrun. The table shows how deep the prebuffer (the plugin's
+ * ClipWriter prebuffer) has to be for a given jitter.
+ *
+ *   aceforge_bridge_bench [clip seconds] [socket path]
+ */
+#include "BridgeHost.hpp"
+#include "AceForgeClient/BridgeClient.hpp"
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <unistd.h>
+
+namespace {
+
+using aceforge::BridgeHost;
+using aceforge::bridge::BridgeClient;
+using Clock = std::chrono::steady_clock;
+
+constexpr double kRate = 48000.0;
+constexpr int kBlockSize = 256;
+
+struct Run {
+    bool ok = false;
+    std::string error;
+    BridgeClient::Stats stats;
+    double wallMs = 0.0;
+    int underruns = 0;
+};
+
+/** Streams one clip; with prebufferFrames > 0 also counts responses that arrive after a paced consumer needed them. */
+Run streamClip(const std::string& path, BridgeClient::Options options, double seconds, int prebufferFrames) {
+    Run run;
+    BridgeClient client(options);
+    if (!client.connect(path, kRate, kBlockSize)) {
+        run.error = client.lastError();
+        return run;
+    }
+    aceforge::bridge::Params params{ { "prompt", "bench" }, { "duration", std::to_string(seconds) } };
+    if (!client.sendParams(params)) {
+        run.error = client.lastError();
+        return run;
+    }
+    int64_t received = 0;
+    Clock::time_point playStart;
+    bool playing = false;
+    const auto t0 = Clock::now();
+    run.ok = client.stream(0, [&](const float*, int numFrames, int) {
+        const auto now = Clock::now();
+        if (playing) {
+            const auto due = playStart + std::chrono::duration_cast<Clock::duration>(
+                                             std::chrono::duration<double>((double)received / kRate));
+            if (now > due) {
+                ++run.underruns;
+                playStart += now - due;  // the consumer stalls until the frames are there
+            }
+        }
+        received += numFrames;
+        if (!playing && prebufferFrames > 0 && received >= prebufferFrames) {
+            playing = true;
+            playStart = now;
+        }
+        return true;
+    });
+    run.wallMs = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+    run.stats = client.stats();
+    if (!run.ok) run.error = client.lastError();
+    return run;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const double seconds = argc > 1 ? std::atof(argv[1]) : 20.0;
+    const std::string path =
+        argc > 2 ? argv[2] : "/tmp/aceforge-bridge-bench-" + std::to_string((long long)getpid()) + ".sock";
+    std::signal(SIGPIPE, SIG_IGN);
+
+    {
+        BridgeHost::Options o;
+        o.socketPath = path;
+        o.sampleRate = kRate;
+        BridgeHost host(o);
+        if (!host.start()) {
+            std::fprintf(stderr, "aceforge_bridge_bench: %s\n", host.error().c_str());
+            return 1;
+        }
+        std::printf("Pipeline: %.0f s clip, %.0f Hz stereo float, host answers at once\n", seconds, kRate);
+        std::printf("%8s %9s %14s %12s %12s %12s\n", "chunk", "in flight", "first audio ms", "x realtime",
+                    "mean RTT us", "max RTT us");
+        for (int chunk : { 256, 1024, 4096 }) {
+            for (int inFlight : { 1, 2, 4, 8 }) {
+                BridgeClient::Options co;
+                co.sharedRing = false;
+                co.chunkFrames = chunk;
+                co.maxInFlight = inFlight;
+                const Run r = streamClip(path, co, seconds, 0);
+                if (!r.ok) {
+                    std::printf("%8d %9d  failed: %s\n", chunk, inFlight, r.error.c_str());
+                    continue;
+                }
+                std::printf("%8d %9d %14.3f %12.1f %12lld %12lld\n", chunk, inFlight,
+                            (double)r.stats.firstAudioUs / 1000.0, seconds * 1000.0 / r.wallMs,
+                            (long long)r.stats.meanRoundTripUs, (long long)r.stats.maxRoundTripUs);
+            }
+        }
+        const Run r = streamClip(path, BridgeClient::Options(), seconds, 0);
+        if (!r.ok)
+            std::printf("%8s %9s  failed: %s\n", "ring", "-", r.error.c_str());
+        else
+            std::printf("%8s %9s %14.3f %12.1f %12s %12s\n", "ring", "-", (double)r.stats.firstAudioUs / 1000.0,
+                        seconds * 1000.0 / r.wallMs, "-", "-");
+        host.stop();
+    }
+
+    // Paced runs take the clip's length in real time each: keep them short
+    const double pacedSeconds = std::min(seconds, 4.0);
+    std::printf("\nJitter: %.0f s clip generated at 1.5x realtime, 1024-frame requests, 4 in flight\n", pacedSeconds);
+    std::printf("%10s %16s %10s %14s\n", "jitter ms", "prebuffer frames", "underruns", "first audio ms");
+    for (int jitterMs : { 0, 20, 50 }) {
+        BridgeHost::Options o;
+        o.socketPath = path;
+        o.sampleRate = kRate;
+        o.realtimeFactor = 1.5;
+        o.jitterMs = jitterMs;
+        BridgeHost host(o);
+        if (!host.start()) {
+            std::fprintf(stderr, "aceforge_bridge_bench: %s\n", host.error().c_str());
+            return 1;
+        }
+        for (int prebuffer : { kBlockSize, 4 * kBlockSize, 16 * kBlockSize }) {
+            BridgeClient::Options co;
+            co.sharedRing = false;  // the host's jitter delays socket responses
+            const Run r = streamClip(path, co, pacedSeconds, prebuffer);
+            if (!r.ok) {
+                std::printf("%10d %16d  failed: %s\n", jitterMs, prebuffer, r.error.c_str());
+                continue;
+            }
+            std::printf("%10d %16d %10d %14.3f\n", jitterMs, prebuffer, r.underruns,
+                        (double)r.stats.firstAudioUs / 1000.0);
+        }
+        host.stop();
+    }
+    return 0;
+}
@@ -0,0 +1,321 @@
+/**
+ * Submit-to-first-audio latency and throughput of a generation through the real client and decode pipeline,
+ * against an in-process MockAceForgeServer (no AceForge, no GPU). The job path is the plugin's runJob with the
+ * scheduler and JUCE taken out: AceForgeClient::startGeneration, waitForJob (event stream, or polling when the
+ * server has no events endpoint), fetchAudioStream into WavStreamDecoder and ClipWriter, published through a
+ * PlaybackCore whose process() runs on a paced "audio thread" at 48 kHz / 256-frame blocks.
+ *
+ * Latency: jobs run one at a time; each stage is timed from the start of the submit:
+ *   submit     POST /api/generate returned a job id
+ *   succeeded  waitForJob returned "succeeded" (shown minus the mock's queue + inference time)
+ *   first byte first WAV bytes of the download arrived
+ *   published  the first kPrebufferFrames were decoded, resampled and handed to the audio thread
+ *   audible    the audio thread rendered the first non-silent block (a device would add its output latency)
+ * Throughput: 1, 2 and 4 workers, each with its own client, submit jobs back to back and decode them fully. The
+ * mock's single simulated GPU serialises inference, so jobs/s tops out at 1000 / inference ms; with inference 0
+ * it shows what the bridge and the HTTP round trips alone cost. Failed jobs (fail rate) are counted, not timed.
+ * With a trace path, the latency runs' stages are also written as Chrome trace-event JSON (PipelineTrace).
+ *
+ *   aceforge_latency_bench [jobs per run] [inference ms] [wav seconds] [fail rate] [trace.json]
+ */
+#include "AceForgeAudio/ClipWriter.hpp"
+#include "AceForgeAudio/PipelineTrace.hpp"
+#include "AceForgeAudio/PlaybackCore.hpp"
+#include "AceForgeAudio/WavStreamDecoder.hpp"
+#include "AceForgeClient/AceForgeClient.hpp"
+#include "MockAceForgeServer.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr double kHostRate = 48000.0;
+constexpr int kBlockSize = 256;
+constexpr int kMaxFrames = 1 << 20;      // same limits as the plugin's streamed clips
+constexpr int kPrebufferFrames = 4096;
+
+using Clock = std::chrono::steady_clock;
+
+double msSince(Clock::time_point t0, Clock::time_point t) {
+    return std::chrono::duration<double, std::milli>(t - t0).count();
+}
+
+/** Renders host blocks in real time and notes when the output first turns audible after arm(). */
+class AudioThread {
+public:
+    explicit AudioThread(aceforge::PlaybackCore& core) : core_(core) {
+        core_.prepare(kHostRate);
+        thread_ = std::thread([this] { run(); });
+    }
+    ~AudioThread() {
+        running_.store(false);
+        thread_.join();
+    }
+
+    /** Stops whatever plays (an empty clip fades it out) and waits until the output is silent. */
+    void silence() {
+        auto& handoff = core_.handoff();
+        handoff.publish(handoff.createClip(aceforge::ClipWriter::kChannels, 1));
+        const int64_t from = blocks_.load();
+        while (silentBlocks_.load() < 2 || blocks_.load() < from + 2)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        handoff.reclaim();
+    }
+    void arm() {
+        audibleAt_.store(0);
+        armed_.store(true);
+    }
+    /** Waits (up to timeoutMs) for the first audible block since arm(); returns its time or Clock::time_point(). */
+    Clock::time_point waitAudible(int timeoutMs) {
+        const auto deadline = Clock::now() + std::chrono::milliseconds(timeoutMs);
+        while (armed_.load() && Clock::now() < deadline) std::this_thread::sleep_for(std::chrono::microseconds(200));
+        const int64_t ns = audibleAt_.load();
+        return ns == 0 ? Clock::time_point() : Clock::time_point(Clock::duration(ns));
+    }
+
+private:
+    void run() {
+        std::vector<float> left(kBlockSize), right(kBlockSize);
+        float* out[2] = { left.data(), right.data() };
+        const auto period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(kBlockSize / kHostRate));
+        auto next = Clock::now();
+        while (running_.load()) {
+            core_.process(out, 2, kBlockSize);
+            const bool audible = std::any_of(left.begin(), left.end(), [](float v) { return v != 0.0f; });
+            if (audible && armed_.load()) {
+                audibleAt_.store(Clock::now().time_since_epoch().count());
+                armed_.store(false);
+            }
+            silentBlocks_.store(audible ? 0 : silentBlocks_.load() + 1);
+            blocks_.fetch_add(1);
+            next += period;
+            std::this_thread::sleep_until(next);
+        }
+    }
+
+    aceforge::PlaybackCore& core_;
+    std::atomic<bool> running_{ true };
+    std::atomic<bool> armed_{ false };
+    std::atomic<int64_t> audibleAt_{ 0 };
+    std::atomic<int> silentBlocks_{ 0 };
+    std::atomic<int64_t> blocks_{ 0 };
+    std::thread thread_;
+};
+
+struct JobTimes {
+    bool ok = false;
+    double submitMs = 0, succeededMs = 0, firstByteMs = 0, publishedMs = 0, audibleMs = 0;
+};
+
+/**
+ * One generation end to end. Publishes into core's handoff; with audio, waits for the audio thread to play it.
+ * Stages go to trace (if any) under job id sourceId, as the plugin records them. Returns ok = false when the job
+ * failed or the download broke.
+ */
+JobTimes runJob(aceforge::AceForgeClient& client, aceforge::PlaybackCore& core, AudioThread* audio, int64_t sourceId,
+                aceforge::PipelineTrace* trace) {
+    using aceforge::Stage;
+    const int traceId = (int)sourceId;
+    auto begin = [&](Stage stage) { if (trace) trace->begin(traceId, stage); };
+    auto end = [&](Stage stage) { if (trace) trace->end(traceId, stage); };
+    JobTimes times;
+    aceforge::GenerateParams params;
+    params.songDescription = "latency bench";
+    params.durationSeconds = 2;
+    params.inferenceSteps = 8;
+
+    if (audio) {
+        audio->silence();
+        audio->arm();
+    }
+    const auto t0 = Clock::now();
+    begin(Stage::Submit);
+    const std::string jobId = client.startGeneration(params);
+    end(Stage::Submit);
+    if (jobId.empty()) return times;
+    times.submitMs = msSince(t0, Clock::now());
+    begin(Stage::Queue);
+    bool running = false;
+    const aceforge::JobStatus status =
+        client.waitForJob(jobId, [&](const aceforge::JobStatus& js, const aceforge::ProgressInfo&) {
+            if (js.status == "running" && !running) {
+                running = true;
+                end(Stage::Queue);
+                begin(Stage::Inference);
+            }
+            return true;
+        });
+    end(Stage::Queue);
+    end(Stage::Inference);
+    if (status.status != "succeeded" || status.audioUrl.empty()) return times;
+    times.succeededMs = msSince(t0, Clock::now());
+
+    aceforge::ClipWriter writer;
+    auto& handoff = core.handoff();
+    handoff.reclaim();
+    int channels = 0;
+    Clock::time_point published;
+    aceforge::WavStreamDecoder decoder(
+        [&](const aceforge::WavStreamDecoder::Format& f) {
+            channels = f.numChannels;
+            return writer.begin(handoff, (int64_t)f.totalFrames, f.sampleRate, kHostRate, sourceId, kMaxFrames,
+                                kPrebufferFrames, [&](const std::shared_ptr<aceforge::PlaybackClip>& clip) {
+                                    published = Clock::now();
+                                    begin(Stage::Handoff);
+                                    handoff.publish(clip);
+                                });
+        },
+        [&](const float* interleaved, int numFrames) {
+            writer.append(interleaved, numFrames, channels);
+            return true;
+        });
+    bool firstChunk = true;
+    int64_t decodeUs = 0;
+    begin(Stage::Fetch);
+    const bool fetched = client.fetchAudioStream(status.audioUrl, [&](const uint8_t* data, size_t size) {
+        if (firstChunk) {
+            times.firstByteMs = msSince(t0, Clock::now());
+            firstChunk = false;
+        }
+        const int64_t start = aceforge::traceNowUs();
+        const bool ok = decoder.push(data, size);
+        decodeUs += aceforge::traceNowUs() - start;
+        return ok;
+    });
+    writer.finish();
+    end(Stage::Fetch);
+    if (trace) {
+        const int64_t now = aceforge::traceNowUs();
+        trace->record(traceId, Stage::Decode, now - decodeUs, now);
+    }
+    if (!fetched || !decoder.isFinished()) return times;
+    times.publishedMs = msSince(t0, published);
+    if (audio) {
+        const Clock::time_point audible = audio->waitAudible(2000);
+        if (audible == Clock::time_point()) return times;
+        times.audibleMs = msSince(t0, audible);
+        // The bench's audio thread stands in for PlaybackCore::lastAcquiredUs(): first audible block
+        if (trace)
+            trace->end(traceId, Stage::Handoff,
+                       std::chrono::duration_cast<std::chrono::microseconds>(audible.time_since_epoch()).count());
+    }
+    times.ok = true;
+    return times;
+}
+
+double percentile(std::vector<double> v, double p) {
+    if (v.empty()) return 0.0;
+    std::sort(v.begin(), v.end());
+    return v[std::min(v.size() - 1, (size_t)(p * (double)(v.size() - 1) + 0.5))];
+}
+
+void printRow(const char* name, const std::vector<double>& v) {
+    std::printf("  %-26s %9.2f %9.2f %9.2f\n", name, percentile(v, 0.5), percentile(v, 0.95),
+                v.empty() ? 0.0 : *std::max_element(v.begin(), v.end()));
+}
+
+bool latencyRun(const aceforge::MockAceForgeServer::Options& options, int jobs, int firstJobId,
+                aceforge::PipelineTrace& trace) {
+    aceforge::MockAceForgeServer server(options);
+    if (!server.start()) {
+        std::fprintf(stderr, "mock server: %s\n", server.error().c_str());
+        return false;
+    }
+    aceforge::AceForgeClient client(server.baseUrl());
+    aceforge::PlaybackCore core;
+    AudioThread audio(core);
+    std::vector<double> submit, overhead, firstByte, publish, audible, total;
+    int failed = 0;
+    const double simulatedMs = options.queueDelayMs + options.inferenceDelayMs;
+    for (int i = 0; i < jobs; ++i) {
+        trace.setLabel(firstJobId + i, options.events ? "event stream" : "polling");
+        const JobTimes t = runJob(client, core, &audio, firstJobId + i, &trace);
+        if (!t.ok) {
+            ++failed;
+            continue;
+        }
+        submit.push_back(t.submitMs);
+        overhead.push_back(t.succeededMs - simulatedMs);
+        firstByte.push_back(t.firstByteMs - t.succeededMs);
+        publish.push_back(t.publishedMs - t.firstByteMs);
+        audible.push_back(t.audibleMs - t.publishedMs);
+        total.push_back(t.audibleMs);
+    }
+    std::printf("\n%s, %d jobs (%d failed), queue %d ms + inference %d ms, %.1f s WAV\n",
+                options.events ? "event stream" : "polling", jobs, failed, options.queueDelayMs,
+                options.inferenceDelayMs, options.wavSeconds);
+    std::printf("  %-26s %9s %9s %9s\n", "stage (ms)", "p50", "p95", "max");
+    printRow("submit", submit);
+    printRow("succeeded - simulated", overhead);
+    printRow("succeeded -> first byte", firstByte);
+    printRow("first byte -> published", publish);
+    printRow("published -> audible", audible);
+    printRow("submit -> audible", total);
+    return true;
+}
+
+bool throughputRun(const aceforge::MockAceForgeServer::Options& options, int workers, int jobsPerWorker) {
+    aceforge::MockAceForgeServer server(options);
+    if (!server.start()) {
+        std::fprintf(stderr, "mock server: %s\n", server.error().c_str());
+        return false;
+    }
+    std::atomic<int> succeeded{ 0 }, failed{ 0 };
+    std::vector<std::thread> threads;
+    const auto t0 = Clock::now();
+    for (int w = 0; w < workers; ++w) {
+        threads.emplace_back([&, w] {
+            aceforge::AceForgeClient client(server.baseUrl());
+            aceforge::PlaybackCore core;
+            for (int i = 0; i < jobsPerWorker; ++i) {
+                if (runJob(client, core, nullptr, (int64_t)w * jobsPerWorker + i + 1, nullptr).ok) ++succeeded;
+                else ++failed;
+            }
+        });
+    }
+    for (auto& t : threads) t.join();
+    const double seconds = msSince(t0, Clock::now()) / 1000.0;
+    const auto stats = server.stats();
+    std::printf("  %7d %8d %8d %10.2f %10.1f %10lld\n", workers, succeeded.load(), failed.load(),
+                succeeded.load() / seconds, (double)stats.audioBytes / 1.0e6 / seconds, (long long)stats.requests);
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int jobs = argc > 1 ? std::atoi(argv[1]) : 20;
+    aceforge::MockAceForgeServer::Options options;
+    options.inferenceDelayMs = argc > 2 ? std::atoi(argv[2]) : 200;
+    options.wavSeconds = argc > 3 ? std::atof(argv[3]) : 10.0;
+    options.failRate = argc > 4 ? std::atof(argv[4]) : 0.0;
+    options.inferenceSteps = 8;
+    std::signal(SIGPIPE, SIG_IGN);  // the client drops event streams mid-response
+
+    aceforge::PipelineTrace trace;
+    if (!latencyRun(options, jobs, 1, trace)) return 1;
+    options.events = false;
+    if (!latencyRun(options, jobs, jobs + 1, trace)) return 1;
+    if (argc > 5) {
+        if (!trace.writeChromeTrace(argv[5])) {
+            std::fprintf(stderr, "cannot write %s\n", argv[5]);
+            return 1;
+        }
+        std::printf("\ntrace written to %s\n", argv[5]);
+    }
+
+    options.events = true;
+    std::printf("\nthroughput, %d jobs per worker, inference %d ms, %.1f s WAV\n", jobs, options.inferenceDelayMs,
+                options.wavSeconds);
+    std::printf("  %7s %8s %8s %10s %10s %10s\n", "workers", "ok", "failed", "jobs/s", "MB/s", "requests");
+    for (int workers : { 1, 2, 4 })
+        if (!throughputRun(options, workers, jobs)) return 1;
+    return 0;
+}
@@ -0,0 +1,73 @@
+/**
+ * Microbenchmark for the AceForge response parser (AceForgeJson).
+ * Parses representative status/progress bodies in a loop and prints ns per parse and MB/s.
+ *
+ *   aceforge_json_bench [iterations]
+ */
+#include "AceForgeClient/AceForgeJson.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+namespace {
+
+struct Case {
+    const char* name;
+    std::string body;
+    int kind;  // 0 status, 1 progress, 2 event
+};
+
+const Case kCases[] = {
+    { "status/queued", R"({"jobId":"3f1c9a52-8d47-4c1e-9a7e-0f6b2d5e8c11","status":"queued","queuePosition":3,"etaSeconds":42.5})", 0 },
+    { "status/running", R"({"error": null, "jobId": "3f1c9a52-8d47-4c1e-9a7e-0f6b2d5e8c11", "status": "running", "queuePosition": 0, "etaSeconds": 7.25, "result": null})", 0 },
+    { "status/succeeded", R"({
+  "error": null,
+  "jobId": "3f1c9a52-8d47-4c1e-9a7e-0f6b2d5e8c11",
+  "status": "succeeded",
+  "result": {
+    "audioUrls": ["/audio/aceforge_bridge_export.wav", "/audio/aceforge_bridge_export_2.wav"],
+    "bpm": 124,
+    "duration": 30,
+    "keyScale": "A minor",
+    "status": "succeeded",
+    "timeSignature": "4/4"
+  }
+})", 0 },
+    { "status/failed", R"json({"error":"CUDA out of memory: tried to allocate \"2.00 GiB\"\n(see log)","jobId":"x","status":"failed"})json", 0 },
+    { "progress", R"({"fraction":0.4181818,"done":false,"error":null,"stage":"diffusion","current":23,"total":55})", 1 },
+    { "event", R"({"jobId":"x","status":"running","etaSeconds":3.2,"stage":"vocoder","current":54,"total":55,"fraction":0.98})", 2 },
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const long iterations = argc > 1 ? std::atol(argv[1]) : 200000;
+    aceforge::JobStatus status;
+    aceforge::ProgressInfo progress;
+    long sink = 0;
+    std::printf("%-18s %12s %12s\n", "case", "ns/parse", "MB/s");
+    for (const Case& c : kCases) {
+        // Warm up, then time; the outputs are reused across iterations like a poll loop reuses them
+        for (int i = 0; i < 1000; ++i)
+            aceforge::parseJobEvent(c.body, status, progress);
+        const auto t0 = std::chrono::steady_clock::now();
+        for (long i = 0; i < iterations; ++i) {
+            bool ok = false;
+            switch (c.kind) {
+            case 0: ok = aceforge::parseJobStatus(c.body, status); break;
+            case 1: ok = aceforge::parseProgressInfo(c.body, progress); break;
+            default: ok = aceforge::parseJobEvent(c.body, status, progress); break;
+            }
+            if (!ok) {
+                std::fprintf(stderr, "parse failed: %s\n", c.name);
+                return 1;
+            }
+            sink += (long)status.status.size() + progress.current;
+        }
+        const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+        const double perParse = ns / (double)iterations;
+        std::printf("%-18s %12.1f %12.1f\n", c.name, perParse, (double)c.body.size() / perParse * 1e3);
+    }
+    return sink == 0 ? 1 : 0;
+}
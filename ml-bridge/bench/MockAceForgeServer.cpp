@@ -0,0 +1,585 @@
+#include "MockAceForgeServer.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace aceforge {
+
+namespace {
+
+constexpr int kAcceptPollMs = 100;
+constexpr size_t kMaxHeaderBytes = 64 * 1024;
+constexpr size_t kMaxBodyBytes = 1 << 20;
+constexpr size_t kMaxStoredAudio = 64;   // generated files kept for download
+constexpr size_t kSendSlice = 64 * 1024;
+constexpr int kEventKeepAliveMs = 10000; // below the client's 30 s read timeout while a job waits in the queue
+
+#ifdef MSG_NOSIGNAL
+constexpr int kSendFlags = MSG_NOSIGNAL;
+#else
+constexpr int kSendFlags = 0;
+#endif
+
+bool writeAll(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t n = ::send(fd, data, size, kSendFlags);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += n;
+        size -= (size_t)n;
+    }
+    return true;
+}
+
+bool writeAll(int fd, const std::string& s) { return writeAll(fd, s.data(), s.size()); }
+
+std::string toLower(std::string s) {
+    for (char& c : s)
+        if (c >= 'A' && c <= 'Z') c = (char)(c - 'A' + 'a');
+    return s;
+}
+
+bool startsWith(const std::string& s, const char* prefix) { return s.compare(0, std::strlen(prefix), prefix) == 0; }
+
+std::string quote(const std::string& s) {
+    std::string out = "\"";
+    for (char c : s) {
+        if (c == '"' || c == '\\') out += '\\';
+        if ((unsigned char)c < 0x20) continue;
+        out += c;
+    }
+    return out + "\"";
+}
+
+std::string number(double v) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.3f", v);
+    return buf;
+}
+
+// Just enough JSON for the fields the mock reacts to in the generate body (flat object, no escapes in values)
+const char* findValue(const std::string& body, const char* key) {
+    const std::string needle = std::string("\"") + key + "\"";
+    size_t at = body.find(needle);
+    if (at == std::string::npos) return nullptr;
+    at = body.find(':', at + needle.size());
+    if (at == std::string::npos) return nullptr;
+    const char* p = body.c_str() + at + 1;
+    while (*p == ' ') ++p;
+    return p;
+}
+
+double numberField(const std::string& body, const char* key, double fallback) {
+    const char* p = findValue(body, key);
+    if (!p) return fallback;
+    char* end = nullptr;
+    const double v = std::strtod(p, &end);
+    return end == p ? fallback : v;
+}
+
+std::string stringField(const std::string& body, const char* key) {
+    const char* p = findValue(body, key);
+    if (!p || *p != '"') return {};
+    const char* end = std::strchr(p + 1, '"');
+    return end ? std::string(p + 1, end) : std::string();
+}
+
+/** File-name-safe title, as AceForge derives output names from it. */
+std::string safeName(const std::string& title) {
+    std::string out;
+    for (char c : title)
+        out += (std::isalnum((unsigned char)c) || c == '-' || c == '_') ? c : '_';
+    return out.empty() ? "aceforge_export" : out;
+}
+
+void put16(std::string& s, uint32_t v) { s += (char)(v & 0xff); s += (char)((v >> 8) & 0xff); }
+void put32(std::string& s, uint32_t v) { put16(s, v & 0xffff); put16(s, v >> 16); }
+
+/** 16-bit PCM stereo WAV: a quiet tone whose pitch differs per job, so consecutive results are distinguishable. */
+std::string makeWav(double seconds, double sampleRate, int64_t jobIndex) {
+    const uint32_t frames = (uint32_t)std::max(1.0, std::round(seconds * sampleRate));
+    const uint32_t dataBytes = frames * 4;
+    std::string wav;
+    wav.reserve(44 + (size_t)dataBytes);
+    wav += "RIFF";
+    put32(wav, 36 + dataBytes);
+    wav += "WAVEfmt ";
+    put32(wav, 16);
+    put16(wav, 1);  // PCM
+    put16(wav, 2);
+    put32(wav, (uint32_t)sampleRate);
+    put32(wav, (uint32_t)sampleRate * 4);
+    put16(wav, 4);
+    put16(wav, 16);
+    wav += "data";
+    put32(wav, dataBytes);
+    const double step = 2.0 * 3.14159265358979 * (220.0 + 55.0 * (double)(jobIndex % 8)) / sampleRate;
+    for (uint32_t i = 0; i < frames; ++i) {
+        const auto v = (int16_t)std::lround(8000.0 * std::sin(step * (double)i));
+        put16(wav, (uint16_t)v);
+        put16(wav, (uint16_t)v);
+    }
+    return wav;
+}
+
+bool sendResponse(int fd, int code, const char* reason, const char* contentType, const std::string& body, bool keepAlive) {
+    std::string head = "HTTP/1.1 " + std::to_string(code) + " " + reason + "\r\nContent-Type: " + contentType
+                       + "\r\nContent-Length: " + std::to_string(body.size())
+                       + (keepAlive ? "\r\nConnection: keep-alive\r\n\r\n" : "\r\nConnection: close\r\n\r\n");
+    return writeAll(fd, head + body);
+}
+
+bool sendJson(int fd, int code, const std::string& body, bool keepAlive) {
+    const char* reason = code == 200 ? "OK" : code == 404 ? "Not Found" : code == 503 ? "Service Unavailable" : "Error";
+    return sendResponse(fd, code, reason, "application/json", body, keepAlive);
+}
+
+/** Reads one request (headers and Content-Length body) from fd; pending keeps bytes past it. */
+bool readRequest(int fd, std::string& pending, std::string& head, std::string& body) {
+    size_t end;
+    while ((end = pending.find("\r\n\r\n")) == std::string::npos) {
+        if (pending.size() > kMaxHeaderBytes) return false;
+        char buf[16 * 1024];
+        ssize_t n = ::recv(fd, buf, sizeof(buf), 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        pending.append(buf, (size_t)n);
+    }
+    head = pending.substr(0, end);
+    pending.erase(0, end + 4);
+
+    size_t length = 0;
+    const std::string lower = toLower(head);
+    const size_t cl = lower.find("\r\ncontent-length:");
+    if (cl != std::string::npos) length = (size_t)std::strtoull(lower.c_str() + cl + 17, nullptr, 10);
+    if (length > kMaxBodyBytes) return false;
+    while (pending.size() < length) {
+        char buf[16 * 1024];
+        ssize_t n = ::recv(fd, buf, sizeof(buf), 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        pending.append(buf, (size_t)n);
+    }
+    body = pending.substr(0, length);
+    pending.erase(0, length);
+    return true;
+}
+
+} // namespace
+
+MockAceForgeServer::MockAceForgeServer() : MockAceForgeServer(Options()) {}
+
+MockAceForgeServer::MockAceForgeServer(Options options) : options_(options), rng_(options.seed) {}
+
+MockAceForgeServer::~MockAceForgeServer() { stop(); }
+
+bool MockAceForgeServer::start() {
+    if (running_.load()) return true;
+    listenFd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (listenFd_ < 0) {
+        error_ = std::string("socket: ") + std::strerror(errno);
+        return false;
+    }
+    int one = 1;
+    ::setsockopt(listenFd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons((uint16_t)options_.port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t len = sizeof(addr);
+    if (::bind(listenFd_, (sockaddr*)&addr, sizeof(addr)) != 0 || ::listen(listenFd_, 64) != 0
+        || ::getsockname(listenFd_, (sockaddr*)&addr, &len) != 0) {
+        error_ = "127.0.0.1:" + std::to_string(options_.port) + ": " + std::strerror(errno);
+        ::close(listenFd_);
+        listenFd_ = -1;
+        return false;
+    }
+    port_ = ntohs(addr.sin_port);
+    {
+        std::lock_guard<std::mutex> l(lock_);
+        stopping_ = false;
+    }
+    running_.store(true);
+    worker_ = std::thread([this] { runWorker(); });
+    acceptThread_ = std::thread([this] { acceptLoop(); });
+    return true;
+}
+
+void MockAceForgeServer::stop() {
+    if (!running_.exchange(false)) return;
+    {
+        std::lock_guard<std::mutex> l(lock_);
+        stopping_ = true;
+    }
+    changed_.notify_all();
+    acceptThread_.join();
+    ::close(listenFd_);
+    listenFd_ = -1;
+    {
+        // Wakes connection threads blocked in recv/send; each fd is closed after its thread is joined
+        std::lock_guard<std::mutex> l(connectionLock_);
+        for (auto& c : connections_) ::shutdown(c->fd, SHUT_RDWR);
+    }
+    reapConnections(true);
+    worker_.join();
+    std::lock_guard<std::mutex> l(lock_);
+    queue_.clear();
+    runningJob_.reset();
+}
+
+MockAceForgeServer::Stats MockAceForgeServer::stats() const {
+    std::lock_guard<std::mutex> l(lock_);
+    return stats_;
+}
+
+void MockAceForgeServer::acceptLoop() {
+    while (running_.load()) {
+        pollfd p{ listenFd_, POLLIN, 0 };
+        if (::poll(&p, 1, kAcceptPollMs) > 0) {
+            const int fd = ::accept(listenFd_, nullptr, nullptr);
+            if (fd >= 0) {
+                int one = 1;
+                ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+#ifdef SO_NOSIGPIPE
+                ::setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));  // no MSG_NOSIGNAL on macOS
+#endif
+                {
+                    std::lock_guard<std::mutex> l(lock_);
+                    ++stats_.connections;
+                    stats_.peakConnections = std::max(stats_.peakConnections, ++openConnections_);
+                }
+                auto connection = std::make_unique<Connection>();
+                connection->fd = fd;
+                Connection* c = connection.get();
+                std::lock_guard<std::mutex> l(connectionLock_);
+                connections_.push_back(std::move(connection));
+                c->thread = std::thread([this, c] { serve(c); });
+            }
+        }
+        reapConnections(false);
+    }
+}
+
+void MockAceForgeServer::reapConnections(bool all) {
+    std::vector<std::unique_ptr<Connection>> finished;
+    {
+        std::lock_guard<std::mutex> l(connectionLock_);
+        auto keep = std::partition(connections_.begin(), connections_.end(),
+                                   [all](const std::unique_ptr<Connection>& c) { return !all && !c->done.load(); });
+        std::move(keep, connections_.end(), std::back_inserter(finished));
+        connections_.erase(keep, connections_.end());
+    }
+    for (auto& c : finished) {
+        c->thread.join();
+        ::close(c->fd);
+    }
+}
+
+void MockAceForgeServer::serve(Connection* connection) {
+    std::string pending, head;
+    Request request;
+    while (running_.load() && readRequest(connection->fd, pending, head, request.body)) {
+        const size_t lineEnd = head.find("\r\n");
+        const std::string line = head.substr(0, lineEnd);
+        const size_t sp1 = line.find(' '), sp2 = line.rfind(' ');
+        if (sp1 == std::string::npos || sp2 <= sp1) break;
+        request.method = line.substr(0, sp1);
+        request.path = line.substr(sp1 + 1, sp2 - sp1 - 1);
+        const std::string lower = toLower(head);
+        request.keepAlive = line.compare(sp2 + 1, 8, "HTTP/1.1") == 0
+                                ? lower.find("\r\nconnection: close") == std::string::npos
+                                : lower.find("\r\nconnection: keep-alive") != std::string::npos;
+        if (!handle(connection->fd, request) || !request.keepAlive) break;
+    }
+    ::shutdown(connection->fd, SHUT_RDWR);
+    {
+        std::lock_guard<std::mutex> l(lock_);
+        --openConnections_;
+    }
+    connection->done.store(true);
+}
+
+bool MockAceForgeServer::handle(int fd, const Request& request) {
+    const std::string& path = request.path;
+    const bool keepAlive = request.keepAlive;
+    bool injectError;
+    {
+        std::lock_guard<std::mutex> l(lock_);
+        ++stats_.requests;
+        injectError = path != "/api/generate/health" && chance(options_.httpErrorRate);
+        if (injectError) ++stats_.httpErrors;
+        if (path == "/api/generate/health") ++stats_.healthRequests;
+        if (startsWith(path, "/api/generate/status/") || path == "/progress") ++stats_.statusRequests;
+    }
+    if (injectError) return sendJson(fd, 503, "{\"error\":\"Injected HTTP error\"}", keepAlive);
+
+    if (request.method == "GET" && path == "/api/generate/health")
+        return sendJson(fd, 200, "{\"healthy\":true}", keepAlive);
+
+    if (request.method == "POST" && path == "/api/generate") {
+        auto job = std::make_shared<Job>();
+        job->title = safeName(stringField(request.body, "title"));
+        job->seconds = options_.wavSeconds > 0.0 ? options_.wavSeconds
+                                                  : std::max(1.0, numberField(request.body, "duration", 30.0));
+        job->steps = std::max(1, options_.inferenceSteps > 0 ? options_.inferenceSteps
+                                                             : (int)numberField(request.body, "inferenceSteps", 15.0));
+        job->bpm = (int)numberField(request.body, "bpm", 0.0);
+        job->submitted = Clock::now();
+        std::string reply;
+        {
+            std::lock_guard<std::mutex> l(lock_);
+            char id[32];
+            std::snprintf(id, sizeof(id), "mock-%06lld", (long long)++nextJob_);
+            job->id = id;
+            job->index = nextJob_;
+            jobs_[job->id] = job;
+            queue_.push_back(job);
+            ++stats_.jobsSubmitted;
+            reply = "{\"jobId\":" + quote(job->id) + ",\"status\":\"queued\",\"queuePosition\":"
+                    + std::to_string(queuePositionLocked(*job)) + "}";
+        }
+        changed_.notify_all();
+        return sendJson(fd, 200, reply, keepAlive);
+    }
+
+    if (request.method == "GET" && startsWith(path, "/api/generate/status/")) {
+        std::shared_ptr<Job> job = findJob(path.substr(21));
+        if (!job) return sendJson(fd, 404, "{\"error\":\"Unknown job\"}", keepAlive);
+        if (options_.garbageStatus)
+            return sendResponse(fd, 200, "OK", "text/html", "<html><body>502 Bad Gateway</body></html>", keepAlive);
+        std::lock_guard<std::mutex> l(lock_);
+        return sendJson(fd, 200, jobJson(*job, false), keepAlive);
+    }
+
+    if (request.method == "GET" && startsWith(path, "/api/generate/events/")) {
+        std::shared_ptr<Job> job = options_.events ? findJob(path.substr(21)) : nullptr;
+        if (!job) return sendJson(fd, 404, "{\"error\":\"Not found\"}", keepAlive);
+        return streamEvents(fd, job);
+    }
+
+    if (request.method == "POST" && startsWith(path, "/api/generate/cancel/")) {
+        std::shared_ptr<Job> job = findJob(path.substr(21));
+        if (!job) return sendJson(fd, 404, "{\"error\":\"Unknown job\"}", keepAlive);
+        std::string reply;
+        {
+            std::lock_guard<std::mutex> l(lock_);
+            if (job->status == "queued") {
+                queue_.erase(std::remove(queue_.begin(), queue_.end(), job), queue_.end());
+                job->status = "cancelled";
+                ++stats_.jobsCancelled;
+                changedLocked(*job);
+            } else if (job->status == "running") {
+                job->cancelRequested = true;  // the worker stops at the next step
+                changedLocked(*job);
+            }
+            reply = "{\"jobId\":" + quote(job->id) + ",\"status\":" + quote(job->status) + "}";
+        }
+        return sendJson(fd, 200, reply, keepAlive);
+    }
+
+    if (request.method == "GET" && path == "/progress") {
+        std::string reply;
+        {
+            std::lock_guard<std::mutex> l(lock_);
+            if (runningJob_) {
+                const Job& job = *runningJob_;
+                reply = "{\"fraction\":" + number((double)job.step / job.steps)
+                        + ",\"done\":" + (job.status == "running" ? "false" : "true")
+                        + ",\"error\":" + (job.error.empty() ? std::string("null") : quote(job.error))
+                        + ",\"stage\":\"inference\",\"current\":" + std::to_string(job.step)
+                        + ",\"total\":" + std::to_string(job.steps) + "}";
+            } else {
+                reply = "{\"fraction\":0,\"done\":false,\"error\":null,\"current\":0,\"total\":0}";
+            }
+        }
+        return sendJson(fd, 200, reply, keepAlive);
+    }
+
+    if (request.method == "GET" && startsWith(path, "/audio/")) {
+        std::shared_ptr<const std::string> wav;
+        {
+            std::lock_guard<std::mutex> l(lock_);
+            auto it = audio_.find(path.substr(7));
+            if (it != audio_.end()) wav = it->second;
+        }
+        if (!wav) return sendJson(fd, 404, "{\"error\":\"No such file\"}", keepAlive);
+        return sendAudio(fd, wav) && keepAlive;
+    }
+
+    return sendJson(fd, 404, "{\"error\":\"Not found\"}", keepAlive);
+}
+
+bool MockAceForgeServer::streamEvents(int fd, const std::shared_ptr<Job>& job) {
+    if (!writeAll(fd, "HTTP/1.1 200 OK\r\nContent-Type: text/event-stream\r\nCache-Control: no-cache\r\n"
+                      "Transfer-Encoding: chunked\r\nConnection: keep-alive\r\n\r\n"))
+        return false;
+    auto chunk = [fd](const std::string& text) {
+        char size[16];
+        std::snprintf(size, sizeof(size), "%zx\r\n", text.size());
+        return writeAll(fd, size + text + "\r\n");
+    };
+    uint64_t sent = 0;
+    bool first = true;
+    for (;;) {
+        std::string event;
+        bool finished = false;
+        {
+            std::unique_lock<std::mutex> l(lock_);
+            const bool woke = changed_.wait_for(l, std::chrono::milliseconds(kEventKeepAliveMs),
+                                                [&] { return stopping_ || first || job->version != sent; });
+            if (stopping_) return false;
+            if (woke) {
+                event = "data: " + jobJson(*job, true) + "\n\n";
+                sent = job->version;
+                first = false;
+                finished = job->status != "queued" && job->status != "running";
+            } else {
+                event = ": keep-alive\n\n";
+            }
+        }
+        if (!chunk(event)) return false;
+        if (finished) return writeAll(fd, "0\r\n\r\n");
+    }
+}
+
+bool MockAceForgeServer::sendAudio(int fd, const std::shared_ptr<const std::string>& wav) {
+    const std::string head = "HTTP/1.1 200 OK\r\nContent-Type: audio/wav\r\nContent-Length: "
+                             + std::to_string(wav->size()) + "\r\nConnection: keep-alive\r\n\r\n";
+    if (!writeAll(fd, head)) return false;
+    const auto start = Clock::now();
+    const int64_t rate = options_.downloadBytesPerSec;
+    for (size_t offset = 0; offset < wav->size() && running_.load();) {
+        const size_t n = std::min(kSendSlice, wav->size() - offset);
+        if (!writeAll(fd, wav->data() + offset, n)) return false;
+        offset += n;
+        {
+            std::lock_guard<std::mutex> l(lock_);
+            stats_.audioBytes += (int64_t)n;
+        }
+        if (rate > 0)
+            std::this_thread::sleep_until(start + std::chrono::microseconds((int64_t)offset * 1000000 / rate));
+    }
+    return running_.load();
+}
+
+void MockAceForgeServer::runWorker() {
+    std::unique_lock<std::mutex> l(lock_);
+    for (;;) {
+        changed_.wait(l, [this] { return stopping_ || !queue_.empty(); });
+        if (stopping_) return;
+        std::shared_ptr<Job> job = queue_.front();
+        const auto startAt = job->submitted + std::chrono::milliseconds(options_.queueDelayMs);
+        if (Clock::now() < startAt) {
+            // Re-evaluated on wake-up: the job may have been cancelled meanwhile
+            changed_.wait_until(l, startAt);
+            continue;
+        }
+        queue_.pop_front();
+        runningJob_ = job;
+        job->status = "running";
+        changedLocked(*job);
+
+        // The audio is rendered up front, inside the simulated inference time, so that writing it does not show
+        // up as server overhead between the last progress step and "succeeded"
+        const auto begin = Clock::now();
+        l.unlock();
+        auto wav = std::make_shared<const std::string>(makeWav(job->seconds, options_.sampleRate, job->index));
+        l.lock();
+        const std::chrono::duration<double, std::milli> stepTime((double)options_.inferenceDelayMs / job->steps);
+        while (job->step < job->steps) {
+            const auto due = begin + std::chrono::duration_cast<Clock::duration>(stepTime * (job->step + 1));
+            if (changed_.wait_until(l, due, [&] { return stopping_ || job->cancelRequested; })) break;
+            ++job->step;
+            changedLocked(*job);
+        }
+        if (stopping_) return;
+
+        if (job->cancelRequested) {
+            job->status = "cancelled";
+            ++stats_.jobsCancelled;
+        } else if (chance(options_.failRate)) {
+            job->status = "failed";
+            job->error = "Injected failure";
+            ++stats_.jobsFailed;
+        } else {
+            job->audioName = job->title + "_" + job->id + ".wav";
+            audio_[job->audioName] = std::move(wav);
+            audioOrder_.push_back(job->audioName);
+            if (audioOrder_.size() > kMaxStoredAudio) {
+                audio_.erase(audioOrder_.front());
+                audioOrder_.pop_front();
+            }
+            job->status = "succeeded";
+            ++stats_.jobsSucceeded;
+        }
+        changedLocked(*job);
+    }
+}
+
+std::shared_ptr<MockAceForgeServer::Job> MockAceForgeServer::findJob(const std::string& id) {
+    std::lock_guard<std::mutex> l(lock_);
+    auto it = jobs_.find(id);
+    return it == jobs_.end() ? nullptr : it->second;
+}
+
+std::string MockAceForgeServer::jobJson(const Job& job, bool withProgress) const {
+    std::string s = "{\"jobId\":" + quote(job.id) + ",\"status\":" + quote(job.status)
+                    + ",\"error\":" + (job.error.empty() ? std::string("null") : quote(job.error));
+    if (job.status == "queued" || job.status == "running") {
+        s += ",\"queuePosition\":" + std::to_string(queuePositionLocked(job));
+        s += ",\"etaSeconds\":" + number(etaSecondsLocked(job));
+    }
+    if (job.status == "succeeded") {
+        s += ",\"result\":{\"audioUrls\":[" + quote("/audio/" + job.audioName) + "],\"bpm\":"
+             + (job.bpm > 0 ? std::to_string(job.bpm) : std::string("null")) + ",\"duration\":" + number(job.seconds) + ",\"keyScale\":null,\"status\":\"succeeded\",\"timeSignature\":null}";
+    }
+    if (withProgress) {
+        s += ",\"fraction\":" + number((double)job.step / job.steps) + ",\"stage\":\"inference\",\"current\":"
+             + std::to_string(job.step) + ",\"total\":" + std::to_string(job.steps);
+    }
+    return s + "}";
+}
+
+int MockAceForgeServer::queuePositionLocked(const Job& job) const {
+    for (size_t i = 0; i < queue_.size(); ++i)
+        if (queue_[i].get() == &job) return (int)i + 1;
+    return 0;
+}
+
+double MockAceForgeServer::etaSecondsLocked(const Job& job) const {
+    const double inference = options_.inferenceDelayMs / 1000.0;
+    double eta = 0.0;
+    if (runningJob_ && runningJob_->status == "running")
+        eta += inference * (1.0 - (double)runningJob_->step / runningJob_->steps);
+    if (job.status == "queued") {
+        const double queued = std::chrono::duration<double>(job.submitted - Clock::now()).count()
+                              + options_.queueDelayMs / 1000.0;
+        eta = std::max(eta, queued) + inference * queuePositionLocked(job);
+    }
+    return eta;
+}
+
+void MockAceForgeServer::changedLocked(Job& job) {
+    ++job.version;
+    changed_.notify_all();
+}
+
+bool MockAceForgeServer::chance(double rate) {
+    if (rate <= 0.0) return false;
+    return std::uniform_real_distribution<double>(0.0, 1.0)(rng_) < rate;
+}
+
+} // namespace aceforge
@@ -0,0 +1,156 @@
+/**
+ * Local stand-in for the AceForge generation API, for exercising the client, the decode pipeline and the plugin
+ * without a real AceForge instance or a GPU.
+ *
+ * Serves the endpoints the plugin uses (AceForge.md): health, POST /api/generate, status, server-sent job events,
+ * /progress, cancel and /audio/<file>. Jobs run one at a time on a simulated GPU worker: each waits out the
+ * configured queue delay, then "infers" for the configured time in inferenceSteps progress steps, and either fails
+ * (failure injection) or produces a 16-bit stereo WAV tone of the configured length. Any request except health can
+ * also be answered with HTTP 503 at a configured rate. Audio downloads can be throttled to mimic a slow disk.
+ *
+ * HTTP/1.1 with keep-alive, one thread per connection, bound to 127.0.0.1 only. POSIX only.
+ */
+#ifndef ACEFORGE_MOCK_SERVER_HPP
+#define ACEFORGE_MOCK_SERVER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace aceforge {
+
+class MockAceForgeServer {
+public:
+    struct Options {
+        int port = 0;                 // 0: any free port (see port())
+        int queueDelayMs = 0;         // minimum time a job stays queued after submission
+        int inferenceDelayMs = 500;   // running time per job
+        int inferenceSteps = 0;       // progress steps per job; 0 = the request's inferenceSteps
+        double wavSeconds = 0.0;      // length of the generated audio; <= 0 = the request's duration
+        double sampleRate = 48000.0;  // AceForge returns 48 kHz 16-bit stereo
+        double failRate = 0.0;        // share of jobs that end "failed"
+        double httpErrorRate = 0.0;   // share of requests (all but health) answered with HTTP 503
+        int64_t downloadBytesPerSec = 0;  // audio download throttle; 0 = unthrottled
+        bool events = true;           // serve /api/generate/events/<id>; false = 404, so clients poll
+        bool garbageStatus = false;   // answer status polls with a 200 HTML page (a proxy error page, a changed API)
+        uint32_t seed = 1;            // failure injection is reproducible for a given seed
+    };
+
+    struct Stats {
+        int64_t requests = 0;
+        int64_t httpErrors = 0;       // injected 503s
+        int64_t healthRequests = 0;
+        int64_t statusRequests = 0;   // status and /progress polls
+        int64_t connections = 0;      // accepted
+        int64_t peakConnections = 0;  // open at once (one thread each)
+        int64_t jobsSubmitted = 0;
+        int64_t jobsSucceeded = 0;
+        int64_t jobsFailed = 0;
+        int64_t jobsCancelled = 0;
+        int64_t audioBytes = 0;       // WAV bytes sent
+    };
+
+    MockAceForgeServer();
+    explicit MockAceForgeServer(Options options);
+    ~MockAceForgeServer();
+    MockAceForgeServer(const MockAceForgeServer&) = delete;
+    MockAceForgeServer& operator=(const MockAceForgeServer&) = delete;
+
+    /** Binds 127.0.0.1:<port> and starts serving. Returns false (error() set) when the port cannot be bound. */
+    bool start();
+    /** Closes every connection, ends event streams and joins all threads. Jobs still pending are dropped. */
+    void stop();
+
+    /** Bound port (the chosen one when Options::port was 0); valid after start(). */
+    int port() const { return port_; }
+    std::string baseUrl() const { return "http://127.0.0.1:" + std::to_string(port_); }
+    const std::string& error() const { return error_; }
+    const Options& options() const { return options_; }
+    Stats stats() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Job {
+        std::string id;
+        int64_t index = 0;  // submission order, picks the tone
+        std::string title;
+        double seconds = 0.0;
+        int bpm = 0;        // requested tempo, reported back in result.bpm (null when not requested)
+        int steps = 1;
+        int step = 0;
+        Clock::time_point submitted;
+        std::string status = "queued";  // queued | running | succeeded | failed | cancelled
+        std::string error;
+        std::string audioName;
+        bool cancelRequested = false;
+        uint64_t version = 0;  // bumped on every change; event streams send a snapshot per version
+    };
+
+    struct Connection {
+        int fd = -1;
+        std::thread thread;
+        std::atomic<bool> done{ false };
+    };
+
+    struct Request {
+        std::string method;
+        std::string path;
+        std::string body;
+        bool keepAlive = true;
+    };
+
+    void acceptLoop();
+    void serve(Connection* connection);
+    void runWorker();
+    /** Answers one request; false when the connection must be closed. */
+    bool handle(int fd, const Request& request);
+    bool streamEvents(int fd, const std::shared_ptr<Job>& job);
+    bool sendAudio(int fd, const std::shared_ptr<const std::string>& wav);
+
+    std::shared_ptr<Job> findJob(const std::string& id);
+    /** Job snapshot as the status endpoint returns it; withProgress adds the /progress fields (events). */
+    std::string jobJson(const Job& job, bool withProgress) const;
+    int queuePositionLocked(const Job& job) const;
+    double etaSecondsLocked(const Job& job) const;
+    void changedLocked(Job& job);
+    bool chance(double rate);
+    void reapConnections(bool all);
+
+    Options options_;
+    int listenFd_ = -1;
+    int port_ = 0;
+    std::string error_;
+    std::atomic<bool> running_{ false };
+    std::thread acceptThread_;
+    std::thread worker_;
+
+    std::mutex connectionLock_;
+    std::vector<std::unique_ptr<Connection>> connections_;
+
+    mutable std::mutex lock_;                        // guards everything below
+    std::condition_variable changed_;                // job changes, new work and stop
+    std::map<std::string, std::shared_ptr<Job>> jobs_;
+    std::deque<std::shared_ptr<Job>> queue_;         // waiting jobs, in order
+    std::shared_ptr<Job> runningJob_;
+    std::map<std::string, std::shared_ptr<const std::string>> audio_;  // generated WAVs by file name
+    std::deque<std::string> audioOrder_;             // oldest first, to bound memory in long runs
+    std::mt19937 rng_;
+    int64_t nextJob_ = 0;
+    int64_t openConnections_ = 0;
+    bool stopping_ = false;
+    Stats stats_;
+};
+
+} // namespace aceforge
+
+#endif
@@ -0,0 +1,89 @@
+/**
+ * Standalone mock AceForge server (MockAceForgeServer) for running the plugin or the client against without a GPU.
+ * Listens on 127.0.0.1 (default port 5056, the plugin's default server URL) until Ctrl-C, then prints its counters.
+ *
+ *   aceforge_mock_server [--port N] [--queue-ms N] [--inference-ms N] [--steps N] [--seconds S] [--rate HZ]
+ *                        [--fail-rate P] [--http-error-rate P] [--download-kbps N] [--no-events]
+ *                        [--garbage-status] [--seed N]
+ */
+#include "MockAceForgeServer.hpp"
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <pthread.h>
+#include <signal.h>
+
+namespace {
+
+void usage() {
+    std::fprintf(stderr,
+                 "usage: aceforge_mock_server [--port N] [--queue-ms N] [--inference-ms N] [--steps N] [--seconds S]\n"
+                 "                            [--rate HZ] [--fail-rate P] [--http-error-rate P] [--download-kbps N]\n"
+                 "                            [--no-events] [--garbage-status] [--seed N]\n");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    aceforge::MockAceForgeServer::Options options;
+    options.port = 5056;
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        if (std::strcmp(arg, "--garbage-status") == 0) {
+            options.garbageStatus = true;
+            continue;
+        }
+        if (std::strcmp(arg, "--no-events") == 0) {
+            options.events = false;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            usage();
+            return 2;
+        }
+        const char* value = argv[++i];
+        if (std::strcmp(arg, "--port") == 0) options.port = std::atoi(value);
+        else if (std::strcmp(arg, "--queue-ms") == 0) options.queueDelayMs = std::atoi(value);
+        else if (std::strcmp(arg, "--inference-ms") == 0) options.inferenceDelayMs = std::atoi(value);
+        else if (std::strcmp(arg, "--steps") == 0) options.inferenceSteps = std::atoi(value);
+        else if (std::strcmp(arg, "--seconds") == 0) options.wavSeconds = std::atof(value);
+        else if (std::strcmp(arg, "--rate") == 0) options.sampleRate = std::atof(value);
+        else if (std::strcmp(arg, "--fail-rate") == 0) options.failRate = std::atof(value);
+        else if (std::strcmp(arg, "--http-error-rate") == 0) options.httpErrorRate = std::atof(value);
+        else if (std::strcmp(arg, "--download-kbps") == 0) options.downloadBytesPerSec = std::atoll(value) * 1000 / 8;
+        else if (std::strcmp(arg, "--seed") == 0) options.seed = (uint32_t)std::strtoul(value, nullptr, 10);
+        else {
+            usage();
+            return 2;
+        }
+    }
+
+    // Wait for Ctrl-C / SIGTERM on this thread; block them before the server threads start so they inherit the mask
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+    std::signal(SIGPIPE, SIG_IGN);
+
+    aceforge::MockAceForgeServer server(options);
+    if (!server.start()) {
+        std::fprintf(stderr, "aceforge_mock_server: %s\n", server.error().c_str());
+        return 1;
+    }
+    std::printf("Mock AceForge on %s (queue %d ms, inference %d ms, fail rate %.2f, http error rate %.2f, events %s)\n",
+                server.baseUrl().c_str(), options.queueDelayMs, options.inferenceDelayMs, options.failRate,
+                options.httpErrorRate, options.events ? "on" : "off");
+    std::fflush(stdout);
+
+    int received = 0;
+    sigwait(&signals, &received);
+    server.stop();
+    const auto s = server.stats();
+    std::printf("requests %lld (injected errors %lld), jobs %lld: %lld succeeded, %lld failed, %lld cancelled; "
+                "%.1f MB audio sent\n",
+                (long long)s.requests, (long long)s.httpErrors, (long long)s.jobsSubmitted, (long long)s.jobsSucceeded,
+                (long long)s.jobsFailed, (long long)s.jobsCancelled, (double)s.audioBytes / 1.0e6);
+    return 0;
+}
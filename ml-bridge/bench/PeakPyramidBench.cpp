@@ -0,0 +1,113 @@
+/**
+ * Cost of waveform thumbnails for the library list (AceForgeAudio PeakPyramid).
+ * Builds the pyramid of a stereo clip with kernels::minMax and with a plain scalar loop (the reduction the kernel
+ * replaces), then draws a list of rows: from the pyramid (what paintListBoxItem does) and by reducing each row's
+ * decoded audio directly, which is the least drawing without a cache could cost, before any file read.
+ *
+ *   aceforge_peaks_bench [seconds per clip] [rows] [columns per row]
+ */
+#include "AceForgeAudio/PeakPyramid.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double msSince(Clock::time_point t0) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+}
+
+/** Level 0 of the pyramid with a scalar reduction, for comparison. */
+std::vector<aceforge::PeakPyramid::Peak> scalarBase(const float* const* channels, int numChannels, int numFrames,
+                                                    int baseFrames) {
+    std::vector<aceforge::PeakPyramid::Peak> out;
+    for (int start = 0; start < numFrames; start += baseFrames) {
+        const int end = std::min(numFrames, start + baseFrames);
+        float lo = 1.0f, hi = -1.0f;
+        for (int c = 0; c < numChannels; ++c)
+            for (int i = start; i < end; ++i) {
+                lo = std::min(lo, channels[c][i]);
+                hi = std::max(hi, channels[c][i]);
+            }
+        out.push_back({ (int8_t)std::lround(lo * 127.0f), (int8_t)std::lround(hi * 127.0f) });
+    }
+    return out;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const double seconds = argc > 1 ? std::atof(argv[1]) : 30.0;
+    const int rows = argc > 2 ? std::atoi(argv[2]) : 300;
+    const int columns = argc > 3 ? std::atoi(argv[3]) : 240;
+    const double rate = 48000.0;
+    const int frames = (int)(seconds * rate);
+    const int reps = 10;
+
+    std::vector<float> left((size_t)frames), right((size_t)frames);
+    for (int i = 0; i < frames; ++i) {
+        const float env = 0.5f + 0.5f * std::sin((float)i * 1.0e-4f);
+        left[(size_t)i] = env * std::sin((float)i * 0.031f);
+        right[(size_t)i] = env * std::sin((float)i * 0.047f);
+    }
+    const float* channels[2] = { left.data(), right.data() };
+    float sink = 0.0f;
+
+    // Build: the whole clip in 64k-frame chunks, as the plugin reads a file
+    aceforge::PeakPyramid pyramid;
+    auto t0 = Clock::now();
+    for (int r = 0; r < reps; ++r) {
+        aceforge::PeakPyramid::Builder builder;
+        for (int pos = 0; pos < frames; pos += 65536) {
+            const float* chunk[2] = { left.data() + pos, right.data() + pos };
+            builder.add(chunk, 2, std::min(65536, frames - pos));
+        }
+        pyramid = builder.finish(rate);
+    }
+    const double kernelMs = msSince(t0) / reps;
+    t0 = Clock::now();
+    for (int r = 0; r < reps; ++r)
+        sink += scalarBase(channels, 2, frames, aceforge::PeakPyramid::kBaseFrames)[0].max;
+    const double scalarMs = msSince(t0) / reps;
+
+    std::printf("%.0f s stereo at %.0f Hz: %d levels, %zu bytes on disk\n", seconds, rate, pyramid.numLevels(),
+                pyramid.serialize().size());
+    std::printf("  %-26s %10s %12s\n", "build", "ms/clip", "x realtime");
+    std::printf("  %-26s %10.3f %12.0f\n", "minMax kernel", kernelMs, seconds * 1000.0 / kernelMs);
+    std::printf("  %-26s %10.3f %12.0f\n", "scalar loop (level 0)", scalarMs, seconds * 1000.0 / scalarMs);
+
+    // Draw: every row once at the given width
+    std::vector<float> mins((size_t)columns), maxs((size_t)columns);
+    t0 = Clock::now();
+    for (int r = 0; r < rows; ++r) {
+        pyramid.render(columns, mins.data(), maxs.data());
+        sink += maxs[(size_t)(r % columns)];
+    }
+    const double pyramidMs = msSince(t0);
+    t0 = Clock::now();
+    for (int r = 0; r < rows; ++r) {
+        for (int c = 0; c < columns; ++c) {
+            const int64_t first = (int64_t)c * frames / columns, end = (int64_t)(c + 1) * frames / columns;
+            float lo = 1.0f, hi = -1.0f;
+            for (int ch = 0; ch < 2; ++ch)
+                for (int64_t i = first; i < end; ++i) {
+                    lo = std::min(lo, channels[ch][i]);
+                    hi = std::max(hi, channels[ch][i]);
+                }
+            mins[(size_t)c] = lo;
+            maxs[(size_t)c] = hi;
+        }
+        sink += maxs[(size_t)(r % columns)];
+    }
+    const double audioMs = msSince(t0);
+    std::printf("  %-26s %10s %12s\n", "draw", "ms total", "us/row");
+    std::printf("  %-26s %10.3f %12.2f\n", "from the pyramid", pyramidMs, pyramidMs * 1000.0 / rows);
+    std::printf("  %-26s %10.3f %12.2f\n", "from decoded audio", audioMs, audioMs * 1000.0 / rows);
+    std::printf("  (%d rows x %d columns)\n", rows, columns);
+    return sink == 12345.0f ? 1 : 0;
+}
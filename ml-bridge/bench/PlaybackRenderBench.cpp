@@ -0,0 +1,86 @@
+/**
+ * Microbenchmark for the planar playback render (AceForgeAudio PlaybackEngine).
+ * Renders a stereo clip at host block sizes 16..4096 and prints ns per output frame for unity gain, a fixed
+ * gain and a gain ramp in every block. The "per-sample" column is the interleaved, bounds-checked copy the
+ * engine replaced, for reference.
+ *
+ *   aceforge_playback_bench [seconds of audio per case]
+ */
+#include "AceForgeAudio/PlaybackEngine.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+constexpr double kSampleRate = 48000.0;
+constexpr int kWarmupBlocks = 64;
+
+template <typename F>
+double nsPerFrame(long blocks, int blockSize, F&& renderBlock) {
+    for (long b = 0; b < kWarmupBlocks; ++b) renderBlock(b);
+    const auto t0 = std::chrono::steady_clock::now();
+    for (long b = kWarmupBlocks; b < kWarmupBlocks + blocks; ++b) renderBlock(b);
+    const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+    return ns / (double)(blocks * blockSize);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const double seconds = argc > 1 ? std::atof(argv[1]) : 20.0;
+    // One clip long enough that every block of every case is a full copy (no restarts inside the timed loop)
+    const int clipFrames = (int)(seconds * kSampleRate) + 4096 * (kWarmupBlocks + 1);
+
+    aceforge::PlaybackClip clip;
+    clip.audio.allocate(2, clipFrames);
+    std::vector<float> interleaved((size_t)clipFrames * 2u);
+    for (int i = 0; i < clipFrames; ++i) {
+        const float v = std::sin((float)i * 0.01f);
+        clip.audio.channel(0)[i] = v;
+        clip.audio.channel(1)[i] = -v;
+        interleaved[(size_t)i * 2u] = v;
+        interleaved[(size_t)i * 2u + 1u] = -v;
+    }
+    clip.readyFrames.store(clipFrames);
+
+    float sink = 0.0f;
+    std::printf("%8s %12s %12s %12s %12s\n", "block", "unity", "gain", "ramp", "per-sample");
+    for (int blockSize = 16; blockSize <= 4096; blockSize *= 2) {
+        const long blocks = (long)(seconds * kSampleRate) / blockSize;
+        std::vector<float> left((size_t)blockSize), right((size_t)blockSize);
+        float* out[2] = { left.data(), right.data() };
+
+        auto runEngine = [&](float gain, bool rampEveryBlock) {
+            aceforge::PlaybackEngine engine;
+            engine.prepare(kSampleRate);
+            engine.setGain(gain);
+            engine.play(&clip);
+            return nsPerFrame(blocks, blockSize, [&](long b) {
+                if (rampEveryBlock) engine.setGain((b & 1) ? 0.25f : 0.75f);
+                engine.render(out, 2, blockSize);
+                sink += left[0];
+            });
+        };
+        const double unity = runEngine(1.0f, false);
+        const double gain = runEngine(0.5f, false);
+        const double ramp = runEngine(0.5f, true);
+
+        // Reference: interleaved source, one bounds-checked store per sample
+        const double perSample = nsPerFrame(blocks, blockSize, [&](long b) {
+            const size_t readPos = (size_t)b * (size_t)blockSize;
+            for (int i = 0; i < blockSize; ++i) {
+                const size_t base = (readPos + (size_t)i) * 2u;
+                if (base + 1 < interleaved.size() && i < blockSize) {
+                    left[(size_t)i] = interleaved[base];
+                    right[(size_t)i] = interleaved[base + 1];
+                }
+            }
+            sink += left[0];
+        });
+        std::printf("%8d %12.3f %12.3f %12.3f %12.3f\n", blockSize, unity, gain, ramp, perSample);
+    }
+    return sink == 12345.0f ? 1 : 0;
+}
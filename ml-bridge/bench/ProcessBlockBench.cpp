@@ -0,0 +1,109 @@
+/**
+ * processBlock-equivalent benchmark for the headless realtime path (AceForgeAudio PlaybackCore).
+ * For host rates 44.1k..192k, a 48 kHz stereo source is resampled into a clip with ClipWriter (as a finished
+ * download is) and published through the core's ClipHandoff; the core then renders it block by block at sizes
+ * 16..4096, exactly as the plugin's processBlock does. Prints the mean ns per output frame (untimed pass), the
+ * worst single block in microseconds (each block timed) and that worst block as a share of its realtime budget
+ * (blockSize / rate). Worst-case numbers include scheduler noise on a loaded machine; run it on an idle box.
+ * After each rate, the core's own RealtimeStats (what the plugin reports) summarise every block it rendered.
+ *
+ *   aceforge_process_bench [seconds of audio per pass]
+ */
+#include "AceForgeAudio/ClipWriter.hpp"
+#include "AceForgeAudio/PlaybackCore.hpp"
+#include "AceForgeAudio/RealtimeStats.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+constexpr double kSourceRate = 48000.0;
+constexpr int kWarmupBlocks = 64;  // past the start fade, caches warm
+
+using Clock = std::chrono::steady_clock;
+
+// Resamples the source to hostRate into a fresh clip and publishes it, like a download finishing
+bool publishClip(aceforge::PlaybackCore& core, const std::vector<float>* source, double hostRate, int64_t sourceId) {
+    const int64_t frames = (int64_t)source[0].size();
+    aceforge::ClipWriter writer;
+    aceforge::ClipHandoff& handoff = core.handoff();
+    const int maxFrames = (int)std::min<int64_t>(1 << 30, (int64_t)std::ceil((double)frames * hostRate / kSourceRate) + 64);
+    if (!writer.begin(handoff, frames, kSourceRate, hostRate, sourceId, maxFrames, 4096,
+                      [&handoff](const std::shared_ptr<aceforge::PlaybackClip>& clip) { handoff.publish(clip); }))
+        return false;
+    const float* planar[2] = { source[0].data(), source[1].data() };
+    writer.appendPlanar(planar, 2, (int)frames);
+    writer.finish();
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const double seconds = argc > 1 ? std::atof(argv[1]) : 5.0;
+    const double rates[] = { 44100.0, 48000.0, 88200.0, 96000.0, 176400.0, 192000.0 };
+
+    // Enough source for the warmup plus both passes at the largest block size
+    const int sourceFrames = (int)(2.0 * seconds * kSourceRate) + 4096 * (kWarmupBlocks + 2);
+    std::vector<float> source[2];
+    for (auto& channel : source) channel.resize((size_t)sourceFrames);
+    for (int i = 0; i < sourceFrames; ++i) {
+        const float v = 0.5f * std::sin((float)i * 0.01f);
+        source[0][(size_t)i] = v;
+        source[1][(size_t)i] = -v;
+    }
+
+    float sink = 0.0f;
+    int64_t sourceId = 0;
+    std::printf("%8s %8s %12s %14s %12s %12s\n", "rate", "block", "ns/frame", "worst blk us", "budget us", "worst/budget");
+    for (double rate : rates) {
+        aceforge::PlaybackCore core;
+        core.prepare(rate);
+        for (int blockSize = 16; blockSize <= 4096; blockSize *= 2) {
+            const auto tc = Clock::now();
+            if (!publishClip(core, source, rate, ++sourceId)) {
+                std::fprintf(stderr, "clip too long at %.0f Hz\n", rate);
+                return 1;
+            }
+            const double clipMs = std::chrono::duration<double, std::milli>(Clock::now() - tc).count();
+            const long blocks = (long)(seconds * rate) / blockSize;
+            std::vector<float> left((size_t)blockSize), right((size_t)blockSize);
+            float* out[2] = { left.data(), right.data() };
+
+            for (long b = 0; b < kWarmupBlocks; ++b) core.process(out, 2, blockSize);
+
+            // Mean: one clock read around the whole pass
+            const auto t0 = Clock::now();
+            for (long b = 0; b < blocks; ++b) {
+                core.process(out, 2, blockSize);
+                sink += left[0];
+            }
+            const double meanNs = std::chrono::duration<double, std::nano>(Clock::now() - t0).count()
+                                  / (double)(blocks * blockSize);
+
+            // Worst case: every block timed on its own
+            double worstNs = 0.0;
+            for (long b = 0; b < blocks; ++b) {
+                const auto s = Clock::now();
+                core.process(out, 2, blockSize);
+                worstNs = std::max(worstNs, std::chrono::duration<double, std::nano>(Clock::now() - s).count());
+                sink += right[0];
+            }
+            const double budgetUs = 1.0e6 * (double)blockSize / rate;
+            std::printf("%8.0f %8d %12.3f %14.2f %12.1f %11.3f%%   (clip %.0f ms)\n", rate, blockSize, meanNs,
+                        worstNs / 1000.0, budgetUs, 100.0 * worstNs / 1000.0 / budgetUs, clipMs);
+            core.handoff().reclaim();
+        }
+        const aceforge::RealtimeStats::Snapshot st = core.stats().snapshot();
+        std::printf("%8s %ld blocks, mean load %.3f%%, peak block %.1f us, peak handoff block %.1f us, "
+                    "%lld handoffs, %lld overruns, %lld underruns\n",
+                    "stats", (long)st.blocks, st.meanLoadPercent(), (double)st.peakBlockNs / 1000.0,
+                    (double)st.peakHandoffBlockNs / 1000.0, (long long)st.handoffs, (long long)st.overruns,
+                    (long long)st.underruns);
+    }
+    return sink == 12345.0f ? 1 : 0;
+}
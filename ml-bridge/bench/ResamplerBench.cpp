@@ -0,0 +1,57 @@
+/**
+ * Microbenchmark for the windowed-sinc resampler (AceForgeAudio Resampler).
+ * Converts a mono source for common rate pairs (the specialized 44.1k <-> 48k and 2x paths, a generic
+ * rational ratio and a non-integer one) and prints ns per output frame and throughput in x realtime.
+ *
+ *   aceforge_resampler_bench [seconds of source audio]
+ */
+#include "AceForgeAudio/Resampler.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+struct Case {
+    const char* name;
+    double sourceRate;
+    double targetRate;
+};
+
+const Case kCases[] = {
+    { "44.1k->48k", 44100.0, 48000.0 },
+    { "48k->44.1k", 48000.0, 44100.0 },
+    { "48k->96k", 48000.0, 96000.0 },
+    { "96k->48k", 96000.0, 48000.0 },
+    { "44.1k->96k", 44100.0, 96000.0 },
+    { "48k->44.1k+0.5", 48000.0, 44100.5 },
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const double seconds = argc > 1 ? std::atof(argv[1]) : 10.0;
+    float sink = 0.0f;
+    std::printf("%-16s %6s %14s %14s\n", "case", "taps", "ns/out frame", "x realtime");
+    for (const Case& c : kCases) {
+        const int64_t sourceFrames = (int64_t)(seconds * c.sourceRate);
+        std::vector<float> source((size_t)sourceFrames);
+        for (int64_t i = 0; i < sourceFrames; ++i) source[(size_t)i] = std::sin((float)i * 0.05f);
+
+        const auto d0 = std::chrono::steady_clock::now();
+        aceforge::Resampler resampler(c.sourceRate, c.targetRate);
+        const double designMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - d0).count();
+
+        const int64_t outFrames = resampler.outputLength(sourceFrames);
+        std::vector<float> out((size_t)outFrames);
+        const auto t0 = std::chrono::steady_clock::now();
+        resampler.render(source.data(), sourceFrames, out.data(), 0, outFrames);
+        const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+        sink += out[(size_t)(outFrames / 2)];
+        std::printf("%-16s %6d %14.2f %14.0f   (filter design %.2f ms)\n", c.name, resampler.numTaps(),
+                    ns / (double)outFrames, seconds * 1e9 / ns, designMs);
+    }
+    return sink == 12345.0f ? 1 : 0;
+}
@@ -0,0 +1,136 @@
+/**
+ * What N plugin instances cost a local AceForge server, with and without the shared AceForgeSession, against an
+ * in-process MockAceForgeServer. Each instance is one thread running jobs back to back the way runJob does, without
+ * the download: health check, submit, wait. Modes:
+ *   own/events       each instance has its own client, checks health before every job and waits on the job's event
+ *                    stream (one open connection, so one server thread, per waiting job)
+ *   own/polling      the same, waiting by polling status (the mock's events endpoint is off)
+ *   session/events   one AceForgeSession for all instances: cached health, pooled clients leased for each submit
+ *                    and each job's event stream
+ *   session/polling  the same without the events endpoint: a single poll thread for every job's status
+ * The mock's single simulated GPU serialises inference, so wall time is about jobs x inference in every mode; the
+ * columns to compare are the health and status requests per job, the connections opened and the peak number open.
+ *
+ *   aceforge_session_bench [jobs per instance] [inference ms]
+ */
+#include "AceForgeClient/AceForgeClient.hpp"
+#include "AceForgeClient/AceForgeSession.hpp"
+#include "MockAceForgeServer.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+enum class Mode { OwnEvents, OwnPolling, SessionEvents, SessionPolling };
+
+const char* modeName(Mode mode) {
+    switch (mode) {
+        case Mode::OwnEvents: return "own/events";
+        case Mode::OwnPolling: return "own/polling";
+        case Mode::SessionEvents: return "session/events";
+        case Mode::SessionPolling: return "session/polling";
+    }
+    return "";
+}
+
+aceforge::GenerateParams benchParams() {
+    aceforge::GenerateParams params;
+    params.songDescription = "session bench";
+    params.durationSeconds = 2;
+    params.inferenceSteps = 8;
+    return params;
+}
+
+/** One instance's jobs with a client of its own: health, submit and wait for every job. */
+int runOwn(const std::string& baseUrl, int jobs) {
+    aceforge::AceForgeClient client(baseUrl);
+    int succeeded = 0;
+    for (int i = 0; i < jobs; ++i) {
+        if (!client.healthCheck()) continue;
+        const std::string jobId = client.startGeneration(benchParams());
+        if (jobId.empty()) continue;
+        const auto st = client.waitForJob(jobId, [](const aceforge::JobStatus&, const aceforge::ProgressInfo&) { return true; });
+        if (st.status == "succeeded") ++succeeded;
+    }
+    return succeeded;
+}
+
+/** The same through the shared session. */
+int runShared(aceforge::AceForgeSession& session, const std::string& baseUrl, int jobs) {
+    int succeeded = 0;
+    for (int i = 0; i < jobs; ++i) {
+        if (!session.isHealthy(baseUrl)) continue;
+        std::string jobId;
+        {
+            // Leased for the submit only, as GenerationScheduler does; the wait takes its own lease or polls
+            auto client = session.acquire(baseUrl);
+            jobId = client->startGeneration(benchParams());
+        }
+        if (jobId.empty()) continue;
+        const auto st = session.waitForJob(baseUrl, jobId,
+                                           [](const aceforge::JobStatus&, const aceforge::ProgressInfo&) { return true; });
+        if (st.status == "succeeded") ++succeeded;
+    }
+    return succeeded;
+}
+
+bool run(Mode mode, int instances, int jobsPerInstance, int inferenceMs) {
+    aceforge::MockAceForgeServer::Options options;
+    options.inferenceDelayMs = inferenceMs;
+    options.inferenceSteps = 8;
+    options.wavSeconds = 1.0;
+    options.events = mode == Mode::OwnEvents || mode == Mode::SessionEvents;
+    aceforge::MockAceForgeServer server(options);
+    if (!server.start()) {
+        std::fprintf(stderr, "mock server: %s\n", server.error().c_str());
+        return false;
+    }
+    std::atomic<int> succeeded{ 0 };
+    {
+        aceforge::AceForgeSession session;
+        const bool shared = mode == Mode::SessionEvents || mode == Mode::SessionPolling;
+        std::vector<std::thread> threads;
+        const auto t0 = Clock::now();
+        for (int i = 0; i < instances; ++i) {
+            threads.emplace_back([&] {
+                succeeded += shared ? runShared(session, server.baseUrl(), jobsPerInstance)
+                                  : runOwn(server.baseUrl(), jobsPerInstance);
+            });
+        }
+        for (auto& t : threads) t.join();
+        const double seconds = std::chrono::duration<double>(Clock::now() - t0).count();
+        const auto s = server.stats();
+        const double jobs = std::max(1, succeeded.load());
+        std::printf("  %-16s %9d %6d %8.2f %9.2f %9.2f %9.2f %7lld %6lld\n", modeName(mode), instances,
+                    succeeded.load(), seconds, (double)s.healthRequests / jobs, (double)s.statusRequests / jobs,
+                    (double)s.requests / jobs, (long long)s.connections, (long long)s.peakConnections);
+    }
+    server.stop();
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int jobsPerInstance = argc > 1 ? std::atoi(argv[1]) : 2;
+    const int inferenceMs = argc > 2 ? std::atoi(argv[2]) : 100;
+    std::signal(SIGPIPE, SIG_IGN);  // the client drops event streams mid-response
+
+    std::printf("%d jobs per instance, inference %d ms; requests are per succeeded job\n", jobsPerInstance, inferenceMs);
+    std::printf("  %-16s %9s %6s %8s %9s %9s %9s %7s %6s\n", "mode", "instances", "ok", "wall s", "health/j",
+                "status/j", "total/j", "conns", "peak");
+    for (int instances : { 1, 4, 16 }) {
+        for (Mode mode : { Mode::OwnEvents, Mode::OwnPolling, Mode::SessionEvents, Mode::SessionPolling })
+            if (!run(mode, instances, jobsPerInstance, inferenceMs)) return 1;
+    }
+    return 0;
+}
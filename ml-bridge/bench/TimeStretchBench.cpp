@@ -0,0 +1,85 @@
+/**
+ * Tempo-conform benchmark for AceForgeAudio TimeStretch (WSOLA), as the plugin's re-render thread runs it.
+ * A 48 kHz stereo source (chords plus a click on every beat, like a generated loop) is stretched at ratios
+ * 0.5..2. Prints the setup time (mono search signals), the render cost in ms per output second and as a multiple
+ * of realtime for a whole clip rendered in 32k-frame chunks, and the time to the first chunk when a re-render
+ * starts mid-clip (what delays a tempo change reaching the speakers).
+ *
+ *   aceforge_stretch_bench [seconds of source audio]
+ */
+#include "AceForgeAudio/TimeStretch.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+constexpr double kRate = 48000.0;
+constexpr int kChunkFrames = 1 << 15;  // the plugin's re-render chunk
+
+using Clock = std::chrono::steady_clock;
+
+double msSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const double seconds = argc > 1 ? std::atof(argv[1]) : 20.0;
+    const double stretches[] = { 0.5, 0.71, 0.9, 0.98, 1.02, 1.1, 1.41, 2.0 };
+
+    const int64_t sourceFrames = (int64_t)(seconds * kRate);
+    std::vector<float> source[2];
+    for (auto& channel : source) channel.resize((size_t)sourceFrames);
+    const int64_t beatFrames = (int64_t)(kRate * 60.0 / 120.0);
+    for (int64_t i = 0; i < sourceFrames; ++i) {
+        const double t = (double)i / kRate;
+        const double chord = 0.2 * std::sin(2.0 * 3.14159265 * 220.0 * t) + 0.15 * std::sin(2.0 * 3.14159265 * 277.2 * t)
+                             + 0.1 * std::sin(2.0 * 3.14159265 * 329.6 * t);
+        const double click = 0.5 * std::exp(-(double)(i % beatFrames) / 200.0);
+        source[0][(size_t)i] = (float)(chord + click);
+        source[1][(size_t)i] = (float)(chord - 0.5 * click);
+    }
+    const float* channels[2] = { source[0].data(), source[1].data() };
+
+    float sink = 0.0f;
+    std::printf("%8s %10s %10s %12s %12s %16s\n", "stretch", "out s", "setup ms", "ms/out s", "x realtime",
+                "first chunk ms");
+    for (double stretch : stretches) {
+        aceforge::TimeStretch stretcher;
+        const auto ts = Clock::now();
+        stretcher.prepare(kRate, stretch);
+        stretcher.setSource(channels, 2, sourceFrames);
+        const double setupMs = msSince(ts);
+
+        const int64_t outFrames = stretcher.outputLength(sourceFrames);
+        std::vector<float> left((size_t)outFrames), right((size_t)outFrames);
+        const auto t0 = Clock::now();
+        for (int64_t start = 0; start < outFrames; start += kChunkFrames) {
+            const int64_t end = std::min(outFrames, start + kChunkFrames);
+            float* out[2] = { left.data() + start, right.data() + start };
+            stretcher.render(out, 2, start, end);
+        }
+        const double renderMs = msSince(t0);
+        sink += left[(size_t)(outFrames / 2)] + right[(size_t)(outFrames / 3)];
+
+        // A re-render starting at the playhead, halfway in, on a fresh stretcher (setup included)
+        const auto t1 = Clock::now();
+        aceforge::TimeStretch midClip;
+        midClip.prepare(kRate, stretch);
+        midClip.setSource(channels, 2, sourceFrames);
+        float* out[2] = { left.data(), right.data() };
+        midClip.render(out, 2, outFrames / 2, std::min(outFrames, outFrames / 2 + kChunkFrames));
+        const double firstChunkMs = msSince(t1);
+        sink += left[0];
+
+        const double outSeconds = (double)outFrames / kRate;
+        std::printf("%8.2f %10.2f %10.2f %12.3f %12.0f %16.2f\n", stretch, outSeconds, setupMs, renderMs / outSeconds,
+                    outSeconds * 1000.0 / renderMs, firstChunkMs);
+    }
+    return sink == 12345.0f ? 1 : 0;
+}
@@ -0,0 +1,37 @@
+/**
+ * Fuzz target for the AceForge response parser (AceForgeJson).
+ * Feeds arbitrary bytes to every parse entry point and checks invariants that must hold
+ * for any input; crashes, sanitizer reports and failed invariants are findings.
+ */
+#include "AceForgeClient/AceForgeJson.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <string_view>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    const std::string_view body(reinterpret_cast<const char*>(data), size);
+
+    bool healthy = false;
+    aceforge::parseHealth(body, healthy);
+
+    aceforge::JobStatus started;
+    aceforge::parseStartResponse(body, started);
+
+    aceforge::JobStatus status;
+    aceforge::parseJobStatus(body, status);
+    if (!status.audioUrls.empty() && status.audioUrl != status.audioUrls[0]) std::abort();
+    if (status.audioUrls.empty() && !status.audioUrl.empty()) std::abort();
+
+    aceforge::ProgressInfo progress;
+    aceforge::parseProgressInfo(body, progress);
+
+    aceforge::JobStatus eventStatus;
+    aceforge::ProgressInfo eventProgress;
+    aceforge::parseJobEvent(body, eventStatus, eventProgress);
+
+    // A valid document must leave the reader exactly at its end after skipValue()
+    aceforge::json::Reader reader(body);
+    if (reader.skipValue() && reader.failed()) std::abort();
+    return 0;
+}
@@ -0,0 +1,55 @@
+/**
+ * Fuzz target for the waveform peak file (PeakPyramid::parse), which the plugin reads from the library folder.
+ * Whatever parses must serialize back to exactly the same bytes and render at any width; the input is also
+ * summarised as 16-bit audio through the Builder, whose result must survive a serialize/parse round trip.
+ */
+#include "AceForgeAudio/PeakPyramid.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+using aceforge::PeakPyramid;
+
+void checkRender(const PeakPyramid& pyramid, int numColumns) {
+    std::vector<float> mins((size_t)numColumns), maxs((size_t)numColumns);
+    pyramid.render(numColumns, mins.data(), maxs.data());
+    for (int c = 0; c < numColumns; ++c)
+        if (!(mins[(size_t)c] >= -1.0f && mins[(size_t)c] <= maxs[(size_t)c] && maxs[(size_t)c] <= 1.0f)) std::abort();
+}
+
+} // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    PeakPyramid parsed;
+    if (PeakPyramid::parse(data, size, parsed)) {
+        if (parsed.serialize() != std::vector<uint8_t>(data, data + size)) std::abort();
+        for (int columns : { 1, 7, 300 }) checkRender(parsed, columns);
+    }
+
+    // The bytes as a 16-bit stereo clip, added in chunks whose sizes come from the input
+    const int frames = (int)(size / 4);
+    std::vector<float> left((size_t)frames), right((size_t)frames);
+    for (int i = 0; i < frames; ++i) {
+        left[(size_t)i] = (float)(int16_t)(data[i * 4] | (data[i * 4 + 1] << 8)) / 32768.0f;
+        right[(size_t)i] = (float)(int16_t)(data[i * 4 + 2] | (data[i * 4 + 3] << 8)) / 32768.0f;
+    }
+    PeakPyramid::Builder builder(size > 0 ? 1 + data[0] % 64 : 1);
+    int pos = 0;
+    while (pos < frames) {
+        const int chunk = std::min(frames - pos, 1 + (int)data[(size_t)pos * 4 % size] % 97);
+        const float* channels[2] = { left.data() + pos, right.data() + pos };
+        builder.add(channels, 2, chunk);
+        pos += chunk;
+    }
+    const PeakPyramid built = builder.finish(48000.0);
+    if (built.numFrames() != frames) std::abort();
+    const std::vector<uint8_t> bytes = built.serialize();
+    PeakPyramid back;
+    if (!PeakPyramid::parse(bytes.data(), bytes.size(), back) || back.serialize() != bytes) std::abort();
+    checkRender(built, 64);
+    return 0;
+}
@@ -0,0 +1,25 @@
+/**
+ * Minimal replacement for libFuzzer's main() when building fuzz targets without Clang:
+ * runs LLVMFuzzerTestOneInput once per file given on the command line (regression corpus).
+ */
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+
+int main(int argc, char** argv) {
+    for (int i = 1; i < argc; ++i) {
+        std::ifstream in(argv[i], std::ios::binary);
+        if (!in) {
+            std::fprintf(stderr, "cannot open %s\n", argv[i]);
+            return 1;
+        }
+        std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        LLVMFuzzerTestOneInput(bytes.data(), bytes.size());
+        std::printf("ok %s (%zu bytes)\n", argv[i], bytes.size());
+    }
+    return 0;
+}
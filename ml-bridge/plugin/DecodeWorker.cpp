@@ -0,0 +1,53 @@
+#include "DecodeWorker.h"
+#include <limits>
+
+DecodeWorker::DecodeWorker()
+    : pool_(juce::ThreadPoolOptions{}.withThreadName("AceForge decode").withNumberOfThreads(1))
+{
+    formatManager_.registerBasicFormats();
+}
+
+DecodeWorker::~DecodeWorker()
+{
+    stop();
+}
+
+void DecodeWorker::stop()
+{
+    pool_.removeAllJobs(true, 10000);
+}
+
+void DecodeWorker::post(std::function<void()> job)
+{
+    pool_.addJob(std::move(job));
+}
+
+DecodeWorker::Decoded DecodeWorker::decode(const std::vector<uint8_t>& bytes)
+{
+    Decoded out;
+    const double start = juce::Time::getMillisecondCounterHiRes();
+    auto stream = std::make_unique<juce::MemoryInputStream>(bytes.data(), bytes.size(), false);
+    std::unique_ptr<juce::AudioFormatReader> reader(formatManager_.createReaderFor(std::move(stream)));
+    if (reader == nullptr)
+    {
+        out.error = "Failed to decode audio";
+        return out;
+    }
+    const int numCh = static_cast<int>(reader->numChannels);
+    const juce::int64 numSamples = reader->lengthInSamples;
+    if (numSamples <= 0 || numCh <= 0 || numSamples > std::numeric_limits<int>::max())
+    {
+        out.error = "Invalid audio (no samples)";
+        return out;
+    }
+    out.audio.setSize(numCh, static_cast<int>(numSamples));
+    if (!reader->read(&out.audio, 0, static_cast<int>(numSamples), 0, true, true))
+    {
+        out.error = "Failed to read audio samples";
+        out.audio.setSize(0, 0);
+        return out;
+    }
+    out.sampleRate = reader->sampleRate;
+    out.decodeMs = juce::Time::getMillisecondCounterHiRes() - start;
+    return out;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <juce_core/juce_core.h>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Background thread that turns fetched audio bytes into samples, so the message thread never decodes.
+// Jobs run one at a time in the order they were posted; the worker owns its AudioFormatManager, which is
+// only ever used from that thread (JUCE format readers are not shared between threads).
+class DecodeWorker
+{
+public:
+    struct Decoded
+    {
+        juce::AudioBuffer<float> audio;
+        double sampleRate = 0.0;
+        double decodeMs = 0.0;
+        juce::String error; // empty on success
+    };
+
+    DecodeWorker();
+    ~DecodeWorker();
+
+    // Drops queued jobs and waits for the running one. Call before tearing down anything the jobs touch.
+    void stop();
+
+    // Queues job to run on the worker thread.
+    void post(std::function<void()> job);
+
+    // Decodes a whole file held in memory (WAV, AIFF, FLAC, ... whatever the manager knows). Worker thread only.
+    Decoded decode(const std::vector<uint8_t>& bytes);
+
+private:
+    juce::AudioFormatManager formatManager_;
+    juce::ThreadPool pool_;
+
+    JUCE_DECLARE_NON_COPYABLE(DecodeWorker)
+};
@@ -0,0 +1,212 @@
+#include "DiskStreamer.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+constexpr int kPollMs = 10; // how often a stream with room to fill checks the ring again
+}
+
+DiskStreamer::DiskStreamer(aceforge::ClipHandoff& handoff)
+    : juce::Thread("AceForge disk stream"), handoff_(handoff)
+{
+}
+
+DiskStreamer::~DiskStreamer()
+{
+    stopThread(2000);
+}
+
+void DiskStreamer::start(const juce::File& file, double hostRate, int64_t sourceId, int64_t startFrame, bool replacing)
+{
+    Request request;
+    request.file = file;
+    request.hostRate = hostRate;
+    request.sourceId = sourceId;
+    request.startFrame = startFrame;
+    request.replacing = replacing;
+    post(request);
+}
+
+void DiskStreamer::setHostRate(double hostRate, int64_t position)
+{
+    Request request;
+    {
+        juce::ScopedLock l(requestLock_);
+        if (active_.sourceId == 0 || active_.hostRate <= 0.0 || active_.hostRate == hostRate)
+            return;
+        request = active_;
+        request.startFrame = std::llround(static_cast<double>(position) * hostRate / active_.hostRate);
+        request.hostRate = hostRate;
+        request.replacing = true;
+    }
+    post(request);
+}
+
+void DiskStreamer::stop()
+{
+    if (activeSourceId_.load() != 0)
+        post(Request{});
+}
+
+void DiskStreamer::post(Request request)
+{
+    {
+        juce::ScopedLock l(requestLock_);
+        pending_ = request;
+        active_ = request;
+        activeSourceId_.store(request.sourceId);
+        hasRequest_.store(true);
+        if (!isThreadRunning())
+            startThread();
+    }
+    notify();
+}
+
+void DiskStreamer::run()
+{
+    // The format manager (and every reader it creates) is only touched from this thread
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+    while (!threadShouldExit())
+    {
+        Request request;
+        bool haveRequest = false;
+        {
+            juce::ScopedLock l(requestLock_);
+            if (hasRequest_.load())
+            {
+                request = pending_;
+                hasRequest_.store(false);
+                haveRequest = true;
+            }
+        }
+        if (haveRequest)
+            open(formatManager, request);
+
+        // The audio thread frees ring space without signalling, so poll while there is more to write
+        const bool more = clip_ != nullptr && fill();
+        wait(more ? kPollMs : -1);
+    }
+    close();
+}
+
+void DiskStreamer::open(juce::AudioFormatManager& formatManager, const Request& request)
+{
+    close();
+    if (request.file == juce::File())
+        return;
+
+    std::unique_ptr<juce::AudioFormatReader> reader;
+    if (auto* format = formatManager.findFormatForFileExtension(request.file.getFileExtension()))
+    {
+        // Mapping costs address space, not memory: pages come in as the read position reaches them
+        std::unique_ptr<juce::MemoryMappedAudioFormatReader> mapped(format->createMemoryMappedReader(request.file));
+        if (mapped != nullptr && mapped->mapEntireFile())
+            reader = std::move(mapped);
+    }
+    if (reader == nullptr)
+        reader.reset(formatManager.createReaderFor(request.file));
+    if (reader == nullptr || reader->lengthInSamples <= 0 || reader->numChannels == 0 || reader->sampleRate <= 0.0)
+    {
+        {
+            juce::ScopedLock l(requestLock_);
+            if (active_.sourceId == request.sourceId && !hasRequest_.load())
+            {
+                active_ = Request{};
+                activeSourceId_.store(0);
+            }
+        }
+        if (onError_)
+            onError_("Cannot play " + request.file.getFileName() + " from disk");
+        return;
+    }
+
+    reader_ = std::move(reader);
+    sourceFrames_ = reader_->lengthInSamples;
+    resampler_.setRates(reader_->sampleRate, request.hostRate);
+    endFrame_ = resampler_.outputLength(sourceFrames_);
+    window_.setSize(2, kChunkFrames + resampler_.numTaps(), false, false, true);
+    const int64_t startFrame = juce::jlimit<int64_t>(0, endFrame_, request.startFrame);
+
+    clip_ = handoff_.createClip(2, kRingFrames);
+    clip_->isRing = true;
+    clip_->firstFrame = startFrame;
+    clip_->readyFrames.store(startFrame, std::memory_order_relaxed);
+    clip_->consumedFrames.store(startFrame, std::memory_order_relaxed);
+    clip_->sampleRate = request.hostRate;
+    clip_->sourceId = request.sourceId;
+    clip_->isRerender = request.replacing;
+    written_ = startFrame;
+    published_ = false;
+}
+
+void DiskStreamer::close()
+{
+    // No more frames will come: if the engine is still playing this clip, running dry is its end, not an underrun
+    if (clip_ != nullptr)
+        clip_->complete.store(true, std::memory_order_release);
+    clip_.reset();
+    reader_.reset();
+    sourceFrames_ = 0;
+    endFrame_ = 0;
+    written_ = 0;
+    published_ = false;
+}
+
+bool DiskStreamer::fill()
+{
+    const int capacity = clip_->audio.numFrames();
+    while (written_ < endFrame_)
+    {
+        if (threadShouldExit() || hasRequest_.load())
+            return true;
+        // Write a whole chunk (or the tail of the file) at a time rather than trickling in single host blocks
+        const int64_t room = clip_->consumedFrames.load(std::memory_order_acquire) + capacity - written_;
+        const int64_t want = std::min<int64_t>(kChunkFrames, endFrame_ - written_);
+        if (room < want)
+            break;
+        renderChunk(written_, written_ + want);
+        written_ += want;
+        clip_->readyFrames.store(written_, std::memory_order_release);
+        if (!published_ && (written_ - clip_->firstFrame >= kPrebufferFrames || written_ == endFrame_))
+        {
+            handoff_.publish(clip_);
+            published_ = true;
+        }
+    }
+    if (written_ < endFrame_)
+        return true;
+    clip_->complete.store(true, std::memory_order_release);
+    reader_.reset(); // whole file is in the ring or played; setHostRate reopens it
+    return false;
+}
+
+void DiskStreamer::renderChunk(int64_t firstFrame, int64_t endFrame)
+{
+    // Read just the source frames this chunk's filter taps cover; frames outside the file count as silence
+    int64_t begin = 0, end = 0;
+    resampler_.sourceWindow(firstFrame, endFrame, begin, end);
+    begin = std::max<int64_t>(0, begin);
+    end = std::min(sourceFrames_, end);
+    const int count = static_cast<int>(std::max<int64_t>(0, end - begin));
+    if (count > window_.getNumSamples())
+        window_.setSize(2, count, false, false, true);
+    if (count > 0)
+    {
+        if (!reader_->read(&window_, 0, count, begin, true, true))
+            window_.clear(0, count);
+        if (reader_->numChannels == 1)
+            window_.copyFrom(1, 0, window_, 0, 0, count);
+    }
+
+    const int capacity = clip_->audio.numFrames();
+    for (int64_t frame = firstFrame; frame < endFrame;)
+    {
+        const int64_t slot = frame % capacity;
+        const int64_t segmentEnd = std::min(endFrame, frame + (capacity - slot));
+        for (int c = 0; c < 2; ++c)
+            resampler_.render(window_.getReadPointer(c), begin, count, clip_->audio.channel(c) + slot, frame, segmentEnd);
+        frame = segmentEnd;
+    }
+}
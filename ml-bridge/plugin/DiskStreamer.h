@@ -0,0 +1,78 @@
+#pragma once
+
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <juce_core/juce_core.h>
+#include "AceForgeAudio/ClipHandoff.hpp"
+#include "AceForgeAudio/Resampler.hpp"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+// Plays audio files of any length from disk with a fixed memory footprint. A read-ahead thread reads the file
+// (memory-mapped when the format supports it, buffered otherwise), resamples it to the host rate and keeps a ring
+// clip of kRingFrames frames topped up ahead of the audio thread. The ring clip goes through the same ClipHandoff
+// as in-memory clips; the engine only has to handle the wrap.
+class DiskStreamer : private juce::Thread
+{
+public:
+    static constexpr int kRingFrames = 1 << 17;       // ~2.7 s at 48k, 1 MB per instance
+    static constexpr int kChunkFrames = 8192;         // frames resampled per read
+    static constexpr int kPrebufferFrames = 16384;    // frames written before the clip is published
+
+    explicit DiskStreamer(aceforge::ClipHandoff& handoff);
+    ~DiskStreamer() override;
+
+    // Called on the read-ahead thread when a file cannot be opened or read. Set before the first start().
+    void setOnError(std::function<void(const juce::String&)> f) { onError_ = std::move(f); }
+
+    // Streams file from host-rate frame startFrame. With replacing, the clip is published as a re-render of the
+    // playing clip with the same sourceId (the engine continues at the same point) instead of starting over.
+    void start(const juce::File& file, double hostRate, int64_t sourceId, int64_t startFrame, bool replacing);
+    // The host rate changed: restarts the active stream at the new rate from position (frames at the old rate).
+    void setHostRate(double hostRate, int64_t position);
+    // Stops reading and drops the clip (the audio thread keeps it until it lets go through ClipHandoff).
+    void stop();
+
+    // Source of the active stream, 0 when idle.
+    int64_t activeSourceId() const { return activeSourceId_.load(); }
+
+private:
+    struct Request
+    {
+        juce::File file; // empty: stop
+        double hostRate = 0.0;
+        int64_t sourceId = 0;
+        int64_t startFrame = 0;
+        bool replacing = false;
+    };
+
+    void run() override;
+    void post(Request request);
+    void open(juce::AudioFormatManager& formatManager, const Request& request);
+    void close();
+    bool fill(); // true while there is more of the file to write
+    void renderChunk(int64_t firstFrame, int64_t endFrame);
+
+    aceforge::ClipHandoff& handoff_;
+    std::function<void(const juce::String&)> onError_;
+
+    // Requests (any thread); only the newest pending one matters
+    juce::CriticalSection requestLock_;
+    Request pending_;
+    Request active_; // last request started, for setHostRate
+    std::atomic<bool> hasRequest_{ false };
+    std::atomic<int64_t> activeSourceId_{ 0 };
+
+    // Read-ahead thread only
+    std::unique_ptr<juce::AudioFormatReader> reader_;
+    aceforge::Resampler resampler_;
+    juce::AudioBuffer<float> window_; // source frames for one chunk
+    std::shared_ptr<aceforge::PlaybackClip> clip_;
+    int64_t sourceFrames_ = 0;
+    int64_t endFrame_ = 0;  // output length at host rate
+    int64_t written_ = 0;
+    bool published_ = false;
+
+    JUCE_DECLARE_NON_COPYABLE(DiskStreamer)
+};
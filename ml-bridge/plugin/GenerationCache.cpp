@@ -0,0 +1,148 @@
+#include "GenerationCache.h"
+#include <algorithm>
+
+namespace
+{
+// Hidden while incomplete, like LibraryWriter's saves: the scan only picks up *.wav
+juce::File partFileFor(const juce::File& target)
+{
+    return target.getSiblingFile("." + target.getFileName() + ".part");
+}
+
+bool writeAtomically(const juce::File& target, const void* data, size_t size)
+{
+    const juce::File part = partFileFor(target);
+    if (part.replaceWithData(data, size) && part.moveFileTo(target))
+        return true;
+    part.deleteFile();
+    return false;
+}
+} // namespace
+
+GenerationCache::GenerationCache(juce::File directory, juce::int64 maxBytes)
+    : directory_(std::move(directory)), maxBytes_(maxBytes)
+{
+}
+
+juce::File GenerationCache::lookup(const aceforge::GenerateParams& params)
+{
+    if (!aceforge::isDeterministic(params))
+        return {};
+    const std::string key = aceforge::generationCacheKey(params);
+    juce::ScopedLock l(lock_);
+    ensureLoadedLocked();
+    auto it = findLocked(key);
+    if (it != entries_.end() && !it->file.existsAsFile())
+    {
+        // Deleted behind our back
+        totalBytes_ -= it->bytes;
+        entries_.erase(it);
+        it = entries_.end();
+    }
+    if (it == entries_.end() || it->canonical != aceforge::canonicalGenerateParams(params))
+    {
+        ++stats_.misses;
+        return {};
+    }
+    ++stats_.hits;
+    it->lastUsed = juce::Time::getCurrentTime();
+    it->file.setLastModificationTime(it->lastUsed);
+    return it->file;
+}
+
+bool GenerationCache::store(const aceforge::GenerateParams& params, const std::vector<uint8_t>& wavBytes)
+{
+    if (!aceforge::isDeterministic(params) || wavBytes.empty())
+        return true;
+    const std::string key = aceforge::generationCacheKey(params);
+    const std::string canonical = aceforge::canonicalGenerateParams(params);
+    juce::ScopedLock l(lock_);
+    ensureLoadedLocked();
+    if (static_cast<juce::int64>(wavBytes.size()) > maxBytes_)
+        return true; // would evict everything else and still not fit
+
+    if (!directory_.exists() && !directory_.createDirectory())
+        return false;
+    const juce::File wav = directory_.getChildFile(juce::String(key) + ".wav");
+    // Parameters first, so a scan never finds audio it cannot verify
+    const juce::File paramsFile = wav.withFileExtension("params");
+    if (!writeAtomically(paramsFile, canonical.data(), canonical.size()) || !writeAtomically(wav, wavBytes.data(), wavBytes.size()))
+    {
+        paramsFile.deleteFile();
+        return false;
+    }
+
+    auto it = findLocked(key);
+    if (it != entries_.end())
+    {
+        totalBytes_ -= it->bytes;
+        entries_.erase(it);
+    }
+    entries_.push_back({ key, canonical, wav, static_cast<juce::int64>(wavBytes.size()), juce::Time::getCurrentTime() });
+    totalBytes_ += entries_.back().bytes;
+    ++stats_.stores;
+    evictLocked();
+    return true;
+}
+
+void GenerationCache::setMaxBytes(juce::int64 maxBytes)
+{
+    juce::ScopedLock l(lock_);
+    maxBytes_ = maxBytes;
+    if (loaded_)
+        evictLocked();
+}
+
+GenerationCache::Stats GenerationCache::getStats() const
+{
+    juce::ScopedLock l(lock_);
+    Stats out = stats_;
+    out.entries = static_cast<int>(entries_.size());
+    out.bytes = totalBytes_;
+    return out;
+}
+
+void GenerationCache::ensureLoadedLocked()
+{
+    if (loaded_)
+        return;
+    loaded_ = true;
+    juce::Array<juce::File> files;
+    directory_.findChildFiles(files, juce::File::findFiles | juce::File::ignoreHiddenFiles, false, "*.wav");
+    for (const juce::File& wav : files)
+    {
+        const juce::File paramsFile = wav.withFileExtension("params");
+        if (!paramsFile.existsAsFile())
+        {
+            wav.deleteFile(); // interrupted store
+            continue;
+        }
+        entries_.push_back({ wav.getFileNameWithoutExtension().toStdString(), paramsFile.loadFileAsString().toStdString(),
+                             wav, wav.getSize(), wav.getLastModificationTime() });
+        totalBytes_ += entries_.back().bytes;
+    }
+    evictLocked();
+}
+
+void GenerationCache::evictLocked()
+{
+    if (totalBytes_ <= maxBytes_)
+        return;
+    // Oldest use first; the newest entry is never evicted by its own store
+    std::sort(entries_.begin(), entries_.end(), [](const Entry& a, const Entry& b) { return a.lastUsed < b.lastUsed; });
+    size_t evicted = 0;
+    while (totalBytes_ > maxBytes_ && evicted + 1 < entries_.size())
+    {
+        const Entry& e = entries_[evicted++];
+        e.file.deleteFile();
+        e.file.withFileExtension("params").deleteFile();
+        totalBytes_ -= e.bytes;
+        ++stats_.evictions;
+    }
+    entries_.erase(entries_.begin(), entries_.begin() + static_cast<std::ptrdiff_t>(evicted));
+}
+
+std::vector<GenerationCache::Entry>::iterator GenerationCache::findLocked(const std::string& key)
+{
+    return std::find_if(entries_.begin(), entries_.end(), [&key](const Entry& e) { return e.key == key; });
+}
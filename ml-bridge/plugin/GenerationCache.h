@@ -0,0 +1,66 @@
+#pragma once
+
+#include "AceForgeClient/AceForgeClient.hpp"
+#include <juce_core/juce_core.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Content-addressed store of generated WAVs, so a repeated fixed-seed request is answered from disk instead of
+// going through AceForge again. An entry is <key>.wav plus <key>.params (the canonical parameter text, compared
+// on lookup so a hash collision is a miss), keyed on aceforge::generationCacheKey(). Least recently used entries
+// are evicted once the folder exceeds its size limit; a hit touches the file, so the order survives restarts.
+// Scanned on first use; thread-safe.
+class GenerationCache
+{
+public:
+    static constexpr juce::int64 kDefaultMaxBytes = 512 * 1024 * 1024;
+
+    struct Stats
+    {
+        juce::int64 hits = 0;
+        juce::int64 misses = 0;
+        juce::int64 stores = 0;
+        juce::int64 evictions = 0;
+        int entries = 0;
+        juce::int64 bytes = 0;
+    };
+
+    explicit GenerationCache(juce::File directory, juce::int64 maxBytes = kDefaultMaxBytes);
+
+    const juce::File& getDirectory() const { return directory_; }
+
+    // The cached WAV for params, or a File that does not exist on a miss. Random-seed requests are not looked up
+    // (and not counted).
+    juce::File lookup(const aceforge::GenerateParams& params);
+    // Stores a copy of wavBytes for params, then evicts down to the size limit. No-op for random seeds; false when
+    // the file cannot be written.
+    bool store(const aceforge::GenerateParams& params, const std::vector<uint8_t>& wavBytes);
+
+    void setMaxBytes(juce::int64 maxBytes);
+    Stats getStats() const;
+
+private:
+    struct Entry
+    {
+        std::string key;
+        std::string canonical;
+        juce::File file;
+        juce::int64 bytes = 0;
+        juce::Time lastUsed;
+    };
+
+    void ensureLoadedLocked();
+    void evictLocked();
+    std::vector<Entry>::iterator findLocked(const std::string& key);
+
+    juce::CriticalSection lock_;
+    juce::File directory_;
+    juce::int64 maxBytes_;
+    std::vector<Entry> entries_;
+    juce::int64 totalBytes_ = 0;
+    bool loaded_ = false;
+    Stats stats_;
+
+    JUCE_DECLARE_NON_COPYABLE(GenerationCache)
+};
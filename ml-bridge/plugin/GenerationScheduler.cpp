@@ -0,0 +1,220 @@
+#include "GenerationScheduler.h"
+#include <algorithm>
+
+GenerationScheduler::GenerationScheduler(aceforge::AceForgeSession& session, juce::String baseUrl, Runner runner)
+    : session_(session),
+      runner_(std::move(runner)),
+      baseUrl_(std::move(baseUrl)),
+      pool_(juce::ThreadPoolOptions{}.withThreadName("AceForge generation").withNumberOfThreads(kMaxWorkers))
+{
+}
+
+GenerationScheduler::~GenerationScheduler()
+{
+    stop();
+}
+
+void GenerationScheduler::setBaseUrl(const juce::String& url)
+{
+    // Picked up by each job as it starts; jobs already talking to the old server finish there
+    juce::ScopedLock l(lock_);
+    baseUrl_ = url;
+}
+
+int GenerationScheduler::submit(const Request& request)
+{
+    int id = 0;
+    {
+        juce::ScopedLock l(lock_);
+        const auto waiting = std::count_if(jobs_.begin(), jobs_.end(), [](const Job& j) { return j.state == State::Waiting; });
+        if (stopped_ || waiting >= kMaxWaiting)
+            return 0;
+        Job job;
+        job.id = id = ++nextId_;
+        job.request = request;
+        job.statusText = "Waiting";
+        job.cancel = std::make_shared<aceforge::CancellationToken>();
+        jobs_.push_back(std::move(job));
+    }
+    // One pool job per request: each takes the oldest waiting request, so they start in submission order
+    pool_.addJob([this] { runNext(); });
+    notifyChange();
+    return id;
+}
+
+void GenerationScheduler::runNext()
+{
+    Job job;
+    std::string baseUrl;
+    {
+        juce::ScopedLock l(lock_);
+        auto it = std::find_if(jobs_.begin(), jobs_.end(), [](const Job& j) { return j.state == State::Waiting; });
+        if (stopped_ || it == jobs_.end())
+            return;
+        it->state = State::Submitting;
+        it->statusText = "Submitting";
+        job = *it;
+        baseUrl = baseUrl_.toStdString();
+    }
+    notifyChange();
+
+    Clients clients(*this, baseUrl);
+    runner_(job, clients);
+}
+
+GenerationScheduler::ClientLease::ClientLease(GenerationScheduler& owner, aceforge::AceForgeSession::Lease lease)
+    : owner_(owner),
+      lease_(std::move(lease))
+{
+    juce::ScopedLock l(owner_.lock_);
+    // Leased after stop() cut the others off, e.g. to withdraw a job: fail at once too
+    if (owner_.aborting_)
+        lease_->abort();
+    owner_.busyClients_.push_back(lease_.get());
+}
+
+GenerationScheduler::ClientLease::~ClientLease()
+{
+    // Off the list before the lease resets the abort and the client serves someone else
+    juce::ScopedLock l(owner_.lock_);
+    owner_.busyClients_.erase(std::find(owner_.busyClients_.begin(), owner_.busyClients_.end(), lease_.get()));
+}
+
+void GenerationScheduler::update(int id, const std::function<void(Job&)>& change)
+{
+    {
+        juce::ScopedLock l(lock_);
+        if (stopped_)
+            return;
+        auto it = std::find_if(jobs_.begin(), jobs_.end(), [id](const Job& j) { return j.id == id; });
+        if (it == jobs_.end() || it->isFinished())
+            return;
+        change(*it);
+        if (it->isFinished())
+            pruneLocked();
+    }
+    notifyChange();
+}
+
+int GenerationScheduler::cancel(int id)
+{
+    int cancelled = 0;
+    {
+        juce::ScopedLock l(lock_);
+        for (Job& job : jobs_)
+        {
+            if ((id == 0 || job.id == id) && !job.isFinished() && !job.cancel->isCancelled())
+            {
+                cancelLocked(job);
+                ++cancelled;
+            }
+        }
+        if (cancelled > 0)
+            pruneLocked();
+    }
+    if (cancelled > 0)
+        notifyChange();
+    return cancelled;
+}
+
+bool GenerationScheduler::isCancelled(int id) const
+{
+    juce::ScopedLock l(lock_);
+    auto it = std::find_if(jobs_.begin(), jobs_.end(), [id](const Job& j) { return j.id == id; });
+    return it != jobs_.end() && it->cancel->isCancelled();
+}
+
+void GenerationScheduler::cancelLocked(Job& job)
+{
+    // Wakes the runner if it is blocked waiting for or downloading this job
+    job.cancel->cancel();
+    if (job.state == State::Waiting)
+    {
+        // Never reached the server; the pool job that would have run it takes the next request instead
+        job.state = State::Cancelled;
+        job.statusText = "Cancelled";
+    }
+    else
+    {
+        job.statusText = "Cancelling...";
+    }
+}
+
+void GenerationScheduler::stop()
+{
+    {
+        juce::ScopedLock l(lock_);
+        if (stopped_)
+            return;
+        for (Job& job : jobs_)
+            if (!job.isFinished())
+                cancelLocked(job);
+        stopped_ = true;
+    }
+    // Runners withdraw their server jobs on the way out; only a server that does not answer makes us cut them off
+    if (!pool_.removeAllJobs(true, kStopGraceMs))
+    {
+        {
+            juce::ScopedLock l(lock_);
+            // Wakes workers blocked in a request or a download
+            aborting_ = true;
+            for (auto* client : busyClients_)
+                client->abort();
+        }
+        pool_.removeAllJobs(true, 10000);
+    }
+    juce::ScopedLock l(lock_);
+    for (Job& job : jobs_)
+    {
+        if (!job.isFinished())
+        {
+            job.state = State::Failed;
+            job.error = job.statusText = "Stopped";
+        }
+    }
+}
+
+std::vector<GenerationScheduler::Job> GenerationScheduler::getJobs() const
+{
+    juce::ScopedLock l(lock_);
+    return jobs_;
+}
+
+bool GenerationScheduler::getJob(int id, Job& out) const
+{
+    juce::ScopedLock l(lock_);
+    auto it = std::find_if(jobs_.begin(), jobs_.end(), [id](const Job& j) { return j.id == id; });
+    if (it == jobs_.end())
+        return false;
+    out = *it;
+    return true;
+}
+
+int GenerationScheduler::getNumActive() const
+{
+    juce::ScopedLock l(lock_);
+    return static_cast<int>(std::count_if(jobs_.begin(), jobs_.end(), [](const Job& j) { return !j.isFinished(); }));
+}
+
+void GenerationScheduler::pruneLocked()
+{
+    auto finished = std::count_if(jobs_.begin(), jobs_.end(), [](const Job& j) { return j.isFinished(); });
+    for (auto it = jobs_.begin(); it != jobs_.end() && finished > kMaxFinished;)
+    {
+        if (it->isFinished())
+        {
+            it = jobs_.erase(it);
+            --finished;
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+void GenerationScheduler::notifyChange()
+{
+    if (onChange_)
+        onChange_();
+}
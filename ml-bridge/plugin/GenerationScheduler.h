@@ -0,0 +1,144 @@
+#pragma once
+
+#include "AceForgeClient/AceForgeClient.hpp"
+#include "AceForgeClient/AceForgeSession.hpp"
+#include <juce_core/juce_core.h>
+#include <functional>
+#include <memory>
+#include <vector>
+
+// Runs one processor's generation jobs on a bounded worker pool. Each worker takes the oldest waiting request through
+// submit, wait and fetch (the Runner), so up to kMaxWorkers jobs sit in the AceForge queue together while an earlier
+// one is still downloading; further requests wait here in order. The runner leases a client from the process-wide
+// AceForgeSession for each request it sends (Clients); the wait in between goes through the session's poll thread
+// and holds no connection.
+// A runner may return with its job still Fetching (decode and library save happen on other threads) and finish
+// it later through update(). cancel() drops a waiting request at once and cancels a started job's token, which
+// interrupts its runner's blocking calls; the runner then withdraws the job from the server and marks it Cancelled.
+// stop() cancels everything, aborts clients on loan to runners that do not return promptly and joins the workers;
+// the destructor calls it.
+class GenerationScheduler
+{
+public:
+    static constexpr int kMaxWorkers = 3;
+    static constexpr int kMaxWaiting = 16;  // requests not yet picked up by a worker
+    static constexpr int kMaxFinished = 16; // finished jobs kept for getJobs()
+    static constexpr int kStopGraceMs = 2000;
+
+    enum class State
+    {
+        Waiting,    // for a worker
+        Submitting, // health check and POST /api/generate
+        Queued,     // in the AceForge queue
+        Running,
+        Fetching,   // downloading / decoding the result
+        Succeeded,
+        Failed,
+        Cancelled
+    };
+
+    struct Request
+    {
+        juce::String prompt;
+        int durationSec = 10;
+        int inferenceSteps = 15;
+        bool randomSeed = true;
+        juce::int64 seed = 0; // used when randomSeed is false
+        int bpm = 0;          // tempo to ask for (the host's, when syncing); 0 lets the model choose
+    };
+
+    struct Job
+    {
+        int id = 0;
+        Request request;
+        State state = State::Waiting;
+        float progress = -1.0f; // 0..1, negative when indeterminate
+        juce::String statusText;
+        juce::String error;
+        juce::String serverJobId;
+        // Shared with the runner; pass it to the client's waiting and download calls
+        std::shared_ptr<aceforge::CancellationToken> cancel;
+
+        bool isFinished() const { return state == State::Succeeded || state == State::Failed || state == State::Cancelled; }
+    };
+
+    // A client on loan to a runner, for one request; goes back to the session's pool when destroyed.
+    class ClientLease
+    {
+    public:
+        ClientLease(GenerationScheduler& owner, aceforge::AceForgeSession::Lease lease);
+        ~ClientLease();
+
+        aceforge::AceForgeClient& operator*() const { return *lease_; }
+        aceforge::AceForgeClient* operator->() const { return lease_.get(); }
+
+    private:
+        GenerationScheduler& owner_;
+        aceforge::AceForgeSession::Lease lease_;
+
+        JUCE_DECLARE_NON_COPYABLE(ClientLease)
+    };
+
+    // Hands one job's runner clients for the server the job started on.
+    class Clients
+    {
+    public:
+        Clients(GenerationScheduler& owner, std::string baseUrl) : owner_(owner), baseUrl_(std::move(baseUrl)) {}
+
+        const std::string& getBaseUrl() const { return baseUrl_; }
+        ClientLease acquire() { return ClientLease(owner_, owner_.session_.acquire(baseUrl_)); }
+
+    private:
+        GenerationScheduler& owner_;
+        std::string baseUrl_;
+    };
+
+    // Worker thread: runs one job, leasing clients from clients as it needs them. Calls given job.cancel fail with
+    // "Cancelled" once the job is cancelled; calls on a leased client fail with "Aborted" when stop() gives up waiting.
+    using Runner = std::function<void(const Job& job, Clients& clients)>;
+
+    // session must outlive the scheduler.
+    GenerationScheduler(aceforge::AceForgeSession& session, juce::String baseUrl, Runner runner);
+    ~GenerationScheduler();
+
+    // Called after every job change, on the thread that made it (outside the scheduler's lock).
+    void setOnChange(std::function<void()> onChange) { onChange_ = std::move(onChange); }
+    void setBaseUrl(const juce::String& url);
+
+    // Queues a request; returns its job id, or 0 when kMaxWaiting requests are already waiting or after stop().
+    int submit(const Request& request);
+    // Applies change to job id (no-op if it was pruned, already finished, or the scheduler stopped).
+    void update(int id, const std::function<void(Job&)>& change);
+    // Cancels job id, or every unfinished job when id is 0. Returns the number of jobs affected.
+    int cancel(int id);
+    bool isCancelled(int id) const;
+    // Cancels every job, gives runners kStopGraceMs to withdraw theirs from the server, then aborts the leased clients
+    // and waits for the workers. Jobs still unfinished afterwards fail with "Stopped".
+    void stop();
+
+    std::vector<Job> getJobs() const; // oldest first
+    bool getJob(int id, Job& out) const;
+    int getNumActive() const;
+
+private:
+    void runNext();
+    void cancelLocked(Job& job);
+    void pruneLocked();
+    void notifyChange();
+
+    aceforge::AceForgeSession& session_;
+    Runner runner_;
+    std::function<void()> onChange_;
+
+    juce::CriticalSection lock_;
+    juce::String baseUrl_;
+    std::vector<Job> jobs_;
+    int nextId_ = 0;
+    bool stopped_ = false;
+    bool aborting_ = false; // stop() gave up waiting: clients leased from now on start aborted
+    std::vector<aceforge::AceForgeClient*> busyClients_; // on loan to runners, for stop() to abort
+
+    juce::ThreadPool pool_;
+
+    JUCE_DECLARE_NON_COPYABLE(GenerationScheduler)
+};
@@ -0,0 +1,93 @@
+#include "LibraryIndex.h"
+#include <algorithm>
+
+namespace
+{
+// Prompt from the JSON sidecar LibraryWriter saves next to each file; the file name for older entries
+juce::String promptFor(const juce::File& audioFile)
+{
+    const juce::File sidecar = audioFile.withFileExtension("json");
+    if (sidecar.existsAsFile())
+    {
+        const juce::var json = juce::JSON::parse(sidecar);
+        const juce::String prompt = json.getProperty("prompt", juce::var()).toString();
+        if (prompt.isNotEmpty())
+            return prompt;
+    }
+    return audioFile.getFileName().upToFirstOccurrenceOf(".", false, false);
+}
+} // namespace
+
+LibraryIndex::LibraryIndex(juce::File directory) : directory_(std::move(directory))
+{
+}
+
+int LibraryIndex::size() const
+{
+    juce::ScopedLock l(lock_);
+    ensureLoadedLocked();
+    return static_cast<int>(entries_.size());
+}
+
+bool LibraryIndex::getEntry(int row, Entry& out) const
+{
+    juce::ScopedLock l(lock_);
+    ensureLoadedLocked();
+    if (row < 0 || row >= static_cast<int>(entries_.size()))
+        return false;
+    out = entries_[entries_.size() - 1 - static_cast<size_t>(row)];
+    return true;
+}
+
+std::vector<LibraryIndex::Entry> LibraryIndex::getEntries() const
+{
+    juce::ScopedLock l(lock_);
+    ensureLoadedLocked();
+    return std::vector<Entry>(entries_.rbegin(), entries_.rend());
+}
+
+void LibraryIndex::add(const juce::File& file, const juce::String& prompt)
+{
+    juce::ScopedLock l(lock_);
+    ensureLoadedLocked();
+    Entry entry{ file, prompt.isNotEmpty() ? prompt : file.getFileNameWithoutExtension(), file.getLastModificationTime() };
+    // Saves within the same second reuse a file name; that file is now the newest
+    auto it = std::find_if(entries_.begin(), entries_.end(), [&file](const Entry& e) { return e.file == file; });
+    if (it != entries_.end())
+        entries_.erase(it);
+    entries_.push_back(std::move(entry));
+    // Our own write changed the folder; don't let refresh() mistake it for an outside change
+    scannedDirTime_ = directory_.getLastModificationTime();
+    ++version_;
+}
+
+bool LibraryIndex::refresh(bool force)
+{
+    juce::ScopedLock l(lock_);
+    if (!force && loaded_ && directory_.getLastModificationTime() == scannedDirTime_)
+        return false;
+    scanLocked();
+    return true;
+}
+
+void LibraryIndex::ensureLoadedLocked() const
+{
+    if (!loaded_)
+        scanLocked();
+}
+
+void LibraryIndex::scanLocked() const
+{
+    scannedDirTime_ = directory_.getLastModificationTime();
+    // Hidden files are saves still in progress (LibraryWriter renames them into place when complete)
+    juce::Array<juce::File> files;
+    directory_.findChildFiles(files, juce::File::findFiles | juce::File::ignoreHiddenFiles, false, "*.wav;*.flac");
+    std::vector<Entry> entries;
+    entries.reserve(static_cast<size_t>(files.size()));
+    for (const juce::File& f : files)
+        entries.push_back({ f, promptFor(f), f.getLastModificationTime() });
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.time < b.time; });
+    entries_ = std::move(entries);
+    loaded_ = true;
+    ++version_;
+}
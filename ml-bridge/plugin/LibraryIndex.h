@@ -0,0 +1,50 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+// In-memory index of the library folder (saved generations), newest first. The folder is scanned once; after
+// that a saved generation is added in place, and refresh() only rescans when the folder's modification time
+// says something else changed it. Row access is O(1) and never touches the disk. Thread-safe.
+class LibraryIndex
+{
+public:
+    struct Entry
+    {
+        juce::File file;
+        juce::String prompt;
+        juce::Time time;
+    };
+
+    explicit LibraryIndex(juce::File directory);
+
+    const juce::File& getDirectory() const { return directory_; }
+
+    int size() const;
+    // Entry at row (0 = newest); false when row is out of range.
+    bool getEntry(int row, Entry& out) const;
+    std::vector<Entry> getEntries() const;
+    // Bumped on every change, so views can skip updateContent() when nothing happened.
+    uint32_t getVersion() const { return version_.load(); }
+
+    // Records a file just written to the folder (replaces the entry if the file was already listed).
+    void add(const juce::File& file, const juce::String& prompt);
+    // Rescans if the folder changed since the last scan, or always with force. Returns true if it rescanned.
+    bool refresh(bool force = false);
+
+private:
+    void ensureLoadedLocked() const;
+    void scanLocked() const;
+
+    juce::CriticalSection lock_;
+    juce::File directory_;
+    // Loaded on first use; mutable so the const accessors can load it
+    mutable std::vector<Entry> entries_; // oldest first, so a new generation is an append
+    mutable juce::Time scannedDirTime_;
+    mutable bool loaded_ = false;
+    mutable std::atomic<uint32_t> version_{ 0 };
+
+    JUCE_DECLARE_NON_COPYABLE(LibraryIndex)
+};
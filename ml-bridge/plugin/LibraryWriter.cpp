@@ -0,0 +1,170 @@
+#include "LibraryWriter.h"
+#include <cstring>
+
+namespace
+{
+bool isWav(const std::vector<uint8_t>& bytes)
+{
+    return bytes.size() >= 12 && (std::memcmp(bytes.data(), "RIFF", 4) == 0 || std::memcmp(bytes.data(), "RF64", 4) == 0)
+           && std::memcmp(bytes.data() + 8, "WAVE", 4) == 0;
+}
+
+// Hidden while incomplete: the library scan skips hidden files and the name matches no audio pattern
+juce::File partFileFor(const juce::File& target)
+{
+    return target.getSiblingFile("." + target.getFileName() + ".part");
+}
+
+bool commit(const juce::File& part, const juce::File& target)
+{
+    // rename(2) within one folder: the target appears complete or not at all
+    if (part.moveFileTo(target))
+        return true;
+    part.deleteFile();
+    return false;
+}
+
+juce::String toJson(const LibraryWriter::Metadata& m, double sampleRate, int numChannels)
+{
+    auto* obj = new juce::DynamicObject();
+    obj->setProperty("prompt", m.prompt);
+    if (m.jobId.isNotEmpty())
+        obj->setProperty("jobId", m.jobId);
+    obj->setProperty("duration", m.durationSec);
+    obj->setProperty("steps", m.inferenceSteps);
+    if (m.guidanceScale > 0.0f)
+        obj->setProperty("guidance", m.guidanceScale);
+    obj->setProperty("seed", m.randomSeed ? juce::var("random") : juce::var(static_cast<juce::int64>(m.seed)));
+    if (m.resultDurationSec > 0.0)
+        obj->setProperty("resultDuration", m.resultDurationSec);
+    if (m.bpm > 0.0)
+        obj->setProperty("bpm", m.bpm);
+    if (m.keyScale.isNotEmpty())
+        obj->setProperty("key", m.keyScale);
+    if (m.backend.isNotEmpty())
+        obj->setProperty("backend", m.backend);
+    // Identifies the generation exactly, so a cache hit or a restored project finds this copy again
+    if (m.cacheKey.isNotEmpty())
+        obj->setProperty("cacheKey", m.cacheKey);
+    obj->setProperty("sampleRate", sampleRate);
+    obj->setProperty("channels", numChannels);
+    obj->setProperty("created", juce::Time::getCurrentTime().toISO8601(true));
+    return juce::JSON::toString(juce::var(obj), true);
+}
+} // namespace
+
+LibraryWriter::LibraryWriter(juce::File directory)
+    : directory_(std::move(directory)),
+      pool_(juce::ThreadPoolOptions{}.withThreadName("AceForge library").withNumberOfThreads(1))
+{
+    formatManager_.registerBasicFormats();
+}
+
+LibraryWriter::~LibraryWriter()
+{
+    stop();
+}
+
+void LibraryWriter::stop()
+{
+    pool_.removeAllJobs(true, 10000);
+}
+
+void LibraryWriter::enqueue(std::shared_ptr<const std::vector<uint8_t>> bytes, Metadata metadata, Callback onSaved)
+{
+    const Format format = format_.load();
+    pool_.addJob([this, bytes = std::move(bytes), metadata = std::move(metadata), onSaved = std::move(onSaved), format]
+    {
+        juce::String error;
+        const juce::File file = bytes != nullptr && !bytes->empty() ? save(*bytes, metadata, format, error) : juce::File();
+        if (file == juce::File() && error.isEmpty())
+            error = "Library save failed (no audio)";
+        if (onSaved)
+            onSaved(file, error);
+    });
+}
+
+juce::File LibraryWriter::uniqueTarget(const juce::String& extension) const
+{
+    if (!directory_.exists())
+        directory_.createDirectory();
+    const juce::String base = "gen_" + juce::Time::getCurrentTime().formatted("%Y%m%d_%H%M%S");
+    juce::File target = directory_.getChildFile(base + extension);
+    // Two saves in the same second get _2, _3, ...
+    for (int n = 2; target.exists() || sidecarFor(target).exists(); ++n)
+        target = directory_.getChildFile(base + "_" + juce::String(n) + extension);
+    return target;
+}
+
+juce::File LibraryWriter::save(const std::vector<uint8_t>& bytes, const Metadata& metadata, Format format,
+                               juce::String& error)
+{
+    if (format == Format::Original && !isWav(bytes))
+        format = Format::WavFloat32;
+
+    // Read the header even for a verbatim copy: the sidecar records rate and channels
+    std::unique_ptr<juce::AudioFormatReader> reader(
+        formatManager_.createReaderFor(std::make_unique<juce::MemoryInputStream>(bytes.data(), bytes.size(), false)));
+    if (reader == nullptr && format != Format::Original)
+    {
+        error = "Library save failed: cannot decode audio";
+        return {};
+    }
+    const double sampleRate = reader != nullptr ? reader->sampleRate : 0.0;
+    const int numChannels = reader != nullptr ? static_cast<int>(reader->numChannels) : 0;
+
+    const juce::File target = uniqueTarget(format == Format::Flac ? ".flac" : ".wav");
+    const juce::File part = partFileFor(target);
+    part.deleteFile();
+    if (format == Format::Original)
+    {
+        if (!part.replaceWithData(bytes.data(), bytes.size()))
+        {
+            error = "Library save failed: cannot write " + part.getFullPathName();
+            part.deleteFile();
+            return {};
+        }
+    }
+    else
+    {
+        std::unique_ptr<juce::OutputStream> out = part.createOutputStream();
+        if (out == nullptr)
+        {
+            error = "Library save failed: cannot write " + part.getFullPathName();
+            return {};
+        }
+        auto options = juce::AudioFormatWriterOptions{}
+                           .withSampleRate(sampleRate)
+                           .withNumChannels(numChannels);
+        if (format == Format::Flac)
+            options = options.withBitsPerSample(24);
+        else
+            options = options.withBitsPerSample(32).withSampleFormat(juce::AudioFormatWriterOptions::SampleFormat::floatingPoint);
+        juce::WavAudioFormat wavFormat;
+        juce::FlacAudioFormat flacFormat;
+        juce::AudioFormat& audioFormat = format == Format::Flac ? static_cast<juce::AudioFormat&>(flacFormat)
+                                                                : static_cast<juce::AudioFormat&>(wavFormat);
+        bool written = false;
+        if (auto writer = audioFormat.createWriterFor(out, options))
+            written = writer->writeFromAudioReader(*reader, 0, -1); // streams through in blocks; the writer closes the file
+        if (!written)
+        {
+            error = "Library save failed: cannot encode " + target.getFileName();
+            part.deleteFile();
+            return {};
+        }
+    }
+
+    // Sidecar first, so the audio file never appears without its metadata
+    const juce::File sidecar = sidecarFor(target);
+    const juce::File sidecarPart = partFileFor(sidecar);
+    if (!sidecarPart.replaceWithText(toJson(metadata, sampleRate, numChannels)) || !commit(sidecarPart, sidecar))
+        sidecarPart.deleteFile(); // still save the audio; the list falls back to the file name
+    if (!commit(part, target))
+    {
+        error = "Library save failed: cannot rename into " + target.getFullPathName();
+        sidecar.deleteFile();
+        return {};
+    }
+    return target;
+}
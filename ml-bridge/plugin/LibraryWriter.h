@@ -0,0 +1,67 @@
+#pragma once
+
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <juce_core/juce_core.h>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+// Saves fetched generations into the library folder on its own thread. Each entry is an audio file plus a
+// one-line JSON sidecar (<name>.json) with the generation settings. Both are written to hidden ".part" files and
+// renamed into place when complete (sidecar first), so a half-written file never shows up in the library list.
+class LibraryWriter
+{
+public:
+    enum class Format
+    {
+        Original,   // bytes exactly as AceForge served them (WAV); other inputs are saved as WavFloat32
+        WavFloat32, // decoded samples as 32-bit float WAV (no requantization)
+        Flac        // 24-bit FLAC, roughly half the size of the WAV
+    };
+
+    struct Metadata
+    {
+        juce::String prompt;
+        juce::String jobId;
+        int durationSec = 0;     // requested
+        int inferenceSteps = 0;
+        float guidanceScale = 0.0f; // 0: not part of the request (left out of the sidecar)
+        bool randomSeed = true;
+        int64_t seed = 0;        // only meaningful when randomSeed is false
+        double resultDurationSec = 0.0;
+        double bpm = 0.0;        // 0 when the server did not report one
+        juce::String keyScale;
+        juce::String backend;    // what generated it: "aceforge" or "local" (the local ML host bridge)
+        juce::String cacheKey;   // aceforge::generationCacheKey() of a fixed-seed AceForge request; empty otherwise
+    };
+
+    // Called on the writer thread: the saved file, or an empty file and an error message.
+    using Callback = std::function<void(const juce::File& file, const juce::String& error)>;
+
+    explicit LibraryWriter(juce::File directory);
+    ~LibraryWriter();
+
+    void setFormat(Format format) { format_.store(format); }
+    Format getFormat() const { return format_.load(); }
+
+    // Queues a complete audio file to be saved as the next library entry in the current format.
+    void enqueue(std::shared_ptr<const std::vector<uint8_t>> bytes, Metadata metadata, Callback onSaved);
+    // Drops queued saves and waits for the running one. Call before tearing down anything the callbacks touch.
+    void stop();
+
+    // Sidecar path for a library file (same name, .json).
+    static juce::File sidecarFor(const juce::File& audioFile) { return audioFile.withFileExtension("json"); }
+
+private:
+    juce::File save(const std::vector<uint8_t>& bytes, const Metadata& metadata, Format format, juce::String& error);
+    juce::File uniqueTarget(const juce::String& extension) const;
+
+    juce::File directory_;
+    std::atomic<Format> format_{ Format::Original };
+    juce::AudioFormatManager formatManager_; // writer thread only
+    juce::ThreadPool pool_;
+
+    JUCE_DECLARE_NON_COPYABLE(LibraryWriter)
+};
@@ -0,0 +1,123 @@
+#include "PeakCache.h"
+#include "PluginLog.h"
+
+namespace
+{
+constexpr int kChunkFrames = 1 << 16; // frames read per step while summarising
+} // namespace
+
+PeakCache::PeakCache()
+    : pool_(juce::ThreadPoolOptions{}.withThreadName("AceForge peaks").withNumberOfThreads(1))
+{
+    formatManager_.registerBasicFormats();
+}
+
+PeakCache::~PeakCache()
+{
+    stop();
+}
+
+void PeakCache::stop()
+{
+    pool_.removeAllJobs(true, 10000);
+}
+
+PeakCache::Pyramid PeakCache::get(const juce::File& audioFile)
+{
+    const juce::String key = audioFile.getFullPathName();
+    {
+        juce::ScopedLock l(lock_);
+        const auto it = entries_.find(key);
+        if (it != entries_.end())
+            return it->second;
+        if (!pending_.insert(key).second)
+            return nullptr;
+    }
+    queue(audioFile, false);
+    return nullptr;
+}
+
+void PeakCache::build(const juce::File& audioFile)
+{
+    {
+        juce::ScopedLock l(lock_);
+        pending_.insert(audioFile.getFullPathName());
+    }
+    queue(audioFile, true);
+}
+
+void PeakCache::queue(const juce::File& audioFile, bool rebuild)
+{
+    pool_.addJob([this, audioFile, rebuild]
+    {
+        Pyramid pyramid = load(audioFile, rebuild);
+        const juce::String key = audioFile.getFullPathName();
+        {
+            juce::ScopedLock l(lock_);
+            pending_.erase(key);
+            if (entries_.find(key) == entries_.end())
+                loadOrder_.push_back(key);
+            entries_[key] = std::move(pyramid);
+            while (static_cast<int>(entries_.size()) > kMaxEntries && !loadOrder_.empty())
+            {
+                entries_.erase(loadOrder_.front());
+                loadOrder_.pop_front();
+            }
+        }
+        ++version_;
+    });
+}
+
+PeakCache::Pyramid PeakCache::load(const juce::File& audioFile, bool rebuild)
+{
+    const juce::File peaksFile = peaksFileFor(audioFile);
+    if (!rebuild && peaksFile.existsAsFile()
+        && peaksFile.getLastModificationTime() >= audioFile.getLastModificationTime())
+    {
+        juce::MemoryBlock data;
+        auto pyramid = std::make_shared<aceforge::PeakPyramid>();
+        if (peaksFile.loadFileAsData(data)
+            && aceforge::PeakPyramid::parse(static_cast<const uint8_t*>(data.getData()), data.getSize(), *pyramid))
+            return pyramid;
+        PluginLog::warning("Peak file " + peaksFile.getFullPathName() + " is damaged; summarising the audio again");
+    }
+    return summarise(audioFile);
+}
+
+PeakCache::Pyramid PeakCache::summarise(const juce::File& audioFile)
+{
+    std::unique_ptr<juce::AudioFormatReader> reader;
+    if (auto* format = formatManager_.findFormatForFileExtension(audioFile.getFileExtension()))
+    {
+        std::unique_ptr<juce::MemoryMappedAudioFormatReader> mapped(format->createMemoryMappedReader(audioFile));
+        if (mapped != nullptr && mapped->mapEntireFile())
+            reader = std::move(mapped);
+    }
+    if (reader == nullptr)
+        reader.reset(formatManager_.createReaderFor(audioFile));
+    if (reader == nullptr || reader->lengthInSamples <= 0 || reader->numChannels == 0)
+        return std::make_shared<const aceforge::PeakPyramid>();
+
+    const int numChannels = static_cast<int>(reader->numChannels);
+    juce::AudioBuffer<float> chunk(numChannels, kChunkFrames);
+    aceforge::PeakPyramid::Builder builder;
+    for (juce::int64 pos = 0; pos < reader->lengthInSamples; pos += kChunkFrames)
+    {
+        const int n = static_cast<int>(juce::jmin<juce::int64>(kChunkFrames, reader->lengthInSamples - pos));
+        if (!reader->read(&chunk, 0, n, pos, true, true))
+            return std::make_shared<const aceforge::PeakPyramid>();
+        builder.add(chunk.getArrayOfReadPointers(), numChannels, n);
+    }
+    auto pyramid = std::make_shared<const aceforge::PeakPyramid>(builder.finish(reader->sampleRate));
+
+    // Written beside the audio under a temporary name and renamed, so a reader never sees half a file
+    const std::vector<uint8_t> bytes = pyramid->serialize();
+    const juce::File peaksFile = peaksFileFor(audioFile);
+    const juce::File part = peaksFile.getSiblingFile("." + peaksFile.getFileName() + ".part");
+    if (!part.replaceWithData(bytes.data(), bytes.size()) || !part.moveFileTo(peaksFile))
+    {
+        part.deleteFile();
+        PluginLog::warning("Could not write " + peaksFile.getFullPathName());
+    }
+    return pyramid;
+}
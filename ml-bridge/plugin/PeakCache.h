@@ -0,0 +1,57 @@
+#pragma once
+
+#include "AceForgeAudio/PeakPyramid.hpp"
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <juce_core/juce_core.h>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <set>
+
+// Waveform thumbnails for the library list: one aceforge::PeakPyramid per library file, saved next to it as
+// <name>.peaks and kept in memory once loaded. get() never touches the disk; a file it has not seen yet is queued
+// for the worker, which reads the .peaks file, or summarises the audio and writes one when it is missing or older
+// than the audio. build() summarises a file that was just added to the library. Views poll getVersion() and
+// repaint when pyramids arrive. Thread-safe; the worker owns its AudioFormatManager.
+class PeakCache
+{
+public:
+    using Pyramid = std::shared_ptr<const aceforge::PeakPyramid>;
+
+    // Pyramids held in memory (about 22 kB for a 30 s clip); the one loaded first is dropped first
+    static constexpr int kMaxEntries = 1024;
+
+    PeakCache();
+    ~PeakCache();
+
+    // Drops queued work and waits for the running job.
+    void stop();
+
+    // The pyramid of audioFile, or null while it is being loaded (queued on the first call). A file that cannot be
+    // read gets an empty pyramid, so it is not retried on every paint.
+    Pyramid get(const juce::File& audioFile);
+    // Summarises audioFile again and replaces its .peaks file, e.g. right after it was saved.
+    void build(const juce::File& audioFile);
+    // Bumped whenever a pyramid arrives.
+    uint32_t getVersion() const { return version_.load(); }
+
+    static juce::File peaksFileFor(const juce::File& audioFile) { return audioFile.withFileExtension("peaks"); }
+
+private:
+    void queue(const juce::File& audioFile, bool rebuild);
+    // Worker thread: the .peaks file when it is current (and rebuild is false), else a fresh summary
+    Pyramid load(const juce::File& audioFile, bool rebuild);
+    Pyramid summarise(const juce::File& audioFile);
+
+    juce::CriticalSection lock_;
+    std::map<juce::String, Pyramid> entries_; // by full path
+    std::deque<juce::String> loadOrder_;      // for eviction
+    std::set<juce::String> pending_;          // queued or being loaded
+    std::atomic<uint32_t> version_{ 0 };
+    juce::AudioFormatManager formatManager_;  // worker thread only
+    juce::ThreadPool pool_;
+
+    JUCE_DECLARE_NON_COPYABLE(PeakCache)
+};
@@ -5,23 +5,44 @@
 // --- LibraryListModel ---
 int LibraryListModel::getNumRows()
 {
-    return static_cast<int>(processor.getLibraryEntries().size());
+    return processor.getNumLibraryEntries();
 }
 
 void LibraryListModel::paintListBoxItem(int rowNumber, juce::Graphics& g, int width, int height, bool rowIsSelected)
 {
-    auto entries = processor.getLibraryEntries();
-    if (rowNumber < 0 || rowNumber >= static_cast<int>(entries.size()))
+    AceForgeBridgeAudioProcessor::LibraryEntry e;
+    if (!processor.getLibraryEntry(rowNumber, e))
         return;
-    const auto& e = entries[static_cast<size_t>(rowNumber)];
     if (rowIsSelected)
         g.fillAll(juce::Colour(0xff2a2a4e));
+    // Name | waveform | time. The waveform comes from the file's peak pyramid, which is in memory or on its way:
+    // painting never reads audio (or any file), however many rows scroll by.
+    const int timeWidth = 104;
+    const int waveX = width * 2 / 5;
+    const int waveWidth = width - timeWidth - waveX - 6;
     g.setColour(juce::Colours::white);
     g.setFont(14.0f);
-    g.drawText(e.file.getFileName(), 6, 0, width - 12, height, juce::Justification::centredLeft);
+    g.drawText(e.file.getFileName(), 6, 0, waveX - 12, height, juce::Justification::centredLeft);
+    const auto peaks = waveWidth > 8 ? processor.getLibraryPeaks(e.file) : nullptr;
+    if (peaks != nullptr && !peaks->empty())
+    {
+        peakMins_.resize(static_cast<size_t>(waveWidth));
+        peakMaxs_.resize(static_cast<size_t>(waveWidth));
+        peaks->render(waveWidth, peakMins_.data(), peakMaxs_.data());
+        const float mid = static_cast<float>(height) * 0.5f;
+        const float scale = static_cast<float>(height) * 0.5f - 3.0f;
+        g.setColour(rowIsSelected ? juce::Colour(0xff9fa8ff) : juce::Colour(0xff6c74c8));
+        for (int x = 0; x < waveWidth; ++x)
+        {
+            const float top = mid - peakMaxs_[static_cast<size_t>(x)] * scale;
+            const float bottom = mid - peakMins_[static_cast<size_t>(x)] * scale;
+            g.drawVerticalLine(waveX + x, top, juce::jmax(bottom, top + 1.0f));
+        }
+    }
     g.setColour(juce::Colours::lightgrey);
     g.setFont(11.0f);
-    g.drawText(e.time.formatted("%Y-%m-%d %H:%M"), 6, 0, width - 12, height, juce::Justification::centredRight);
+    g.drawText(e.time.formatted("%Y-%m-%d %H:%M"), width - timeWidth, 0, timeWidth - 6, height,
+               juce::Justification::centredRight);
 }
 
 void LibraryListModel::listBoxItemDoubleClicked(int row, const juce::MouseEvent&)
@@ -51,13 +72,13 @@ void LibraryListBox::mouseDrag(const juce::MouseEvent& e)
         return;
     }
     int row = getRowContainingPosition(e.x, e.y);
-    auto entries = processorRef.getLibraryEntries();
-    if (row < 0 || row >= static_cast<int>(entries.size()))
+    AceForgeBridgeAudioProcessor::LibraryEntry entry;
+    if (!processorRef.getLibraryEntry(row, entry))
     {
         ListBox::mouseDrag(e);
         return;
     }
-    juce::String path = entries[static_cast<size_t>(row)].file.getFullPathName();
+    juce::String path = entry.file.getFullPathName();
     if (path.isEmpty())
     {
         ListBox::mouseDrag(e);
@@ -84,19 +105,46 @@ AceForgeBridgeAudioProcessorEditor::AceForgeBridgeAudioProcessorEditor(
     AceForgeBridgeAudioProcessor& p)
     : AudioProcessorEditor(&p), processorRef(p), libraryListModel(p), libraryList(p, libraryListModel)
 {
-    setSize(460, 500);
+    setSize(500, 500);
 
     connectionLabel.setText("Checking...", juce::dontSendNotification);
     connectionLabel.setColour(juce::Label::textColourId, juce::Colours::white);
     connectionLabel.setJustificationType(juce::Justification::left);
     addAndMakeVisible(connectionLabel);
 
+    // processBlock health: load over the last second, overruns and underruns since the plugin was loaded
+    audioStatsLabel.setColour(juce::Label::textColourId, juce::Colours::grey);
+    audioStatsLabel.setFont(juce::Font(juce::FontOptions().withPointHeight(10.0f)));
+    audioStatsLabel.setJustificationType(juce::Justification::right);
+    audioStatsLabel.setMinimumHorizontalScale(0.8f);
+    addAndMakeVisible(audioStatsLabel);
+
+    // Controls start from the settings the project saved (see PluginState)
+    const PluginState saved = processorRef.getSavedState();
+
     promptEditor.setMultiLine(false);
     promptEditor.setReturnKeyStartsNewLine(false);
-    promptEditor.setText("upbeat electronic beat, 10s");
+    promptEditor.setText(saved.prompt.isNotEmpty() ? saved.prompt : juce::String("upbeat electronic beat, 10s"));
     promptEditor.setTextToShowWhenEmpty("Describe the music (e.g. calm piano, 10s)", juce::Colours::grey);
     addAndMakeVisible(promptEditor);
 
+    // Seed: empty for a random one per take; a fixed seed reproduces (and re-plays from the cache) the same audio
+    seedEditor.setMultiLine(false);
+    seedEditor.setInputRestrictions(10, "0123456789");
+    seedEditor.setTextToShowWhenEmpty("Random seed", juce::Colours::grey);
+    seedEditor.setTooltip("Fixed seed (takes use seed, seed+1, ...); repeats load from the cache");
+    if (saved.seed >= 0)
+        seedEditor.setText(juce::String(saved.seed));
+    addAndMakeVisible(seedEditor);
+
+    syncButton.setButtonText("Sync");
+    syncButton.setTooltip("Generate at the host tempo, time-stretch clips to it (pitch unchanged) and start them on "
+                          "the next bar while the transport runs");
+    syncButton.setColour(juce::ToggleButton::textColourId, juce::Colours::white);
+    syncButton.setToggleState(processorRef.isSyncingToHost(), juce::dontSendNotification);
+    syncButton.onClick = [this] { processorRef.setSyncToHost(syncButton.getToggleState()); };
+    addAndMakeVisible(syncButton);
+
     durationLabel.setText("Duration (s):", juce::dontSendNotification);
     durationLabel.setColour(juce::Label::textColourId, juce::Colours::white);
     addAndMakeVisible(durationLabel);
@@ -105,7 +153,8 @@ AceForgeBridgeAudioProcessorEditor::AceForgeBridgeAudioProcessorEditor(
     durationCombo.addItem("15", 15);
     durationCombo.addItem("20", 20);
     durationCombo.addItem("30", 30);
-    durationCombo.setSelectedId(10, juce::dontSendNotification);
+    durationCombo.setSelectedId(durationCombo.indexOfItemId(saved.durationSec) >= 0 ? saved.durationSec : 10,
+                                juce::dontSendNotification);
     addAndMakeVisible(durationCombo);
 
     qualityLabel.setText("Quality:", juce::dontSendNotification);
@@ -114,29 +163,79 @@ AceForgeBridgeAudioProcessorEditor::AceForgeBridgeAudioProcessorEditor(
 
     qualityCombo.addItem("Fast (15 steps)", 15);
     qualityCombo.addItem("High (55 steps)", 55);
-    qualityCombo.setSelectedId(15, juce::dontSendNotification);
+    qualityCombo.setSelectedId(qualityCombo.indexOfItemId(saved.inferenceSteps) >= 0 ? saved.inferenceSteps : 15,
+                               juce::dontSendNotification);
     addAndMakeVisible(qualityCombo);
 
+    // Takes: the same prompt several times with different seeds, generated side by side
+    takesCombo.addItem("x1", 1);
+    takesCombo.addItem("x2", 2);
+    takesCombo.addItem("x4", 4);
+    takesCombo.setSelectedId(1, juce::dontSendNotification);
+    takesCombo.setTooltip("Number of takes (random seeds) per click");
+    addAndMakeVisible(takesCombo);
+
     generateButton.setButtonText("Generate");
     generateButton.onClick = [this] { startGeneration(); };
     addAndMakeVisible(generateButton);
 
+    // Stop: cancels every queued and running job, on the server too
+    stopButton.setButtonText("Stop");
+    stopButton.setTooltip("Cancel all generations in progress");
+    stopButton.onClick = [this] { processorRef.cancelGeneration(); };
+    stopButton.setEnabled(false);
+    addAndMakeVisible(stopButton);
+
     statusLabel.setText("Idle - enter a prompt and click Generate.", juce::dontSendNotification);
     statusLabel.setColour(juce::Label::textColourId, juce::Colours::lightgrey);
     statusLabel.setJustificationType(juce::Justification::topLeft);
     statusLabel.setMinimumHorizontalScale(1.0f);
     addAndMakeVisible(statusLabel);
 
+    progressBar.setPercentageDisplay(false);
+    addAndMakeVisible(progressBar);
+
+    // Where the shown job's time went, stage by stage
+    timingLabel.setColour(juce::Label::textColourId, juce::Colours::grey);
+    timingLabel.setFont(juce::Font(juce::FontOptions().withPointHeight(10.0f)));
+    timingLabel.setMinimumHorizontalScale(0.8f);
+    addAndMakeVisible(timingLabel);
+
+    traceButton.setButtonText("Trace");
+    traceButton.setTooltip("Save every job's stage timings as trace-event JSON (chrome://tracing, Perfetto)");
+    traceButton.onClick = [this] { exportTrace(); };
+    addAndMakeVisible(traceButton);
+
     libraryLabel.setText("Library", juce::dontSendNotification);
     libraryLabel.setColour(juce::Label::textColourId, juce::Colours::white);
     addAndMakeVisible(libraryLabel);
 
     refreshLibraryButton.setButtonText("Refresh");
-    refreshLibraryButton.onClick = [this] { refreshLibraryList(); };
+    refreshLibraryButton.onClick = [this]
+    {
+        processorRef.refreshLibrary(true);
+        refreshLibraryList();
+    };
     addAndMakeVisible(refreshLibraryButton);
 
+    // Ids are LibraryWriter::Format + 1
+    libraryFormatCombo.addItem("WAV (as served)", 1);
+    libraryFormatCombo.addItem("WAV 32-bit float", 2);
+    libraryFormatCombo.addItem("FLAC", 3);
+    libraryFormatCombo.setSelectedId(static_cast<int>(processorRef.getLibraryFormat()) + 1, juce::dontSendNotification);
+    libraryFormatCombo.setTooltip("Format for new library saves");
+    libraryFormatCombo.onChange = [this]
+    {
+        processorRef.setLibraryFormat(static_cast<LibraryWriter::Format>(libraryFormatCombo.getSelectedId() - 1));
+    };
+    addAndMakeVisible(libraryFormatCombo);
+
     addAndMakeVisible(libraryList);
 
+    auditionButton.setButtonText("Play");
+    auditionButton.onClick = [this] { auditionSelected(); };
+    addAndMakeVisible(auditionButton);
+
     insertIntoDawButton.setButtonText("Insert into DAW");
     insertIntoDawButton.onClick = [this] { insertSelectedIntoDaw(); };
     addAndMakeVisible(insertIntoDawButton);
@@ -152,10 +251,10 @@ AceForgeBridgeAudioProcessorEditor::AceForgeBridgeAudioProcessorEditor(
     addAndMakeVisible(libraryHintLabel);
 
     libraryListModel.setOnRowDoubleClicked([this](int row) {
-        auto entries = processorRef.getLibraryEntries();
-        if (row < 0 || row >= static_cast<int>(entries.size()))
+        AceForgeBridgeAudioProcessor::LibraryEntry entry;
+        if (!processorRef.getLibraryEntry(row, entry))
             return;
-        juce::SystemClipboard::copyTextToClipboard(entries[static_cast<size_t>(row)].file.getFullPathName());
+        juce::SystemClipboard::copyTextToClipboard(entry.file.getFullPathName());
         showLibraryFeedback();
     });
 
@@ -179,14 +278,31 @@ void AceForgeBridgeAudioProcessorEditor::timerCallback()
     {
         updateStatusFromProcessor();
     }
-    libraryList.updateContent();
+    // Outside changes to the library folder: one modification-time check a second. The list only reloads when
+    // the index actually changed.
+    if (++libraryCheckTicks_ >= 4)
+    {
+        libraryCheckTicks_ = 0;
+        processorRef.refreshLibrary();
+    }
+    const uint32_t version = processorRef.getLibraryVersion();
+    if (version != libraryVersion_)
+    {
+        libraryVersion_ = version;
+        refreshLibraryList();
+    }
+    // Thumbnails that finished loading since the last tick
+    const uint32_t peaksVersion = processorRef.getLibraryPeaksVersion();
+    if (peaksVersion != peaksVersion_)
+    {
+        peaksVersion_ = peaksVersion;
+        libraryList.repaint();
+    }
 }
 
 void AceForgeBridgeAudioProcessorEditor::updateStatusFromProcessor()
 {
     const auto state = processorRef.getState();
-    if (state == AceForgeBridgeAudioProcessor::State::Succeeded)
-        refreshLibraryList();
     if (processorRef.isConnected())
         connectionLabel.setText("AceForge: connected", juce::dontSendNotification);
     else if (state == AceForgeBridgeAudioProcessor::State::Failed)
@@ -203,14 +319,45 @@ void AceForgeBridgeAudioProcessorEditor::updateStatusFromProcessor()
     const bool busy = (state == AceForgeBridgeAudioProcessor::State::Submitting ||
                       state == AceForgeBridgeAudioProcessor::State::Queued ||
                       state == AceForgeBridgeAudioProcessor::State::Running);
-    generateButton.setEnabled(!busy);
+    // Clicking while busy queues another job behind the running ones
+    generateButton.setButtonText(busy ? "Queue" : "Generate");
+    stopButton.setEnabled(busy);
+    progressValue_ = busy ? static_cast<double>(processorRef.getProgress())
+                          : (state == AceForgeBridgeAudioProcessor::State::Succeeded ? 1.0 : 0.0);
+    timingLabel.setText(processorRef.getTimingSummary(), juce::dontSendNotification);
+    updateAudioStats();
+}
+
+void AceForgeBridgeAudioProcessorEditor::updateAudioStats()
+{
+    const auto stats = processorRef.getRealtimeStats();
+    audioStatsLabel.setText(processorRef.getRealtimeSummary(), juce::dontSendNotification);
+    audioStatsLabel.setColour(juce::Label::textColourId, stats.overruns > 0 || stats.underruns > 0 ? juce::Colours::salmon
+                                                                                                  : juce::Colours::grey);
+    // Hover for the whole load histogram (share of each block's deadline) and the handoff counters
+    juce::String tip = juce::String(static_cast<juce::int64>(stats.blocks)) + " blocks, "
+                       + juce::String(static_cast<juce::int64>(stats.handoffs)) + " clip handoffs ("
+                       + juce::String(static_cast<juce::int64>(stats.rerenders)) + " re-renders)\nBlock load:";
+    int lower = 0;
+    for (int i = 0; i < aceforge::RealtimeStats::kNumBuckets; ++i)
+    {
+        const int upper = aceforge::RealtimeStats::bucketLimitPermille(i);
+        const juce::String from = juce::String(lower / 10.0, 1) + "%";
+        const juce::String range = upper < 0 ? "over " + from : from + " - " + juce::String(upper / 10.0, 1) + "%";
+        tip << "\n  " << range << ": " << juce::String(static_cast<juce::int64>(stats.histogram[i]));
+        lower = upper;
+    }
+    audioStatsLabel.setTooltip(tip);
 }
 
 void AceForgeBridgeAudioProcessorEditor::startGeneration()
 {
     const int durationSec = durationCombo.getSelectedId();
     const int steps = qualityCombo.getSelectedId();
-    processorRef.startGeneration(promptEditor.getText(), durationSec > 0 ? durationSec : 10, steps > 0 ? steps : 15);
+    const int takes = takesCombo.getSelectedId();
+    const juce::String seedText = seedEditor.getText().trim();
+    processorRef.startGeneration(promptEditor.getText(), durationSec > 0 ? durationSec : 10, steps > 0 ? steps : 15,
+                                 takes > 0 ? takes : 1, seedText.isEmpty() ? -1 : seedText.getLargeIntValue());
 }
 
 void AceForgeBridgeAudioProcessorEditor::refreshLibraryList()
@@ -219,17 +366,36 @@ void AceForgeBridgeAudioProcessorEditor::refreshLibraryList()
     libraryList.repaint();
 }
 
+void AceForgeBridgeAudioProcessorEditor::auditionSelected()
+{
+    AceForgeBridgeAudioProcessor::LibraryEntry entry;
+    if (!processorRef.getLibraryEntry(libraryList.getSelectedRow(), entry))
+    {
+        libraryFeedbackMessage_ = "Select a library entry first.";
+        libraryFeedbackCountdown_ = 8;
+        return;
+    }
+    const juce::File& file = entry.file;
+    if (!file.existsAsFile())
+    {
+        libraryFeedbackMessage_ = "File not found.";
+        libraryFeedbackCountdown_ = 8;
+        return;
+    }
+    // Streamed from disk through the plugin output, so any length plays without loading it into memory
+    processorRef.auditionLibraryEntry(file);
+}
+
 void AceForgeBridgeAudioProcessorEditor::insertSelectedIntoDaw()
 {
-    const int row = libraryList.getSelectedRow();
-    auto entries = processorRef.getLibraryEntries();
-    if (row < 0 || row >= static_cast<int>(entries.size()))
+    AceForgeBridgeAudioProcessor::LibraryEntry entry;
+    if (!processorRef.getLibraryEntry(libraryList.getSelectedRow(), entry))
     {
         libraryFeedbackMessage_ = "Select a library entry first.";
         libraryFeedbackCountdown_ = 8;
         return;
     }
-    const juce::File& file = entries[static_cast<size_t>(row)].file;
+    const juce::File& file = entry.file;
     if (!file.existsAsFile())
     {
         libraryFeedbackMessage_ = "File not found.";
@@ -259,15 +425,14 @@ void AceForgeBridgeAudioProcessorEditor::insertSelectedIntoDaw()
 
 void AceForgeBridgeAudioProcessorEditor::revealSelectedInFinder()
 {
-    const int row = libraryList.getSelectedRow();
-    auto entries = processorRef.getLibraryEntries();
-    if (row < 0 || row >= static_cast<int>(entries.size()))
+    AceForgeBridgeAudioProcessor::LibraryEntry entry;
+    if (!processorRef.getLibraryEntry(libraryList.getSelectedRow(), entry))
     {
         libraryFeedbackMessage_ = "Select a library entry first.";
         libraryFeedbackCountdown_ = 8;
         return;
     }
-    const juce::File& f = entries[static_cast<size_t>(row)].file;
+    const juce::File& f = entry.file;
     if (f.existsAsFile())
         f.revealToUser();
     else
@@ -277,6 +442,18 @@ void AceForgeBridgeAudioProcessorEditor::revealSelectedInFinder()
     }
 }
 
+void AceForgeBridgeAudioProcessorEditor::exportTrace()
+{
+    // Next to the log, so a bug report can attach both
+    const juce::File file = PluginLog::getLogDirectory().getChildFile(
+        "AceForgeBridge-trace-" + juce::Time::getCurrentTime().formatted("%Y%m%d-%H%M%S") + ".json");
+    if (processorRef.exportPipelineTrace(file))
+        libraryFeedbackMessage_ = "Trace saved to " + file.getFullPathName() + " - open it in chrome://tracing or Perfetto.";
+    else
+        libraryFeedbackMessage_ = "Could not write " + file.getFullPathName();
+    libraryFeedbackCountdown_ = 14;
+}
+
 void AceForgeBridgeAudioProcessorEditor::showLibraryFeedback()
 {
     libraryFeedbackMessage_ = "Path copied. Click Insert into DAW to open in Logic, or Reveal in Finder and drag.";
@@ -298,12 +475,15 @@ void AceForgeBridgeAudioProcessorEditor::resized()
     auto r = getLocalBounds().reduced(pad);
     r.removeFromTop(26);
 
-    connectionLabel.setBounds(r.getX(), r.getY(), r.getWidth(), 22);
+    connectionLabel.setBounds(r.getX(), r.getY(), r.getWidth() - 244, 22);
+    audioStatsLabel.setBounds(r.getRight() - 240, r.getY(), 240, 22);
     r.removeFromTop(22);
     r.removeFromTop(6);
 
     auto row = r.removeFromTop(24);
-    promptEditor.setBounds(row.getX(), row.getY(), row.getWidth(), 24);
+    promptEditor.setBounds(row.getX(), row.getY(), row.getWidth() - 162, 24);
+    syncButton.setBounds(row.getRight() - 158, row.getY(), 62, 24);
+    seedEditor.setBounds(row.getRight() - 92, row.getY(), 92, 24);
     r.removeFromTop(6);
 
     row = r.removeFromTop(24);
@@ -311,15 +491,23 @@ void AceForgeBridgeAudioProcessorEditor::resized()
     durationCombo.setBounds(row.getX() + 82, row.getY(), 56, 22);
     qualityLabel.setBounds(row.getX() + 146, row.getY(), 52, 22);
     qualityCombo.setBounds(row.getX() + 200, row.getY(), 120, 22);
-    generateButton.setBounds(row.getX() + 324, row.getY(), 100, 22);
+    takesCombo.setBounds(row.getX() + 324, row.getY(), 56, 22);
+    generateButton.setBounds(row.getX() + 384, row.getY(), 92, 22);
     r.removeFromTop(8);
 
-    statusLabel.setBounds(r.getX(), r.getY(), r.getWidth(), 44);
-    r.removeFromTop(44);
+    statusLabel.setBounds(r.getX(), r.getY(), r.getWidth() - 60, 32);
+    stopButton.setBounds(r.getRight() - 56, r.getY() + 4, 56, 22);
+    r.removeFromTop(32);
+    progressBar.setBounds(r.getX(), r.getY(), r.getWidth(), 8);
+    r.removeFromTop(10);
+    timingLabel.setBounds(r.getX(), r.getY(), r.getWidth() - 60, 18);
+    traceButton.setBounds(r.getRight() - 56, r.getY(), 56, 18);
+    r.removeFromTop(22);
 
     auto libHeader = r.removeFromTop(22);
     libraryLabel.setBounds(libHeader.getX(), libHeader.getY(), 60, 22);
     refreshLibraryButton.setBounds(libHeader.getX() + 64, libHeader.getY(), 60, 22);
+    libraryFormatCombo.setBounds(libHeader.getRight() - 140, libHeader.getY(), 140, 22);
     r.removeFromTop(4);
 
     libraryList.setBounds(r.getX(), r.getY(), r.getWidth(), 120);
@@ -327,8 +515,9 @@ void AceForgeBridgeAudioProcessorEditor::resized()
     r.removeFromTop(4);
 
     auto btnRow = r.removeFromTop(24);
-    insertIntoDawButton.setBounds(btnRow.getX(), btnRow.getY(), 120, 22);
-    revealInFinderButton.setBounds(btnRow.getX() + 124, btnRow.getY(), 110, 22);
+    auditionButton.setBounds(btnRow.getX(), btnRow.getY(), 56, 22);
+    insertIntoDawButton.setBounds(btnRow.getX() + 60, btnRow.getY(), 120, 22);
+    revealInFinderButton.setBounds(btnRow.getX() + 184, btnRow.getY(), 110, 22);
     r.removeFromTop(4);
 
     libraryHintLabel.setBounds(r.getX(), r.getY(), r.getWidth(), 32);
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <functional>
+#include <vector>
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_gui_basics/juce_gui_basics.h>
 #include "PluginProcessor.h"
@@ -21,6 +22,7 @@ public:
 private:
     AceForgeBridgeAudioProcessor& processor;
     std::function<void(int)> onRowDoubleClicked_;
+    std::vector<float> peakMins_, peakMaxs_; // one row's waveform columns, reused across paints
 };
 
 // ListBox that starts external file drag when user drags a row (for drag-into-DAW)
@@ -54,29 +56,46 @@ private:
     AceForgeBridgeAudioProcessor& processorRef;
 
     juce::Label connectionLabel;
+    juce::Label audioStatsLabel;
     juce::TextEditor promptEditor;
+    juce::TextEditor seedEditor;
+    juce::ToggleButton syncButton;
     juce::Label durationLabel;
     juce::ComboBox durationCombo;
     juce::Label qualityLabel;
     juce::ComboBox qualityCombo;
+    juce::ComboBox takesCombo;
     juce::TextButton generateButton;
+    juce::TextButton stopButton;
     juce::Label statusLabel;
+    double progressValue_{ 0.0 }; // read by progressBar; -1 shows the indeterminate animation
+    juce::ProgressBar progressBar{ progressValue_ };
+    juce::Label timingLabel;
+    juce::TextButton traceButton;
     juce::Label libraryLabel;
     juce::TextButton refreshLibraryButton;
+    juce::ComboBox libraryFormatCombo;
     LibraryListModel libraryListModel;
     LibraryListBox libraryList;
+    juce::TextButton auditionButton;
     juce::TextButton insertIntoDawButton;
     juce::TextButton revealInFinderButton;
     juce::Label libraryHintLabel;
 
     void updateStatusFromProcessor();
+    void updateAudioStats();
     void startGeneration();
     void refreshLibraryList();
+    void auditionSelected();
     void insertSelectedIntoDaw();
     void revealSelectedInFinder();
+    void exportTrace();
 
     juce::String libraryFeedbackMessage_;
     int libraryFeedbackCountdown_{ 0 };
+    uint32_t libraryVersion_{ 0 }; // index version the list last loaded
+    uint32_t peaksVersion_{ 0 };   // waveform thumbnails the list last drew
+    int libraryCheckTicks_{ 0 };
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AceForgeBridgeAudioProcessorEditor)
 };
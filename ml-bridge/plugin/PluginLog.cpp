@@ -0,0 +1,58 @@
+#include "PluginLog.h"
+#include <atomic>
+#include <cstdio>
+
+namespace
+{
+std::atomic<aceforge::AsyncLog*> currentLog{ nullptr };
+std::atomic<aceforge::LogLevel> currentLevel{ aceforge::LogLevel::Trace };
+} // namespace
+
+PluginLog::PluginLog()
+{
+    const juce::File dir = getLogDirectory();
+    if (!dir.exists())
+        dir.createDirectory();
+    aceforge::AsyncLog::Options options;
+#if JUCE_DEBUG
+    options.echoLevel = aceforge::LogLevel::Trace;
+#endif
+    log_.setLevel(currentLevel.load());
+    if (log_.open(getLogFile().getFullPathName().toStdString(), options))
+        currentLog.store(&log_, std::memory_order_release);
+    else
+        std::fprintf(stderr, "[AceForgeBridge] cannot open %s\n", getLogFile().getFullPathName().toRawUTF8());
+}
+
+PluginLog::~PluginLog()
+{
+    // Only the last processor gets here, after it has stopped every thread that logs
+    currentLog.store(nullptr, std::memory_order_release);
+    log_.close();
+}
+
+void PluginLog::write(aceforge::LogLevel level, const juce::String& message)
+{
+    aceforge::AsyncLog* log = currentLog.load(std::memory_order_acquire);
+    if (log == nullptr || !log->isEnabled(level))
+        return;
+    log->write(level, message.toRawUTF8(), message.getNumBytesAsUTF8());
+}
+
+void PluginLog::setLevel(aceforge::LogLevel level)
+{
+    currentLevel.store(level);
+    if (aceforge::AsyncLog* log = currentLog.load(std::memory_order_acquire))
+        log->setLevel(level);
+}
+
+juce::File PluginLog::getLogDirectory()
+{
+#if JUCE_MAC
+    return juce::File::getSpecialLocation(juce::File::userHomeDirectory).getChildFile("Library").getChildFile("Logs");
+#else
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+        .getChildFile("AceForgeBridge")
+        .getChildFile("Logs");
+#endif
+}
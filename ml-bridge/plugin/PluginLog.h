@@ -0,0 +1,33 @@
+#pragma once
+
+#include "AceForgeAudio/AsyncLog.hpp"
+#include <juce_core/juce_core.h>
+
+// Process-wide AceForgeBridge.log, shared by every plugin instance in the host. Each processor holds a
+// juce::SharedResourcePointer<PluginLog>: the first one opens the file and starts the writer thread, the last one
+// drains and closes it. The static write functions are lock-free (aceforge::AsyncLog ring) and do nothing while
+// no instance holds the log.
+class PluginLog
+{
+public:
+    PluginLog();
+    ~PluginLog();
+
+    static void trace(const juce::String& message) { write(aceforge::LogLevel::Trace, message); }
+    static void info(const juce::String& message) { write(aceforge::LogLevel::Info, message); }
+    static void warning(const juce::String& message) { write(aceforge::LogLevel::Warning, message); }
+    static void error(const juce::String& message) { write(aceforge::LogLevel::Error, message); }
+    static void write(aceforge::LogLevel level, const juce::String& message);
+
+    // Lines below this level are skipped before any formatting (default: everything, so traces stay on).
+    static void setLevel(aceforge::LogLevel level);
+
+    // ~/Library/Logs on macOS, %APPDATA%\AceForgeBridge\Logs on Windows, ~/.config/AceForgeBridge/Logs on Linux.
+    static juce::File getLogDirectory();
+    static juce::File getLogFile() { return getLogDirectory().getChildFile("AceForgeBridge.log"); }
+
+private:
+    aceforge::AsyncLog log_;
+
+    JUCE_DECLARE_NON_COPYABLE(PluginLog)
+};
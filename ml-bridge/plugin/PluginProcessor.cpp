@@ -1,45 +1,27 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include "AceForgeAudio/AudioKernels.hpp"
+#include "AceForgeAudio/TimeStretch.hpp"
+#include "AceForgeAudio/WavStreamDecoder.hpp"
 #include <algorithm>
 #include <cmath>
-#include <fstream>
-#include <iostream>
 #include <vector>
 #include <thread>
 #include <chrono>
 
 namespace
 {
-void writeToLogFile(const juce::String& message)
-{
-    juce::Logger::writeToLog("[AceForgeBridge] " + message);
-#if JUCE_DEBUG
-    std::cerr << "[AceForgeBridge] " << message.toRawUTF8() << std::endl;
-#endif
-    juce::File logDir = juce::File::getSpecialLocation(juce::File::userHomeDirectory).getChildFile("Library").getChildFile("Logs");
-    if (logDir.exists() || logDir.createDirectory())
-    {
-        juce::File logFile = logDir.getChildFile("AceForgeBridge.log");
-        juce::String line = juce::Time::getCurrentTime().formatted("%Y-%m-%d %H:%M:%S") + " " + message + "\n";
-        std::string path = logFile.getFullPathName().toStdString();
-        std::ofstream f(path, std::ios::app);
-        if (f)
-        {
-            f << line.toRawUTF8();
-            f.flush();
-        }
-    }
-}
-
+// Both only queue the line (PluginLog); the writer thread appends it to the file and, for errors, stderr
 void logErrorToFileAndStderr(const juce::String& message)
 {
-    writeToLogFile("ERROR: " + message);
+    PluginLog::error(message);
 }
 
-// Trace steps so after a crash you can open ~/Library/Logs/AceForgeBridge.log and see last step reached
+// Trace steps so after a crash you can open AceForgeBridge.log (see PluginLog::getLogDirectory) and see the last
+// step reached
 void logTrace(const juce::String& message)
 {
-    writeToLogFile("TRACE: " + message);
+    PluginLog::trace(message);
 }
 
 const char* stateToString(AceForgeBridgeAudioProcessor::State s)
@@ -52,9 +34,103 @@ const char* stateToString(AceForgeBridgeAudioProcessor::State s)
     case AceForgeBridgeAudioProcessor::State::Running: return "Generating…";
     case AceForgeBridgeAudioProcessor::State::Succeeded: return "Ready";
     case AceForgeBridgeAudioProcessor::State::Failed: return "Failed";
+    case AceForgeBridgeAudioProcessor::State::Cancelled: return "Cancelled";
     }
     return "";
 }
+
+AceForgeBridgeAudioProcessor::State toProcessorState(GenerationScheduler::State s)
+{
+    switch (s)
+    {
+    case GenerationScheduler::State::Waiting:
+    case GenerationScheduler::State::Submitting: return AceForgeBridgeAudioProcessor::State::Submitting;
+    case GenerationScheduler::State::Queued: return AceForgeBridgeAudioProcessor::State::Queued;
+    case GenerationScheduler::State::Running:
+    case GenerationScheduler::State::Fetching: return AceForgeBridgeAudioProcessor::State::Running;
+    case GenerationScheduler::State::Succeeded: return AceForgeBridgeAudioProcessor::State::Succeeded;
+    case GenerationScheduler::State::Failed: return AceForgeBridgeAudioProcessor::State::Failed;
+    case GenerationScheduler::State::Cancelled: return AceForgeBridgeAudioProcessor::State::Cancelled;
+    }
+    return AceForgeBridgeAudioProcessor::State::Idle;
+}
+
+constexpr const char* kDefaultBaseUrl = "http://127.0.0.1:5056";
+
+// Float WAV of planar frames: the library copy of audio streamed from the local ML host
+std::vector<uint8_t> encodeFloatWav(const float* const* channels, int numChannels, int numFrames, double sampleRate)
+{
+    juce::MemoryBlock block;
+    {
+        std::unique_ptr<juce::OutputStream> out = std::make_unique<juce::MemoryOutputStream>(block, false);
+        auto options = juce::AudioFormatWriterOptions{}
+                           .withSampleRate(sampleRate)
+                           .withNumChannels(numChannels)
+                           .withBitsPerSample(32)
+                           .withSampleFormat(juce::AudioFormatWriterOptions::SampleFormat::floatingPoint);
+        juce::WavAudioFormat wavFormat;
+        auto writer = wavFormat.createWriterFor(out, options);
+        if (writer == nullptr || !writer->writeFromFloatArrays(channels, numChannels, numFrames))
+            return {};
+    } // the writer completes the header when it is destroyed
+    const auto* data = static_cast<const uint8_t*>(block.getData());
+    return std::vector<uint8_t>(data, data + block.getSize());
+}
+
+// Tempo changes smaller than this (relative) keep the clip as it is: hosts report tempos with jitter in the last digits
+constexpr double kTempoTolerance = 0.001;
+
+// Clip length factor that plays sourceBpm at hostBpm (1: as generated). Folded by octaves into [0.71, 1.41], so a
+// clip at half or double the host tempo plays in half or double time instead of being stretched twofold.
+double conformStretch(double sourceBpm, double hostBpm)
+{
+    if (sourceBpm <= 0.0 || hostBpm <= 0.0)
+        return 1.0;
+    double stretch = sourceBpm / hostBpm;
+    while (stretch > juce::MathConstants<double>::sqrt2)
+        stretch *= 0.5;
+    while (stretch < 1.0 / juce::MathConstants<double>::sqrt2)
+        stretch *= 2.0;
+    return std::abs(stretch - 1.0) < aceforge::TimeStretch::kIdentityTolerance ? 1.0 : stretch;
+}
+
+juce::File libraryDirectory()
+{
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+        .getChildFile("AceForgeBridge")
+        .getChildFile("Generations");
+}
+
+juce::File generationCacheDirectory()
+{
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+        .getChildFile("AceForgeBridge")
+        .getChildFile("Cache");
+}
+
+// Generation settings of a library file from the JSON sidecar LibraryWriter saved next to it (defaults when it has
+// none), and its generation cache key: enough for a project that references the file to find it again
+aceforge::GenerateParams paramsFromSidecar(const juce::File& audioFile, double& bpm, juce::String& jobId,
+                                           juce::String& cacheKey)
+{
+    aceforge::GenerateParams params;
+    bpm = 0.0;
+    cacheKey = {};
+    const juce::var json = juce::JSON::parse(audioFile.withFileExtension("json"));
+    if (!json.isObject())
+        return params;
+    params.songDescription = json.getProperty("prompt", "").toString().toStdString();
+    params.durationSeconds = static_cast<int>(json.getProperty("duration", params.durationSeconds));
+    params.inferenceSteps = static_cast<int>(json.getProperty("steps", params.inferenceSteps));
+    params.guidanceScale = static_cast<float>(static_cast<double>(json.getProperty("guidance", params.guidanceScale)));
+    const juce::var seed = json.getProperty("seed", "random");
+    params.randomSeed = seed.isString();
+    params.seed = params.randomSeed ? 0 : static_cast<juce::int64>(seed);
+    bpm = static_cast<double>(json.getProperty("bpm", 0.0));
+    jobId = json.getProperty("jobId", "").toString();
+    cacheKey = json.getProperty("cacheKey", "").toString();
+    return params;
+}
 } // namespace
 
 AceForgeBridgeAudioProcessor::AceForgeBridgeAudioProcessor()
@@ -65,276 +141,1168 @@ AceForgeBridgeAudioProcessor::AceForgeBridgeAudioProcessor()
 #endif
                          .withOutput("Output", juce::AudioChannelSet::stereo(), true)
 #endif
-      )
+      ),
+      libraryIndex_(libraryDirectory()),
+      libraryWriter_(libraryDirectory()),
+      generationCache_(generationCacheDirectory()),
+      scheduler_(session_.get(), kDefaultBaseUrl, [this](const GenerationScheduler::Job& job, GenerationScheduler::Clients& clients) { runJob(job, clients); })
 {
-    baseUrl_ = "http://127.0.0.1:5056";
-    client_ = std::make_unique<aceforge::AceForgeClient>(baseUrl_.toStdString());
-    playbackBuffer_.resize(kPlaybackFifoFrames * 2, 0.0f);
+    baseUrl_ = kDefaultBaseUrl;
+    bridgeSocketPath_ = aceforge::bridge::kDefaultSocketPath;
+    scheduler_.setOnChange([this] { updateGenerationSummary(); });
     {
         juce::ScopedLock l(statusLock_);
         statusText_ = "Idle - open the plugin and click Generate (10s).";
     }
+    diskStreamer_.setOnError([this](const juce::String& message)
+    {
+        juce::ScopedLock l(statusLock_);
+        lastError_ = message;
+        statusText_ = message;
+        logErrorToFileAndStderr(message);
+    });
+    startTimer(250);
 }
 
 AceForgeBridgeAudioProcessor::~AceForgeBridgeAudioProcessor()
 {
+    stopTimer();
     cancelPendingUpdate();
+    scheduler_.stop();    // cancels jobs in flight (also on the server) and joins the generation workers
+    decodeWorker_.stop(); // a running job may still publish a clip or start a re-render
+    libraryWriter_.stop(); // save callbacks update the index and may start disk playback
+    peakCache_.stop();
+    stopRerender();
 }
 
 void AceForgeBridgeAudioProcessor::setBaseUrl(const juce::String& url)
 {
-    baseUrl_ = url.isEmpty() ? "http://127.0.0.1:5056" : url;
-    if (client_)
-        client_->setBaseUrl(baseUrl_.toStdString());
+    baseUrl_ = url.isEmpty() ? kDefaultBaseUrl : url;
+    session_->invalidateHealth(baseUrl_.toStdString()); // a fresh check, in case the user just started the server
+    scheduler_.setBaseUrl(baseUrl_);
+}
+
+void AceForgeBridgeAudioProcessor::setBridgeSocketPath(const juce::String& path)
+{
+    juce::ScopedLock l(statusLock_);
+    bridgeSocketPath_ = path;
+}
+
+juce::String AceForgeBridgeAudioProcessor::getBridgeSocketPath() const
+{
+    juce::ScopedLock l(statusLock_);
+    return bridgeSocketPath_;
 }
 
 void AceForgeBridgeAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
-    juce::ignoreUnused(samplesPerBlock);
     sampleRate_.store(sampleRate);
+    blockSize_.store(juce::jmax(1, samplesPerBlock));
+    core_.prepare(sampleRate);
+    rerenderForHost(sampleRate, syncTempo());
+    diskStreamer_.setHostRate(sampleRate, core_.position());
 }
 
-void AceForgeBridgeAudioProcessor::releaseResources() {}
+void AceForgeBridgeAudioProcessor::setSyncToHost(bool shouldSync)
+{
+    syncToHost_.store(shouldSync);
+    rerenderForHost(sampleRate_.load(), syncTempo());
+}
 
-void AceForgeBridgeAudioProcessor::startGeneration(const juce::String& prompt, int durationSeconds, int inferenceSteps)
+void AceForgeBridgeAudioProcessor::rerenderForHost(double hostRate, double hostBpm)
 {
-    // Only one generation at a time: atomically transition to Submitting only from a non-busy state,
-    // so double-clicks or rapid UI updates don't spawn multiple threads (each would POST /api/generate).
-    State expected = state_.load();
-    while (expected == State::Submitting || expected == State::Queued || expected == State::Running)
-        return;
-    while (!state_.compare_exchange_weak(expected, State::Submitting))
+    std::shared_ptr<const SourceAudio> source;
+    double stretch = 1.0;
+    int64_t startFrame = 0;
     {
-        if (expected == State::Submitting || expected == State::Queued || expected == State::Running)
+        juce::ScopedLock l(sourceLock_);
+        if (lastSource_ == nullptr)
             return;
+        stretch = conformStretch(lastSource_->bpm, hostBpm);
+        // Past the clip limit once stretched: keep the source tempo rather than cut the clip short
+        const double hostFrames = static_cast<double>(lastSource_->channels[0].size()) * hostRate / lastSource_->sampleRate;
+        if (hostFrames * stretch > kMaxPlaybackFrames)
+            stretch = 1.0;
+        if (renderedRate_ == hostRate && std::abs(stretch / renderedStretch_ - 1.0) < kTempoTolerance)
+            return;
+        // Start at the playhead, at the same point in the source (the engine maps it the same way when it swaps
+        // the clip in); a clip not yet handed over, or still waiting for its bar, starts from the top
+        if (publishedRate_ > 0.0 && !core_.waitingForBar())
+            startFrame = std::llround(static_cast<double>(core_.position()) * hostRate * stretch
+                                      / (publishedRate_ * publishedStretch_));
+        source = lastSource_;
+        renderedRate_ = hostRate;
+        renderedStretch_ = stretch;
     }
-    triggerAsyncUpdate();
-    std::thread t(&AceForgeBridgeAudioProcessor::runGenerationThread, this, prompt, durationSeconds, inferenceSteps);
-    t.detach();
+    juce::ScopedLock l(rerenderLock_);
+    stopRerender();
+    logTrace("rerenderForHost: " + juce::String(source->sampleRate) + " Hz at " + juce::String(source->bpm, 1) + " bpm -> "
+             + juce::String(hostRate) + " Hz, stretch " + juce::String(stretch, 4) + " from frame "
+             + juce::String(static_cast<juce::int64>(startFrame)));
+    rerenderThread_ = std::thread([this, source, hostRate, stretch, startFrame]
+    {
+        constexpr int kChunkFrames = 1 << 15;
+        // Resampled once per source and host rate; a tempo change only re-runs the stretch
+        HostRateAudio& audio = hostRateAudio_;
+        if (audio.sourceId != source->id || audio.sampleRate != hostRate)
+        {
+            audio.sourceId = 0; // incomplete until every chunk is in
+            aceforge::Resampler resampler(source->sampleRate, hostRate);
+            const int64_t sourceFrames = static_cast<int64_t>(source->channels[0].size());
+            const int frames = static_cast<int>(std::min<int64_t>(kMaxPlaybackFrames, resampler.outputLength(sourceFrames)));
+            for (int c = 0; c < 2; ++c)
+                audio.channels[c].resize(static_cast<size_t>(std::max(0, frames)));
+            for (int start = 0; start < frames; start += 2 * kChunkFrames)
+            {
+                if (rerenderCancel_.load(std::memory_order_relaxed))
+                    return;
+                const int end = std::min(frames, start + 2 * kChunkFrames);
+                for (int c = 0; c < 2; ++c)
+                    resampler.render(source->channels[c].data(), sourceFrames, audio.channels[c].data() + start, start, end);
+            }
+            audio.sampleRate = hostRate;
+            audio.sourceId = source->id;
+        }
+
+        const int64_t hostFrames = static_cast<int64_t>(audio.channels[0].size());
+        const float* channels[2] = { audio.channels[0].data(), audio.channels[1].data() };
+        aceforge::TimeStretch stretcher;
+        stretcher.prepare(hostRate, stretch);
+        stretcher.setSource(channels, 2, hostFrames);
+        const int outFrames = static_cast<int>(std::min<int64_t>(kMaxPlaybackFrames, stretcher.outputLength(hostFrames)));
+        const int firstFrame = static_cast<int>(juce::jlimit<int64_t>(0, outFrames, startFrame));
+        if (firstFrame >= outFrames)
+            return; // already played to the end
+        auto clip = core_.handoff().createClip(2, outFrames);
+        clip->sampleRate = hostRate;
+        clip->sourceId = source->id;
+        clip->stretch = stretcher.stretch();
+        clip->firstFrame = firstFrame;
+        clip->readyFrames.store(firstFrame, std::memory_order_relaxed);
+
+        // Published after the first chunk; the rest is rendered well ahead of the playhead while it plays
+        for (int start = firstFrame; start < outFrames; start += kChunkFrames)
+        {
+            if (rerenderCancel_.load(std::memory_order_relaxed))
+                break;
+            const int end = std::min(outFrames, start + kChunkFrames);
+            float* out[2] = { clip->audio.channel(0) + start, clip->audio.channel(1) + start };
+            stretcher.render(out, 2, start, end);
+            clip->readyFrames.store(end, std::memory_order_release);
+            if (start != firstFrame)
+                continue;
+            // Publish only while this source is still the newest; a clip started since then must not be replaced
+            juce::ScopedLock sl(sourceLock_);
+            if (currentSourceId_ != source->id || rerenderCancel_.load(std::memory_order_relaxed))
+                return;
+            // The first clip of a source held back for conforming starts like any new clip: on the next bar
+            clip->isRerender = publishedRate_ > 0.0;
+            clip->startOnBar = !clip->isRerender && syncToHost_.load();
+            if (!clip->isRerender)
+            {
+                pipelineTrace_.begin(source->jobId, aceforge::Stage::Handoff);
+                handoffJobId_ = source->jobId;
+                handoffSourceId_ = source->id;
+            }
+            publishedRate_ = hostRate;
+            publishedStretch_ = clip->stretch;
+            core_.handoff().publish(clip);
+        }
+        // Also when cancelled: the render replacing this one takes over long before the playhead gets here
+        clip->complete.store(true, std::memory_order_release);
+    });
 }
 
-void AceForgeBridgeAudioProcessor::runGenerationThread(juce::String prompt, int durationSec, int inferenceSteps)
+void AceForgeBridgeAudioProcessor::stopRerender()
 {
-    if (!client_)
+    juce::ScopedLock l(rerenderLock_);
+    rerenderCancel_.store(true);
+    if (rerenderThread_.joinable())
+        rerenderThread_.join();
+    rerenderCancel_.store(false);
+}
+
+void AceForgeBridgeAudioProcessor::releaseResources()
+{
+    core_.handoff().reclaim();
+}
+
+int AceForgeBridgeAudioProcessor::startGeneration(const juce::String& prompt, int durationSeconds, int inferenceSteps,
+                                                  int variations, juce::int64 seed)
+{
+    GenerationScheduler::Request request;
+    request.prompt = prompt;
+    request.durationSec = durationSeconds <= 0 ? 10 : durationSeconds;
+    request.inferenceSteps = inferenceSteps <= 0 ? 15 : (inferenceSteps > 100 ? 55 : inferenceSteps);
+    request.randomSeed = seed < 0;
     {
-        state_.store(State::Failed);
+        juce::ScopedLock l(stateLock_);
+        savedState_.prompt = prompt;
+        savedState_.durationSec = request.durationSec;
+        savedState_.inferenceSteps = request.inferenceSteps;
+        savedState_.seed = request.randomSeed ? -1 : seed;
+    }
+    // Ask for the host's tempo so the clip needs little or no stretching to conform
+    const double hostBpm = syncTempo();
+    request.bpm = hostBpm > 0.0 ? juce::roundToInt(hostBpm) : 0;
+    // Variations differ only by seed: random ones from the server, or consecutive ones from a fixed seed
+    int firstId = 0;
+    for (int i = 0; i < juce::jmax(1, variations); ++i)
+    {
+        request.seed = request.randomSeed ? 0 : seed + i;
+        const int id = scheduler_.submit(request);
+        if (id == 0)
         {
             juce::ScopedLock l(statusLock_);
-            lastError_ = "No client";
-            logErrorToFileAndStderr(lastError_);
+            statusText_ = "Too many generations waiting - try again when one has started.";
+            break;
         }
-        triggerAsyncUpdate();
-        return;
+        if (firstId == 0)
+            firstId = id;
+    }
+    triggerAsyncUpdate();
+    return firstId;
+}
+
+int AceForgeBridgeAudioProcessor::cancelGeneration(int jobId)
+{
+    const int cancelled = scheduler_.cancel(jobId);
+    if (cancelled > 0)
+        logTrace("cancelGeneration: " + juce::String(cancelled) + " job(s)");
+    return cancelled;
+}
+
+void AceForgeBridgeAudioProcessor::finishCancelledJob(int jobId, GenerationScheduler::Clients& clients,
+                                                      const std::string& serverJobId)
+{
+    // Frees the server's GPU for the next job; servers without the endpoint answer 404 and run it to the end
+    if (!serverJobId.empty())
+    {
+        auto client = clients.acquire();
+        if (!client->cancelJob(serverJobId))
+            logTrace("runJob: cancel " + juce::String(serverJobId) + " on server failed (" + juce::String(client->lastError()) + ")");
     }
+    scheduler_.update(jobId, [](GenerationScheduler::Job& job)
+    {
+        job.state = GenerationScheduler::State::Cancelled;
+        job.statusText = stateToString(State::Cancelled);
+    });
+}
 
-    client_->setBaseUrl(baseUrl_.toStdString());
-    if (!client_->healthCheck())
+void AceForgeBridgeAudioProcessor::failJob(int jobId, const juce::String& error)
+{
+    logErrorToFileAndStderr(error);
+    scheduler_.update(jobId, [&error](GenerationScheduler::Job& job)
     {
-        state_.store(State::Failed);
-        connected_.store(false);
-        {
-            juce::ScopedLock l(statusLock_);
-            lastError_ = "Cannot reach AceForge at " + baseUrl_ + " - is it running?";
-            statusText_ = lastError_;
-            logErrorToFileAndStderr(lastError_);
-        }
-        triggerAsyncUpdate();
+        job.state = GenerationScheduler::State::Failed;
+        job.error = error;
+        job.statusText = error;
+    });
+}
+
+void AceForgeBridgeAudioProcessor::updateGenerationSummary()
+{
+    const std::vector<GenerationScheduler::Job> jobs = scheduler_.getJobs();
+    if (jobs.empty())
         return;
+    const GenerationScheduler::Job* shown = nullptr;
+    int active = 0;
+    for (const auto& job : jobs)
+    {
+        if (job.isFinished())
+            continue;
+        if (shown == nullptr)
+            shown = &job;
+        ++active;
     }
-    connected_.store(true);
+    if (shown == nullptr)
+        shown = &jobs.back();
+    shownJobId_.store(shown->id);
+    state_.store(toProcessorState(shown->state));
+    progress_.store(shown->progress);
+    {
+        juce::ScopedLock l(statusLock_);
+        statusText_ = shown->statusText;
+        if (active > 1)
+            statusText_ += " (+" + juce::String(active - 1) + " more)";
+        if (shown->state == GenerationScheduler::State::Failed)
+            lastError_ = shown->error;
+    }
+    triggerAsyncUpdate();
+}
 
+void AceForgeBridgeAudioProcessor::runJob(const GenerationScheduler::Job& job, GenerationScheduler::Clients& clients)
+{
+    using JobState = GenerationScheduler::State;
+    using aceforge::Stage;
+    const int id = job.id;
+    const aceforge::CancellationToken& cancel = *job.cancel;
     aceforge::GenerateParams params;
-    params.songDescription = prompt.toStdString();
-    params.durationSeconds = durationSec <= 0 ? 10 : durationSec;
-    params.inferenceSteps = inferenceSteps <= 0 ? 15 : (inferenceSteps > 100 ? 55 : inferenceSteps);
+    params.songDescription = job.request.prompt.toStdString();
+    params.durationSeconds = job.request.durationSec;
+    params.inferenceSteps = job.request.inferenceSteps;
+    params.randomSeed = job.request.randomSeed;
+    params.seed = job.request.seed;
+    params.bpm = job.request.bpm;
     params.instrumental = true;
     params.lyrics = "[inst]";
     params.taskType = "text2music";
     params.title = "aceforge_bridge_export";
+    pipelineTrace_.setLabel(id, job.request.prompt.substring(0, 60).toStdString());
+
+    // The local ML host comes first; the cache only holds AceForge's audio, which would not be the host's
+    if (runBridgeJob(job, params, clients))
+        return;
+    // A fixed seed reproduces its audio: answer repeats from disk, even while AceForge is down
+    pipelineTrace_.begin(id, Stage::Cache);
+    const juce::File cached = generationCache_.lookup(params);
+    pipelineTrace_.end(id, Stage::Cache);
+    if (cached.existsAsFile() && playCachedGeneration(id, cached, params))
+        return;
+
+    // Shared with every instance: at most one check per few seconds reaches the server
+    pipelineTrace_.begin(id, Stage::Health);
+    const bool healthy = session_->isHealthy(clients.getBaseUrl());
+    pipelineTrace_.end(id, Stage::Health);
+    if (!healthy)
+    {
+        connected_.store(false);
+        failJob(id, "Cannot reach AceForge at " + juce::String(clients.getBaseUrl()) + " - is it running?");
+        return;
+    }
+    connected_.store(true);
 
-    std::string jobId = client_->startGeneration(params);
+    if (cancel.isCancelled())
+    {
+        finishCancelledJob(id, clients, {});
+        return;
+    }
+    pipelineTrace_.begin(id, Stage::Submit);
+    std::string jobId;
+    juce::String submitError;
+    {
+        auto client = clients.acquire();
+        jobId = client->startGeneration(params);
+        submitError = juce::String(client->lastError());
+    }
+    pipelineTrace_.end(id, Stage::Submit);
     if (jobId.empty())
     {
-        state_.store(State::Failed);
-        juce::ScopedLock l(statusLock_);
-        lastError_ = juce::String(client_->lastError());
-        statusText_ = lastError_;
-        logErrorToFileAndStderr(lastError_);
-        triggerAsyncUpdate();
+        failJob(id, submitError);
+        return;
+    }
+    pipelineTrace_.begin(id, Stage::Queue);
+    if (cancel.isCancelled()) // during the POST: the job only just entered the queue
+    {
+        finishCancelledJob(id, clients, jobId);
         return;
     }
+    scheduler_.update(id, [&jobId](GenerationScheduler::Job& j)
+    {
+        j.serverJobId = juce::String(jobId);
+        j.state = JobState::Queued;
+        j.statusText = stateToString(State::Queued);
+    });
 
-    state_.store(State::Queued);
-    triggerAsyncUpdate();
+    // Polled with every other instance's jobs by the session's one poll thread; the callback runs here, on this worker
+    bool inferenceStarted = false;
+    aceforge::JobStatus st = session_->waitForJob(clients.getBaseUrl(), jobId, [this, id, &cancel, &inferenceStarted](const aceforge::JobStatus& js, const aceforge::ProgressInfo& pr)
+    {
+        const bool running = js.status == "running";
+        if (running && !inferenceStarted)
+        {
+            inferenceStarted = true;
+            pipelineTrace_.end(id, Stage::Queue);
+            pipelineTrace_.begin(id, Stage::Inference);
+        }
+        if (js.isFinished() || cancel.isCancelled()) // keep "Cancelling..." up until the job is withdrawn
+            return true;
+        float fraction = -1.0f; // indeterminate while queued or when the server reports no steps
+        if (running && pr.total > 0)
+            fraction = juce::jlimit(0.0f, 1.0f, static_cast<float>(pr.current) / static_cast<float>(pr.total));
+        else if (running && pr.fraction > 0.0f)
+            fraction = juce::jlimit(0.0f, 1.0f, pr.fraction);
+        juce::String text = stateToString(running ? State::Running : State::Queued);
+        if (!running && js.queuePosition > 0)
+            text += " (queue: " + juce::String(js.queuePosition) + ")";
+        if (running && pr.total > 0)
+            text += " step " + juce::String(pr.current) + "/" + juce::String(pr.total);
+        if (running && !pr.stage.empty())
+            text += " - " + juce::String::fromUTF8(pr.stage.c_str());
+        if (js.etaSeconds > 0)
+            text += " (~" + juce::String(static_cast<int>(std::ceil(js.etaSeconds))) + "s left)";
+        scheduler_.update(id, [&](GenerationScheduler::Job& j)
+        {
+            j.state = running ? JobState::Running : JobState::Queued;
+            j.progress = fraction;
+            j.statusText = text;
+        });
+        return true;
+    }, &cancel);
+    // A job seen only as queued (or straight from the queue to finished) has no inference stage of its own
+    pipelineTrace_.end(id, Stage::Queue);
+    pipelineTrace_.end(id, Stage::Inference);
 
-    while (true)
+    if (cancel.isCancelled())
+    {
+        finishCancelledJob(id, clients, st.isFinished() ? std::string() : jobId);
+        return;
+    }
+    if (st.status == "cancelled") // from another client of the same server
+    {
+        finishCancelledJob(id, clients, {});
+        return;
+    }
+    if (st.status == "succeeded")
     {
-        aceforge::JobStatus st = client_->getStatus(jobId);
-        if (st.status == "succeeded")
+        if (st.audioUrl.empty())
+        {
+            failJob(id, "No audio URL in result");
+            return;
+        }
+        scheduler_.update(id, [](GenerationScheduler::Job& j)
         {
-            state_.store(State::Running);
-            triggerAsyncUpdate();
-            if (st.audioUrl.empty())
+            j.state = JobState::Fetching;
+            j.progress = 1.0f;
+            j.statusText = "Fetching audio...";
+        });
+        LibraryWriter::Metadata metadata;
+        metadata.prompt = job.request.prompt;
+        metadata.jobId = juce::String(jobId);
+        metadata.durationSec = params.durationSeconds;
+        metadata.inferenceSteps = params.inferenceSteps;
+        metadata.guidanceScale = params.guidanceScale;
+        metadata.randomSeed = params.randomSeed;
+        metadata.seed = params.seed;
+        metadata.resultDurationSec = st.durationSeconds;
+        metadata.bpm = st.bpm;
+        metadata.keyScale = juce::String(st.keyScale);
+        metadata.backend = "aceforge";
+        if (aceforge::isDeterministic(params))
+            metadata.cacheKey = juce::String(aceforge::generationCacheKey(params));
+        auto client = clients.acquire();
+        if (streamAudioToPlayback(*client, job, params, st.audioUrl, metadata))
+            return;
+        if (cancel.isCancelled())
+            finishCancelledJob(id, clients, {});
+        else
+            failJob(id, juce::String(client->lastError()));
+        return;
+    }
+
+    failJob(id, st.error.empty() ? juce::String("Job ended with status: ") + juce::String(st.status)
+                                 : juce::String::fromUTF8(st.error.c_str()));
+}
+
+bool AceForgeBridgeAudioProcessor::runBridgeJob(const GenerationScheduler::Job& job, const aceforge::GenerateParams& params,
+                                                GenerationScheduler::Clients& clients)
+{
+    using aceforge::Stage;
+    const juce::String socketPath = getBridgeSocketPath();
+    if (socketPath.isEmpty() || !juce::File(socketPath).exists())
+        return false;
+    const int id = job.id;
+    const int blockSize = blockSize_.load(std::memory_order_relaxed);
+    aceforge::bridge::BridgeClient bridge;
+    pipelineTrace_.begin(id, Stage::Health);
+    const bool connected = bridge.connect(socketPath.toStdString(), sampleRate_.load(std::memory_order_relaxed), blockSize);
+    pipelineTrace_.end(id, Stage::Health);
+    if (!connected)
+    {
+        logTrace("runBridgeJob: " + juce::String(bridge.lastError()) + " - using AceForge");
+        return false;
+    }
+    const aceforge::bridge::Hello format = bridge.hostFormat();
+    logTrace("runBridgeJob: host streams " + juce::String(format.sampleRate) + " Hz, " + juce::String(static_cast<int>(format.numChannels))
+             + " ch" + (bridge.usesSharedRing() ? " through shared memory" : ""));
+
+    aceforge::bridge::Params request{ { "prompt", params.songDescription },
+                                      { "duration", std::to_string(params.durationSeconds) },
+                                      { "steps", std::to_string(params.inferenceSteps) } };
+    if (!params.randomSeed)
+        request.emplace_back("seed", std::to_string(params.seed));
+    if (params.bpm > 0)
+        request.emplace_back("bpm", std::to_string(params.bpm));
+    pipelineTrace_.begin(id, Stage::Submit);
+    const bool submitted = bridge.sendParams(request);
+    pipelineTrace_.end(id, Stage::Submit);
+    if (!submitted)
+    {
+        failJob(id, "Local ML host: " + juce::String(bridge.lastError()));
+        return true;
+    }
+    scheduler_.update(id, [](GenerationScheduler::Job& j)
+    {
+        j.state = GenerationScheduler::State::Running;
+        j.progress = 0.0f;
+        j.statusText = "Streaming from the local ML host...";
+    });
+
+    // Frames play as they arrive: the requests in flight plus a few buffered host blocks absorb the host's jitter.
+    // Over a shared ring the callback reads the host's frames in place, and the writer's source-rate copy is all
+    // that is kept: the library copy is encoded from it. Only a clip too long to play is collected here instead.
+    const int channels = static_cast<int>(format.numChannels);
+    const int64_t totalFrames = std::llround(params.durationSeconds * format.sampleRate);
+    const double sourceBpm = static_cast<double>(params.bpm);
+    auto unplayed = std::make_shared<SourceAudio>();
+    aceforge::ClipWriter writer;
+    pipelineTrace_.begin(id, Stage::Fetch);
+    const bool playing = beginStreamedPlayback(id, writer, totalFrames, format.sampleRate, sourceBpm,
+                                               kBridgePrebufferBlocks * blockSize);
+    double decodeMs = 0.0; // resampling into the clip, not the wait for the host
+    int64_t received = 0;
+    const bool ok = bridge.stream(totalFrames, [&](const float* interleaved, int numFrames, int numChannels)
+    {
+        if (playing)
+        {
+            const double start = juce::Time::getMillisecondCounterHiRes();
+            appendStreamedPlayback(writer, interleaved, numFrames, numChannels);
+            decodeMs += juce::Time::getMillisecondCounterHiRes() - start;
+        }
+        else
+        {
+            const size_t base = unplayed->channels[0].size();
+            float* dst[2];
+            for (int c = 0; c < 2; ++c)
             {
-                state_.store(State::Failed);
-                juce::ScopedLock l(statusLock_);
-                lastError_ = "No audio URL in result";
-                logErrorToFileAndStderr(lastError_);
-                triggerAsyncUpdate();
-                return;
+                unplayed->channels[c].resize(base + static_cast<size_t>(numFrames));
+                dst[c] = unplayed->channels[c].data() + base;
             }
-            std::vector<uint8_t> wavBytes = client_->fetchAudio(st.audioUrl);
-            if (wavBytes.empty())
+            aceforge::kernels::deinterleave(interleaved, numChannels, numFrames, dst, 2);
+        }
+        received += numFrames;
+        const float fraction = juce::jmin(1.0f, static_cast<float>(received) / static_cast<float>(juce::jmax<int64_t>(1, totalFrames)));
+        scheduler_.update(id, [fraction](GenerationScheduler::Job& j) { j.progress = fraction; });
+        return true;
+    }, job.cancel.get());
+    pipelineTrace_.end(id, Stage::Fetch);
+    std::shared_ptr<const SourceAudio> source = unplayed;
+    if (playing)
+    {
+        const double start = juce::Time::getMillisecondCounterHiRes();
+        source = finishStreamedPlayback(writer, id, sourceBpm);
+        decodeMs += juce::Time::getMillisecondCounterHiRes() - start;
+        // Resampling overlapped the stream; its share is drawn as one span ending with it
+        const int64_t now = aceforge::traceNowUs();
+        pipelineTrace_.record(id, Stage::Decode, now - static_cast<int64_t>(decodeMs * 1000.0), now);
+    }
+    const aceforge::bridge::BridgeClient::Stats& stats = bridge.stats();
+    logTrace("runBridgeJob: " + juce::String(static_cast<juce::int64>(stats.frames)) + " frames in "
+             + juce::String(static_cast<juce::int64>(stats.responses)) + " responses, first audio after "
+             + juce::String(static_cast<double>(stats.firstAudioUs) / 1000.0, 1) + " ms, max round trip "
+             + juce::String(static_cast<double>(stats.maxRoundTripUs) / 1000.0, 1) + " ms");
+    if (job.cancel->isCancelled())
+    {
+        finishCancelledJob(id, clients, {});
+        return true;
+    }
+    if (!ok || received == 0 || source == nullptr)
+    {
+        failJob(id, "Local ML host: " + juce::String(ok ? std::string("no audio") : bridge.lastError()));
+        return true;
+    }
+    bridge.close();
+
+    LibraryWriter::Metadata metadata;
+    metadata.prompt = job.request.prompt;
+    metadata.durationSec = params.durationSeconds;
+    metadata.inferenceSteps = params.inferenceSteps;
+    metadata.randomSeed = params.randomSeed;
+    metadata.seed = params.seed;
+    metadata.resultDurationSec = static_cast<double>(received) / format.sampleRate;
+    metadata.bpm = sourceBpm;
+    // The host is sent no guidance, and its audio is no AceForge generation: no guidance, no cache key
+    metadata.backend = "local";
+    FetchedAudio fetched;
+    fetched.jobId = id;
+    fetched.params = params;
+    fetched.cacheable = false;
+    fetched.decoded = true;
+    fetched.decodeMs = decodeMs;
+    fetched.bpm = sourceBpm;
+    fetched.playFromLibrary = !playing || writer.truncated();
+    fetched.continueSourceId = writer.truncated() ? writer.sourceId() : 0;
+    // Encoding the library copy happens on the decode worker, like the rest of a finished download. The clip is
+    // stereo (mono duplicated, further channels dropped), and so is the copy unless the host streams mono.
+    const double sampleRate = format.sampleRate;
+    const int libraryChannels = juce::jmin(channels, 2);
+    decodeWorker_.post([this, source, libraryChannels, sampleRate, fetched, metadata]
+    {
+        const float* planar[2] = { source->channels[0].data(), source->channels[1].data() };
+        const int numFrames = static_cast<int>(source->channels[0].size());
+        auto bytes = std::make_shared<const std::vector<uint8_t>>(encodeFloatWav(planar, libraryChannels, numFrames, sampleRate));
+        finishFetchedAudio(bytes, fetched, metadata);
+    });
+    return true;
+}
+
+bool AceForgeBridgeAudioProcessor::playCachedGeneration(int jobId, const juce::File& cachedFile,
+                                                        const aceforge::GenerateParams& params)
+{
+    juce::MemoryBlock data;
+    if (!cachedFile.loadFileAsData(data) || data.getSize() == 0)
+        return false; // evicted meanwhile: generate it again
+    const GenerationCache::Stats stats = generationCache_.getStats();
+    logTrace("generationCache: hit " + cachedFile.getFileName() + " (hits=" + juce::String(stats.hits)
+             + " misses=" + juce::String(stats.misses) + ")");
+    scheduler_.update(jobId, [](GenerationScheduler::Job& j)
+    {
+        j.state = GenerationScheduler::State::Fetching;
+        j.progress = 1.0f;
+        j.statusText = "Loading from cache...";
+    });
+    FetchedAudio fetched;
+    fetched.jobId = jobId;
+    fetched.params = params;
+    fetched.cachedFile = cachedFile;
+    fetched.bpm = params.bpm;
+    const auto* begin = static_cast<const uint8_t*>(data.getData());
+    auto bytes = std::make_shared<const std::vector<uint8_t>>(begin, begin + data.getSize());
+    decodeWorker_.post([this, bytes, fetched] { finishFetchedAudio(bytes, fetched, {}); });
+    return true;
+}
+
+bool AceForgeBridgeAudioProcessor::streamAudioToPlayback(aceforge::AceForgeClient& client, const GenerationScheduler::Job& job,
+                                                         const aceforge::GenerateParams& params, const std::string& audioUrl,
+                                                         const LibraryWriter::Metadata& metadata)
+{
+    // Decode on this thread while the file downloads; playback starts after the first few thousand frames.
+    // The whole file is still collected for the library copy.
+    std::vector<uint8_t> wavBytes;
+    aceforge::ClipWriter writer;
+    bool formatSeen = false;
+    bool playing = false;
+    bool decoderOk = true;
+    int channels = 0;
+    double decodeMs = 0.0; // decoder + resampler time, not the download
+    const int jobId = job.id;
+    // The tempo AceForge reports for the result, else the one asked for
+    const double sourceBpm = metadata.bpm > 0.0 ? metadata.bpm : static_cast<double>(params.bpm);
+    aceforge::WavStreamDecoder decoder(
+        [this, jobId, sourceBpm, &writer, &formatSeen, &playing, &channels](const aceforge::WavStreamDecoder::Format& f)
+        {
+            logTrace("streamAudioToPlayback: WAV rate=" + juce::String(f.sampleRate) + " ch=" + juce::String(f.numChannels)
+                     + " frames=" + juce::String(static_cast<juce::int64>(f.totalFrames)));
+            formatSeen = true;
+            channels = f.numChannels;
+            playing = beginStreamedPlayback(jobId, writer, static_cast<int64_t>(f.totalFrames), f.sampleRate, sourceBpm);
+            return true; // keep downloading even when the clip is too long to play, for the library
+        },
+        [this, &writer, &playing, &channels](const float* interleaved, int numFrames)
+        {
+            if (playing)
+                appendStreamedPlayback(writer, interleaved, numFrames, channels);
+            return true;
+        });
+
+    logTrace("streamAudioToPlayback: fetching " + juce::String(audioUrl));
+    pipelineTrace_.begin(jobId, aceforge::Stage::Fetch);
+    const bool ok = client.fetchAudioStream(audioUrl, [&](const uint8_t* data, size_t size)
+    {
+        wavBytes.insert(wavBytes.end(), data, data + size);
+        if (decoderOk)
+        {
+            const double start = juce::Time::getMillisecondCounterHiRes();
+            if (!decoder.push(data, size))
             {
-                state_.store(State::Failed);
-                juce::ScopedLock l(statusLock_);
-                lastError_ = juce::String(client_->lastError());
-                logErrorToFileAndStderr(lastError_);
-                triggerAsyncUpdate();
-                return;
+                logTrace("streamAudioToPlayback: decoder stopped (" + juce::String(decoder.error()) + ")");
+                decoderOk = false;
             }
-            // Decode and push on message thread (JUCE AudioFormatManager/Reader not safe from background thread)
+            decodeMs += juce::Time::getMillisecondCounterHiRes() - start;
+        }
+        return true;
+    }, job.cancel.get());
+    pipelineTrace_.end(jobId, aceforge::Stage::Fetch);
+    if (playing)
+    {
+        const double start = juce::Time::getMillisecondCounterHiRes();
+        finishStreamedPlayback(writer, jobId, sourceBpm);
+        decodeMs += juce::Time::getMillisecondCounterHiRes() - start;
+    }
+    if (formatSeen)
+    {
+        // Decoding overlapped the download; its share is drawn as one span ending with it
+        const int64_t now = aceforge::traceNowUs();
+        pipelineTrace_.record(jobId, aceforge::Stage::Decode, now - static_cast<int64_t>(decodeMs * 1000.0), now);
+    }
+    if (!ok || wavBytes.empty())
+        return false;
+    logTrace("streamAudioToPlayback: done, bytes=" + juce::String(wavBytes.size()) + " frames="
+             + juce::String(static_cast<juce::int64>(decoder.framesDecoded())));
+
+    // The rest (library copy, and a full decode for formats the streaming decoder rejected before any audio)
+    // happens on the decode worker so this thread can report back and the message thread never blocks
+    FetchedAudio fetched;
+    fetched.jobId = job.id;
+    fetched.params = params;
+    fetched.decoded = formatSeen;
+    fetched.decodeMs = decodeMs;
+    fetched.bpm = sourceBpm;
+    // Too long for an in-memory clip: play it from the library copy, continuing where a full clip stopped
+    fetched.playFromLibrary = formatSeen && (!playing || writer.truncated());
+    fetched.continueSourceId = writer.truncated() ? writer.sourceId() : 0;
+    auto bytes = std::make_shared<const std::vector<uint8_t>>(std::move(wavBytes));
+    decodeWorker_.post([this, bytes, fetched, metadata] { finishFetchedAudio(bytes, fetched, metadata); });
+    return true;
+}
+
+void AceForgeBridgeAudioProcessor::finishFetchedAudio(std::shared_ptr<const std::vector<uint8_t>> wavBytes,
+                                                      const FetchedAudio& fetched, const LibraryWriter::Metadata& metadata)
+{
+    logTrace("finishFetchedAudio: size=" + juce::String(wavBytes->size()) + " decoded=" + juce::String(fetched.decoded ? 1 : 0)
+             + " fromLibrary=" + juce::String(fetched.playFromLibrary ? 1 : 0));
+    if (scheduler_.isCancelled(fetched.jobId))
+    {
+        // Cancelled after the download: skip the full decode and the library copy
+        scheduler_.update(fetched.jobId, [](GenerationScheduler::Job& job)
+        {
+            job.state = GenerationScheduler::State::Cancelled;
+            job.statusText = stateToString(State::Cancelled);
+        });
+        return;
+    }
+    if (fetched.decoded)
+    {
+        lastDecodeMs_.store(fetched.decodeMs);
+        playbackBufferReady_.store(true);
+        const juce::String text = fetched.playFromLibrary && fetched.continueSourceId == 0
+                                      ? juce::String("Generated - long clip, playing from disk.")
+                                      : "Generated - playing (decoded in " + juce::String(fetched.decodeMs, 1) + " ms).";
+        scheduler_.update(fetched.jobId, [&text](GenerationScheduler::Job& job)
+        {
+            job.state = GenerationScheduler::State::Succeeded;
+            job.statusText = text;
+        });
+        logTrace("finishFetchedAudio: streamed decode took " + juce::String(fetched.decodeMs, 2) + " ms");
+        if (fetched.cacheable)
+            generationCache_.store(fetched.params, *wavBytes);
+        saveToLibrary(std::move(wavBytes), metadata, fetched.params, fetched.playFromLibrary, fetched.continueSourceId,
+                      beginClip());
+        return;
+    }
+
+    try
+    {
+        const int64_t decodeStart = aceforge::traceNowUs();
+        DecodeWorker::Decoded decoded = decodeWorker_.decode(*wavBytes);
+        pipelineTrace_.record(fetched.jobId, aceforge::Stage::Decode, decodeStart, aceforge::traceNowUs());
+        if (decoded.error.isNotEmpty())
+        {
+            failJob(fetched.jobId, decoded.error);
+            return;
+        }
+        const int numCh = decoded.audio.getNumChannels();
+        const int numSamples = decoded.audio.getNumSamples();
+        logTrace("finishFetchedAudio: decoded rate=" + juce::String(decoded.sampleRate) + " ch=" + juce::String(numCh)
+                 + " samples=" + juce::String(numSamples) + " in " + juce::String(decoded.decodeMs, 2) + " ms");
+
+        const double start = juce::Time::getMillisecondCounterHiRes();
+        pipelineTrace_.begin(fetched.jobId, aceforge::Stage::Push);
+        const bool inMemory = pushSamplesToPlayback(fetched.jobId, decoded.audio.getArrayOfReadPointers(), numCh, numSamples,
+                                                    decoded.sampleRate, fetched.bpm);
+        pipelineTrace_.end(fetched.jobId, aceforge::Stage::Push);
+        const double decodeMs = decoded.decodeMs + juce::Time::getMillisecondCounterHiRes() - start;
+        lastDecodeMs_.store(decodeMs);
+        playbackBufferReady_.store(true);
+        const bool fromCache = fetched.cachedFile != juce::File();
+        const juce::String text = juce::String(fromCache ? "From cache" : "Generated") + " - playing (decoded in "
+                                  + juce::String(decodeMs, 1) + " ms).";
+        scheduler_.update(fetched.jobId, [&text](GenerationScheduler::Job& job)
+        {
+            job.state = GenerationScheduler::State::Succeeded;
+            job.statusText = text;
+        });
+        logTrace("finishFetchedAudio: decode + resample took " + juce::String(decodeMs, 2) + " ms");
+        const int clipSerial = beginClip();
+        if (fromCache)
+        {
+            // A clip too long for memory streams the cache file. The project references the library copy from the
+            // first run instead, since the cache evicts; one the user deleted is saved to the library again.
+            if (!inMemory)
+                playFromDisk(fetched.cachedFile, 0);
+            const juce::String cacheKey(aceforge::generationCacheKey(fetched.params));
+            double sourceBpm = fetched.bpm;
+            juce::String jobId;
+            const juce::File copy = findLibraryCopy(cacheKey, sourceBpm, jobId);
+            if (copy != juce::File())
             {
-                juce::ScopedLock l(pendingWavLock_);
-                pendingWavBytes_ = std::move(wavBytes);
-                pendingPrompt_ = prompt;
-                pendingDurationSec_ = durationSec;
+                referenceClip(copy, fetched.params, sourceBpm, jobId, cacheKey, clipSerial);
+                return;
             }
-            triggerAsyncUpdate();
+            LibraryWriter::Metadata saved;
+            saved.prompt = juce::String::fromUTF8(fetched.params.songDescription.c_str());
+            saved.durationSec = fetched.params.durationSeconds;
+            saved.inferenceSteps = fetched.params.inferenceSteps;
+            saved.guidanceScale = fetched.params.guidanceScale;
+            saved.randomSeed = fetched.params.randomSeed;
+            saved.seed = fetched.params.seed;
+            saved.resultDurationSec = static_cast<double>(numSamples) / decoded.sampleRate;
+            saved.bpm = fetched.bpm;
+            saved.backend = "aceforge";
+            saved.cacheKey = cacheKey;
+            saveToLibrary(std::move(wavBytes), saved, fetched.params, false, 0, clipSerial);
             return;
         }
-        if (st.status == "failed")
+        if (fetched.cacheable)
+            generationCache_.store(fetched.params, *wavBytes);
+        // Too long for an in-memory clip: stream the library copy once it is written
+        saveToLibrary(std::move(wavBytes), metadata, fetched.params, !inMemory, 0, clipSerial);
+    }
+    catch (const std::exception& e)
+    {
+        failJob(fetched.jobId, juce::String("Decode error: ") + e.what());
+    }
+    catch (...)
+    {
+        failJob(fetched.jobId, "Decode error (unknown)");
+    }
+}
+
+void AceForgeBridgeAudioProcessor::saveToLibrary(std::shared_ptr<const std::vector<uint8_t>> wavBytes,
+                                                 const LibraryWriter::Metadata& metadata,
+                                                 const aceforge::GenerateParams& params, bool playWhenSaved,
+                                                 int64_t continueSourceId, int clipSerial)
+{
+    // Encoded and renamed into place on the library writer thread; playback never waits for it
+    const juce::String prompt = metadata.prompt;
+    const juce::String jobId = metadata.jobId;
+    const juce::String cacheKey = metadata.cacheKey;
+    const double sourceBpm = metadata.bpm > 0.0 ? metadata.bpm : static_cast<double>(params.bpm);
+    libraryWriter_.enqueue(std::move(wavBytes), metadata,
+                           [this, prompt, jobId, cacheKey, params, sourceBpm, playWhenSaved, continueSourceId,
+                            clipSerial](const juce::File& file, const juce::String& error)
+    {
+        if (file == juce::File())
         {
-            state_.store(State::Failed);
-            juce::ScopedLock l(statusLock_);
-            lastError_ = juce::String::fromUTF8(st.error.c_str());
-            statusText_ = lastError_;
-            logErrorToFileAndStderr(lastError_);
-            triggerAsyncUpdate();
+            logErrorToFileAndStderr(error);
             return;
         }
-        state_.store(st.status == "running" ? State::Running : State::Queued);
+        logTrace("saveToLibrary: saved " + file.getFullPathName());
+        addToLibrary(file, prompt);
+        if (playWhenSaved)
+            playFromDisk(file, continueSourceId);
+        referenceClip(file, params, sourceBpm, jobId, cacheKey, clipSerial);
+    });
+}
+
+void AceForgeBridgeAudioProcessor::playFromDisk(const juce::File& file, int64_t continueSourceId)
+{
+    const double hostRate = sampleRate_.load(std::memory_order_relaxed);
+    int64_t sourceId = continueSourceId;
+    int64_t startFrame = 0;
+    {
+        juce::ScopedLock l(sourceLock_);
+        if (continueSourceId != 0)
         {
-            juce::ScopedLock l(statusLock_);
-            statusText_ = juce::String(stateToString(state_.load()));
-            if (st.queuePosition > 0)
-                statusText_ += " (queue: " + juce::String(st.queuePosition) + ")";
+            // Pick up where the in-memory clip is now, unless something else has started playing since
+            if (currentSourceId_ != continueSourceId)
+                return;
+            // The file is at the source tempo: undo the clip's stretch too
+            const int64_t position = core_.position();
+            startFrame = publishedRate_ > 0.0
+                             ? std::llround(static_cast<double>(position) * hostRate / (publishedRate_ * publishedStretch_))
+                             : position;
+        }
+        else
+        {
+            sourceId = ++nextSourceId_;
+            currentSourceId_ = sourceId;
         }
-        triggerAsyncUpdate();
-        std::this_thread::sleep_for(std::chrono::milliseconds(800));
+        lastSource_ = nullptr;
+        renderedRate_ = publishedRate_ = hostRate;
+        renderedStretch_ = publishedStretch_ = 1.0;
     }
+    logTrace("playFromDisk: " + file.getFullPathName() + " from frame " + juce::String(static_cast<juce::int64>(startFrame)));
+    diskStreamer_.start(file, hostRate, sourceId, startFrame, continueSourceId != 0);
 }
 
-void AceForgeBridgeAudioProcessor::pushSamplesToPlayback(const float* interleaved, int numFrames,
-                                                         int sourceChannels, double sourceSampleRate)
+void AceForgeBridgeAudioProcessor::auditionLibraryEntry(const juce::File& file)
 {
-    logTrace("pushSamplesToPlayback: numFrames=" + juce::String(numFrames) + " ch=" + juce::String(sourceChannels) + " rate=" + juce::String(sourceSampleRate));
-    if (numFrames <= 0 || interleaved == nullptr)
+    if (!file.existsAsFile())
         return;
-    const double hostRate = sampleRate_.load(std::memory_order_relaxed);
-    const double ratio = sourceSampleRate > 0.0 ? hostRate / sourceSampleRate : 1.0;
-    const int outFrames = static_cast<int>(std::round(static_cast<double>(numFrames) * ratio));
-    if (outFrames <= 0 || outFrames > kPlaybackFifoFrames)
+    playFromDisk(file, 0);
+    const int clipSerial = beginClip();
+    decodeWorker_.post([this, file, clipSerial]
     {
-        logTrace("pushSamplesToPlayback: skipped (outFrames=" + juce::String(outFrames) + ")");
-        return;
-    }
+        double bpm = 0.0;
+        juce::String jobId, cacheKey;
+        const aceforge::GenerateParams params = paramsFromSidecar(file, bpm, jobId, cacheKey);
+        referenceClip(file, params, bpm, jobId, cacheKey, clipSerial);
+    });
+    juce::ScopedLock l(statusLock_);
+    statusText_ = "Playing " + file.getFileName() + " from the library.";
+}
 
-    // Write into the buffer the audio thread is not reading (alternate 0/1)
-    const int writeIdx = nextWriteIndex_.load(std::memory_order_relaxed);
-    std::vector<float>& outBuf = pendingPlaybackBuffer_[writeIdx];
-    logTrace("pushSamplesToPlayback: resizing buffer to " + juce::String(outFrames * 2) + " floats");
-    outBuf.resize(static_cast<size_t>(outFrames) * 2u);
-    float* out = outBuf.data();
-    for (int i = 0; i < outFrames; ++i)
-    {
-        const double srcIdx = ratio > 0.0 ? (double)i / ratio : (double)i;
-        const int i0 = std::min(std::max(0, static_cast<int>(srcIdx)), numFrames - 1);
-        const int i1 = std::min(i0 + 1, numFrames - 1);
-        const float t = static_cast<float>(srcIdx - std::floor(srcIdx));
-        float l = 0.0f, r = 0.0f;
-        if (sourceChannels >= 1)
+juce::File AceForgeBridgeAudioProcessor::findLibraryCopy(const juce::String& cacheKey, double& sourceBpm,
+                                                         juce::String& jobId) const
+{
+    if (cacheKey.isEmpty())
+        return {};
+    for (const LibraryIndex::Entry& entry : libraryIndex_.getEntries())
+    {
+        // Only files whose sidecar mentions the key get parsed
+        const juce::File sidecar = entry.file.withFileExtension("json");
+        if (!entry.file.existsAsFile() || !sidecar.loadFileAsString().contains(cacheKey))
+            continue;
+        double bpm = 0.0;
+        juce::String id, key;
+        paramsFromSidecar(entry.file, bpm, id, key);
+        if (key == cacheKey)
         {
-            l = interleaved[i0 * sourceChannels] * (1.0f - t) + interleaved[i1 * sourceChannels] * t;
-            r = sourceChannels >= 2
-                    ? interleaved[i0 * sourceChannels + 1] * (1.0f - t) + interleaved[i1 * sourceChannels + 1] * t
-                    : l;
+            sourceBpm = bpm > 0.0 ? bpm : sourceBpm;
+            jobId = id;
+            return entry.file;
         }
-        out[i * 2] = l;
-        out[i * 2 + 1] = r;
     }
-    pendingPlaybackFrames_.store(outFrames, std::memory_order_release);
-    pendingPlaybackBufferIndex_.store(writeIdx, std::memory_order_release);
-    pendingPlaybackReady_.store(true, std::memory_order_release);
-    nextWriteIndex_.store(1 - writeIdx, std::memory_order_release);
-    logTrace("pushSamplesToPlayback: done");
+    return {};
 }
 
-void AceForgeBridgeAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer,
-                                                juce::MidiBuffer& midiMessages)
+int AceForgeBridgeAudioProcessor::beginClip()
 {
-    juce::ignoreUnused(midiMessages);
-    juce::ScopedNoDenormals noDenormals;
-    const int numSamples = buffer.getNumSamples();
-    const int numCh = buffer.getNumChannels();
-    if (numCh < 2)
+    restorePending_.store(false);
+    return ++clipSerial_;
+}
+
+void AceForgeBridgeAudioProcessor::referenceClip(const juce::File& file, const aceforge::GenerateParams& params,
+                                                 double sourceBpm, const juce::String& jobId,
+                                                 const juce::String& cacheKey, int clipSerial)
+{
+    if (clipSerial != clipSerial_.load())
+        return;
+    PluginState::Clip clip;
+    clip.file = file;
+    clip.fileSize = file.getSize();
+    clip.contentHash = PluginState::hashFile(file);
+    clip.params = params;
+    clip.sourceBpm = sourceBpm;
+    clip.jobId = jobId;
+    clip.cacheKey = cacheKey;
+    if (clip.contentHash.isEmpty())
     {
-        buffer.clear();
+        logErrorToFileAndStderr("Could not read " + file.getFullPathName() + " to save it with the project");
         return;
     }
+    juce::ScopedLock l(stateLock_);
+    if (clipSerial == clipSerial_.load())
+        savedState_.clip = clip;
+}
 
-    // Apply any new playback buffer from the message thread; only we (audio thread) may reset the fifo (JUCE AbstractFifo is single-reader single-writer; reset from another thread causes crashes).
-    if (pendingPlaybackReady_.exchange(false, std::memory_order_acq_rel))
+void AceForgeBridgeAudioProcessor::restoreClip(PluginState::Clip clip, int clipSerial)
+{
+    const auto matches = [&clip](const juce::File& file)
     {
-        const int N = pendingPlaybackFrames_.load(std::memory_order_acquire);
-        const int bufIdx = pendingPlaybackBufferIndex_.load(std::memory_order_acquire);
-        const std::vector<float>& srcBuf = pendingPlaybackBuffer_[bufIdx];
-        if (N > 0 && N <= kPlaybackFifoFrames && srcBuf.size() >= static_cast<size_t>(N) * 2u)
+        return file.existsAsFile() && file.getSize() == clip.fileSize && PluginState::hashFile(file) == clip.contentHash;
+    };
+    juce::File found;
+    if (matches(clip.file))
+        found = clip.file;
+    else
+    {
+        // Project opened on another machine or the library moved: the same file in this library
+        const juce::File local = libraryIndex_.getDirectory().getChildFile(clip.file.getFileName());
+        if (local != clip.file && matches(local))
+            found = local;
+        else if (clip.cacheKey.isNotEmpty() && clip.cacheKey == juce::String(aceforge::generationCacheKey(clip.params)))
         {
-            playbackFifo_.reset();
-            int start1, block1, start2, block2;
-            playbackFifo_.prepareToWrite(N, start1, block1, start2, block2);
-            const float* src = srcBuf.data();
-            auto copyBlock = [&](int fifoStart, int count, int srcOffset)
-            {
-                for (int i = 0; i < count && (fifoStart + i) * 2 + 1 < static_cast<int>(playbackBuffer_.size()); ++i)
-                {
-                    const int s = (srcOffset + i) * 2;
-                    playbackBuffer_[static_cast<size_t>(fifoStart + i) * 2u] = src[s];
-                    playbackBuffer_[static_cast<size_t>(fifoStart + i) * 2u + 1u] = src[s + 1];
-                }
-            };
-            copyBlock(start1, block1, 0);
-            copyBlock(start2, block2, block1);
-            playbackFifo_.finishedWrite(block1 + block2);
+            // Fixed-seed AceForge generation: another library copy of it, else the generation cache (its key is the
+            // canonical parameters, so the bytes need no hash check)
+            juce::String jobId;
+            found = findLibraryCopy(clip.cacheKey, clip.sourceBpm, jobId);
+            if (found == juce::File())
+                found = generationCache_.lookup(clip.params);
         }
     }
 
-    int start1, block1, start2, block2;
-    playbackFifo_.prepareToRead(numSamples, start1, block1, start2, block2);
+    const juce::String prompt = juce::String::fromUTF8(clip.params.songDescription.c_str());
+    if (clipSerial != clipSerial_.load())
+        return; // something else started playing meanwhile
+    if (found == juce::File())
+    {
+        logTrace("restoreClip: " + clip.file.getFullPathName() + " (" + clip.contentHash + ") not found");
+        juce::ScopedLock l(statusLock_);
+        statusText_ = "Saved clip \"" + prompt + "\" not found in the library - generate it again.";
+        return;
+    }
+    logTrace("restoreClip: " + found.getFullPathName() + (found == clip.file ? "" : " (moved)"));
+    if (found != clip.file)
+    {
+        // Saving the project again references the file that was found
+        clip.file = found;
+        clip.fileSize = found.getSize();
+        clip.contentHash = PluginState::hashFile(found);
+    }
+    {
+        juce::ScopedLock l(stateLock_);
+        if (clipSerial != clipSerial_.load())
+            return;
+        savedState_.clip = clip;
+        restoredFile_ = found;
+        restorePending_.store(true);
+    }
+    juce::ScopedLock l(statusLock_);
+    statusText_ = "Restored \"" + prompt + "\" - plays when the transport starts.";
+}
+
+void AceForgeBridgeAudioProcessor::startRestoredClip()
+{
+    juce::File file;
+    {
+        juce::ScopedLock l(stateLock_);
+        if (!restorePending_.exchange(false))
+            return;
+        file = restoredFile_;
+    }
+    // Streamed (memory-mapped) from disk like a library audition; nothing is decoded up front
+    playFromDisk(file, 0);
+    juce::ScopedLock l(statusLock_);
+    statusText_ = "Playing " + file.getFileName() + " (restored with the project).";
+}
 
-    auto readFrames = [&](int fifoStart, int count, int bufferOffset)
+PluginState AceForgeBridgeAudioProcessor::getSavedState() const
+{
+    PluginState state;
     {
-        for (int i = 0; i < count; ++i)
+        juce::ScopedLock l(stateLock_);
+        state = savedState_;
+    }
+    state.baseUrl = baseUrl_;
+    state.bridgeSocketPath = getBridgeSocketPath();
+    state.syncToHost = isSyncingToHost();
+    state.libraryFormat = getLibraryFormat();
+    return state;
+}
+
+bool AceForgeBridgeAudioProcessor::beginStreamedPlayback(int jobId, aceforge::ClipWriter& writer, int64_t sourceFrames,
+                                                         double sourceSampleRate, double sourceBpm, int prebufferFrames)
+{
+    const double hostRate = sampleRate_.load(std::memory_order_relaxed);
+    const int64_t sourceId = ++nextSourceId_; // an id skipped when begin() fails is harmless
+    // The stretch needs the whole source: a clip off the host tempo plays once it has arrived and been conformed
+    // (rerenderForHost, from finishStreamedPlayback). Clips too long for memory keep their own tempo.
+    const double stretch = conformStretch(sourceBpm, syncTempo());
+    const bool conform = stretch != 1.0 && sourceFrames > 0 && sourceSampleRate > 0.0
+                         && static_cast<double>(sourceFrames) * hostRate / sourceSampleRate * stretch <= kMaxPlaybackFrames;
+    auto publish = [this, jobId, sourceId, conform](const std::shared_ptr<aceforge::PlaybackClip>& clip)
+    {
+        if (conform)
+            return;
         {
-            const size_t base = static_cast<size_t>(fifoStart + i) * 2u;
-            if (base + 1 < playbackBuffer_.size() && bufferOffset + i < numSamples)
+            // Something newer (another generation, an audition) may have started while this one prebuffered
+            juce::ScopedLock l(sourceLock_);
+            if (currentSourceId_ == sourceId)
             {
-                buffer.setSample(0, bufferOffset + i, playbackBuffer_[base]);
-                buffer.setSample(1, bufferOffset + i, playbackBuffer_[base + 1]);
+                // Stamped before the publish: the audio thread may pick the clip up right away
+                pipelineTrace_.begin(jobId, aceforge::Stage::Handoff);
+                handoffJobId_ = jobId;
+                handoffSourceId_ = sourceId;
+                clip->startOnBar = syncToHost_.load();
+                core_.handoff().publish(clip);
             }
         }
+        logTrace("renderStreamedFrames: playback started with " + juce::String(clip->readyFrames.load()) + " frames");
     };
-    readFrames(start1, block1, 0);
-    readFrames(start2, block2, block1);
-    playbackFifo_.finishedRead(block1 + block2);
+    // Always a fresh clip: the audio thread may still be reading (or fading out) the previous one
+    diskStreamer_.stop();
+    core_.handoff().reclaim();
+    if (!writer.begin(core_.handoff(), sourceFrames, sourceSampleRate, hostRate, sourceId, kMaxPlaybackFrames,
+                      prebufferFrames, std::move(publish)))
+    {
+        logTrace("beginStreamedPlayback: skipped (sourceFrames=" + juce::String(static_cast<juce::int64>(sourceFrames)) + ")");
+        return false;
+    }
+    {
+        // The previous source can no longer be re-rendered into playback once this clip takes over
+        juce::ScopedLock l(sourceLock_);
+        currentSourceId_ = sourceId;
+        lastSource_ = nullptr;
+        renderedRate_ = publishedRate_ = conform ? 0.0 : hostRate;
+        renderedStretch_ = publishedStretch_ = 1.0;
+    }
+    if (conform)
+        logTrace("beginStreamedPlayback: conforming " + juce::String(sourceBpm, 1) + " bpm to the host (stretch "
+                 + juce::String(stretch, 4) + ") once the clip is in");
+    return true;
+}
+
+void AceForgeBridgeAudioProcessor::appendStreamedPlayback(aceforge::ClipWriter& writer, const float* interleaved, int numFrames,
+                                                          int sourceChannels)
+{
+    const bool wasTruncated = writer.truncated();
+    writer.append(interleaved, numFrames, sourceChannels);
+    // The clip buffer is full; the rest plays from the library file once it is saved (playFromDisk)
+    if (writer.truncated() && !wasTruncated)
+        logTrace("appendStreamedPlayback: clip full at " + juce::String(writer.framesWritten()) + " frames, rest streams from disk");
+}
+
+std::shared_ptr<const AceForgeBridgeAudioProcessor::SourceAudio>
+AceForgeBridgeAudioProcessor::finishStreamedPlayback(aceforge::ClipWriter& writer, int jobId, double sourceBpm)
+{
+    if (!writer.active())
+        return nullptr;
+    writer.finish();
+    if (writer.truncated())
+        return nullptr;
+
+    // Keep the source-rate audio so a later host rate or tempo change re-renders instead of playing at the wrong speed
+    auto source = std::make_shared<SourceAudio>();
+    for (int c = 0; c < 2; ++c)
+        source->channels[c] = writer.takeSource(c);
+    source->sampleRate = writer.resampler().sourceRate();
+    source->bpm = sourceBpm;
+    source->id = writer.sourceId();
+    source->jobId = jobId;
+    {
+        juce::ScopedLock l(sourceLock_);
+        if (currentSourceId_ == source->id)
+            lastSource_ = source;
+    }
+    // Conforms a clip held back for it; also picks up host rate or tempo changes made while the clip streamed in
+    rerenderForHost(sampleRate_.load(std::memory_order_relaxed), syncTempo());
+    return source;
+}
 
-    const int readCount = block1 + block2;
-    for (int i = readCount; i < numSamples; ++i)
+bool AceForgeBridgeAudioProcessor::pushSamplesToPlayback(int jobId, const float* const* channels, int numChannels,
+                                                         int numFrames, double sourceSampleRate, double sourceBpm)
+{
+    logTrace("pushSamplesToPlayback: numFrames=" + juce::String(numFrames) + " ch=" + juce::String(numChannels) + " rate=" + juce::String(sourceSampleRate));
+    if (numFrames <= 0 || numChannels <= 0 || channels == nullptr)
+        return false;
+    // A whole decoded clip is just a stream that arrives in one piece (already planar: no deinterleave)
+    aceforge::ClipWriter writer;
+    if (!beginStreamedPlayback(jobId, writer, numFrames, sourceSampleRate, sourceBpm))
+        return false;
+    writer.appendPlanar(channels, numChannels, numFrames);
+    finishStreamedPlayback(writer, jobId, sourceBpm);
+    logTrace("pushSamplesToPlayback: done");
+    return true;
+}
+
+void AceForgeBridgeAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer,
+                                                juce::MidiBuffer& midiMessages)
+{
+    juce::ignoreUnused(midiMessages);
+    juce::ScopedNoDenormals noDenormals;
+    // Transport for bar-synced starts and the host tempo; hosts without a play head (or a tempo) just play
+    aceforge::HostTransport transport;
+    if (auto* playHead = getPlayHead())
     {
-        buffer.setSample(0, i, 0.0f);
-        buffer.setSample(1, i, 0.0f);
+        if (const auto position = playHead->getPosition())
+        {
+            transport.playing = position->getIsPlaying();
+            transport.bpm = position->getBpm().orFallback(0.0);
+            transport.ppqPosition = position->getPpqPosition().orFallback(0.0);
+            transport.barStartPpq = position->getPpqPositionOfLastBarStart().orFallback(transport.ppqPosition);
+            if (const auto signature = position->getTimeSignature())
+            {
+                transport.numerator = signature->numerator;
+                transport.denominator = signature->denominator;
+            }
+        }
     }
+    hostPlaying_.store(transport.playing, std::memory_order_relaxed);
+    // Stereo out; with fewer channels the core writes silence (the same code aceforge_process_bench measures)
+    core_.process(buffer.getArrayOfWritePointers(), juce::jmin(2, buffer.getNumChannels()), buffer.getNumSamples(),
+                  &transport);
 }
 
 juce::String AceForgeBridgeAudioProcessor::getStatusText() const
@@ -351,153 +1319,90 @@ juce::String AceForgeBridgeAudioProcessor::getLastError() const
 
 juce::File AceForgeBridgeAudioProcessor::getLibraryDirectory() const
 {
-    juce::File dir = juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
-                         .getChildFile("AceForgeBridge")
-                         .getChildFile("Generations");
+    const juce::File& dir = libraryIndex_.getDirectory();
     if (!dir.exists())
         dir.createDirectory();
     return dir;
 }
 
-std::vector<AceForgeBridgeAudioProcessor::LibraryEntry> AceForgeBridgeAudioProcessor::getLibraryEntries() const
+void AceForgeBridgeAudioProcessor::addToLibrary(const juce::File& wavFile, const juce::String& prompt)
 {
-    juce::Array<juce::File> wavs;
-    getLibraryDirectory().findChildFiles(wavs, juce::File::findFiles, false, "*.wav");
-    std::vector<LibraryEntry> entries;
-    for (const juce::File& f : wavs)
-        entries.push_back({ f, f.getFileName().upToFirstOccurrenceOf(".", false, false), f.getLastModificationTime() });
-    std::sort(entries.begin(), entries.end(),
-              [](const LibraryEntry& a, const LibraryEntry& b) { return a.time > b.time; });
-    return entries;
+    // File is already on disk; the index picks it up without rescanning the folder
+    libraryIndex_.add(wavFile, prompt);
+    peakCache_.build(wavFile);
 }
 
-void AceForgeBridgeAudioProcessor::addToLibrary(const juce::File& wavFile, const juce::String& prompt)
+void AceForgeBridgeAudioProcessor::handleAsyncUpdate()
 {
-    juce::ignoreUnused(wavFile, prompt);
-    // File is already on disk; optional: write prompt to .txt sidecar for display
+    // Decoding happens on the generation thread or the decode worker; here we only free clips the audio thread
+    // has finished with. The editor polls state and status on its timer.
+    core_.handoff().reclaim();
+    resolveHandoff();
 }
 
-void AceForgeBridgeAudioProcessor::handleAsyncUpdate()
+void AceForgeBridgeAudioProcessor::resolveHandoff()
 {
-    logTrace("handleAsyncUpdate: start");
-    std::vector<uint8_t> wavBytes;
-    juce::String promptForLibrary;
-    {
-        juce::ScopedLock l(pendingWavLock_);
-        if (pendingWavBytes_.empty())
-            return;
-        wavBytes = std::move(pendingWavBytes_);
-        pendingWavBytes_.clear();
-        promptForLibrary = pendingPrompt_;
-    }
-    logTrace("handleAsyncUpdate: got WAV bytes, size=" + juce::String(wavBytes.size()));
+    juce::ScopedLock l(sourceLock_);
+    if (handoffSourceId_ == 0 || core_.lastAcquiredSource() != handoffSourceId_)
+        return;
+    pipelineTrace_.end(handoffJobId_, aceforge::Stage::Handoff, core_.lastAcquiredUs());
+    handoffSourceId_ = 0;
+}
 
-    try
-    {
-        juce::AudioFormatManager fm;
-        fm.registerFormat(new juce::WavAudioFormat(), true);
-        logTrace("handleAsyncUpdate: creating MemoryInputStream");
-        auto mis = std::make_unique<juce::MemoryInputStream>(wavBytes.data(), wavBytes.size(), false);
-        logTrace("handleAsyncUpdate: creating reader");
-        std::unique_ptr<juce::AudioFormatReader> reader(fm.createReaderFor(std::move(mis)));
-        if (!reader)
-        {
-            state_.store(State::Failed);
-            juce::ScopedLock l(statusLock_);
-            lastError_ = "Failed to decode WAV";
-            statusText_ = lastError_;
-            logErrorToFileAndStderr(lastError_);
-            return;
-        }
-        const double fileSampleRate = reader->sampleRate;
-        const int numCh = static_cast<int>(reader->numChannels);
-        const int numSamples = static_cast<int>(reader->lengthInSamples);
-        logTrace("handleAsyncUpdate: WAV info rate=" + juce::String(fileSampleRate) + " ch=" + juce::String(numCh) + " samples=" + juce::String(numSamples));
-        if (numSamples <= 0 || numCh <= 0)
-        {
-            state_.store(State::Failed);
-            juce::ScopedLock l(statusLock_);
-            lastError_ = "Invalid WAV (no samples)";
-            statusText_ = lastError_;
-            logErrorToFileAndStderr(lastError_);
-            return;
-        }
-        logTrace("handleAsyncUpdate: allocating fileBuffer");
-        juce::AudioBuffer<float> fileBuffer(numCh, numSamples);
-        logTrace("handleAsyncUpdate: reading samples");
-        if (!reader->read(&fileBuffer, 0, numSamples, 0, true, true))
-        {
-            state_.store(State::Failed);
-            juce::ScopedLock l(statusLock_);
-            lastError_ = "Failed to read WAV samples";
-            statusText_ = lastError_;
-            logErrorToFileAndStderr(lastError_);
-            return;
-        }
-        logTrace("handleAsyncUpdate: building interleaved buffer");
-        std::vector<float> interleaved(static_cast<size_t>(numSamples) * 2u);
-        for (int i = 0; i < numSamples; ++i)
-        {
-            interleaved[static_cast<size_t>(i) * 2u] = numCh > 0 ? fileBuffer.getSample(0, i) : 0.0f;
-            interleaved[static_cast<size_t>(i) * 2u + 1u] = numCh > 1 ? fileBuffer.getSample(1, i) : interleaved[static_cast<size_t>(i) * 2u];
-        }
-        logTrace("handleAsyncUpdate: calling pushSamplesToPlayback");
-        pushSamplesToPlayback(interleaved.data(), numSamples, 2, fileSampleRate);
-        playbackBufferReady_.store(true);
-        state_.store(State::Succeeded);
-        {
-            juce::ScopedLock l(statusLock_);
-            statusText_ = "Generated - playing.";
-        }
-        logTrace("handleAsyncUpdate: playback updated, saving to library");
-        // Save to library so user can drag into DAW (own try so a file error doesn't lose playback)
-        try
-        {
-            juce::File libDir = getLibraryDirectory();
-            juce::String baseName = "gen_" + juce::Time::getCurrentTime().formatted("%Y%m%d_%H%M%S");
-            juce::File wavFile = libDir.getChildFile(baseName + ".wav");
-            std::unique_ptr<juce::OutputStream> outStream = wavFile.createOutputStream();
-            if (outStream != nullptr)
-            {
-                juce::WavAudioFormat wavFormat;
-                auto options = juce::AudioFormatWriterOptions{}
-                                  .withSampleRate(fileSampleRate)
-                                  .withNumChannels(numCh)
-                                  .withBitsPerSample(24);
-                if (auto writer = wavFormat.createWriterFor(outStream, options))
-                {
-                    if (writer->writeFromAudioSampleBuffer(fileBuffer, 0, numSamples))
-                        addToLibrary(wavFile, promptForLibrary);
-                }
-            }
-            logTrace("handleAsyncUpdate: library save done");
-        }
-        catch (const std::exception& e)
-        {
-            logErrorToFileAndStderr("Library save failed: " + juce::String(e.what()));
-        }
-        catch (...)
-        {
-            logErrorToFileAndStderr("Library save failed (unknown)");
-        }
-        logTrace("handleAsyncUpdate: done");
-    }
-    catch (const std::exception& e)
-    {
-        state_.store(State::Failed);
-        juce::ScopedLock l(statusLock_);
-        lastError_ = juce::String("Decode error: ") + e.what();
-        statusText_ = lastError_;
-        logErrorToFileAndStderr(lastError_);
-    }
-    catch (...)
-    {
-        state_.store(State::Failed);
-        juce::ScopedLock l(statusLock_);
-        lastError_ = "Decode error (unknown)";
-        statusText_ = lastError_;
-        logErrorToFileAndStderr(lastError_);
-    }
+juce::String AceForgeBridgeAudioProcessor::getTimingSummary()
+{
+    resolveHandoff();
+    aceforge::JobTimeline timeline;
+    if (!pipelineTrace_.get(shownJobId_.load(), timeline))
+        return {};
+    return juce::String(timeline.summary());
+}
+
+void AceForgeBridgeAudioProcessor::timerCallback()
+{
+    // Tempo automation and sync changes: re-renders (from the playhead) only when the tempo actually moved
+    rerenderForHost(sampleRate_.load(), syncTempo());
+    // A clip restored with the project waits for the host to play, so loading a project stays silent
+    if (restorePending_.load() && hostPlaying_.load(std::memory_order_relaxed))
+        startRestoredClip();
+    if (++timerTicks_ % 4 != 0)
+        return;
+    // The audio thread only stores atomics; reading and logging them happens here
+    const aceforge::RealtimeStats::Snapshot now = core_.stats().takePeak();
+    realtimeWindow_ = now.since(realtimeTotal_);
+    realtimeTotal_ = now;
+    const auto& w = realtimeWindow_;
+    if (w.overruns == 0 && w.underruns == 0)
+        return;
+    PluginLog::warning("processBlock: " + juce::String(static_cast<juce::int64>(w.overruns)) + " overrun(s), "
+                       + juce::String(static_cast<juce::int64>(w.underruns)) + " underrun(s) in the last second; load "
+                       + juce::String(w.meanLoadPercent(), 2) + "%, peak block "
+                       + juce::String(static_cast<double>(w.peakBlockNs) / 1000.0, 1) + " us ("
+                       + juce::String(w.peakLoadPermille / 10.0, 1) + "% of its budget), "
+                       + juce::String(static_cast<juce::int64>(w.handoffs)) + " handoff(s), slowest handoff block "
+                       + juce::String(static_cast<double>(w.peakHandoffBlockNs) / 1000.0, 1) + " us");
+}
+
+juce::String AceForgeBridgeAudioProcessor::getRealtimeSummary() const
+{
+    if (realtimeTotal_.blocks == 0)
+        return {};
+    return "audio " + juce::String(realtimeWindow_.meanLoadPercent(), 1) + "% (peak "
+           + juce::String(realtimeWindow_.peakLoadPermille / 10.0, 1) + "%) - "
+           + juce::String(static_cast<juce::int64>(realtimeTotal_.overruns)) + " overruns, "
+           + juce::String(static_cast<juce::int64>(realtimeTotal_.underruns)) + " underruns";
+}
+
+bool AceForgeBridgeAudioProcessor::exportPipelineTrace(const juce::File& file)
+{
+    resolveHandoff();
+    file.getParentDirectory().createDirectory();
+    const bool ok = pipelineTrace_.writeChromeTrace(file.getFullPathName().toStdString());
+    if (ok)
+        logTrace("exportPipelineTrace: " + file.getFullPathName());
+    else
+        logErrorToFileAndStderr("Could not write trace " + file.getFullPathName());
+    return ok;
 }
 
 const juce::String AceForgeBridgeAudioProcessor::getName() const { return JucePlugin_Name; }
@@ -533,11 +1438,33 @@ juce::AudioProcessorEditor* AceForgeBridgeAudioProcessor::createEditor()
 }
 void AceForgeBridgeAudioProcessor::getStateInformation(juce::MemoryBlock& destData)
 {
-    juce::ignoreUnused(destData);
+    // Settings and a reference to the clip, never audio: the project stays small and saves instantly
+    const std::unique_ptr<juce::XmlElement> xml = getSavedState().toXml();
+    copyXmlToBinary(*xml, destData);
 }
 void AceForgeBridgeAudioProcessor::setStateInformation(const void* data, int sizeInBytes)
 {
-    juce::ignoreUnused(data, sizeInBytes);
+    const std::unique_ptr<juce::XmlElement> xml = getXmlFromBinary(data, sizeInBytes);
+    PluginState state = getSavedState(); // attributes an older version did not save keep the current values
+    if (xml == nullptr || !PluginState::fromXml(*xml, state))
+    {
+        logErrorToFileAndStderr("setStateInformation: not an AceForge Bridge state (" + juce::String(sizeInBytes)
+                                + " bytes), ignored");
+        return;
+    }
+    setBaseUrl(state.baseUrl);
+    setBridgeSocketPath(state.bridgeSocketPath);
+    setSyncToHost(state.syncToHost);
+    setLibraryFormat(state.libraryFormat);
+
+    // The clip is looked up and hashed on the decode worker: the host's load call does no file I/O
+    const int clipSerial = beginClip();
+    {
+        juce::ScopedLock l(stateLock_);
+        savedState_ = state;
+    }
+    if (state.clip.isValid())
+        decodeWorker_.post([this, clip = state.clip, clipSerial] { restoreClip(clip, clipSerial); });
 }
 
 juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
@@ -4,12 +4,30 @@
 #include <juce_audio_formats/juce_audio_formats.h>
 #include <juce_core/juce_core.h>
 #include "AceForgeClient/AceForgeClient.hpp"
+#include "AceForgeClient/AceForgeSession.hpp"
+#include "AceForgeClient/BridgeClient.hpp"
+#include "DecodeWorker.h"
+#include "DiskStreamer.h"
+#include "GenerationCache.h"
+#include "GenerationScheduler.h"
+#include "LibraryIndex.h"
+#include "LibraryWriter.h"
+#include "PeakCache.h"
+#include "PluginLog.h"
+#include "PluginState.h"
+#include "AceForgeAudio/ClipWriter.hpp"
+#include "AceForgeAudio/PipelineTrace.hpp"
+#include "AceForgeAudio/PlaybackCore.hpp"
+#include "AceForgeAudio/RealtimeStats.hpp"
+#include "AceForgeAudio/Resampler.hpp"
 #include <atomic>
 #include <memory>
+#include <thread>
 #include <vector>
 
 class AceForgeBridgeAudioProcessor : public juce::AudioProcessor,
-                                     public juce::AsyncUpdater
+                                     public juce::AsyncUpdater,
+                                     private juce::Timer
 {
 public:
     enum class State
@@ -19,7 +37,8 @@ public:
         Queued,
         Running,
         Succeeded,
-        Failed
+        Failed,
+        Cancelled
     };
 
     AceForgeBridgeAudioProcessor();
@@ -51,57 +70,249 @@ public:
 
     void handleAsyncUpdate() override;
 
-    // Generation (call from UI or elsewhere; runs on background thread)
-    void startGeneration(const juce::String& prompt, int durationSeconds = 10, int inferenceSteps = 15);
+    // Generation (call from UI or elsewhere). Queues `variations` jobs on the scheduler; jobs run concurrently up to
+    // GenerationScheduler::kMaxWorkers. A negative seed picks a random one per job; otherwise take i uses seed + i
+    // and repeats come from the generation cache. Returns the first job id, or 0 if the queue is full.
+    int startGeneration(const juce::String& prompt, int durationSeconds = 10, int inferenceSteps = 15, int variations = 1,
+                        juce::int64 seed = -1);
+    // Stops job jobId (0: every unfinished job): waiting ones are dropped, started ones are withdrawn from the
+    // AceForge queue and their download and decode abandoned. Returns the number of jobs cancelled.
+    int cancelGeneration(int jobId = 0);
     void setBaseUrl(const juce::String& url);
+    // Local ML host (protocol.md): while one listens on this Unix socket, jobs stream from it block by block instead
+    // of going through AceForge. Defaults to aceforge::bridge::kDefaultSocketPath; empty turns the bridge off.
+    void setBridgeSocketPath(const juce::String& path);
+    juce::String getBridgeSocketPath() const;
+    // Hit/miss/eviction counters of the fixed-seed generation cache
+    GenerationCache::Stats getGenerationCacheStats() const { return generationCache_.getStats(); }
+    // Every job still running plus the last few finished ones, oldest first
+    std::vector<GenerationScheduler::Job> getGenerationJobs() const { return scheduler_.getJobs(); }
 
+    // Summary of the job the editor shows: the oldest one in progress, else the newest finished one
     State getState() const { return state_.load(); }
     juce::String getStatusText() const;
     juce::String getLastError() const;
+    /** Job progress 0..1 while generating, or negative when indeterminate (queued / no step info). */
+    float getProgress() const { return progress_.load(); }
     bool isConnected() const { return connected_; }
+    /** Time spent decoding (and resampling) the last fetched clip, in ms. */
+    double getLastDecodeMs() const { return lastDecodeMs_.load(); }
+    // Stage breakdown of the job the editor shows, e.g. "health 2.1 ms | submit 4.0 ms | queue 1.2 s | ..." (empty
+    // before the first job). Message thread (closes a pending handoff stage).
+    juce::String getTimingSummary();
+    // Writes the stages of every recorded job as Chrome trace-event JSON (chrome://tracing, Perfetto); false on error
+    bool exportPipelineTrace(const juce::File& file);
+    // Audio-thread counters since the plugin was created, as of the last timer tick (peaks cover the second before
+    // it). Message thread.
+    aceforge::RealtimeStats::Snapshot getRealtimeStats() const { return realtimeTotal_; }
+    // e.g. "audio 0.4% (peak 3.1%) - 0 overruns, 2 underruns"; load is over the last second. Message thread.
+    juce::String getRealtimeSummary() const;
 
-    // Library of saved generations (on disk) for drag-into-DAW
-    struct LibraryEntry
-    {
-        juce::File file;
-        juce::String prompt;
-        juce::Time time;
-    };
+    // Tempo sync: new generations ask AceForge for the host's tempo, clips are time-stretched to it (pitch kept)
+    // and start on the host's next bar line while the transport runs. Tempo changes re-render the playing clip.
+    void setSyncToHost(bool shouldSync);
+    bool isSyncingToHost() const { return syncToHost_.load(); }
+
+    // Library of saved generations (on disk) for drag-into-DAW. Served from an in-memory index: row access never
+    // touches the disk; refreshLibrary() rescans only when the folder changed outside the plugin.
+    using LibraryEntry = LibraryIndex::Entry;
     juce::File getLibraryDirectory() const;
-    std::vector<LibraryEntry> getLibraryEntries() const;
+    std::vector<LibraryEntry> getLibraryEntries() const { return libraryIndex_.getEntries(); }
+    int getNumLibraryEntries() const { return libraryIndex_.size(); }
+    bool getLibraryEntry(int row, LibraryEntry& out) const { return libraryIndex_.getEntry(row, out); }
+    uint32_t getLibraryVersion() const { return libraryIndex_.getVersion(); }
+    void refreshLibrary(bool force = false) { libraryIndex_.refresh(force); }
+    // Format for new library saves (each also gets a JSON sidecar with the generation settings)
+    void setLibraryFormat(LibraryWriter::Format format) { libraryWriter_.setFormat(format); }
+    LibraryWriter::Format getLibraryFormat() const { return libraryWriter_.getFormat(); }
     void addToLibrary(const juce::File& wavFile, const juce::String& prompt);
+    // Waveform summary of a library file for drawing, or null while it loads (queued then; never reads the disk).
+    // getLibraryPeaksVersion() changes when one arrives.
+    PeakCache::Pyramid getLibraryPeaks(const juce::File& file) { return peakCache_.get(file); }
+    uint32_t getLibraryPeaksVersion() const { return peakCache_.getVersion(); }
+    // Plays a library file from disk (any length), replacing whatever is playing
+    void auditionLibraryEntry(const juce::File& file);
+
+    // What getStateInformation saves: settings, the generation settings last used and the clip last played. The
+    // editor fills its controls from it when it opens.
+    PluginState getSavedState() const;
 
 private:
-    void runGenerationThread(juce::String prompt, int durationSec, int inferenceSteps);
-    void pushSamplesToPlayback(const float* interleaved, int numFrames, int sourceChannels, double sourceSampleRate);
+    // What the generation thread hands to the decode worker along with the fetched bytes
+    struct FetchedAudio
+    {
+        int jobId = 0;
+        bool decoded = false;          // streaming decoder read it (playback already started unless too long)
+        bool playFromLibrary = false;  // too long for an in-memory clip: stream the library copy from disk
+        int64_t continueSourceId = 0;  // non-zero: the in-memory clip of this source stopped short, continue it
+        double decodeMs = 0.0;
+        double bpm = 0.0;              // tempo of the audio (reported by AceForge, else requested); 0: unknown
+        aceforge::GenerateParams params; // cache key once the audio proved decodable
+        bool cacheable = true;           // false for the local ML host, whose audio the AceForge key does not describe
+        juce::File cachedFile;           // set when the bytes came from the generation cache
+    };
+
+    // Planar stereo source-rate audio of a clip that streamed in (ClipWriter::takeSource)
+    struct SourceAudio
+    {
+        std::vector<float> channels[2];
+        double sampleRate = 0.0;
+        double bpm = 0.0; // 0: unknown, never conformed
+        int64_t id = 0;
+        int jobId = 0;
+    };
+
+    // Scheduler worker: submit, wait and fetch for one job, with a client leased for each request
+    void runJob(const GenerationScheduler::Job& job, GenerationScheduler::Clients& clients);
+    void failJob(int jobId, const juce::String& error);
+    // Worker thread, once the job's token is cancelled: withdraws serverJobId (if any) and marks the job Cancelled
+    void finishCancelledJob(int jobId, GenerationScheduler::Clients& clients, const std::string& serverJobId);
+    // Worker thread: streams the job from the local ML host into playback. False when no host answers on the
+    // bridge socket (AceForge takes the job); true once the job was handled, whatever its outcome.
+    bool runBridgeJob(const GenerationScheduler::Job& job, const aceforge::GenerateParams& params,
+                      GenerationScheduler::Clients& clients);
+    // Scheduler change callback: refreshes state_, progress_ and the status text from the jobs
+    void updateGenerationSummary();
+    bool streamAudioToPlayback(aceforge::AceForgeClient& client, const GenerationScheduler::Job& job,
+                               const aceforge::GenerateParams& params, const std::string& audioUrl,
+                               const LibraryWriter::Metadata& metadata);
+    // Worker thread: hands a cached WAV to the decode worker instead of asking AceForge
+    bool playCachedGeneration(int jobId, const juce::File& cachedFile, const aceforge::GenerateParams& params);
+    // Decode thread: full decode when the streaming decoder could not play the file, then queues the library copy
+    void finishFetchedAudio(std::shared_ptr<const std::vector<uint8_t>> wavBytes, const FetchedAudio& fetched,
+                            const LibraryWriter::Metadata& metadata);
+    // Queues the library copy; playWhenSaved streams it from disk once written (see playFromDisk). The saved file
+    // becomes the project's clip reference unless clip clipSerial has been replaced by then.
+    void saveToLibrary(std::shared_ptr<const std::vector<uint8_t>> wavBytes, const LibraryWriter::Metadata& metadata,
+                       const aceforge::GenerateParams& params, bool playWhenSaved, int64_t continueSourceId,
+                       int clipSerial);
+    // False when the clip is too long to hold in memory (or empty)
+    bool pushSamplesToPlayback(int jobId, const float* const* channels, int numChannels, int numFrames,
+                               double sourceSampleRate, double sourceBpm);
+
+    // Streamed playback: frames are resampled and published to the audio thread as they are decoded. The writer is
+    // owned by the thread producing the frames (generation or decode thread). jobId's handoff stage starts when
+    // the clip is published. While syncing to a host tempo the source's tempo (sourceBpm, 0: unknown) does not
+    // match, nothing is published: the clip is conformed once the source is complete (rerenderForHost).
+    // prebufferFrames host-rate frames are rendered before the clip is published.
+    bool beginStreamedPlayback(int jobId, aceforge::ClipWriter& writer, int64_t sourceFrames, double sourceSampleRate,
+                               double sourceBpm, int prebufferFrames = kStreamPrebufferFrames);
+    void appendStreamedPlayback(aceforge::ClipWriter& writer, const float* interleaved, int numFrames, int sourceChannels);
+    // Returns the clip's source-rate audio (null when it was truncated), which also becomes lastSource_
+    std::shared_ptr<const SourceAudio> finishStreamedPlayback(aceforge::ClipWriter& writer, int jobId, double sourceBpm);
+
+    // Host rate or tempo changes (hostBpm 0: play at the source tempo): the last clip's source-rate audio is
+    // re-rendered on a background thread, from the playhead on and in chunks, and swapped in after the first chunk
+    void rerenderForHost(double hostRate, double hostBpm);
+    // Host tempo to conform to: 0 unless syncing and the host has reported one
+    double syncTempo() const { return syncToHost_.load() ? core_.hostBpm() : 0.0; }
+    void stopRerender();
+    // Streams a library file through diskStreamer_; continueSourceId != 0 takes over from that source's clip
+    void playFromDisk(const juce::File& file, int64_t continueSourceId);
+    // Ends the pending handoff stage once the audio thread has picked up that clip (core_.lastAcquiredSource())
+    void resolveHandoff();
+    // Four times a second: follows the host tempo; once a second also snapshots the audio thread's counters and
+    // logs overruns and underruns
+    void timerCallback() override;
+
+    // A new clip replaces the current one: returns its serial and drops a restored clip still waiting to play
+    int beginClip();
+    // Background thread: hashes file and makes it the clip the project saves, unless clip clipSerial was replaced
+    void referenceClip(const juce::File& file, const aceforge::GenerateParams& params, double sourceBpm,
+                       const juce::String& jobId, const juce::String& cacheKey, int clipSerial);
+    // Newest library file whose sidecar records cacheKey (a fixed-seed AceForge generation); none if missing
+    juce::File findLibraryCopy(const juce::String& cacheKey, double& sourceBpm, juce::String& jobId) const;
+    // Decode worker: finds the saved clip on disk (library file, same name in this library, generation cache) and
+    // queues it to play from disk once the host transport runs. Never contacts the server.
+    void restoreClip(PluginState::Clip clip, int clipSerial);
+    void startRestoredClip();
+
+    // First member: the shared log outlives every thread this processor stops in its destructor
+    juce::SharedResourcePointer<PluginLog> log_;
+    // Shared by every instance too: cached health, pooled connections and one status poll for all jobs. Declared
+    // before scheduler_, which leases its clients from it.
+    juce::SharedResourcePointer<aceforge::AceForgeSession> session_;
 
-    std::unique_ptr<aceforge::AceForgeClient> client_;
     juce::String baseUrl_;
+    juce::String bridgeSocketPath_; // guarded by statusLock_
     std::atomic<State> state_{ State::Idle };
     std::atomic<bool> connected_{ false };
+    std::atomic<float> progress_{ 0.0f };
     juce::CriticalSection statusLock_;
     juce::String lastError_;
     juce::String statusText_;
 
-    static constexpr int kPlaybackFifoFrames = 1 << 20; // ~10s at 44.1k stereo
-    juce::AbstractFifo playbackFifo_{ kPlaybackFifoFrames };
-    std::vector<float> playbackBuffer_;
+    static constexpr int kMaxPlaybackFrames = 1 << 20; // ~23s at 44.1k
+    static constexpr int kStreamPrebufferFrames = 4096; // frames rendered before a streamed clip starts playing
+    // A bridge stream arrives in small chunks as it is generated: play once this many host blocks are buffered
+    static constexpr int kBridgePrebufferBlocks = 4;
     std::atomic<bool> playbackBufferReady_{ false };
 
-    // Double-buffer handoff: message thread writes to one buffer, audio thread reads from the other. Avoids race where message thread resize() invalidates pointer audio thread is reading.
-    std::vector<float> pendingPlaybackBuffer_[2];
-    std::atomic<int> pendingPlaybackFrames_{ 0 };
-    std::atomic<int> pendingPlaybackBufferIndex_{ 0 }; // which buffer has new data (0 or 1)
-    std::atomic<int> nextWriteIndex_{ 0 };           // which buffer message thread will write next
-    std::atomic<bool> pendingPlaybackReady_{ false };
+    // Realtime path (JUCE-free, see AceForgeAudio/PlaybackCore): writers fill a fresh planar clip and publish it
+    // through core_.handoff() with one pointer exchange; processBlock renders it and hands finished clips back, and
+    // reclaim() frees them off the audio thread. A clip's readyFrames grows while it streams in; frames below it
+    // never change.
+    aceforge::PlaybackCore core_;
+
+    // Clips longer than kMaxPlaybackFrames (and library auditions) play through a small ring fed from disk
+    DiskStreamer diskStreamer_{ core_.handoff() };
+
+    // Source-rate audio of the clip last handed to playback, kept so a host rate change can re-render it
+    juce::CriticalSection sourceLock_;
+    std::shared_ptr<const SourceAudio> lastSource_; // null while the current clip is still streaming in
+    int64_t currentSourceId_{ 0 };                  // source of the newest clip; guarded by sourceLock_
+    double renderedRate_{ 0.0 };                     // host rate the newest clip was (or is being) rendered at
+    double renderedStretch_{ 1.0 };                  // (0: not yet) and its TimeStretch factor
+    double publishedRate_{ 0.0 };                    // the same for the clip the audio thread was last handed (0:
+    double publishedStretch_{ 1.0 };                 // none yet); a re-render maps the playhead from these
+    std::atomic<int64_t> nextSourceId_{ 0 };
+    int handoffJobId_{ 0 };                          // job whose published clip the audio thread has not picked up
+    int64_t handoffSourceId_{ 0 };                   // yet (0: none); both guarded by sourceLock_
+
+    juce::CriticalSection rerenderLock_;             // serializes starting/stopping the re-render thread
+    std::thread rerenderThread_;
+    std::atomic<bool> rerenderCancel_{ false };
+    // Re-render thread only: the last source resampled to a host rate, so tempo changes only re-run the stretch
+    struct HostRateAudio
+    {
+        std::vector<float> channels[2];
+        double sampleRate = 0.0;
+        int64_t sourceId = 0;
+    };
+    HostRateAudio hostRateAudio_;
+    std::atomic<bool> syncToHost_{ false };
 
     std::atomic<double> sampleRate_{ 44100.0 };
+    std::atomic<int> blockSize_{ 512 };              // samplesPerBlock from prepareToPlay
+
+    LibraryIndex libraryIndex_;
+    LibraryWriter libraryWriter_;
+    PeakCache peakCache_;
+    GenerationCache generationCache_;
+    std::atomic<double> lastDecodeMs_{ 0.0 };
+    // Per-job stage timestamps (worker, decode worker and message thread); outlives every thread that writes them
+    aceforge::PipelineTrace pipelineTrace_;
+    std::atomic<int> shownJobId_{ 0 };               // job the status summary describes
+    aceforge::RealtimeStats::Snapshot realtimeTotal_;  // last timer snapshot of core_.stats() (message thread)
+    aceforge::RealtimeStats::Snapshot realtimeWindow_; // the second before it
+    int timerTicks_{ 0 };
+
+    // Project state: savedState_ (guarded by stateLock_) is kept current as clips play, so saving only copies it.
+    // clipSerial_ counts clips; a hash or restore finishing after a newer clip started is dropped.
+    juce::CriticalSection stateLock_;
+    PluginState savedState_;
+    std::atomic<int> clipSerial_{ 0 };
+    juce::File restoredFile_;                        // guarded by stateLock_
+    std::atomic<bool> restorePending_{ false };      // restoredFile_ plays when the transport starts
+    std::atomic<bool> hostPlaying_{ false };         // from processBlock, for the timer
+
+    // Submit/wait/fetch workers, each with a client leased from session_. Stopped first in the destructor: a running job posts to
+    // the decode worker and touches most other members.
+    GenerationScheduler scheduler_;
 
-    // Pending WAV bytes from background thread; decoded on message thread (JUCE not thread-safe)
-    juce::CriticalSection pendingWavLock_;
-    std::vector<uint8_t> pendingWavBytes_;
-    juce::String pendingPrompt_;
-    int pendingDurationSec_{ 0 };
+    // Fetched files are finished on this worker (full decode with its own AudioFormatManager when needed); the
+    // message thread is only notified. Declared last so queued jobs stop before other members go away.
+    DecodeWorker decodeWorker_;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AceForgeBridgeAudioProcessor)
 };
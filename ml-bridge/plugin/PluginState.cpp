@@ -0,0 +1,159 @@
+#include "PluginState.h"
+
+namespace
+{
+constexpr const char* kRootTag = "AceForgeBridge";
+
+juce::String fromStd(const std::string& s)
+{
+    return juce::String::fromUTF8(s.c_str());
+}
+
+// Every field that shapes the audio, so the generation cache key comes out the same on load
+void writeParams(juce::XmlElement& e, const aceforge::GenerateParams& p)
+{
+    e.setAttribute("prompt", fromStd(p.songDescription));
+    e.setAttribute("lyrics", fromStd(p.lyrics));
+    e.setAttribute("instrumental", p.instrumental);
+    e.setAttribute("duration", p.durationSeconds);
+    e.setAttribute("steps", p.inferenceSteps);
+    e.setAttribute("guidance", static_cast<double>(p.guidanceScale));
+    e.setAttribute("randomSeed", p.randomSeed);
+    e.setAttribute("seed", juce::String(static_cast<juce::int64>(p.seed)));
+    e.setAttribute("taskType", fromStd(p.taskType));
+    e.setAttribute("title", fromStd(p.title));
+    e.setAttribute("bpm", p.bpm);
+    if (!p.referenceAudioUrl.empty())
+    {
+        e.setAttribute("referenceAudioUrl", fromStd(p.referenceAudioUrl));
+        e.setAttribute("refAudioStrength", static_cast<double>(p.refAudioStrength));
+    }
+    if (!p.sourceAudioUrl.empty())
+    {
+        e.setAttribute("sourceAudioUrl", fromStd(p.sourceAudioUrl));
+        e.setAttribute("audioCoverStrength", static_cast<double>(p.audioCoverStrength));
+    }
+}
+
+void readParams(const juce::XmlElement& e, aceforge::GenerateParams& p)
+{
+    p.songDescription = e.getStringAttribute("prompt", fromStd(p.songDescription)).toStdString();
+    p.lyrics = e.getStringAttribute("lyrics", fromStd(p.lyrics)).toStdString();
+    p.instrumental = e.getBoolAttribute("instrumental", p.instrumental);
+    p.durationSeconds = e.getIntAttribute("duration", p.durationSeconds);
+    p.inferenceSteps = e.getIntAttribute("steps", p.inferenceSteps);
+    p.guidanceScale = static_cast<float>(e.getDoubleAttribute("guidance", p.guidanceScale));
+    p.randomSeed = e.getBoolAttribute("randomSeed", p.randomSeed);
+    p.seed = e.getStringAttribute("seed", "0").getLargeIntValue();
+    p.taskType = e.getStringAttribute("taskType", fromStd(p.taskType)).toStdString();
+    p.title = e.getStringAttribute("title", fromStd(p.title)).toStdString();
+    p.bpm = e.getIntAttribute("bpm", p.bpm);
+    p.referenceAudioUrl = e.getStringAttribute("referenceAudioUrl").toStdString();
+    p.refAudioStrength = static_cast<float>(e.getDoubleAttribute("refAudioStrength", p.refAudioStrength));
+    p.sourceAudioUrl = e.getStringAttribute("sourceAudioUrl").toStdString();
+    p.audioCoverStrength = static_cast<float>(e.getDoubleAttribute("audioCoverStrength", p.audioCoverStrength));
+}
+
+struct Fnv1a64
+{
+    juce::uint64 h = 14695981039346656037ull;
+
+    void add(const void* data, size_t size)
+    {
+        const auto* p = static_cast<const juce::uint8*>(data);
+        for (size_t i = 0; i < size; ++i)
+            h = (h ^ p[i]) * 1099511628211ull;
+    }
+
+    juce::String hex() const { return juce::String::toHexString(static_cast<juce::int64>(h)).paddedLeft('0', 16); }
+};
+} // namespace
+
+std::unique_ptr<juce::XmlElement> PluginState::toXml() const
+{
+    auto xml = std::make_unique<juce::XmlElement>(kRootTag);
+    xml->setAttribute("version", kVersion);
+    xml->setAttribute("baseUrl", baseUrl);
+    xml->setAttribute("bridgeSocket", bridgeSocketPath);
+    xml->setAttribute("sync", syncToHost);
+    xml->setAttribute("libraryFormat", static_cast<int>(libraryFormat));
+
+    auto* settings = xml->createNewChildElement("Settings");
+    settings->setAttribute("prompt", prompt);
+    settings->setAttribute("duration", durationSec);
+    settings->setAttribute("steps", inferenceSteps);
+    settings->setAttribute("seed", juce::String(seed));
+
+    if (clip.isValid())
+    {
+        auto* c = xml->createNewChildElement("Clip");
+        c->setAttribute("file", clip.file.getFullPathName());
+        c->setAttribute("hash", clip.contentHash);
+        c->setAttribute("size", juce::String(clip.fileSize));
+        c->setAttribute("sourceBpm", clip.sourceBpm);
+        c->setAttribute("jobId", clip.jobId);
+        if (clip.cacheKey.isNotEmpty())
+            c->setAttribute("cacheKey", clip.cacheKey);
+        writeParams(*c->createNewChildElement("Params"), clip.params);
+    }
+    return xml;
+}
+
+bool PluginState::fromXml(const juce::XmlElement& xml, PluginState& out)
+{
+    if (!xml.hasTagName(kRootTag))
+        return false;
+    out.baseUrl = xml.getStringAttribute("baseUrl", out.baseUrl);
+    out.bridgeSocketPath = xml.getStringAttribute("bridgeSocket", out.bridgeSocketPath);
+    out.syncToHost = xml.getBoolAttribute("sync", out.syncToHost);
+    const int format = xml.getIntAttribute("libraryFormat", static_cast<int>(out.libraryFormat));
+    if (format >= static_cast<int>(LibraryWriter::Format::Original) && format <= static_cast<int>(LibraryWriter::Format::Flac))
+        out.libraryFormat = static_cast<LibraryWriter::Format>(format);
+
+    if (const auto* settings = xml.getChildByName("Settings"))
+    {
+        out.prompt = settings->getStringAttribute("prompt", out.prompt);
+        out.durationSec = settings->getIntAttribute("duration", out.durationSec);
+        out.inferenceSteps = settings->getIntAttribute("steps", out.inferenceSteps);
+        out.seed = settings->getStringAttribute("seed", juce::String(out.seed)).getLargeIntValue();
+    }
+
+    out.clip = {};
+    if (const auto* c = xml.getChildByName("Clip"))
+    {
+        out.clip.file = juce::File::isAbsolutePath(c->getStringAttribute("file")) ? juce::File(c->getStringAttribute("file"))
+                                                                                   : juce::File();
+        out.clip.contentHash = c->getStringAttribute("hash");
+        out.clip.fileSize = c->getStringAttribute("size", "0").getLargeIntValue();
+        out.clip.sourceBpm = c->getDoubleAttribute("sourceBpm", 0.0);
+        out.clip.jobId = c->getStringAttribute("jobId");
+        out.clip.cacheKey = c->getStringAttribute("cacheKey");
+        if (const auto* params = c->getChildByName("Params"))
+            readParams(*params, out.clip.params);
+    }
+    return true;
+}
+
+juce::String PluginState::hashFile(const juce::File& file)
+{
+    Fnv1a64 fnv;
+    juce::MemoryMappedFile mapped(file, juce::MemoryMappedFile::readOnly);
+    if (mapped.getData() != nullptr && static_cast<juce::int64>(mapped.getSize()) == file.getSize())
+    {
+        fnv.add(mapped.getData(), mapped.getSize());
+        return fnv.hex();
+    }
+    // Not mappable (or an empty file): stream it
+    juce::FileInputStream in(file);
+    if (!in.openedOk())
+        return {};
+    juce::HeapBlock<char> buffer(1 << 16);
+    for (;;)
+    {
+        const int n = in.read(buffer.getData(), 1 << 16);
+        if (n <= 0)
+            break;
+        fnv.add(buffer.getData(), static_cast<size_t>(n));
+    }
+    return in.isExhausted() ? fnv.hex() : juce::String();
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "AceForgeClient/AceForgeClient.hpp"
+#include "LibraryWriter.h"
+#include <juce_core/juce_core.h>
+#include <memory>
+
+// What the plugin saves in the host project (getStateInformation): connection settings, the generation settings
+// last used and a reference to the clip last played. No audio: the reference names the clip's library file (or
+// generation cache entry), a hash of that file's bytes and the parameters that generated it, and the clip is
+// restored from disk when the project loads. Versioned XML, so later versions can read older projects.
+struct PluginState
+{
+    static constexpr int kVersion = 1;
+
+    struct Clip
+    {
+        juce::File file;             // library file the clip plays from (a restore may find only the cache file)
+        juce::String contentHash;    // hashFile() of file when it was referenced; empty: no clip
+        juce::int64 fileSize = 0;
+        aceforge::GenerateParams params; // prompt, duration, steps, guidance, seed and requested bpm
+        double sourceBpm = 0.0;      // tempo of the audio (reported by AceForge, else requested); 0: unknown
+        juce::String jobId;          // AceForge job that produced it, for the log
+        juce::String cacheKey;       // aceforge::generationCacheKey() of a fixed-seed AceForge generation, else empty
+
+        bool isValid() const { return contentHash.isNotEmpty(); }
+    };
+
+    juce::String baseUrl;
+    juce::String bridgeSocketPath;
+    bool syncToHost = false;
+    LibraryWriter::Format libraryFormat = LibraryWriter::Format::Original;
+
+    // Generation settings, as last passed to startGeneration (seed < 0: random)
+    juce::String prompt;
+    int durationSec = 10;
+    int inferenceSteps = 15;
+    juce::int64 seed = -1;
+
+    Clip clip;
+
+    std::unique_ptr<juce::XmlElement> toXml() const;
+    // False when xml is not an AceForgeBridge state (out is left alone then). Unknown attributes are ignored and
+    // missing ones keep out's defaults.
+    static bool fromXml(const juce::XmlElement& xml, PluginState& out);
+
+    // FNV-1a 64 of the file's bytes as 16 hex digits, read memory-mapped when possible; empty when unreadable.
+    static juce::String hashFile(const juce::File& file);
+};